@@ -0,0 +1,361 @@
+#include "async_file_io.h"
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define ASYNC_FILE_IO_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+
+static bool IsComplete(const AsyncIORequest *req)
+{
+	return req->result >= 0 && static_cast< size_t >(req->result) == req->length;
+}
+
+
+// pread/pwrite on a few worker threads
+class ThreadPoolFileIO : public AsyncFileIO {
+public:
+	ThreadPoolFileIO(unsigned depth, unsigned threads)
+		: depth_(depth), pending_(0), failed_(0), stopping_(false)
+	{
+		for (unsigned i = 0; i < threads; i++) {
+			workers_.push_back(std::thread(&ThreadPoolFileIO::Run, this));
+		}
+	}
+
+	virtual ~ThreadPoolFileIO()
+	{
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			stopping_ = true;
+		}
+		work_cv_.notify_all();
+		for (size_t i = 0; i < workers_.size(); i++) {
+			workers_[i].join();
+		}
+	}
+
+	virtual int Submit(AsyncIORequest *req)
+	{
+		std::unique_lock< std::mutex > lock(mutex_);
+		idle_cv_.wait(lock, [this] { return pending_ < depth_; });
+		queue_.push_back(req);
+		pending_++;
+		work_cv_.notify_one();
+		return 0;
+	}
+
+	virtual int Drain()
+	{
+		std::unique_lock< std::mutex > lock(mutex_);
+		idle_cv_.wait(lock, [this] { return 0 == pending_; });
+		int failed = failed_;
+		failed_ = 0;
+		return failed;
+	}
+
+	virtual const char *Name() const { return "threads"; }
+
+private:
+	static void Transfer(AsyncIORequest *req)
+	{
+		size_t done = 0;
+		while (done < req->length) {
+			ssize_t n = req->write
+				? pwrite(req->fd, req->buffer + done, req->length - done, req->offset + done)
+				: pread(req->fd, req->buffer + done, req->length - done, req->offset + done);
+			if (n < 0) {
+				if (errno == EINTR) continue;
+				req->result = -errno;
+				return;
+			}
+			if (0 == n) break;
+			done += n;
+		}
+		req->result = done;
+	}
+
+	void Run()
+	{
+		for (;;) {
+			AsyncIORequest *req = nullptr;
+			{
+				std::unique_lock< std::mutex > lock(mutex_);
+				work_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+				if (queue_.empty()) return;
+				req = queue_.front();
+				queue_.pop_front();
+			}
+			Transfer(req);
+			bool failed = !IsComplete(req);
+			if (req->done) req->done(req);
+			{
+				std::lock_guard< std::mutex > lock(mutex_);
+				if (failed) failed_++;
+				pending_--;
+			}
+			idle_cv_.notify_all();
+		}
+	}
+
+	unsigned depth_;
+	unsigned pending_;
+	int failed_;
+	bool stopping_;
+	std::deque< AsyncIORequest * > queue_;
+	std::vector< std::thread > workers_;
+	std::mutex mutex_;
+	std::condition_variable work_cv_;
+	std::condition_variable idle_cv_;
+};
+
+
+#ifdef ASYNC_FILE_IO_HAVE_IO_URING
+
+// io_uring through the raw syscalls, so no liburing is needed. Only the
+// submitting thread touches the ring; completions are reaped in Submit()
+// when the queue is full and in Drain().
+class IoUringFileIO : public AsyncFileIO {
+public:
+	IoUringFileIO()
+		: ring_fd_(-1), sq_ptr_(MAP_FAILED), cq_ptr_(MAP_FAILED), sqes_(MAP_FAILED),
+		  sq_size_(0), cq_size_(0), sqes_size_(0), in_flight_(0), failed_(0)
+	{
+	}
+
+	virtual ~IoUringFileIO()
+	{
+		if (ring_fd_ >= 0) {
+			Drain();
+		}
+		if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+		if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_size_);
+		if (sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_size_);
+		if (ring_fd_ >= 0) close(ring_fd_);
+	}
+
+	int Init(unsigned depth)
+	{
+		struct io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		ring_fd_ = syscall(__NR_io_uring_setup, depth, &params);
+		if (ring_fd_ < 0) {
+			return -1;
+		}
+
+		sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			if (cq_size_ > sq_size_) sq_size_ = cq_size_;
+			cq_size_ = sq_size_;
+		}
+		sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+		if (sq_ptr_ == MAP_FAILED) {
+			return -1;
+		}
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			cq_ptr_ = sq_ptr_;
+		} else {
+			cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+			if (cq_ptr_ == MAP_FAILED) {
+				return -1;
+			}
+		}
+		sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+		sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+		if (sqes_ == MAP_FAILED) {
+			return -1;
+		}
+
+		char *sq = static_cast< char * >(sq_ptr_);
+		char *cq = static_cast< char * >(cq_ptr_);
+		sq_tail_ = reinterpret_cast< unsigned * >(sq + params.sq_off.tail);
+		sq_mask_ = *reinterpret_cast< unsigned * >(sq + params.sq_off.ring_mask);
+		sq_array_ = reinterpret_cast< unsigned * >(sq + params.sq_off.array);
+		cq_head_ = reinterpret_cast< unsigned * >(cq + params.cq_off.head);
+		cq_tail_ = reinterpret_cast< unsigned * >(cq + params.cq_off.tail);
+		cq_mask_ = *reinterpret_cast< unsigned * >(cq + params.cq_off.ring_mask);
+		cqes_ = reinterpret_cast< struct io_uring_cqe * >(cq + params.cq_off.cqes);
+
+		// never keep more in flight than the completion ring can hold
+		depth_ = params.sq_entries < params.cq_entries ? params.sq_entries : params.cq_entries;
+		slots_.resize(depth_);
+		for (unsigned i = 0; i < depth_; i++) {
+			free_slots_.push_back(i);
+		}
+		return 0;
+	}
+
+	virtual int Submit(AsyncIORequest *req)
+	{
+		while (free_slots_.empty()) {
+			Reap(1);
+		}
+		unsigned index = free_slots_.back();
+		free_slots_.pop_back();
+		slots_[index].req = req;
+		slots_[index].done = 0;
+		in_flight_++;
+		return Queue(index);
+	}
+
+	virtual int Drain()
+	{
+		while (in_flight_ > 0) {
+			Reap(1);
+		}
+		int failed = failed_;
+		failed_ = 0;
+		return failed;
+	}
+
+	virtual const char *Name() const { return "io_uring"; }
+
+private:
+	struct Slot {
+		AsyncIORequest *req;
+		size_t done;
+		struct iovec iov;
+	};
+
+	int Queue(unsigned index)
+	{
+		Slot &slot = slots_[index];
+		AsyncIORequest *req = slot.req;
+		slot.iov.iov_base = req->buffer + slot.done;
+		slot.iov.iov_len = req->length - slot.done;
+
+		unsigned tail = *sq_tail_;
+		unsigned sq_index = tail & sq_mask_;
+		struct io_uring_sqe *sqe = static_cast< struct io_uring_sqe * >(sqes_) + sq_index;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = req->write ? IORING_OP_WRITEV : IORING_OP_READV;
+		sqe->fd = req->fd;
+		sqe->addr = reinterpret_cast< uintptr_t >(&slot.iov);
+		sqe->len = 1;
+		sqe->off = req->offset + slot.done;
+		sqe->user_data = index;
+		sq_array_[sq_index] = sq_index;
+		__atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+		for (;;) {
+			int ret = syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0);
+			if (ret >= 0) return 0;
+			if (errno != EINTR) break;
+		}
+		// the entry never reached the kernel
+		__atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+		req->result = -errno;
+		Finish(index);
+		return -1;
+	}
+
+	// wait for at least 'min_complete' completions and handle every
+	// completion that is available. The kernel posts completions to the
+	// ring whether or not the wait succeeds, so if it fails this polls the
+	// ring instead of giving up: a request still in flight may be writing
+	// into a buffer its owner frees as soon as Drain() returns.
+	void Reap(unsigned min_complete)
+	{
+		unsigned head = *cq_head_;
+		if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+			int ret = syscall(__NR_io_uring_enter, ring_fd_, 0, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0);
+			if (ret < 0 && errno != EINTR) sched_yield();
+		}
+		unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+		std::vector< unsigned > requeue;
+		while (head != tail) {
+			struct io_uring_cqe *cqe = &cqes_[head & cq_mask_];
+			unsigned index = static_cast< unsigned >(cqe->user_data);
+			Slot &slot = slots_[index];
+			int res = cqe->res;
+			head++;
+			if (res == -EINTR || res == -EAGAIN) {
+				requeue.push_back(index);
+			} else if (res < 0) {
+				slot.req->result = res;
+				Finish(index);
+			} else {
+				slot.done += res;
+				if (res > 0 && slot.done < slot.req->length) {
+					requeue.push_back(index);
+				} else {
+					slot.req->result = slot.done;
+					Finish(index);
+				}
+			}
+		}
+		__atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+		// resubmit short transfers once the completion ring is released
+		for (size_t i = 0; i < requeue.size(); i++) {
+			Queue(requeue[i]);
+		}
+	}
+
+	void Finish(unsigned index)
+	{
+		AsyncIORequest *req = slots_[index].req;
+		if (!IsComplete(req)) failed_++;
+		in_flight_--;
+		free_slots_.push_back(index);
+		if (req->done) req->done(req);
+	}
+
+	int ring_fd_;
+	void *sq_ptr_;
+	void *cq_ptr_;
+	void *sqes_;
+	size_t sq_size_;
+	size_t cq_size_;
+	size_t sqes_size_;
+	unsigned *sq_tail_;
+	unsigned sq_mask_;
+	unsigned *sq_array_;
+	unsigned *cq_head_;
+	unsigned *cq_tail_;
+	unsigned cq_mask_;
+	struct io_uring_cqe *cqes_;
+	unsigned depth_;
+	unsigned in_flight_;
+	int failed_;
+	std::vector< Slot > slots_;
+	std::vector< unsigned > free_slots_;
+};
+
+#endif  // ASYNC_FILE_IO_HAVE_IO_URING
+
+
+AsyncFileIO *AsyncFileIO::Create(unsigned depth, Backend backend)
+{
+	if (0 == depth) depth = 1;
+#ifdef ASYNC_FILE_IO_HAVE_IO_URING
+	if (kBackendAuto == backend) {
+		// io_uring may be missing or blocked by seccomp (e.g. for Android apps)
+		IoUringFileIO *io = new IoUringFileIO();
+		if (0 == io->Init(depth)) {
+			return io;
+		}
+		delete io;
+	}
+#endif
+	unsigned threads = std::thread::hardware_concurrency();
+	if (threads == 0 || threads > 4) threads = 4;
+	if (threads > depth) threads = depth;
+	return new ThreadPoolFileIO(depth, threads);
+}
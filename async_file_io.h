@@ -0,0 +1,46 @@
+#ifndef ASYNC_FILE_IO_H_
+#define ASYNC_FILE_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// One positional read or write. The request and its buffer must stay alive
+// until 'done' has run (or Drain() has returned).
+struct AsyncIORequest {
+	int fd;
+	char *buffer;
+	size_t length;
+	uint64_t offset;
+	bool write;
+	// called once the whole range is transferred, EOF is hit or an error
+	// occurs; may run on any thread
+	void (*done)(AsyncIORequest *req);
+	void *user;
+
+	// filled in by the backend: bytes transferred, or -errno
+	ssize_t result;
+};
+
+// Keeps up to 'depth' reads/writes in flight. Backed by io_uring when the
+// kernel allows it and by a small pthread pool doing pread/pwrite otherwise.
+class AsyncFileIO {
+public:
+	enum Backend {
+		kBackendAuto,
+		kBackendThreads,
+	};
+
+	static AsyncFileIO *Create(unsigned depth, Backend backend = kBackendAuto);
+	virtual ~AsyncFileIO() {}
+
+	// blocks while the queue is full; returns 0, or -1 if the request could
+	// not be queued, in which case it counts as failed and 'done' has run
+	virtual int Submit(AsyncIORequest *req) = 0;
+	// waits for everything submitted so far; returns the number of
+	// requests that failed or came up short
+	virtual int Drain() = 0;
+	virtual const char *Name() const = 0;
+};
+
+#endif  // ASYNC_FILE_IO_H_
@@ -143,6 +143,7 @@
 
 
    Latest revision history:
+      2.06a (local)      stbi_jpeg_stream_from_memory/_callbacks scanline streaming
       2.06  (2015-04-19) fix bug where PSD returns wrong '*comp' value
       2.05  (2015-04-19) fix bug in progressive JPEG handling, fix warning
       2.04  (2015-04-15) try to re-enable SIMD on MinGW 64-bit
@@ -497,6 +498,23 @@ STBIDEF void stbi_convert_iphone_png_to_rgb(int flag_true_if_should_convert);
 // flip the image vertically, so the first pixel in the output array is the bottom left
 STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip);
 
+// JPEG scanline streaming - deliver decoded rows through a callback instead
+// of returning the whole image. Baseline JPEGs are decoded one MCU row at a
+// time, so only a few MCU rows of each component plus one band of output
+// (16 scanlines at most for 4:2:0) are ever resident. Progressive and
+// non-interleaved multi-scan files are decoded fully and then delivered the
+// same way. Rows are handed over top to bottom and ignore the vertical flip
+// setting. Not available with STBI_NO_JPEG.
+
+typedef struct
+{
+   int      (*begin) (void *user,int x,int y,int comp);   // optional; called once the frame header is read. return 0 to cancel
+   int      (*rows)  (void *user,stbi_uc const *data,int y0,int count); // 'count' scanlines of x*req_comp bytes starting at row 'y0'. return 0 to stop
+} stbi_jpeg_row_callbacks;
+
+STBIDEF int stbi_jpeg_stream_from_memory   (stbi_uc           const *buffer, int len   , int *x, int *y, int *comp, int req_comp, stbi_jpeg_row_callbacks const *rows, void *rows_user);
+STBIDEF int stbi_jpeg_stream_from_callbacks(stbi_io_callbacks const *clbk  , void *user, int *x, int *y, int *comp, int req_comp, stbi_jpeg_row_callbacks const *rows, void *rows_user);
+
 // ZLIB client - used by PNG, available for other purposes
 
 STBIDEF char *stbi_zlib_decode_malloc_guesssize(const char *buffer, int len, int initial_size, int *outlen);
@@ -1190,7 +1208,8 @@ enum
 {
    STBI__SCAN_load=0,
    STBI__SCAN_type,
-   STBI__SCAN_header
+   STBI__SCAN_header,
+   STBI__SCAN_stream    // like load, but component buffers are left to the caller
 };
 
 static void stbi__refill_buffer(stbi__context *s)
@@ -2678,6 +2697,27 @@ static int stbi__process_scan_header(stbi__jpeg *z)
    return 1;
 }
 
+// allocate 'rows' scanlines of sample storage for component i (plus the
+// coefficient buffer for progressive images, which always covers all rows)
+static int stbi__jpeg_alloc_component(stbi__jpeg *z, int i, int rows)
+{
+   z->img_comp[i].raw_data = stbi__malloc(z->img_comp[i].w2 * rows+15);
+   if (z->img_comp[i].raw_data == NULL)
+      return 0;
+   // align blocks for idct using mmx/sse
+   z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
+   if (z->progressive) {
+      z->img_comp[i].coeff_w = (z->img_comp[i].w2 + 7) >> 3;
+      z->img_comp[i].coeff_h = (z->img_comp[i].h2 + 7) >> 3;
+      z->img_comp[i].raw_coeff = STBI_MALLOC(z->img_comp[i].coeff_w * z->img_comp[i].coeff_h * 64 * sizeof(short) + 15);
+      z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
+   } else {
+      z->img_comp[i].coeff = 0;
+      z->img_comp[i].raw_coeff = 0;
+   }
+   return 1;
+}
+
 static int stbi__process_frame_header(stbi__jpeg *z, int scan)
 {
    stbi__context *s = z->s;
@@ -2707,7 +2747,7 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       z->img_comp[i].tq = stbi__get8(s);  if (z->img_comp[i].tq > 3) return stbi__err("bad TQ","Corrupt JPEG");
    }
 
-   if (scan != STBI__SCAN_load) return 1;
+   if (scan != STBI__SCAN_load && scan != STBI__SCAN_stream) return 1;
 
    if ((1 << 30) / s->img_x / s->img_n < s->img_y) return stbi__err("too large", "Image too large to decode");
 
@@ -2734,27 +2774,21 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       // discard the extra data until colorspace conversion
       z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * 8;
       z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * 8;
-      z->img_comp[i].raw_data = stbi__malloc(z->img_comp[i].w2 * z->img_comp[i].h2+15);
+      z->img_comp[i].linebuf = NULL;
+      if (scan == STBI__SCAN_stream) {
+         // sized once the first scan shows whether it can be streamed
+         z->img_comp[i].raw_data = NULL;
+         z->img_comp[i].raw_coeff = NULL;
+         continue;
+      }
 
-      if (z->img_comp[i].raw_data == NULL) {
+      if (!stbi__jpeg_alloc_component(z, i, z->img_comp[i].h2)) {
          for(--i; i >= 0; --i) {
             STBI_FREE(z->img_comp[i].raw_data);
             z->img_comp[i].data = NULL;
          }
          return stbi__err("outofmem", "Out of memory");
       }
-      // align blocks for idct using mmx/sse
-      z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
-      z->img_comp[i].linebuf = NULL;
-      if (z->progressive) {
-         z->img_comp[i].coeff_w = (z->img_comp[i].w2 + 7) >> 3;
-         z->img_comp[i].coeff_h = (z->img_comp[i].h2 + 7) >> 3;
-         z->img_comp[i].raw_coeff = STBI_MALLOC(z->img_comp[i].coeff_w * z->img_comp[i].coeff_h * 64 * sizeof(short) + 15);
-         z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
-      } else {
-         z->img_comp[i].coeff = 0;
-         z->img_comp[i].raw_coeff = 0;
-      }
    }
 
    return 1;
@@ -2791,34 +2825,33 @@ static int stbi__decode_jpeg_header(stbi__jpeg *z, int scan)
    return 1;
 }
 
-// decode image to YCbCr format
-static int stbi__decode_jpeg_image(stbi__jpeg *j)
+// find the marker that follows an entropy-coded segment
+static int stbi__jpeg_end_scan(stbi__jpeg *j)
 {
-   int m;
-   for (m = 0; m < 4; m++) {
-      j->img_comp[m].raw_data = NULL;
-      j->img_comp[m].raw_coeff = NULL;
+   if (j->marker == STBI__MARKER_none ) {
+      // handle 0s at the end of image data from IP Kamera 9060
+      while (!stbi__at_eof(j->s)) {
+         int x = stbi__get8(j->s);
+         if (x == 255) {
+            j->marker = stbi__get8(j->s);
+            break;
+         } else if (x != 0) {
+            return stbi__err("junk before marker", "Corrupt JPEG");
+         }
+      }
+      // if we reach eof without hitting a marker, stbi__get_marker() below will fail and we'll eventually return 0
    }
-   j->restart_interval = 0;
-   if (!stbi__decode_jpeg_header(j, STBI__SCAN_load)) return 0;
-   m = stbi__get_marker(j);
+   return 1;
+}
+
+// decode all remaining scans, starting at marker m, up to EOI
+static int stbi__decode_jpeg_scans(stbi__jpeg *j, int m)
+{
    while (!stbi__EOI(m)) {
       if (stbi__SOS(m)) {
          if (!stbi__process_scan_header(j)) return 0;
          if (!stbi__parse_entropy_coded_data(j)) return 0;
-         if (j->marker == STBI__MARKER_none ) {
-            // handle 0s at the end of image data from IP Kamera 9060
-            while (!stbi__at_eof(j->s)) {
-               int x = stbi__get8(j->s);
-               if (x == 255) {
-                  j->marker = stbi__get8(j->s);
-                  break;
-               } else if (x != 0) {
-                  return stbi__err("junk before marker", "Corrupt JPEG");
-               }
-            }
-            // if we reach eof without hitting a marker, stbi__get_marker() below will fail and we'll eventually return 0
-         }
+         if (!stbi__jpeg_end_scan(j)) return 0;
       } else {
          if (!stbi__process_marker(j, m)) return 0;
       }
@@ -2829,6 +2862,19 @@ static int stbi__decode_jpeg_image(stbi__jpeg *j)
    return 1;
 }
 
+// decode image to YCbCr format
+static int stbi__decode_jpeg_image(stbi__jpeg *j)
+{
+   int m;
+   for (m = 0; m < 4; m++) {
+      j->img_comp[m].raw_data = NULL;
+      j->img_comp[m].raw_coeff = NULL;
+   }
+   j->restart_interval = 0;
+   if (!stbi__decode_jpeg_header(j, STBI__SCAN_load)) return 0;
+   return stbi__decode_jpeg_scans(j, stbi__get_marker(j));
+}
+
 // static jfif-centered resampling (across block boundaries)
 
 typedef stbi_uc *(*resample_row_func)(stbi_uc *out, stbi_uc *in0, stbi_uc *in1,
@@ -3282,12 +3328,79 @@ typedef struct
 {
    resample_row_func resample;
    stbi_uc *line0,*line1;
+   stbi_uc *line_first,*line_end; // line1 wraps back to line_first at line_end
    int hs,vs;   // expansion factor in each axis
    int w_lores; // horizontal pixels pre-expansion
    int ystep;   // how far through vertical expansion we are
    int ypos;    // which pre-expansion row we're on
 } stbi__resample;
 
+// set up the resampler for component k; the component samples are read as
+// a ring of 'rows' scanlines
+static int stbi__jpeg_setup_resample(stbi__jpeg *z, stbi__resample *r, int k, int rows)
+{
+   // allocate line buffer big enough for upsampling off the edges
+   // with upsample factor of 4
+   z->img_comp[k].linebuf = (stbi_uc *) stbi__malloc(z->s->img_x + 3);
+   if (!z->img_comp[k].linebuf) return stbi__err("outofmem", "Out of memory");
+
+   r->hs      = z->img_h_max / z->img_comp[k].h;
+   r->vs      = z->img_v_max / z->img_comp[k].v;
+   r->ystep   = r->vs >> 1;
+   r->w_lores = (z->s->img_x + r->hs-1) / r->hs;
+   r->ypos    = 0;
+   r->line0   = r->line1 = r->line_first = z->img_comp[k].data;
+   r->line_end = z->img_comp[k].data + z->img_comp[k].w2 * rows;
+
+   if      (r->hs == 1 && r->vs == 1) r->resample = resample_row_1;
+   else if (r->hs == 1 && r->vs == 2) r->resample = stbi__resample_row_v_2;
+   else if (r->hs == 2 && r->vs == 1) r->resample = stbi__resample_row_h_2;
+   else if (r->hs == 2 && r->vs == 2) r->resample = z->resample_row_hv_2_kernel;
+   else                               r->resample = stbi__resample_row_generic;
+   return 1;
+}
+
+// resample and color-convert the next output scanline into 'out'
+static void stbi__jpeg_output_row(stbi__jpeg *z, stbi__resample *res_comp, int decode_n, stbi_uc *out, int n)
+{
+   int k;
+   unsigned int i;
+   stbi_uc *coutput[4];
+   for (k=0; k < decode_n; ++k) {
+      stbi__resample *r = &res_comp[k];
+      int y_bot = r->ystep >= (r->vs >> 1);
+      coutput[k] = r->resample(z->img_comp[k].linebuf,
+                               y_bot ? r->line1 : r->line0,
+                               y_bot ? r->line0 : r->line1,
+                               r->w_lores, r->hs);
+      if (++r->ystep >= r->vs) {
+         r->ystep = 0;
+         r->line0 = r->line1;
+         if (++r->ypos < z->img_comp[k].y) {
+            r->line1 += z->img_comp[k].w2;
+            if (r->line1 == r->line_end) r->line1 = r->line_first;
+         }
+      }
+   }
+   if (n >= 3) {
+      stbi_uc *y = coutput[0];
+      if (z->s->img_n == 3) {
+         z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+      } else
+         for (i=0; i < z->s->img_x; ++i) {
+            out[0] = out[1] = out[2] = y[i];
+            out[3] = 255; // not used if n==3
+            out += n;
+         }
+   } else {
+      stbi_uc *y = coutput[0];
+      if (n == 1)
+         for (i=0; i < z->s->img_x; ++i) out[i] = y[i];
+      else
+         for (i=0; i < z->s->img_x; ++i) *out++ = y[i], *out++ = 255;
+   }
+}
+
 static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp)
 {
    int n, decode_n;
@@ -3310,32 +3423,13 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    // resample and color-convert
    {
       int k;
-      unsigned int i,j;
+      unsigned int j;
       stbi_uc *output;
-      stbi_uc *coutput[4];
 
       stbi__resample res_comp[4];
 
       for (k=0; k < decode_n; ++k) {
-         stbi__resample *r = &res_comp[k];
-
-         // allocate line buffer big enough for upsampling off the edges
-         // with upsample factor of 4
-         z->img_comp[k].linebuf = (stbi_uc *) stbi__malloc(z->s->img_x + 3);
-         if (!z->img_comp[k].linebuf) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
-
-         r->hs      = z->img_h_max / z->img_comp[k].h;
-         r->vs      = z->img_v_max / z->img_comp[k].v;
-         r->ystep   = r->vs >> 1;
-         r->w_lores = (z->s->img_x + r->hs-1) / r->hs;
-         r->ypos    = 0;
-         r->line0   = r->line1 = z->img_comp[k].data;
-
-         if      (r->hs == 1 && r->vs == 1) r->resample = resample_row_1;
-         else if (r->hs == 1 && r->vs == 2) r->resample = stbi__resample_row_v_2;
-         else if (r->hs == 2 && r->vs == 1) r->resample = stbi__resample_row_h_2;
-         else if (r->hs == 2 && r->vs == 2) r->resample = z->resample_row_hv_2_kernel;
-         else                               r->resample = stbi__resample_row_generic;
+         if (!stbi__jpeg_setup_resample(z, &res_comp[k], k, z->img_comp[k].h2)) { stbi__cleanup_jpeg(z); return NULL; }
       }
 
       // can't error after this so, this is safe
@@ -3343,40 +3437,8 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
       if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
 
       // now go ahead and resample
-      for (j=0; j < z->s->img_y; ++j) {
-         stbi_uc *out = output + n * z->s->img_x * j;
-         for (k=0; k < decode_n; ++k) {
-            stbi__resample *r = &res_comp[k];
-            int y_bot = r->ystep >= (r->vs >> 1);
-            coutput[k] = r->resample(z->img_comp[k].linebuf,
-                                     y_bot ? r->line1 : r->line0,
-                                     y_bot ? r->line0 : r->line1,
-                                     r->w_lores, r->hs);
-            if (++r->ystep >= r->vs) {
-               r->ystep = 0;
-               r->line0 = r->line1;
-               if (++r->ypos < z->img_comp[k].y)
-                  r->line1 += z->img_comp[k].w2;
-            }
-         }
-         if (n >= 3) {
-            stbi_uc *y = coutput[0];
-            if (z->s->img_n == 3) {
-               z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-            } else
-               for (i=0; i < z->s->img_x; ++i) {
-                  out[0] = out[1] = out[2] = y[i];
-                  out[3] = 255; // not used if n==3
-                  out += n;
-               }
-         } else {
-            stbi_uc *y = coutput[0];
-            if (n == 1)
-               for (i=0; i < z->s->img_x; ++i) out[i] = y[i];
-            else
-               for (i=0; i < z->s->img_x; ++i) *out++ = y[i], *out++ = 255;
-         }
-      }
+      for (j=0; j < z->s->img_y; ++j)
+         stbi__jpeg_output_row(z, res_comp, decode_n, output + n * z->s->img_x * j, n);
       stbi__cleanup_jpeg(z);
       *out_x = z->s->img_x;
       *out_y = z->s->img_y;
@@ -3422,6 +3484,189 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp)
    j.s = s;
    return stbi__jpeg_info_raw(&j, x, y, comp);
 }
+
+// decode one unit of a single-scan baseline image into ring slot 'slot':
+// an MCU row for interleaved scans, a block row for one-component scans.
+// returns 0 on error, 1 to continue, 2 if the data ended early.
+static int stbi__jpeg_decode_stream_unit(stbi__jpeg *z, int slot)
+{
+   int i,k,x,y;
+   STBI_SIMD_ALIGN(short, data[64]);
+   if (z->scan_n == 1) {
+      int n = z->order[0];
+      int w = (z->img_comp[n].x+7) >> 3;
+      int ha = z->img_comp[n].ha;
+      for (i=0; i < w; ++i) {
+         if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+         z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*slot*8+i*8, z->img_comp[n].w2, data);
+         if (--z->todo <= 0) {
+            if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+            if (!STBI__RESTART(z->marker)) return 2;
+            stbi__jpeg_reset(z);
+         }
+      }
+   } else {
+      for (i=0; i < z->img_mcu_x; ++i) {
+         for (k=0; k < z->scan_n; ++k) {
+            int n = z->order[k];
+            for (y=0; y < z->img_comp[n].v; ++y) {
+               for (x=0; x < z->img_comp[n].h; ++x) {
+                  int x2 = (i*z->img_comp[n].h + x)*8;
+                  int y2 = (slot*z->img_comp[n].v + y)*8;
+                  int ha = z->img_comp[n].ha;
+                  if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+                  z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
+               }
+            }
+         }
+         if (--z->todo <= 0) {
+            if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+            if (!STBI__RESTART(z->marker)) return 2;
+            stbi__jpeg_reset(z);
+         }
+      }
+   }
+   return 1;
+}
+
+typedef struct
+{
+   stbi_jpeg_row_callbacks const *cb;
+   void *user;
+   stbi__resample res_comp[4];
+   int decode_n, n;
+   stbi_uc *band;       // up to 'band_rows' output scanlines
+   int band_rows, band_count;
+   int y;               // next output scanline
+} stbi__jpeg_stream;
+
+// emit every output scanline whose source rows are decoded; avail[k] is the
+// number of rows of component k decoded so far
+static int stbi__jpeg_stream_rows(stbi__jpeg *z, stbi__jpeg_stream *st, int *avail)
+{
+   int k, stride = st->n * z->s->img_x;
+   while (st->y < (int) z->s->img_y) {
+      for (k=0; k < st->decode_n; ++k) {
+         int row1 = st->res_comp[k].ypos < z->img_comp[k].y ? st->res_comp[k].ypos : z->img_comp[k].y-1;
+         if (row1 >= avail[k]) break;
+      }
+      if (k < st->decode_n) break;
+      stbi__jpeg_output_row(z, st->res_comp, st->decode_n, st->band + stride * st->band_count, st->n);
+      ++st->y;
+      if (++st->band_count == st->band_rows || st->y == (int) z->s->img_y) {
+         if (!st->cb->rows(st->user, st->band, st->y - st->band_count, st->band_count))
+            return 0;
+         st->band_count = 0;
+      }
+   }
+   return 1;
+}
+
+static int stbi__jpeg_stream_image(stbi__jpeg *z, int req_comp, stbi_jpeg_row_callbacks const *cb, void *user)
+{
+   stbi__jpeg_stream st;
+   int k, m, streaming, unit_rows[4], avail[4];
+
+   if (req_comp < 0 || req_comp > 4) return stbi__err("bad req_comp", "Internal error");
+   for (m = 0; m < 4; m++) {
+      z->img_comp[m].raw_data = NULL;
+      z->img_comp[m].raw_coeff = NULL;
+      z->img_comp[m].linebuf = NULL;
+   }
+   z->restart_interval = 0;
+   if (!stbi__decode_jpeg_header(z, STBI__SCAN_stream)) return 0;
+
+   st.cb = cb;
+   st.user = user;
+   st.n = req_comp ? req_comp : z->s->img_n;
+   st.decode_n = (z->s->img_n == 3 && st.n < 3) ? 1 : z->s->img_n;
+   st.band_rows = z->img_mcu_h;
+   st.band_count = 0;
+   st.y = 0;
+   st.band = NULL;
+   if (cb->begin && !cb->begin(user, z->s->img_x, z->s->img_y, z->s->img_n))
+      return 1;
+
+   // tables and such come before the first scan
+   m = stbi__get_marker(z);
+   while (!stbi__SOS(m)) {
+      if (stbi__EOI(m)) return stbi__err("no SOS", "Corrupt JPEG");
+      if (!stbi__process_marker(z, m)) return 0;
+      m = stbi__get_marker(z);
+   }
+   if (!stbi__process_scan_header(z)) return 0;
+
+   // a baseline scan that carries every component can be consumed one MCU
+   // row at a time; anything else needs the whole image before output
+   streaming = !z->progressive && z->scan_n == z->s->img_n;
+   for (k=0; k < z->s->img_n; ++k) {
+      int rows = z->img_comp[k].h2;
+      if (streaming) {
+         unit_rows[k] = z->scan_n == 1 ? 8 : z->img_comp[k].v * 8;
+         rows = 2 * unit_rows[k];
+      }
+      if (!stbi__jpeg_alloc_component(z, k, rows)) return stbi__err("outofmem", "Out of memory");
+      if (k < st.decode_n && !stbi__jpeg_setup_resample(z, &st.res_comp[k], k, rows)) return 0;
+   }
+   st.band = (stbi_uc *) stbi__malloc(st.n * z->s->img_x * st.band_rows + 1);
+   if (!st.band) return stbi__err("outofmem", "Out of memory");
+
+   if (streaming) {
+      int j, r = 1, units;
+      units = z->scan_n == 1 ? (z->img_comp[z->order[0]].y+7) >> 3 : z->img_mcu_y;
+      stbi__jpeg_reset(z);
+      for (j=0; j < units && r == 1; ++j) {
+         r = stbi__jpeg_decode_stream_unit(z, j & 1);
+         if (!r) { STBI_FREE(st.band); return 0; }
+         for (k=0; k < z->s->img_n; ++k)
+            avail[k] = r == 1 ? (j+1) * unit_rows[k] : z->img_comp[k].y;
+         if (j+1 == units)
+            for (k=0; k < z->s->img_n; ++k) avail[k] = z->img_comp[k].y;
+         if (!stbi__jpeg_stream_rows(z, &st, avail)) break;
+      }
+   } else {
+      if (!stbi__parse_entropy_coded_data(z) || !stbi__jpeg_end_scan(z) ||
+          !stbi__decode_jpeg_scans(z, stbi__get_marker(z))) {
+         STBI_FREE(st.band);
+         return 0;
+      }
+      for (k=0; k < z->s->img_n; ++k) avail[k] = z->img_comp[k].y;
+      stbi__jpeg_stream_rows(z, &st, avail);
+   }
+   STBI_FREE(st.band);
+   return 1;
+}
+
+static int stbi__jpeg_stream_main(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi_jpeg_row_callbacks const *rows, void *rows_user)
+{
+   int r;
+   stbi__jpeg j;
+   j.s = s;
+   s->img_n = 0; // make stbi__cleanup_jpeg safe
+   stbi__setup_jpeg(&j);
+   r = stbi__jpeg_stream_image(&j, req_comp, rows, rows_user);
+   stbi__cleanup_jpeg(&j);
+   if (r) {
+      if (x) *x = s->img_x;
+      if (y) *y = s->img_y;
+      if (comp) *comp = s->img_n;
+   }
+   return r;
+}
+
+STBIDEF int stbi_jpeg_stream_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp, stbi_jpeg_row_callbacks const *rows, void *rows_user)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer,len);
+   return stbi__jpeg_stream_main(&s,x,y,comp,req_comp,rows,rows_user);
+}
+
+STBIDEF int stbi_jpeg_stream_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp, stbi_jpeg_row_callbacks const *rows, void *rows_user)
+{
+   stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__jpeg_stream_main(&s,x,y,comp,req_comp,rows,rows_user);
+}
 #endif
 
 // public domain zlib decode    v0.2  Sean Barrett 2006-11-18
@@ -6295,6 +6540,7 @@ STBIDEF int stbi_info_from_callbacks(stbi_io_callbacks const *c, void *user, int
 
 /*
    revision history:
+      2.06a (local)      stbi_jpeg_stream_from_memory/_callbacks scanline streaming
       2.06  (2015-04-19) fix bug where PSD returns wrong '*comp' value
       2.05  (2015-04-19) fix bug in progressive JPEG handling, fix warning
       2.04  (2015-04-15) try to re-enable SIMD on MinGW 64-bit
@@ -39,6 +39,31 @@ USAGE:
 
    Each function returns 0 on failure and non-0 on success.
 
+   PNG can also be written through a callback:
+
+     int stbi_write_png_to_func(stbi_write_func *func, void *context, int w, int h, int comp, const void *data, int stride_in_bytes);
+
+   where the callback is:
+      void stbi_write_func(void *context, void *data, int size);
+
+   The compressed stream is handed to the callback in IDAT chunks while it
+   is being deflated, so the complete PNG is never held in memory.
+   stbi_write_png() uses this path with fwrite.
+
+   PNG speed/size can be traded off with two globals:
+
+     stbi_write_png_compression_level (default 8)
+        0    = stored blocks, no compression
+        1..3 = fast single-probe match finder; 1 also skips indexing
+               the positions inside a match
+        4+   = hash chains with lazy matching; higher is smaller and slower
+     stbi_write_force_png_filter (default -1)
+        -1   = try all five filters per row and keep the cheapest
+        0..4 = always use that filter (skips the trial encodes)
+
+   If compiled with OpenMP, rows are filtered in parallel; #define
+   STBIW_NO_OPENMP to prevent that.
+
    The functions create an image file defined by the parameters. The image
    is a rectangle of pixels stored from left-to-right, top-to-bottom.
    Each pixel contains 'comp' channels of data stored interleaved with 8-bits
@@ -89,6 +114,13 @@ extern int stbi_write_bmp(char const *filename, int w, int h, int comp, const vo
 extern int stbi_write_tga(char const *filename, int w, int h, int comp, const void  *data);
 extern int stbi_write_hdr(char const *filename, int w, int h, int comp, const float *data);
 
+typedef void stbi_write_func(void *context, void *data, int size);
+
+extern int stbi_write_png_to_func(stbi_write_func *func, void *context, int w, int h, int comp, const void  *data, int stride_in_bytes);
+
+extern int stbi_write_png_compression_level;
+extern int stbi_write_force_png_filter;
+
 #ifdef __cplusplus
 }
 #endif
@@ -466,7 +498,20 @@ static unsigned int stbiw__zhash(unsigned char *data)
 
 #define stbiw__ZHASH   16384
 
-unsigned char * stbi_zlib_compress(unsigned char *data, int data_len, int *out_len, int quality)
+// flush the compressed stream to the sink once this many bytes are pending
+#ifndef STBIW_ZLIB_SINK_SIZE
+#define STBIW_ZLIB_SINK_SIZE 65536
+#endif
+
+#define stbiw__zlib_drain() \
+      (sink && stbiw__sbn(out) >= STBIW_ZLIB_SINK_SIZE ? (sink(sink_context, out, stbiw__sbn(out)), stbiw__sbn(out) = 0) : 0)
+
+// quality <= 0 writes stored blocks, 1..3 use a single-probe hash head
+// (1 = no insertion inside matches), >= 4 use the hash chains with lazy
+// matching (values below 5 behave as 5). If 'sink' is set the compressed
+// bytes are handed to it as they are produced; the returned stretchy
+// buffer must still be freed by the caller.
+static unsigned char *stbiw__zlib_compress_core(unsigned char *data, int data_len, int quality, stbi_write_func *sink, void *sink_context)
 {
    static unsigned short lengthc[] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258, 259 };
    static unsigned char  lengtheb[]= { 0,0,0,0,0,0,0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4,  4,  5,  5,  5,  5,  0 };
@@ -476,77 +521,129 @@ unsigned char * stbi_zlib_compress(unsigned char *data, int data_len, int *out_l
    int i,j, bitcount=0;
    unsigned char *out = NULL;
    unsigned char **hash_table[stbiw__ZHASH]; // 64KB on the stack!
-   if (quality < 5) quality = 5;
-
-   stbiw__sbpush(out, 0x78);   // DEFLATE 32K window
-   stbiw__sbpush(out, 0x5e);   // FLEVEL = 1
-   stbiw__zlib_add(1,1);  // BFINAL = 1
-   stbiw__zlib_add(1,2);  // BTYPE = 1 -- fixed huffman
-
-   for (i=0; i < stbiw__ZHASH; ++i)
-      hash_table[i] = NULL;
-
-   i=0;
-   while (i < data_len-3) {
-      // hash next 3 bytes of data to be compressed
-      int h = stbiw__zhash(data+i)&(stbiw__ZHASH-1), best=3;
-      unsigned char *bestloc = 0;
-      unsigned char **hlist = hash_table[h];
-      int n = stbiw__sbcount(hlist);
-      for (j=0; j < n; ++j) {
-         if (hlist[j]-data > i-32768) { // if entry lies within window
-            int d = stbiw__zlib_countm(hlist[j], data+i, data_len-i);
-            if (d >= best) best=d,bestloc=hlist[j];
+   int *head = NULL;
+
+   if (quality <= 0) {
+      stbiw__sbpush(out, 0x78);   // DEFLATE 32K window
+      stbiw__sbpush(out, 0x01);   // FLEVEL = 0
+      i = 0;
+      do {
+         int blen = data_len - i > 65535 ? 65535 : data_len - i;
+         stbiw__zlib_add(i + blen >= data_len, 1); // BFINAL
+         stbiw__zlib_add(0,2);                     // BTYPE = 0 -- stored
+         while (bitcount)
+            stbiw__zlib_add(0,1);
+         stbiw__sbpush(out, (unsigned char) blen);
+         stbiw__sbpush(out, (unsigned char) (blen >> 8));
+         stbiw__sbpush(out, (unsigned char) ~blen);
+         stbiw__sbpush(out, (unsigned char) (~blen >> 8));
+         if (blen) {
+            stbiw__sbmaybegrow(out, blen);
+            STBIW_MEMMOVE(out + stbiw__sbn(out), data + i, blen);
+            stbiw__sbn(out) += blen;
          }
+         i += blen;
+         stbiw__zlib_drain();
+      } while (i < data_len);
+   } else {
+      if (quality <= 3) {
+         head = (int *) STBIW_MALLOC(sizeof(int) * stbiw__ZHASH);
+         if (!head) return NULL;
+         for (i=0; i < stbiw__ZHASH; ++i)
+            head[i] = -32768;
+      } else {
+         if (quality < 5) quality = 5;
+         for (i=0; i < stbiw__ZHASH; ++i)
+            hash_table[i] = NULL;
       }
-      // when hash table entry is too long, delete half the entries
-      if (hash_table[h] && stbiw__sbn(hash_table[h]) == 2*quality) {
-         STBIW_MEMMOVE(hash_table[h], hash_table[h]+quality, sizeof(hash_table[h][0])*quality);
-         stbiw__sbn(hash_table[h]) = quality;
-      }
-      stbiw__sbpush(hash_table[h],data+i);
-
-      if (bestloc) {
-         // "lazy matching" - check match at *next* byte, and if it's better, do cur byte as literal
-         h = stbiw__zhash(data+i+1)&(stbiw__ZHASH-1);
-         hlist = hash_table[h];
-         n = stbiw__sbcount(hlist);
-         for (j=0; j < n; ++j) {
-            if (hlist[j]-data > i-32767) {
-               int e = stbiw__zlib_countm(hlist[j], data+i+1, data_len-i-1);
-               if (e > best) { // if next match is better, bail on current match
-                  bestloc = NULL;
-                  break;
+
+      stbiw__sbpush(out, 0x78);   // DEFLATE 32K window
+      stbiw__sbpush(out, 0x5e);   // FLEVEL = 1
+      stbiw__zlib_add(1,1);  // BFINAL = 1
+      stbiw__zlib_add(1,2);  // BTYPE = 1 -- fixed huffman
+
+      i=0;
+      while (i < data_len-3) {
+         // hash next 3 bytes of data to be compressed
+         int h = stbiw__zhash(data+i)&(stbiw__ZHASH-1), best=3;
+         unsigned char *bestloc = 0;
+
+         if (head) {
+            // fast path: only try the most recent position with this hash
+            int cand = head[h];
+            head[h] = i;
+            if (i - cand <= 32767 && data[cand] == data[i] && data[cand+1] == data[i+1] && data[cand+2] == data[i+2]) {
+               best = stbiw__zlib_countm(data+cand, data+i, data_len-i);
+               bestloc = data+cand;
+            }
+         } else {
+            unsigned char **hlist = hash_table[h];
+            int n = stbiw__sbcount(hlist);
+            for (j=0; j < n; ++j) {
+               if (hlist[j]-data > i-32768) { // if entry lies within window
+                  int d = stbiw__zlib_countm(hlist[j], data+i, data_len-i);
+                  if (d >= best) best=d,bestloc=hlist[j];
+               }
+            }
+            // when hash table entry is too long, delete half the entries
+            if (hash_table[h] && stbiw__sbn(hash_table[h]) == 2*quality) {
+               STBIW_MEMMOVE(hash_table[h], hash_table[h]+quality, sizeof(hash_table[h][0])*quality);
+               stbiw__sbn(hash_table[h]) = quality;
+            }
+            stbiw__sbpush(hash_table[h],data+i);
+
+            if (bestloc) {
+               // "lazy matching" - check match at *next* byte, and if it's better, do cur byte as literal
+               h = stbiw__zhash(data+i+1)&(stbiw__ZHASH-1);
+               hlist = hash_table[h];
+               n = stbiw__sbcount(hlist);
+               for (j=0; j < n; ++j) {
+                  if (hlist[j]-data > i-32767) {
+                     int e = stbiw__zlib_countm(hlist[j], data+i+1, data_len-i-1);
+                     if (e > best) { // if next match is better, bail on current match
+                        bestloc = NULL;
+                        break;
+                     }
+                  }
                }
             }
          }
-      }
 
-      if (bestloc) {
-         int d = (int) (data+i - bestloc); // distance back
-         STBIW_ASSERT(d <= 32767 && best <= 258);
-         for (j=0; best > lengthc[j+1]-1; ++j);
-         stbiw__zlib_huff(j+257);
-         if (lengtheb[j]) stbiw__zlib_add(best - lengthc[j], lengtheb[j]);
-         for (j=0; d > distc[j+1]-1; ++j);
-         stbiw__zlib_add(stbiw__zlib_bitrev(j,5),5);
-         if (disteb[j]) stbiw__zlib_add(d - distc[j], disteb[j]);
-         i += best;
-      } else {
-         stbiw__zlib_huffb(data[i]);
-         ++i;
+         if (bestloc) {
+            int d = (int) (data+i - bestloc); // distance back
+            STBIW_ASSERT(d <= 32767 && best <= 258);
+            for (j=0; best > lengthc[j+1]-1; ++j);
+            stbiw__zlib_huff(j+257);
+            if (lengtheb[j]) stbiw__zlib_add(best - lengthc[j], lengtheb[j]);
+            for (j=0; d > distc[j+1]-1; ++j);
+            stbiw__zlib_add(stbiw__zlib_bitrev(j,5),5);
+            if (disteb[j]) stbiw__zlib_add(d - distc[j], disteb[j]);
+            if (head && quality > 1) {
+               // keep the skipped positions findable at a small cost in speed
+               for (j=1; j < best && i+j < data_len-3; ++j)
+                  head[stbiw__zhash(data+i+j)&(stbiw__ZHASH-1)] = i+j;
+            }
+            i += best;
+         } else {
+            stbiw__zlib_huffb(data[i]);
+            ++i;
+         }
+         stbiw__zlib_drain();
       }
+      // write out final bytes
+      for (;i < data_len; ++i)
+         stbiw__zlib_huffb(data[i]);
+      stbiw__zlib_huff(256); // end of block
+      // pad with 0 bits to byte boundary
+      while (bitcount)
+         stbiw__zlib_add(0,1);
+
+      if (head)
+         STBIW_FREE(head);
+      else
+         for (i=0; i < stbiw__ZHASH; ++i)
+            (void) stbiw__sbfree(hash_table[i]);
    }
-   // write out final bytes
-   for (;i < data_len; ++i)
-      stbiw__zlib_huffb(data[i]);
-   stbiw__zlib_huff(256); // end of block
-   // pad with 0 bits to byte boundary
-   while (bitcount)
-      stbiw__zlib_add(0,1);
-
-   for (i=0; i < stbiw__ZHASH; ++i)
-      (void) stbiw__sbfree(hash_table[i]);
 
    {
       // compute adler32 on input
@@ -563,16 +660,26 @@ unsigned char * stbi_zlib_compress(unsigned char *data, int data_len, int *out_l
       stbiw__sbpush(out, (unsigned char) (s1 >> 8));
       stbiw__sbpush(out, (unsigned char) s1);
    }
+   if (sink) {
+      sink(sink_context, out, stbiw__sbn(out));
+      stbiw__sbn(out) = 0;
+   }
+   return out;
+}
+
+unsigned char * stbi_zlib_compress(unsigned char *data, int data_len, int *out_len, int quality)
+{
+   unsigned char *out = stbiw__zlib_compress_core(data, data_len, quality, NULL, NULL);
+   if (!out) return NULL;
    *out_len = stbiw__sbn(out);
    // make returned pointer freeable
    STBIW_MEMMOVE(stbiw__sbraw(out), out, *out_len);
    return (unsigned char *) stbiw__sbraw(out);
 }
 
-unsigned int stbiw__crc32(unsigned char *buffer, int len)
+static unsigned int stbiw__crc32_update(unsigned int crc, unsigned char *buffer, int len)
 {
    static unsigned int crc_table[256];
-   unsigned int crc = ~0u;
    int i,j;
    if (crc_table[1] == 0)
       for(i=0; i < 256; i++)
@@ -580,7 +687,12 @@ unsigned int stbiw__crc32(unsigned char *buffer, int len)
             crc_table[i] = (crc_table[i] >> 1) ^ (crc_table[i] & 1 ? 0xedb88320 : 0);
    for (i=0; i < len; ++i)
       crc = (crc >> 8) ^ crc_table[buffer[i] ^ (crc & 0xff)];
-   return ~crc;
+   return crc;
+}
+
+unsigned int stbiw__crc32(unsigned char *buffer, int len)
+{
+   return ~stbiw__crc32_update(~0u, buffer, len);
 }
 
 #define stbiw__wpng4(o,a,b,c,d) ((o)[0]=(unsigned char)(a),(o)[1]=(unsigned char)(b),(o)[2]=(unsigned char)(c),(o)[3]=(unsigned char)(d),(o)+=4)
@@ -601,61 +713,89 @@ static unsigned char stbiw__paeth(int a, int b, int c)
    return (unsigned char) c;
 }
 
+static void stbiw__encode_png_line(unsigned char *z, int stride_bytes, int x, int n, int type, signed char *line_buffer)
+{
+   int i;
+   for (i=0; i < n; ++i)
+      switch (type) {
+         case 0: line_buffer[i] = z[i]; break;
+         case 1: line_buffer[i] = z[i]; break;
+         case 2: line_buffer[i] = z[i] - z[i-stride_bytes]; break;
+         case 3: line_buffer[i] = z[i] - (z[i-stride_bytes]>>1); break;
+         case 4: line_buffer[i] = (signed char) (z[i] - stbiw__paeth(0,z[i-stride_bytes],0)); break;
+         case 5: line_buffer[i] = z[i]; break;
+         case 6: line_buffer[i] = z[i]; break;
+      }
+   for (i=n; i < x*n; ++i) {
+      switch (type) {
+         case 0: line_buffer[i] = z[i]; break;
+         case 1: line_buffer[i] = z[i] - z[i-n]; break;
+         case 2: line_buffer[i] = z[i] - z[i-stride_bytes]; break;
+         case 3: line_buffer[i] = z[i] - ((z[i-n] + z[i-stride_bytes])>>1); break;
+         case 4: line_buffer[i] = z[i] - stbiw__paeth(z[i-n], z[i-stride_bytes], z[i-stride_bytes-n]); break;
+         case 5: line_buffer[i] = z[i] - (z[i-n]>>1); break;
+         case 6: line_buffer[i] = z[i] - stbiw__paeth(z[i-n], 0,0); break;
+      }
+   }
+}
+
+// filters row j into out_row (filter byte followed by x*n bytes); the
+// output row doubles as scratch so rows can be filtered independently
+static void stbiw__filter_png_row(unsigned char *pixels, int stride_bytes, int x, int n, int j, int force_filter, unsigned char *out_row)
+{
+   static int mapping[] = { 0,1,2,3,4 };
+   static int firstmap[] = { 0,1,0,5,6 };
+   int *mymap = j ? mapping : firstmap;
+   unsigned char *z = pixels + stride_bytes*j;
+   signed char *line_buffer = (signed char *) out_row + 1;
+   int i,k, best = 0, bestval = 0x7fffffff;
+
+   if (force_filter >= 0 && force_filter < 5) {
+      best = force_filter;
+   } else {
+      for (k=0; k < 5; ++k) {
+         int est=0;
+         stbiw__encode_png_line(z, stride_bytes, x, n, mymap[k], line_buffer);
+         for (i=0; i < x*n; ++i)
+            est += abs((signed char) line_buffer[i]);
+         if (est < bestval) { bestval = est; best = k; }
+      }
+      if (best == 4) { out_row[0] = 4; return; } // line_buffer already holds it
+   }
+   stbiw__encode_png_line(z, stride_bytes, x, n, mymap[best], line_buffer);
+   out_row[0] = (unsigned char) best;
+}
+
+static unsigned char *stbiw__filter_png(unsigned char *pixels, int stride_bytes, int x, int y, int n)
+{
+   unsigned char *filt = (unsigned char *) STBIW_MALLOC((x*n+1) * y);
+   int j, force_filter = stbi_write_force_png_filter;
+   if (!filt) return 0;
+   // rows only read the source pixels, so they can be filtered in parallel
+#if defined(_OPENMP) && !defined(STBIW_NO_OPENMP)
+   #pragma omp parallel for schedule(static) if (y >= 64)
+#endif
+   for (j=0; j < y; ++j)
+      stbiw__filter_png_row(pixels, stride_bytes, x, n, j, force_filter, filt + j*(x*n+1));
+   return filt;
+}
+
+int stbi_write_png_compression_level = 8;
+int stbi_write_force_png_filter = -1;
+
 unsigned char *stbi_write_png_to_mem(unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len)
 {
    int ctype[5] = { -1, 0, 4, 2, 6 };
    unsigned char sig[8] = { 137,80,78,71,13,10,26,10 };
    unsigned char *out,*o, *filt, *zlib;
-   signed char *line_buffer;
-   int i,j,k,p,zlen;
+   int zlen;
 
    if (stride_bytes == 0)
       stride_bytes = x * n;
 
-   filt = (unsigned char *) STBIW_MALLOC((x*n+1) * y); if (!filt) return 0;
-   line_buffer = (signed char *) STBIW_MALLOC(x * n); if (!line_buffer) { STBIW_FREE(filt); return 0; }
-   for (j=0; j < y; ++j) {
-      static int mapping[] = { 0,1,2,3,4 };
-      static int firstmap[] = { 0,1,0,5,6 };
-      int *mymap = j ? mapping : firstmap;
-      int best = 0, bestval = 0x7fffffff;
-      for (p=0; p < 2; ++p) {
-         for (k= p?best:0; k < 5; ++k) {
-            int type = mymap[k],est=0;
-            unsigned char *z = pixels + stride_bytes*j;
-            for (i=0; i < n; ++i)
-               switch (type) {
-                  case 0: line_buffer[i] = z[i]; break;
-                  case 1: line_buffer[i] = z[i]; break;
-                  case 2: line_buffer[i] = z[i] - z[i-stride_bytes]; break;
-                  case 3: line_buffer[i] = z[i] - (z[i-stride_bytes]>>1); break;
-                  case 4: line_buffer[i] = (signed char) (z[i] - stbiw__paeth(0,z[i-stride_bytes],0)); break;
-                  case 5: line_buffer[i] = z[i]; break;
-                  case 6: line_buffer[i] = z[i]; break;
-               }
-            for (i=n; i < x*n; ++i) {
-               switch (type) {
-                  case 0: line_buffer[i] = z[i]; break;
-                  case 1: line_buffer[i] = z[i] - z[i-n]; break;
-                  case 2: line_buffer[i] = z[i] - z[i-stride_bytes]; break;
-                  case 3: line_buffer[i] = z[i] - ((z[i-n] + z[i-stride_bytes])>>1); break;
-                  case 4: line_buffer[i] = z[i] - stbiw__paeth(z[i-n], z[i-stride_bytes], z[i-stride_bytes-n]); break;
-                  case 5: line_buffer[i] = z[i] - (z[i-n]>>1); break;
-                  case 6: line_buffer[i] = z[i] - stbiw__paeth(z[i-n], 0,0); break;
-               }
-            }
-            if (p) break;
-            for (i=0; i < x*n; ++i)
-               est += abs((signed char) line_buffer[i]);
-            if (est < bestval) { bestval = est; best = k; }
-         }
-      }
-      // when we get here, best contains the filter type, and line_buffer contains the data
-      filt[j*(x*n+1)] = (unsigned char) best;
-      STBIW_MEMMOVE(filt+j*(x*n+1)+1, line_buffer, x*n);
-   }
-   STBIW_FREE(line_buffer);
-   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, 8); // increase 8 to get smaller but use more memory
+   filt = stbiw__filter_png(pixels, stride_bytes, x, y, n);
+   if (!filt) return 0;
+   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, stbi_write_png_compression_level);
    STBIW_FREE(filt);
    if (!zlib) return 0;
 
@@ -693,22 +833,90 @@ unsigned char *stbi_write_png_to_mem(unsigned char *pixels, int stride_bytes, in
    return out;
 }
 
+typedef struct
+{
+   stbi_write_func *func;
+   void *context;
+} stbiw__png_context;
+
+static void stbiw__png_write_chunk(stbiw__png_context *s, const char *tag, unsigned char *data, int len)
+{
+   unsigned char hdr[8], *o = hdr;
+   unsigned int crc;
+   stbiw__wp32(o, len);
+   stbiw__wptag(o, tag);
+   crc = stbiw__crc32_update(~0u, hdr+4, 4);
+   crc = ~stbiw__crc32_update(crc, data, len);
+   s->func(s->context, hdr, 8);
+   if (len) s->func(s->context, data, len);
+   o = hdr;
+   stbiw__wp32(o, crc);
+   s->func(s->context, hdr, 4);
+}
+
+static void stbiw__png_idat_sink(void *context, void *data, int size)
+{
+   if (size > 0)
+      stbiw__png_write_chunk((stbiw__png_context *) context, "IDAT", (unsigned char *) data, size);
+}
+
+int stbi_write_png_to_func(stbi_write_func *func, void *context, int x, int y, int n, const void *data, int stride_bytes)
+{
+   int ctype[5] = { -1, 0, 4, 2, 6 };
+   unsigned char sig[8] = { 137,80,78,71,13,10,26,10 };
+   unsigned char ihdr[13], *o = ihdr, *filt, *zlib;
+   stbiw__png_context s;
+
+   if (stride_bytes == 0)
+      stride_bytes = x * n;
+
+   filt = stbiw__filter_png((unsigned char *) data, stride_bytes, x, y, n);
+   if (!filt) return 0;
+
+   s.func = func;
+   s.context = context;
+   func(context, sig, 8);
+   stbiw__wp32(o, x);
+   stbiw__wp32(o, y);
+   *o++ = 8;
+   *o++ = (unsigned char) ctype[n];
+   *o++ = 0;
+   *o++ = 0;
+   *o++ = 0;
+   stbiw__png_write_chunk(&s, "IHDR", ihdr, 13);
+
+   // compressed data goes out as a sequence of IDAT chunks while deflating
+   zlib = stbiw__zlib_compress_core(filt, y*(x*n+1), stbi_write_png_compression_level, stbiw__png_idat_sink, &s);
+   STBIW_FREE(filt);
+   if (!zlib) return 0;
+   (void) stbiw__sbfree(zlib);
+
+   stbiw__png_write_chunk(&s, "IEND", NULL, 0);
+   return 1;
+}
+
+static void stbiw__stdio_write(void *context, void *data, int size)
+{
+   fwrite(data, 1, size, (FILE *) context);
+}
+
 int stbi_write_png(char const *filename, int x, int y, int comp, const void *data, int stride_bytes)
 {
    FILE *f;
-   int len;
-   unsigned char *png = stbi_write_png_to_mem((unsigned char *) data, stride_bytes, x, y, comp, &len);
-   if (!png) return 0;
+   int r;
    f = fopen(filename, "wb");
-   if (!f) { STBIW_FREE(png); return 0; }
-   fwrite(png, 1, len, f);
+   if (!f) return 0;
+   r = stbi_write_png_to_func(stbiw__stdio_write, f, x, y, comp, data, stride_bytes);
    fclose(f);
-   STBIW_FREE(png);
-   return 1;
+   return r;
 }
 #endif // STB_IMAGE_WRITE_IMPLEMENTATION
 
 /* Revision history
+      0.98a  (local)
+             PNG callback output with streamed IDAT chunks, compression
+             level and forced filter knobs, fast match finder, parallel
+             row filtering
       0.98 (2015-04-08)
              added STBIW_MALLOC, STBIW_ASSERT etc
       0.97 (2015-01-18)
@@ -0,0 +1,191 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/arena.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace google {
+namespace protobuf {
+
+const size_t Arena::kDefaultBlockSize;
+const size_t Arena::kMaxBlockSize;
+const size_t Arena::kAlignment;
+
+namespace {
+
+inline size_t AlignUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) & ~(alignment - 1);
+}
+
+// Number of cleanups the first chunk holds; later chunks double.
+const size_t kInitialCleanupCapacity = 8;
+
+}  // namespace
+
+Arena::Arena() {
+  Init(NULL, 0);
+}
+
+Arena::Arena(char* initial_block, size_t initial_block_size) {
+  Init(initial_block, initial_block_size);
+}
+
+Arena::~Arena() {
+  Reset();
+}
+
+void Arena::Init(char* initial_block, size_t initial_block_size) {
+  head_ = NULL;
+  cleanups_ = NULL;
+  next_block_size_ = kDefaultBlockSize;
+  space_allocated_ = 0;
+
+  if (initial_block == NULL) return;
+
+  // The caller's block may not be aligned; skip to the first aligned byte.
+  size_t skip = AlignUp(reinterpret_cast<uintptr_t>(initial_block),
+                        kAlignment) -
+                reinterpret_cast<uintptr_t>(initial_block);
+  size_t header = AlignUp(sizeof(Block), kAlignment);
+  if (initial_block_size < skip + header) return;
+
+  Block* block = reinterpret_cast<Block*>(initial_block + skip);
+  block->next = NULL;
+  block->pos = header;
+  block->size = initial_block_size - skip;
+  block->owned = false;
+  head_ = block;
+  space_allocated_ = initial_block_size;
+}
+
+void* Arena::AllocateFromNewBlock(size_t size) {
+  size_t header = AlignUp(sizeof(Block), kAlignment);
+  size_t block_size = next_block_size_;
+  if (block_size - header < size) {
+    // Too big for the usual block: give it a block of its own rather than
+    // letting it set the size of every later block.
+    block_size = header + size;
+  } else if (next_block_size_ < kMaxBlockSize) {
+    next_block_size_ *= 2;
+  }
+
+  Block* block = reinterpret_cast<Block*>(malloc(block_size));
+  GOOGLE_CHECK(block != NULL) << "Arena failed to allocate " << block_size
+                              << " bytes.";
+  block->next = head_;
+  block->pos = header + size;
+  block->size = block_size;
+  block->owned = true;
+  space_allocated_ += block_size;
+
+  // Keep allocating from whichever block has more room left, so a dedicated
+  // block for one large object does not strand the rest of the current one.
+  if (head_ != NULL && block->size - block->pos < head_->size - head_->pos) {
+    block->next = head_->next;
+    head_->next = block;
+  } else {
+    head_ = block;
+  }
+  return reinterpret_cast<char*>(block) + header;
+}
+
+void Arena::AddCleanup(void* object, void (*cleanup)(void*)) {
+  if (cleanups_ == NULL || cleanups_->len == cleanups_->capacity) {
+    size_t capacity = cleanups_ == NULL ? kInitialCleanupCapacity
+                                        : cleanups_->capacity * 2;
+    CleanupChunk* chunk = reinterpret_cast<CleanupChunk*>(AllocateAligned(
+        sizeof(CleanupChunk) + (capacity - 1) * sizeof(CleanupNode)));
+    chunk->next = cleanups_;
+    chunk->len = 0;
+    chunk->capacity = capacity;
+    cleanups_ = chunk;
+  }
+  CleanupNode* node = &cleanups_->nodes[cleanups_->len++];
+  node->object = object;
+  node->cleanup = cleanup;
+}
+
+void Arena::RunCleanups() {
+  // Newest first, so objects are destroyed in the reverse order of their
+  // registration, like members of a class.  The chunks themselves live in
+  // the arena's blocks and go away with them.
+  for (CleanupChunk* chunk = cleanups_; chunk != NULL; chunk = chunk->next) {
+    for (size_t i = chunk->len; i > 0; i--) {
+      chunk->nodes[i - 1].cleanup(chunk->nodes[i - 1].object);
+    }
+  }
+  cleanups_ = NULL;
+}
+
+uint64 Arena::Reset() {
+  RunCleanups();
+
+  uint64 space_allocated = space_allocated_;
+  Block* initial_block = NULL;
+  Block* block = head_;
+  while (block != NULL) {
+    Block* next = block->next;
+    if (block->owned) {
+      free(block);
+    } else {
+      initial_block = block;
+    }
+    block = next;
+  }
+
+  head_ = NULL;
+  next_block_size_ = kDefaultBlockSize;
+  space_allocated_ = 0;
+  if (initial_block != NULL) {
+    initial_block->next = NULL;
+    initial_block->pos = AlignUp(sizeof(Block), kAlignment);
+    head_ = initial_block;
+    space_allocated_ = initial_block->size;
+  }
+  return space_allocated;
+}
+
+uint64 Arena::SpaceAllocated() const {
+  return space_allocated_;
+}
+
+uint64 Arena::SpaceUsed() const {
+  size_t header = AlignUp(sizeof(Block), kAlignment);
+  uint64 used = 0;
+  for (const Block* block = head_; block != NULL; block = block->next) {
+    used += block->pos - header;
+  }
+  return used;
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,218 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Region allocation for lite messages.
+//
+// An Arena hands out memory from a few large blocks and releases all of it at
+// once, when it is destroyed or Reset().  A message created with
+// Arena::CreateMessage<T>() allocates its submessages, strings and repeated
+// field storage from the same arena, so parsing into it costs a handful of
+// block allocations instead of one per object, and tearing it down does not
+// walk the object graph:
+//
+//   google::protobuf::Arena arena;
+//   MyMessage* message =
+//       google::protobuf::Arena::CreateMessage<MyMessage>(&arena);
+//   message->ParseFromArray(data, size);
+//   ...
+//   // No delete; everything goes away with the arena.
+//
+// Only messages generated for optimize_for = LITE_RUNTIME files are
+// arena-aware.  Other types can still be created in an arena; they are
+// default-constructed there and their destructors run when it is cleared.
+//
+// An Arena is not thread-safe.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_H__
+#define GOOGLE_PROTOBUF_ARENA_H__
+
+#include <stddef.h>
+#include <new>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+namespace internal {
+
+// is_arena_constructable<T>::value is true for generated lite messages,
+// which declare InternalArenaConstructable_ and a constructor taking the
+// Arena to allocate their fields from.
+template <typename T>
+class is_arena_constructable {
+  typedef char yes;
+  typedef char (&no)[2];
+  template <typename U>
+  static yes Check(const typename U::InternalArenaConstructable_*);
+  template <typename U>
+  static no Check(...);
+ public:
+  static const bool value = sizeof(Check<T>(NULL)) == sizeof(yes);
+};
+
+}  // namespace internal
+
+class LIBPROTOBUF_EXPORT Arena {
+ public:
+  // Size of the first block the arena allocates for itself; later blocks
+  // double up to kMaxBlockSize.
+  static const size_t kDefaultBlockSize = 8 << 10;
+  static const size_t kMaxBlockSize = 1 << 20;
+
+  Arena();
+  // Serves allocations from "initial_block" until it is full.  The caller
+  // keeps ownership of it and must keep it alive as long as the arena.
+  Arena(char* initial_block, size_t initial_block_size);
+  ~Arena();
+
+  // Returns a new T owned by "arena", or a heap-allocated T if "arena" is
+  // NULL.  Generated lite messages are constructed to use the arena for
+  // everything they allocate; any other T is default-constructed in the
+  // arena and destroyed when the arena is cleared.
+  template <typename T>
+  static T* CreateMessage(Arena* arena) {
+    if (arena == NULL) return new T;
+    return arena->DoCreateMessage<T>(
+        Tag<internal::is_arena_constructable<T>::value>());
+  }
+
+  // Returns a new T() or T(arg) whose destructor runs when "arena" is
+  // cleared, or a heap-allocated one if "arena" is NULL.
+  template <typename T>
+  static T* Create(Arena* arena) {
+    if (arena == NULL) return new T;
+    T* object = new (arena->AllocateAligned(sizeof(T))) T;
+    arena->OwnDestructor(object);
+    return object;
+  }
+  template <typename T, typename Arg>
+  static T* Create(Arena* arena, const Arg& arg) {
+    if (arena == NULL) return new T(arg);
+    T* object = new (arena->AllocateAligned(sizeof(T))) T(arg);
+    arena->OwnDestructor(object);
+    return object;
+  }
+
+  // Returns "size" bytes aligned to 8.  The memory is never freed
+  // individually.
+  void* AllocateAligned(size_t size) {
+    size = (size + kAlignment - 1) & ~(kAlignment - 1);
+    if (GOOGLE_PREDICT_TRUE(head_ != NULL && head_->size - head_->pos >= size)) {
+      void* result = reinterpret_cast<char*>(head_) + head_->pos;
+      head_->pos += size;
+      return result;
+    }
+    return AllocateFromNewBlock(size);
+  }
+
+  // Deletes "object" when the arena is cleared.
+  template <typename T>
+  void Own(T* object) {
+    AddCleanup(object, &DeleteObject<T>);
+  }
+  // Runs ~T() on "object", which lives in arena memory, when the arena is
+  // cleared.
+  template <typename T>
+  void OwnDestructor(T* object) {
+    AddCleanup(object, &DestroyObject<T>);
+  }
+
+  // Runs all registered cleanups in reverse order and frees every block
+  // except the caller's initial block.  Returns the number of bytes that
+  // were allocated from the arena.
+  uint64 Reset();
+
+  // Bytes obtained from the system (plus the initial block), and bytes
+  // handed out to callers, so far.
+  uint64 SpaceAllocated() const;
+  uint64 SpaceUsed() const;
+
+ private:
+  static const size_t kAlignment = 8;
+
+  // Blocks and cleanup chunks start with their header; "pos" and "size" are
+  // offsets from the start of the block.
+  struct Block {
+    Block* next;
+    size_t pos;
+    size_t size;
+    bool owned;
+  };
+  struct CleanupNode {
+    void* object;
+    void (*cleanup)(void*);
+  };
+  struct CleanupChunk {
+    CleanupChunk* next;
+    size_t len;
+    size_t capacity;
+    CleanupNode nodes[1];
+  };
+
+  template <bool> struct Tag {};
+
+  template <typename T>
+  T* DoCreateMessage(Tag<true>) {
+    return new (AllocateAligned(sizeof(T))) T(this);
+  }
+  template <typename T>
+  T* DoCreateMessage(Tag<false>) {
+    T* object = new (AllocateAligned(sizeof(T))) T;
+    OwnDestructor(object);
+    return object;
+  }
+
+  template <typename T>
+  static void DeleteObject(void* object) {
+    delete reinterpret_cast<T*>(object);
+  }
+  template <typename T>
+  static void DestroyObject(void* object) {
+    reinterpret_cast<T*>(object)->~T();
+  }
+
+  void* AllocateFromNewBlock(size_t size);
+  void AddCleanup(void* object, void (*cleanup)(void*));
+  void RunCleanups();
+  void Init(char* initial_block, size_t initial_block_size);
+
+  Block* head_;              // block currently allocated from
+  CleanupChunk* cleanups_;   // most recent chunk first
+  size_t next_block_size_;
+  uint64 space_allocated_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Arena);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_ARENA_H__
@@ -125,9 +125,12 @@ TEST(BootstrapTest, GeneratedDescriptorMatches) {
     importer.Import("google/protobuf/descriptor.proto");
   const FileDescriptor* plugin_proto_file =
     importer.Import("google/protobuf/compiler/plugin.proto");
+  const FileDescriptor* cpp_options_proto_file =
+    importer.Import("google/protobuf/cpp_options.proto");
   EXPECT_EQ("", error_collector.text_);
   ASSERT_TRUE(proto_file != NULL);
   ASSERT_TRUE(plugin_proto_file != NULL);
+  ASSERT_TRUE(cpp_options_proto_file != NULL);
 
   CppGenerator generator;
   MockGeneratorContext context;
@@ -139,6 +142,9 @@ TEST(BootstrapTest, GeneratedDescriptorMatches) {
   parameter = "dllexport_decl=LIBPROTOC_EXPORT";
   ASSERT_TRUE(generator.Generate(plugin_proto_file, parameter,
                                  &context, &error));
+  parameter = "dllexport_decl=LIBPROTOBUF_EXPORT";
+  ASSERT_TRUE(generator.Generate(cpp_options_proto_file, parameter,
+                                 &context, &error));
 
   context.ExpectFileMatches("google/protobuf/descriptor.pb.h",
                             "google/protobuf/descriptor.pb.h");
@@ -148,6 +154,10 @@ TEST(BootstrapTest, GeneratedDescriptorMatches) {
                             "google/protobuf/compiler/plugin.pb.h");
   context.ExpectFileMatches("google/protobuf/compiler/plugin.pb.cc",
                             "google/protobuf/compiler/plugin.pb.cc");
+  context.ExpectFileMatches("google/protobuf/cpp_options.pb.h",
+                            "google/protobuf/cpp_options.pb.h");
+  context.ExpectFileMatches("google/protobuf/cpp_options.pb.cc",
+                            "google/protobuf/cpp_options.pb.cc");
 }
 
 }  // namespace
@@ -299,6 +299,31 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
   printer->Print("}\n");
 }
 
+void RepeatedEnumFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  if (descriptor_->options().packed()) {
+    printer->Print(variables_,
+      "if (this->$name$_size() > 0) {\n"
+      "  const int end = output->ByteCount();\n"
+      "  for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "    ::google::protobuf::internal::WireFormatLite::WriteEnumNoTag(\n"
+      "      this->$name$(i), output);\n"
+      "  }\n"
+      "  output->WriteVarint32(output->ByteCount() - end);\n"
+      "  ::google::protobuf::internal::WireFormatLite::WriteTag(\n"
+      "    $number$,\n"
+      "    ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,\n"
+      "    output);\n"
+      "}\n");
+  } else {
+    printer->Print(variables_,
+      "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "  ::google::protobuf::internal::WireFormatLite::WriteEnum(\n"
+      "    $number$, this->$name$(i), output);\n"
+      "}\n");
+  }
+}
+
 void RepeatedEnumFieldGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   if (descriptor_->options().packed()) {
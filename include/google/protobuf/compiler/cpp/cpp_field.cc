@@ -80,6 +80,11 @@ GenerateMergeFromCodedStreamWithPacking(io::Printer* printer) const {
 
 }
 
+void FieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  GenerateSerializeWithCachedSizes(printer);
+}
+
 FieldGeneratorMap::FieldGeneratorMap(const Descriptor* descriptor)
   : descriptor_(descriptor),
     field_generators_(
@@ -94,6 +99,9 @@ FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field) {
   if (field->is_repeated()) {
     switch (field->cpp_type()) {
       case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (IsFlatField(field)) {
+          return new RepeatedFlatMessageFieldGenerator(field);
+        }
         return new RepeatedMessageFieldGenerator(field);
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
@@ -112,6 +120,13 @@ FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field) {
         return new MessageFieldGenerator(field);
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            // Reflection reads string fields through their ::std::string*,
+            // which an aliased value bypasses, so this is lite-only.
+            if (!HasDescriptorMethods(field->file())) {
+              return new StringPieceFieldGenerator(field);
+            }
+            // Fall through.
           default:  // StringFieldGenerator handles unknown ctypes.
           case FieldOptions::STRING:
             return new StringFieldGenerator(field);
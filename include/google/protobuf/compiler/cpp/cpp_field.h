@@ -133,6 +133,15 @@ class FieldGenerator {
   virtual void GenerateSerializeWithCachedSizesToArray(
       io::Printer* printer) const = 0;
 
+  // Generate lines to prepend this field to the ReverseCodedOutputBuffer
+  // "output", which are placed within the message's SerializeReverse()
+  // method (lite only).  WireFormatLite's writers are overloaded for
+  // ReverseCodedOutputBuffer, so the default implementation reuses
+  // GenerateSerializeWithCachedSizes(); that only works for fields written
+  // with a single call, so repeated fields must override this to write
+  // their elements last to first.
+  virtual void GenerateSerializeReverse(io::Printer* printer) const;
+
   // Generate lines to compute the serialized size of this field, which
   // are placed in the message's ByteSize() method.
   virtual void GenerateByteSize(io::Printer* printer) const = 0;
@@ -135,6 +135,14 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
   if (HasDescriptorMethods(file_)) {
     printer->Print(
       "#include <google/protobuf/generated_message_reflection.h>\n");
+  } else {
+    // For the Fields::foo::kType of lite classes.
+    printer->Print(
+      "#include <google/protobuf/wire_format_lite.h>\n");
+    if (file_->options().GetExtension(cc_table_driven_parsing)) {
+      printer->Print(
+        "#include <google/protobuf/generated_message_table_driven.h>\n");
+    }
   }
 
   if (HasGenericServices(file_)) {
@@ -144,6 +152,7 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
 
 
   for (int i = 0; i < file_->dependency_count(); i++) {
+    if (!UsesDependency(file_, file_->dependency(i))) continue;
     printer->Print(
       "#include \"$dependency$.pb.h\"\n",
       "dependency", StripProto(file_->dependency(i)->name()));
@@ -188,6 +197,11 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
     enum_generators_[i]->GenerateDefinition(printer);
   }
 
+  // Generate the structs [flat = true] fields store.
+  for (int i = 0; i < file_->message_type_count(); i++) {
+    message_generators_[i]->GenerateFlatStructDefinitions(printer);
+  }
+
   printer->Print(kThickSeparator);
   printer->Print("\n");
 
@@ -511,6 +525,7 @@ void FileGenerator::GenerateBuildDescriptors(io::Printer* printer) {
   // sure they get added first.
   for (int i = 0; i < file_->dependency_count(); i++) {
     const FileDescriptor* dependency = file_->dependency(i);
+    if (!UsesDependency(file_, dependency)) continue;
     // Print the namespace prefix for the dependency.
     vector<string> dependency_package_parts;
     SplitStringUsing(dependency->package(), ".", &dependency_package_parts);
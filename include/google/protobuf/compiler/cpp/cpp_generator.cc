@@ -48,6 +48,55 @@ namespace protobuf {
 namespace compiler {
 namespace cpp {
 
+namespace {
+
+// DescriptorPool knows nothing about the options in cpp_options.proto, so the
+// fields which set them are checked here.
+bool ValidateFlatField(const FieldDescriptor* field, string* error) {
+  if (!field->options().GetExtension(flat)) return true;
+
+  if (!field->is_repeated() ||
+      field->type() != FieldDescriptor::TYPE_MESSAGE) {
+    *error = field->full_name() + ": [(google.protobuf.flat) = true] can "
+             "only be specified for repeated message fields.";
+    return false;
+  }
+  if (!IsFlattenable(field->message_type())) {
+    *error = field->full_name() + ": [(google.protobuf.flat) = true] "
+             "requires \"" + field->message_type()->full_name() + "\" to "
+             "have between 1 and 32 fields, all of them required float, "
+             "double, fixed32, fixed64, sfixed32 or sfixed64, and no nested "
+             "types or extension ranges.";
+    return false;
+  }
+  return true;
+}
+
+bool ValidateFlatFields(const Descriptor* descriptor, string* error) {
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    if (!ValidateFlatField(descriptor->field(i), error)) return false;
+  }
+  for (int i = 0; i < descriptor->extension_count(); i++) {
+    if (!ValidateFlatField(descriptor->extension(i), error)) return false;
+  }
+  for (int i = 0; i < descriptor->nested_type_count(); i++) {
+    if (!ValidateFlatFields(descriptor->nested_type(i), error)) return false;
+  }
+  return true;
+}
+
+bool ValidateFlatFields(const FileDescriptor* file, string* error) {
+  for (int i = 0; i < file->message_type_count(); i++) {
+    if (!ValidateFlatFields(file->message_type(i), error)) return false;
+  }
+  for (int i = 0; i < file->extension_count(); i++) {
+    if (!ValidateFlatField(file->extension(i), error)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 CppGenerator::CppGenerator() {}
 CppGenerator::~CppGenerator() {}
 
@@ -91,6 +140,7 @@ bool CppGenerator::Generate(const FileDescriptor* file,
 
   // -----------------------------------------------------------------
 
+  if (!ValidateFlatFields(file, error)) return false;
 
   string basename = StripProto(file->name());
   basename.append(".pb");
@@ -37,6 +37,8 @@
 #include <google/protobuf/stubs/hash.h>
 
 #include <google/protobuf/compiler/cpp/cpp_helpers.h>
+#include <google/protobuf/io/printer.h>
+#include <google/protobuf/wire_format.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
@@ -341,6 +343,128 @@ string EscapeTrigraphs(const string& to_escape) {
   return StringReplace(to_escape, "?", "\\?", true);
 }
 
+namespace {
+
+// Does this field, or the extension it declares, refer to a type declared in
+// "dependency"?
+bool FieldUsesFile(const FieldDescriptor* field,
+                   const FileDescriptor* dependency) {
+  if (field->is_extension() &&
+      field->containing_type()->file() == dependency) {
+    return true;
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return field->message_type()->file() == dependency;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return field->enum_type()->file() == dependency;
+    default:
+      return false;
+  }
+}
+
+bool MessageUsesFile(const Descriptor* descriptor,
+                     const FileDescriptor* dependency) {
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    if (FieldUsesFile(descriptor->field(i), dependency)) return true;
+  }
+  for (int i = 0; i < descriptor->extension_count(); i++) {
+    if (FieldUsesFile(descriptor->extension(i), dependency)) return true;
+  }
+  for (int i = 0; i < descriptor->nested_type_count(); i++) {
+    if (MessageUsesFile(descriptor->nested_type(i), dependency)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool UsesDependency(const FileDescriptor* file,
+                    const FileDescriptor* dependency) {
+  if (HasDescriptorMethods(file) || !HasDescriptorMethods(dependency)) {
+    return true;
+  }
+  for (int i = 0; i < file->message_type_count(); i++) {
+    if (MessageUsesFile(file->message_type(i), dependency)) return true;
+  }
+  for (int i = 0; i < file->extension_count(); i++) {
+    if (FieldUsesFile(file->extension(i), dependency)) return true;
+  }
+  for (int i = 0; i < file->service_count(); i++) {
+    const ServiceDescriptor* service = file->service(i);
+    for (int j = 0; j < service->method_count(); j++) {
+      if (service->method(j)->input_type()->file() == dependency ||
+          service->method(j)->output_type()->file() == dependency) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool IsFlattenable(const Descriptor* descriptor) {
+  if (descriptor->field_count() == 0 || descriptor->field_count() > 32 ||
+      descriptor->extension_range_count() > 0 ||
+      descriptor->nested_type_count() > 0 ||
+      descriptor->enum_type_count() > 0) {
+    return false;
+  }
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_required()) return false;
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_FLOAT:
+      case FieldDescriptor::TYPE_DOUBLE:
+      case FieldDescriptor::TYPE_FIXED32:
+      case FieldDescriptor::TYPE_FIXED64:
+      case FieldDescriptor::TYPE_SFIXED32:
+      case FieldDescriptor::TYPE_SFIXED64:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+int FixedByteSize(const Descriptor* descriptor) {
+  if (HasDescriptorMethods(descriptor->file())) return -1;
+  if (descriptor->field_count() == 0 || descriptor->field_count() > 32 ||
+      descriptor->extension_range_count() > 0) {
+    return -1;
+  }
+  int size = 0;
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_required()) return -1;
+    size += internal::WireFormat::TagSize(field->number(), field->type());
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_BOOL:
+        size += 1;
+        break;
+      case FieldDescriptor::TYPE_FLOAT:
+      case FieldDescriptor::TYPE_FIXED32:
+      case FieldDescriptor::TYPE_SFIXED32:
+        size += 4;
+        break;
+      case FieldDescriptor::TYPE_DOUBLE:
+      case FieldDescriptor::TYPE_FIXED64:
+      case FieldDescriptor::TYPE_SFIXED64:
+        size += 8;
+        break;
+      default:
+        return -1;
+    }
+  }
+  return size;
+}
+
+void PrintClassBodyDirective(io::Printer* printer, const char* directive) {
+  printer->Outdent();
+  printer->Print(directive);
+  printer->Indent();
+}
+
 }  // namespace cpp
 }  // namespace compiler
 }  // namespace protobuf
@@ -38,9 +38,14 @@
 #include <string>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/cpp_options.pb.h>
 
 namespace google {
 namespace protobuf {
+namespace io {
+  class Printer;                // printer.h
+}
+
 namespace compiler {
 namespace cpp {
 
@@ -131,6 +136,75 @@ inline bool HasDescriptorMethods(const FileDescriptor *file) {
   return file->options().optimize_for() != FileOptions::LITE_RUNTIME;
 }
 
+// Does the generated code for "file" need that of "dependency", one of its
+// imports?  It always does, except when a lite file imports a file with
+// descriptors only for the custom options declared there, like those of
+// cpp_options.proto: the lite code must not pull in the full runtime.
+bool UsesDependency(const FileDescriptor* file,
+                    const FileDescriptor* dependency);
+
+// Can message classes in this file allocate their fields from an Arena?
+// Only lite classes can; reflection assumes every field is heap-owned.
+inline bool HasArenaSupport(const FileDescriptor *file) {
+  return file->options().optimize_for() == FileOptions::LITE_RUNTIME;
+}
+
+// Does this message class override MessageLite::SerializeReverse()?  Only
+// lite classes do: the others keep unknown fields, which have no reverse
+// writer, and MessageSets are left to the default implementation.
+inline bool HasReverseSerialization(const Descriptor* descriptor) {
+  return descriptor->file()->options().optimize_for() ==
+             FileOptions::LITE_RUNTIME &&
+         !descriptor->options().message_set_wire_format();
+}
+
+// Can [flat = true], that is the custom option (google.protobuf.flat) from
+// cpp_options.proto, be set on fields of this message type?  It needs between
+// 1 and 32 fields, all of them required and fixed-width, and no nested types
+// or extension ranges.
+bool IsFlattenable(const Descriptor* descriptor);
+
+// Can instances of this message be stored as plain structs in [flat = true]
+// fields?  Only flattenable lite messages qualify.
+inline bool HasFlatLayout(const Descriptor* descriptor) {
+  return !HasDescriptorMethods(descriptor->file()) &&
+         IsFlattenable(descriptor);
+}
+
+// Returns the size of the encoding of this message, not counting its own tag
+// and length, if that is the same for every instance that has all its fields
+// set: a lite message whose fields are all required and either fixed-width
+// or bool.  Returns -1 for any other message.
+int FixedByteSize(const Descriptor* descriptor);
+
+// Is this repeated message field stored as an array of flat structs?
+inline bool IsFlatField(const FieldDescriptor* field) {
+  return field->options().GetExtension(flat) &&
+         !HasDescriptorMethods(field->file()) &&
+         HasFlatLayout(field->message_type());
+}
+
+// Does this message parse through a ParseTable (see
+// generated_message_table_driven.h) rather than a generated switch?  Only
+// lite files that set option (google.protobuf.cc_table_driven_parsing) from
+// cpp_options.proto do, and MessageSets keep their own parser.
+inline bool HasTableDrivenParsing(const Descriptor* descriptor) {
+  const FileDescriptor* file = descriptor->file();
+  return file->options().GetExtension(cc_table_driven_parsing) &&
+         !HasDescriptorMethods(file) &&
+         !descriptor->options().message_set_wire_format();
+}
+
+// Can a ParseTable entry parse this field?  Groups, [flat = true] fields and
+// aliased [ctype = STRING_PIECE] fields are left to generated code.
+inline bool IsTableDrivenField(const FieldDescriptor* field) {
+  return field->type() != FieldDescriptor::TYPE_GROUP &&
+         !IsFlatField(field) &&
+         (field->is_repeated() ||
+          field->options().ctype() != FieldOptions::STRING_PIECE ||
+          field->cpp_type() != FieldDescriptor::CPPTYPE_STRING);
+}
+
 // Should we generate generic services for this file?
 inline bool HasGenericServices(const FileDescriptor *file) {
   return file->service_count() > 0 &&
@@ -150,6 +224,10 @@ inline bool HasFastArraySerialization(const FileDescriptor* file) {
   return file->options().optimize_for() == FileOptions::SPEED;
 }
 
+// Prints "directive", a preprocessor line, at column 0 from inside a class
+// body, which the printer indents by one level.
+void PrintClassBodyDirective(io::Printer* printer, const char* directive);
+
 
 }  // namespace cpp
 }  // namespace compiler
@@ -95,6 +95,75 @@ const FieldDescriptor** SortFieldsByNumber(const Descriptor* descriptor) {
   return fields;
 }
 
+// Print the condition of an if() that is true when "tag" falls in one of the
+// message's extension ranges.
+void PrintExtensionRangeCondition(io::Printer* printer,
+                                  const Descriptor* descriptor) {
+  printer->Print(
+    "if (");
+  for (int i = 0; i < descriptor->extension_range_count(); i++) {
+    const Descriptor::ExtensionRange* range =
+      descriptor->extension_range(i);
+    if (i > 0) printer->Print(" ||\n    ");
+
+    uint32 start_tag = WireFormatLite::MakeTag(
+      range->start, static_cast<WireFormatLite::WireType>(0));
+    uint32 end_tag = WireFormatLite::MakeTag(
+      range->end, static_cast<WireFormatLite::WireType>(0));
+
+    if (range->end > FieldDescriptor::kMaxNumber) {
+      printer->Print(
+        "($start$u <= tag)",
+        "start", SimpleItoa(start_tag));
+    } else {
+      printer->Print(
+        "($start$u <= tag && tag < $end$u)",
+        "start", SimpleItoa(start_tag),
+        "end", SimpleItoa(end_tag));
+    }
+  }
+  printer->Print(") {\n");
+}
+
+// Does a table-driven message need a generated fallback for the tags its
+// ParseTable can't parse?
+bool HasParseFallback(const Descriptor* descriptor) {
+  if (descriptor->extension_range_count() > 0) return true;
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    if (!IsTableDrivenField(descriptor->field(i))) return true;
+  }
+  return false;
+}
+
+// The ParseTableField::flags of a table-driven field.
+string ParseTableFlags(const FieldDescriptor* field) {
+  if (!field->is_repeated()) return "0";
+  if (field->options().packed()) {
+    return "::google::protobuf::internal::kParseTableRepeated | "
+           "::google::protobuf::internal::kParseTablePacked";
+  }
+  return "::google::protobuf::internal::kParseTableRepeated";
+}
+
+// The ParseTableField::aux of a table-driven field.
+string ParseTableAux(const FieldDescriptor* field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+      if (field->is_repeated() || field->default_value_string().empty()) {
+        return "NULL";
+      }
+      return "&_default_" + FieldName(field) + "_";
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return "&::google::protobuf::internal::ParseTableEnumOf< " +
+             ClassName(field->enum_type(), true) + "_IsValid>::kAux";
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return "&::google::protobuf::internal::ParseTableMessageOf< " +
+             FieldMessageTypeName(field) + " >::kAux";
+    default:
+      return "NULL";
+  }
+}
+
 // Functor for sorting extension ranges by their "start" field number.
 struct ExtensionRangeSorter {
   bool operator()(const Descriptor::ExtensionRange* left,
@@ -129,7 +198,8 @@ static bool HasRequiredFields(
     if (field->is_required()) {
       return true;
     }
-    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        !IsFlatField(field)) {
       if (HasRequiredFields(field->message_type(), already_seen)) {
         return true;
       }
@@ -144,6 +214,171 @@ static bool HasRequiredFields(const Descriptor* type) {
   return HasRequiredFields(type, &already_seen);
 }
 
+// Returns the mask of the has-bits of all of a message's fields, which must
+// fit in _has_bits_[0].
+static string AllFieldsMask(const Descriptor* type) {
+  char buffer[kFastToBufferSize];
+  return FastHex32ToBuffer(
+      type->field_count() == 32 ?
+          0xFFFFFFFFu : (1u << type->field_count()) - 1,
+      buffer);
+}
+
+// Sets the variables GenerateFlatMethods() uses to read or write one field
+// of a flat message.
+static void SetFlatFieldVariables(const FieldDescriptor* field,
+                                  map<string, string>* variables) {
+  (*variables)["name"] = FieldName(field);
+  (*variables)["number"] = SimpleItoa(field->number());
+  (*variables)["tag"] = SimpleItoa(WireFormat::MakeTag(field));
+  (*variables)["type"] = PrimitiveTypeName(field->cpp_type());
+  (*variables)["declared_type"] = DeclaredTypeMethodName(field->type());
+  (*variables)["wire_format_field_type"] =
+      "::google::protobuf::internal::WireFormatLite::" +
+      FieldDescriptorProto_Type_Name(
+          static_cast<FieldDescriptorProto_Type>(field->type()));
+}
+
+// Can the in-order fast path of a lite parser read this field straight from
+// the buffer?  Singular scalars with one- or two-byte tags can; enums are
+// left out since their values need checking first.
+static bool IsInOrderField(const FieldDescriptor* field) {
+  if (HasDescriptorMethods(field->file()) || field->is_repeated() ||
+      WireFormat::MakeTag(field) >= (1 << 14)) {
+    return false;
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_ENUM:
+    case FieldDescriptor::CPPTYPE_STRING:
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Returns the most bytes the fast path may look at to read the value of
+// "field": ReadPrimitiveFromArray() wants a whole varint's worth of buffer
+// even when the value turns out shorter.
+static int InOrderValueByteSize(const FieldDescriptor* field) {
+  switch (WireFormat::WireTypeForField(field)) {
+    case WireFormatLite::WIRETYPE_FIXED32: return 4;
+    case WireFormatLite::WIRETYPE_FIXED64: return 8;
+    default: return io::CodedInputStream::kMaxVarintBytes;
+  }
+}
+
+// Prints the fast path for fields[begin..end], a run of consecutive
+// IsInOrderField() fields, for the top of fields[begin]'s case, after its
+// tag has been read.  If the run follows in order within the current limit,
+// it is read with one tag comparison per field and the parser moves on to
+// "next_field" (NULL if none).  Otherwise nothing is stored or consumed, and
+// the regular code takes over at fields[begin].
+//
+// The reads may look past the limit, as long as the buffer goes on; a run
+// that turns out to end beyond it is thrown away like a mismatch.  Without
+// that, a nested message's last fields would rarely leave enough room to
+// read varints from the array.
+static void PrintInOrderFastPath(io::Printer* printer,
+                                 const FieldDescriptor** fields,
+                                 int begin, int end,
+                                 const FieldDescriptor* next_field) {
+  int max_size = InOrderValueByteSize(fields[begin]);
+  for (int i = begin + 1; i <= end; i++) {
+    max_size += WireFormat::TagSize(fields[i]->number(), fields[i]->type()) +
+                InOrderValueByteSize(fields[i]);
+  }
+
+  printer->Print(
+    "{\n"
+    "  // Fast path: $first$ to $last$ in order.\n"
+    "  const void* data;\n"
+    "  int size;\n"
+    "  int readable;\n"
+    "  input->GetDirectBufferPointerInline(&data, &size, &readable);\n"
+    "  const ::google::protobuf::uint8* start =\n"
+    "      static_cast<const ::google::protobuf::uint8*>(data);\n"
+    "  const ::google::protobuf::uint8* ptr = start;\n",
+    "first", fields[begin]->name(),
+    "last", fields[end]->name());
+  for (int i = begin; i <= end; i++) {
+    map<string, string> vars;
+    SetFlatFieldVariables(fields[i], &vars);
+    printer->Print(vars, "  $type$ $name$_value;\n");
+  }
+  printer->Print(
+    "  if (readable >= $max_size$ &&\n",
+    "max_size", SimpleItoa(max_size));
+  printer->Indent();
+  printer->Indent();
+  printer->Indent();
+  for (int i = begin; i <= end; i++) {
+    map<string, string> vars;
+    SetFlatFieldVariables(fields[i], &vars);
+    if (i > begin) {
+      printer->Print(vars,
+        "(ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(\n"
+        "   ptr, $tag$)) != NULL &&\n");
+    }
+    printer->Print(vars,
+      "(ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<\n"
+      "     $type$, $wire_format_field_type$>(\n"
+      "   ptr, &$name$_value)) != NULL &&\n");
+  }
+  printer->Print("ptr - start <= size) {\n");
+  printer->Outdent();
+  for (int i = begin; i <= end; i++) {
+    printer->Print(
+      "$name$_ = $name$_value;\n"
+      "set_has_$name$();\n",
+      "name", FieldName(fields[i]));
+  }
+  printer->Print(
+    "DO_(input->Skip(ptr - start));\n");
+  if (next_field != NULL) {
+    printer->Print(
+      "if (input->ExpectTag($next_tag$)) goto parse_$next_name$;\n",
+      "next_tag", SimpleItoa(WireFormat::MakeTag(next_field)),
+      "next_name", next_field->name());
+  } else {
+    printer->Print(
+      "if (input->ExpectAtEnd()) return true;\n");
+  }
+  printer->Print("break;\n");
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(
+    "  }\n"
+    "}\n");
+}
+
+// Returns the type of the values a field's getter returns, and sets
+// "by_reference" if it returns them by const reference.
+string FieldValueType(const FieldDescriptor* field, bool* by_reference) {
+  *by_reference = false;
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return ClassName(field->enum_type(), true);
+    case FieldDescriptor::CPPTYPE_STRING:
+      // See FieldGeneratorMap::MakeGenerator().
+      if (!field->is_repeated() &&
+          field->options().ctype() == FieldOptions::STRING_PIECE &&
+          !HasDescriptorMethods(field->file())) {
+        return "::google::protobuf::StringPiece";
+      }
+      *by_reference = true;
+      return "::std::string";
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      *by_reference = true;
+      if (IsFlatField(field)) {
+        return FieldMessageTypeName(field) + "_Flat";
+      }
+      return FieldMessageTypeName(field);
+    default:
+      return PrimitiveTypeName(field->cpp_type());
+  }
+}
+
 // This returns an estimate of the compiler's alignment for the field.  This
 // can't guarantee to be correct because the generated code could be compiled on
 // different systems with different alignment rules.  The estimates below assume
@@ -320,6 +555,30 @@ GenerateForwardDeclaration(io::Printer* printer) {
   }
 }
 
+void MessageGenerator::
+GenerateFlatStructDefinitions(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->nested_type_count(); i++) {
+    nested_generators_[i]->GenerateFlatStructDefinitions(printer);
+  }
+
+  if (!HasFlatLayout(descriptor_)) return;
+
+  printer->Print(
+    "// $full_name$ as a plain struct, for [flat = true] fields.\n"
+    "struct $classname$_Flat {\n",
+    "full_name", descriptor_->full_name(),
+    "classname", classname_);
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = descriptor_->field(i);
+    printer->Print("  $type$ $name$;\n",
+                   "type", PrimitiveTypeName(field->cpp_type()),
+                   "name", FieldName(field));
+  }
+  printer->Print(
+    "};\n"
+    "\n");
+}
+
 void MessageGenerator::
 GenerateEnumDefinitions(io::Printer* printer) {
   for (int i = 0; i < descriptor_->nested_type_count(); i++) {
@@ -376,6 +635,80 @@ GenerateFieldAccessorDeclarations(io::Printer* printer) {
   }
 }
 
+void MessageGenerator::
+GenerateFieldVisitor(io::Printer* printer) {
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+
+  printer->Print(
+    "// fields ----------------------------------------------------------\n"
+    "\n"
+    "// One type per field, for templates that work on any message without\n"
+    "// reflection.  Size() is the number of values set, 0 or 1 for singular\n"
+    "// fields, and Get() returns the index-th one.\n"
+    "struct Fields {\n");
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = ordered_fields[i];
+    map<string, string> vars;
+    SetCommonFieldVariables(field, &vars);
+    vars["field_name"] = field->name();
+    vars["repeated"] = field->is_repeated() ? "true" : "false";
+    string type = DeclaredTypeMethodName(field->type());
+    UpperString(&type);
+    vars["type"] = "::google::protobuf::internal::WireFormatLite::TYPE_" + type;
+    bool by_reference;
+    vars["value_type"] = FieldValueType(field, &by_reference);
+    vars["get_type"] = by_reference ? "const Type&" : "Type";
+
+    printer->Print(vars,
+      "struct $name$ {\n"
+      "  typedef $classname$ Message;\n"
+      "  typedef $value_type$ Type;\n"
+      "  static const int kNumber = $number$;\n"
+      "  static const ::google::protobuf::internal::WireFormatLite::FieldType kType =\n"
+      "      $type$;\n"
+      "  static const bool kRepeated = $repeated$;\n"
+      "  static const char* Name() { return \"$field_name$\"; }\n");
+    if (field->is_repeated()) {
+      printer->Print(vars,
+        "  static int Size(const $classname$& message) {\n"
+        "    return message.$name$_size();\n"
+        "  }\n"
+        "  static $get_type$ Get(const $classname$& message, int index) {\n"
+        "    return message.$name$(index);\n"
+        "  }\n");
+    } else {
+      printer->Print(vars,
+        "  static int Size(const $classname$& message) {\n"
+        "    return message.has_$name$() ? 1 : 0;\n"
+        "  }\n"
+        "  static $get_type$ Get(const $classname$& message, int) {\n"
+        "    return message.$name$();\n"
+        "  }\n");
+    }
+    printer->Print("};\n");
+  }
+  printer->Outdent();
+  printer->Print(
+    "};\n"
+    "\n"
+    "// Calls (*visitor)(Fields::foo()) for each field foo, in order of number.\n"
+    "template <typename Visitor>\n"
+    "static void VisitFields(Visitor* visitor) {\n");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    printer->Print(
+      "  (*visitor)(Fields::$name$());\n",
+      "name", FieldName(ordered_fields[i]));
+  }
+  if (descriptor_->field_count() == 0) {
+    printer->Print("  (void) visitor;\n");
+  }
+  printer->Print(
+    "}\n"
+    "\n");
+}
+
 void MessageGenerator::
 GenerateFieldAccessorDefinitions(io::Printer* printer) {
   printer->Print("// $classname$\n\n", "classname", classname_);
@@ -470,6 +803,40 @@ GenerateClassDefinition(io::Printer* printer) {
     "}\n"
     "\n");
 
+  // Moves swap the fields over instead of copying them, which only works
+  // between messages on the same arena.
+  PrintClassBodyDirective(printer,
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n");
+  printer->Print(vars,
+    "$classname$($classname$&& from);\n"
+    "\n"
+    "inline $classname$& operator=($classname$&& from) {\n");
+  if (HasArenaSupport(descriptor_->file())) {
+    printer->Print(vars,
+      "  if (arena_ == from.arena_) {\n"
+      "    Swap(&from);\n"
+      "  } else {\n"
+      "    CopyFrom(from);\n"
+      "  }\n");
+  } else {
+    printer->Print(vars,
+      "  Swap(&from);\n");
+  }
+  printer->Print(vars,
+    "  return *this;\n"
+    "}\n");
+  PrintClassBodyDirective(printer, "#endif\n");
+  printer->Print("\n");
+
+  if (HasArenaSupport(descriptor_->file())) {
+    // Instances on an arena come from Arena::CreateMessage(), which looks for
+    // InternalArenaConstructable_ and calls the private constructor.
+    printer->Print(
+      "inline ::google::protobuf::Arena* GetArena() const { return arena_; }\n"
+      "typedef void InternalArenaConstructable_;\n"
+      "\n");
+  }
+
   if (HasUnknownFields(descriptor_->file())) {
     printer->Print(
       "inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {\n"
@@ -526,14 +893,60 @@ GenerateClassDefinition(io::Printer* printer) {
       printer->Print(
         "::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;\n");
     }
+    if (HasReverseSerialization(descriptor_)) {
+      printer->Print(
+        "void SerializeReverse(\n"
+        "    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;\n");
+    }
   }
 
+  if (FixedByteSize(descriptor_) >= 0) {
+    vars["byte_size"] = SimpleItoa(FixedByteSize(descriptor_));
+    vars["all_fields"] = AllFieldsMask(descriptor_);
+    printer->Print(vars,
+      "// Every field is required and fixed-width, so once they are all set\n"
+      "// the message takes kByteSize bytes, and ByteSize() has nothing to\n"
+      "// cache.\n"
+      "static const int kByteSize = $byte_size$;\n"
+      "int GetCachedSize() const {\n"
+      "  return (_has_bits_[0] & 0x$all_fields$u) == 0x$all_fields$u ?\n"
+      "      kByteSize : _cached_size_;\n"
+      "}\n"
+      "private:\n");
+  } else {
+    printer->Print(vars,
+      "int GetCachedSize() const { return _cached_size_; }\n"
+      "private:\n");
+  }
+  if (HasArenaSupport(descriptor_->file())) {
+    printer->Print(vars,
+      "explicit $classname$(::google::protobuf::Arena* arena);\n"
+      "friend class ::google::protobuf::Arena;\n");
+  }
   printer->Print(vars,
-    "int GetCachedSize() const { return _cached_size_; }\n"
-    "private:\n"
     "void SharedCtor();\n"
     "void SharedDtor();\n"
-    "void SetCachedSize(int size) const;\n"
+    "void SetCachedSize(int size) const;\n");
+  if (HasGeneratedMethods(descriptor_->file()) &&
+      HasTableDrivenParsing(descriptor_)) {
+    if (HasParseFallback(descriptor_)) {
+      printer->Print(
+        "bool MergeFieldFromCodedStream(\n"
+        "    ::google::protobuf::uint32 tag,\n"
+        "    ::google::protobuf::io::CodedInputStream* input);\n"
+        "static bool ParseFallback(\n"
+        "    ::google::protobuf::MessageLite* msg, ::google::protobuf::uint32 tag,\n"
+        "    ::google::protobuf::io::CodedInputStream* input);\n");
+    }
+    if (descriptor_->field_count() > 0) {
+      printer->Print(
+        "static const ::google::protobuf::internal::ParseTableField "
+            "_parse_table_fields_[];\n");
+    }
+    printer->Print(
+      "static const ::google::protobuf::internal::ParseTable _parse_table_;\n");
+  }
+  printer->Print(
     "public:\n"
     "\n");
 
@@ -563,6 +976,26 @@ GenerateClassDefinition(io::Printer* printer) {
     printer->Print("\n");
   }
 
+  if (HasFlatLayout(descriptor_)) {
+    vars["flat_byte_size"] = SimpleItoa(FixedByteSize(descriptor_));
+    printer->Print(vars,
+      "// flat layout -----------------------------------------------------\n"
+      "\n"
+      "// [flat = true] fields store this message as a Flat struct.  These\n"
+      "// read and write one element, tag and length included.\n"
+      "typedef $classname$_Flat Flat;\n"
+      "static const int kFlatByteSize = $flat_byte_size$;\n"
+      "static bool ReadFlat(\n"
+      "    ::google::protobuf::io::CodedInputStream* input, Flat* value);\n"
+      "static void WriteFlat(\n"
+      "    int field_number, const Flat& value,\n"
+      "    ::google::protobuf::io::CodedOutputStream* output);\n"
+      "static ::google::protobuf::uint8* WriteFlatToArray(\n"
+      "    int field_number, const Flat& value,\n"
+      "    ::google::protobuf::uint8* target);\n"
+      "\n");
+  }
+
   // Import all nested enums and their values into this class's scope with
   // typedefs and constants.
   for (int i = 0; i < descriptor_->enum_type_count(); i++) {
@@ -582,6 +1015,12 @@ GenerateClassDefinition(io::Printer* printer) {
     extension_generators_[i]->GenerateDeclaration(printer);
   }
 
+  // Lite classes have no reflection, so they describe their fields to
+  // templates instead.
+  if (!HasDescriptorMethods(descriptor_->file())) {
+    GenerateFieldVisitor(printer);
+  }
+
 
   printer->Print(
     "// @@protoc_insertion_point(class_scope:$full_name$)\n",
@@ -612,6 +1051,12 @@ GenerateClassDefinition(io::Printer* printer) {
 
   // Members assumed to align to 8 bytes:
 
+  if (HasArenaSupport(descriptor_->file())) {
+    printer->Print(
+      "::google::protobuf::Arena* arena_;\n"
+      "\n");
+  }
+
   if (descriptor_->extension_range_count() > 0) {
     printer->Print(
       "::google::protobuf::internal::ExtensionSet _extensions_;\n"
@@ -861,6 +1306,27 @@ GenerateClassMethods(io::Printer* printer) {
       "classname", ClassName(FieldScope(field), false),
       "constant_name", FieldConstantName(field));
   }
+  if (FixedByteSize(descriptor_) >= 0) {
+    printer->Print(
+      "const int $classname$::kByteSize;\n",
+      "classname", classname_);
+  }
+  if (HasFlatLayout(descriptor_)) {
+    printer->Print(
+      "const int $classname$::kFlatByteSize;\n",
+      "classname", classname_);
+  }
+  if (!HasDescriptorMethods(descriptor_->file())) {
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      printer->Print(
+        "const int $classname$::Fields::$name$::kNumber;\n"
+        "const ::google::protobuf::internal::WireFormatLite::FieldType\n"
+        "    $classname$::Fields::$name$::kType;\n"
+        "const bool $classname$::Fields::$name$::kRepeated;\n",
+        "classname", classname_,
+        "name", FieldName(descriptor_->field(i)));
+    }
+  }
   printer->Print(
     "#endif  // !_MSC_VER\n"
     "\n");
@@ -888,6 +1354,11 @@ GenerateClassMethods(io::Printer* printer) {
       printer->Print("\n");
     }
 
+    if (HasReverseSerialization(descriptor_)) {
+      GenerateSerializeReverse(printer);
+      printer->Print("\n");
+    }
+
     GenerateByteSize(printer);
     printer->Print("\n");
 
@@ -899,6 +1370,11 @@ GenerateClassMethods(io::Printer* printer) {
 
     GenerateIsInitialized(printer);
     printer->Print("\n");
+
+    if (HasFlatLayout(descriptor_)) {
+      GenerateFlatMethods(printer);
+      printer->Print("\n");
+    }
   }
 
   GenerateSwap(printer);
@@ -969,6 +1445,42 @@ GenerateSharedConstructorCode(io::Printer* printer) {
   printer->Print("}\n\n");
 }
 
+void MessageGenerator::
+GenerateArenaConstructor(io::Printer* printer) {
+  printer->Print(
+    "\n"
+    "$classname$::$classname$(::google::protobuf::Arena* arena)\n"
+    "  : $superclass$(),\n"
+    "    arena_(arena)",
+    "classname", classname_,
+    "superclass", SuperClassName(descriptor_));
+
+  // Repeated fields take the arena in their constructors.  List them in
+  // declaration order, which GenerateClassDefinition() gets from
+  // OptimizePadding().
+  vector<const FieldDescriptor*> fields;
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    fields.push_back(descriptor_->field(i));
+  }
+  OptimizePadding(&fields);
+  for (int i = 0; i < fields.size(); i++) {
+    if (fields[i]->is_repeated()) {
+      printer->Print(",\n"
+                     "    $name$_(arena)",
+                     "name", FieldName(fields[i]));
+    }
+  }
+
+  printer->Print(" {\n"
+                 "  SharedCtor();\n");
+  if (descriptor_->extension_range_count() > 0) {
+    // Arena messages are never destroyed, but their extensions live on the
+    // heap.
+    printer->Print("  arena->OwnDestructor(&_extensions_);\n");
+  }
+  printer->Print("}\n");
+}
+
 void MessageGenerator::
 GenerateSharedDestructorCode(io::Printer* printer) {
   printer->Print(
@@ -1009,14 +1521,24 @@ void MessageGenerator::
 GenerateStructors(io::Printer* printer) {
   string superclass = SuperClassName(descriptor_);
 
+  // Lite classes record the arena their fields are allocated from; the
+  // default and copy constructors use the heap.
+  string heap_initializer =
+      HasArenaSupport(descriptor_->file()) ? ",\n    arena_(NULL)" : "";
+
   // Generate the default constructor.
   printer->Print(
     "$classname$::$classname$()\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$()$heap_initializer$ {\n"
     "  SharedCtor();\n"
     "}\n",
     "classname", classname_,
-    "superclass", superclass);
+    "superclass", superclass,
+    "heap_initializer", heap_initializer);
+
+  if (HasArenaSupport(descriptor_->file())) {
+    GenerateArenaConstructor(printer);
+  }
 
   printer->Print(
     "\n"
@@ -1047,13 +1569,40 @@ GenerateStructors(io::Printer* printer) {
   // Generate the copy constructor.
   printer->Print(
     "$classname$::$classname$(const $classname$& from)\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$()$heap_initializer$ {\n"
     "  SharedCtor();\n"
     "  MergeFrom(from);\n"
     "}\n"
     "\n",
     "classname", classname_,
-    "superclass", superclass);
+    "superclass", superclass,
+    "heap_initializer", heap_initializer);
+
+  // Generate the move constructor.  The new message is on the heap, so it
+  // can only take the fields of another heap message.
+  printer->Print(
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n"
+    "$classname$::$classname$($classname$&& from)\n"
+    "  : $superclass$()$heap_initializer$ {\n"
+    "  SharedCtor();\n",
+    "classname", classname_,
+    "superclass", superclass,
+    "heap_initializer", heap_initializer);
+  if (HasArenaSupport(descriptor_->file())) {
+    printer->Print(
+      "  if (from.arena_ == NULL) {\n"
+      "    Swap(&from);\n"
+      "  } else {\n"
+      "    MergeFrom(from);\n"
+      "  }\n");
+  } else {
+    printer->Print(
+      "  Swap(&from);\n");
+  }
+  printer->Print(
+    "}\n"
+    "#endif\n"
+    "\n");
 
   // Generate the shared constructor code.
   GenerateSharedConstructorCode(printer);
@@ -1202,6 +1751,19 @@ GenerateSwap(io::Printer* printer) {
   printer->Print("if (other != this) {\n");
   printer->Indent();
 
+  if (HasArenaSupport(descriptor_->file())) {
+    // Fields can't move between arenas, so swap by value instead.
+    printer->Print(
+      "if (arena_ != other->arena_) {\n"
+      "  $classname$ temp;\n"
+      "  temp.MergeFrom(*other);\n"
+      "  other->CopyFrom(*this);\n"
+      "  CopyFrom(temp);\n"
+      "  return;\n"
+      "}\n",
+      "classname", classname_);
+  }
+
   if (HasGeneratedMethods(descriptor_->file())) {
     for (int i = 0; i < descriptor_->field_count(); i++) {
       const FieldDescriptor* field = descriptor_->field(i);
@@ -1385,6 +1947,11 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
     return;
   }
 
+  if (HasTableDrivenParsing(descriptor_)) {
+    GenerateTableDrivenMergeFromCodedStream(printer);
+    return;
+  }
+
   printer->Print(
     "bool $classname$::MergePartialFromCodedStream(\n"
     "    ::google::protobuf::io::CodedInputStream* input) {\n"
@@ -1437,6 +2004,19 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
       }
 
       printer->Indent();
+      if (IsInOrderField(field) &&
+          (i == 0 || !IsInOrderField(ordered_fields[i - 1]))) {
+        int end = i;
+        while (end + 1 < descriptor_->field_count() &&
+               IsInOrderField(ordered_fields[end + 1])) {
+          end++;
+        }
+        if (end > i) {
+          PrintInOrderFastPath(printer, ordered_fields.get(), i, end,
+              end + 1 < descriptor_->field_count() ?
+                  ordered_fields[end + 1] : NULL);
+        }
+      }
       if (field->options().packed()) {
         field_generator.GenerateMergeFromCodedStreamWithPacking(printer);
       } else {
@@ -1516,30 +2096,7 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
 
   // Handle extension ranges.
   if (descriptor_->extension_range_count() > 0) {
-    printer->Print(
-      "if (");
-    for (int i = 0; i < descriptor_->extension_range_count(); i++) {
-      const Descriptor::ExtensionRange* range =
-        descriptor_->extension_range(i);
-      if (i > 0) printer->Print(" ||\n    ");
-
-      uint32 start_tag = WireFormatLite::MakeTag(
-        range->start, static_cast<WireFormatLite::WireType>(0));
-      uint32 end_tag = WireFormatLite::MakeTag(
-        range->end, static_cast<WireFormatLite::WireType>(0));
-
-      if (range->end > FieldDescriptor::kMaxNumber) {
-        printer->Print(
-          "($start$u <= tag)",
-          "start", SimpleItoa(start_tag));
-      } else {
-        printer->Print(
-          "($start$u <= tag && tag < $end$u)",
-          "start", SimpleItoa(start_tag),
-          "end", SimpleItoa(end_tag));
-      }
-    }
-    printer->Print(") {\n");
+    PrintExtensionRangeCondition(printer, descriptor_);
     if (HasUnknownFields(descriptor_->file())) {
       printer->Print(
         "  DO_(_extensions_.ParseField(tag, input, default_instance_,\n"
@@ -1580,6 +2137,151 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
     "}\n");
 }
 
+void MessageGenerator::
+GenerateTableDrivenMergeFromCodedStream(io::Printer* printer) {
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+  if (descriptor_->field_count() > 0) {
+    printer->Print(
+      "const ::google::protobuf::internal::ParseTableField\n"
+      "    $classname$::_parse_table_fields_[] = {\n",
+      "classname", classname_);
+    printer->Indent();
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = ordered_fields[i];
+      map<string, string> vars;
+      vars["tag"] = SimpleItoa(WireFormat::MakeTag(field));
+      vars["classname"] = classname_;
+      vars["name"] = FieldName(field);
+      vars["has_bit"] =
+          field->is_repeated() ? "-1" : SimpleItoa(field->index());
+      if (IsTableDrivenField(field)) {
+        string type = DeclaredTypeMethodName(field->type());
+        UpperString(&type);
+        vars["type"] =
+            "::google::protobuf::internal::WireFormatLite::TYPE_" + type;
+        vars["aux"] = ParseTableAux(field);
+      } else {
+        vars["type"] = "::google::protobuf::internal::kParseTableFallback";
+        vars["aux"] = "NULL";
+      }
+      vars["field_name"] =
+          field->cpp_type() == FieldDescriptor::CPPTYPE_STRING
+              ? "\"" + field->full_name() + "\"" : "NULL";
+      vars["flags"] = ParseTableFlags(field);
+      PrintFieldComment(printer, field);
+      printer->Print(vars,
+        "{ $tag$u, GOOGLE_PROTOBUF_PARSE_TABLE_OFFSET($classname$, $name$_), $has_bit$,\n"
+        "  $type$, $flags$,\n"
+        "  $aux$, $field_name$ },\n");
+    }
+    printer->Outdent();
+    printer->Print("};\n\n");
+  }
+
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["fields"] =
+      descriptor_->field_count() > 0 ? "_parse_table_fields_" : "NULL";
+  vars["field_count"] = SimpleItoa(descriptor_->field_count());
+  vars["fallback"] = HasParseFallback(descriptor_) ? "&ParseFallback" : "NULL";
+  printer->Print(vars,
+    "const ::google::protobuf::internal::ParseTable $classname$::_parse_table_ = {\n"
+    "  $fields$, $field_count$,\n"
+    "  GOOGLE_PROTOBUF_PARSE_TABLE_OFFSET($classname$, _has_bits_),\n"
+    "  GOOGLE_PROTOBUF_PARSE_TABLE_OFFSET($classname$, arena_),\n"
+    "  $fallback$\n"
+    "};\n"
+    "\n"
+    "bool $classname$::MergePartialFromCodedStream(\n"
+    "    ::google::protobuf::io::CodedInputStream* input) {\n"
+    "  return ::google::protobuf::internal::TableDrivenParser::\n"
+    "      MergePartialFromCodedStream(this, _parse_table_, input);\n"
+    "}\n");
+
+  if (!HasParseFallback(descriptor_)) return;
+
+  // The fallback parses the kParseTableFallback fields the way the switch in
+  // GenerateMergeFromCodedStream() does, and extensions and unknown tags.
+  printer->Print(
+    "\n"
+    "bool $classname$::ParseFallback(\n"
+    "    ::google::protobuf::MessageLite* msg, ::google::protobuf::uint32 tag,\n"
+    "    ::google::protobuf::io::CodedInputStream* input) {\n"
+    "  return static_cast<$classname$*>(msg)->MergeFieldFromCodedStream(\n"
+    "      tag, input);\n"
+    "}\n"
+    "\n"
+    "bool $classname$::MergeFieldFromCodedStream(\n"
+    "    ::google::protobuf::uint32 tag,\n"
+    "    ::google::protobuf::io::CodedInputStream* input) {\n"
+    "#define DO_(EXPRESSION) if (!(EXPRESSION)) return false\n",
+    "classname", classname_);
+  printer->Indent();
+
+  bool has_fallback_fields = false;
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (!IsTableDrivenField(descriptor_->field(i))) has_fallback_fields = true;
+  }
+
+  if (has_fallback_fields) {
+    printer->Print(
+      "switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {\n");
+    printer->Indent();
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = ordered_fields[i];
+      if (IsTableDrivenField(field)) continue;
+
+      PrintFieldComment(printer, field);
+      printer->Print(
+        "case $number$: {\n"
+        "  if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==\n"
+        "      ::google::protobuf::internal::WireFormatLite::WIRETYPE_$wiretype$) {\n",
+        "number", SimpleItoa(field->number()),
+        "wiretype", kWireTypeNames[WireFormat::WireTypeForField(field)]);
+      if (field->is_repeated()) {
+        printer->Print(
+          "   parse_$name$:\n",
+          "name", field->name());
+      }
+      printer->Indent();
+      printer->Indent();
+      field_generators_.get(field).GenerateMergeFromCodedStream(printer);
+      if (field->is_repeated()) {
+        // Elements of a repeated field usually come together; read them all
+        // rather than returning to the table for each one.
+        printer->Print(
+          "if (input->ExpectTag($tag$)) goto parse_$name$;\n",
+          "tag", SimpleItoa(WireFormat::MakeTag(field)),
+          "name", field->name());
+      }
+      printer->Print("return true;\n");
+      printer->Outdent();
+      printer->Outdent();
+      printer->Print(
+        "  }\n"
+        "  break;\n"
+        "}\n"
+        "\n");
+    }
+    printer->Outdent();
+    printer->Print("}\n");
+  }
+
+  if (descriptor_->extension_range_count() > 0) {
+    PrintExtensionRangeCondition(printer, descriptor_);
+    printer->Print(
+      "  return _extensions_.ParseField(tag, input, default_instance_);\n"
+      "}\n");
+  }
+
+  printer->Outdent();
+  printer->Print(
+    "  return ::google::protobuf::internal::WireFormatLite::SkipField(input, tag);\n"
+    "#undef DO_\n"
+    "}\n");
+}
+
 void MessageGenerator::GenerateSerializeOneField(
     io::Printer* printer, const FieldDescriptor* field, bool to_array) {
   PrintFieldComment(printer, field);
@@ -1744,6 +2446,78 @@ GenerateSerializeWithCachedSizesBody(io::Printer* printer, bool to_array) {
   }
 }
 
+void MessageGenerator::GenerateSerializeReverseOneField(
+    io::Printer* printer, const FieldDescriptor* field) {
+  PrintFieldComment(printer, field);
+
+  if (!field->is_repeated()) {
+    printer->Print(
+      "if (has_$name$()) {\n",
+      "name", FieldName(field));
+    printer->Indent();
+  }
+
+  field_generators_.get(field).GenerateSerializeReverse(printer);
+
+  if (!field->is_repeated()) {
+    printer->Outdent();
+    printer->Print("}\n");
+  }
+  printer->Print("\n");
+}
+
+void MessageGenerator::GenerateSerializeReverseOneExtensionRange(
+    io::Printer* printer, const Descriptor::ExtensionRange* range) {
+  map<string, string> vars;
+  vars["start"] = SimpleItoa(range->start);
+  vars["end"] = SimpleItoa(range->end);
+  printer->Print(vars,
+    "// Extension range [$start$, $end$)\n"
+    "_extensions_.SerializeReverse($start$, $end$, output);\n\n");
+}
+
+void MessageGenerator::
+GenerateSerializeReverse(io::Printer* printer) {
+  printer->Print(
+    "void $classname$::SerializeReverse(\n"
+    "    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {\n",
+    "classname", classname_);
+  printer->Indent();
+
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+
+  vector<const Descriptor::ExtensionRange*> sorted_extensions;
+  for (int i = 0; i < descriptor_->extension_range_count(); ++i) {
+    sorted_extensions.push_back(descriptor_->extension_range(i));
+  }
+  sort(sorted_extensions.begin(), sorted_extensions.end(),
+       ExtensionRangeSorter());
+
+  // The same merge as GenerateSerializeWithCachedSizesBody(), from the end,
+  // so the output comes out in field number order.
+  int i = descriptor_->field_count();
+  int j = sorted_extensions.size();
+  while (i > 0 || j > 0) {
+    if (i == 0) {
+      GenerateSerializeReverseOneExtensionRange(printer,
+                                                sorted_extensions[--j]);
+    } else if (j == 0) {
+      GenerateSerializeReverseOneField(printer, ordered_fields[--i]);
+    } else if (ordered_fields[i - 1]->number() >=
+               sorted_extensions[j - 1]->start) {
+      GenerateSerializeReverseOneField(printer, ordered_fields[--i]);
+    } else {
+      GenerateSerializeReverseOneExtensionRange(printer,
+                                                sorted_extensions[--j]);
+    }
+  }
+
+  printer->Outdent();
+  printer->Print(
+    "}\n");
+}
+
 void MessageGenerator::
 GenerateByteSize(io::Printer* printer) {
   if (descriptor_->options().message_set_wire_format()) {
@@ -1770,6 +2544,13 @@ GenerateByteSize(io::Printer* printer) {
     "int $classname$::ByteSize() const {\n",
     "classname", classname_);
   printer->Indent();
+  if (FixedByteSize(descriptor_) >= 0) {
+    printer->Print(
+      "if ((_has_bits_[0] & 0x$all_fields$u) == 0x$all_fields$u) {\n"
+      "  return kByteSize;\n"
+      "}\n",
+      "all_fields", AllFieldsMask(descriptor_));
+  }
   printer->Print(
     "int total_size = 0;\n"
     "\n");
@@ -1861,6 +2642,155 @@ GenerateByteSize(io::Printer* printer) {
   printer->Print("}\n");
 }
 
+void MessageGenerator::
+GenerateFlatMethods(io::Printer* printer) {
+  map<string, string> vars;
+  vars["classname"] = classname_;
+
+  printer->Print(vars,
+    "bool $classname$::ReadFlat(\n"
+    "    ::google::protobuf::io::CodedInputStream* input, Flat* value) {\n"
+    "#define DO_(EXPRESSION) if (!(EXPRESSION)) return false\n"
+    "  ::google::protobuf::uint32 length;\n"
+    "  DO_(input->ReadVarint32(&length));\n"
+    "\n"
+    "  // Fast path: every field once, in order, entirely in the buffer.\n"
+    "  const void* data;\n"
+    "  int size;\n"
+    "  input->GetDirectBufferPointerInline(&data, &size);\n"
+    "  if (length == kFlatByteSize && size >= kFlatByteSize) {\n"
+    "    const ::google::protobuf::uint8* ptr =\n"
+    "        static_cast<const ::google::protobuf::uint8*>(data);\n");
+  printer->Indent();
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    map<string, string> field_vars;
+    SetFlatFieldVariables(descriptor_->field(i), &field_vars);
+    printer->Print(field_vars,
+      "if ((ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(\n"
+      "         ptr, $tag$)) != NULL) {\n"
+      "  ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<\n"
+      "      $type$, $wire_format_field_type$>(ptr, &value->$name$);\n");
+    printer->Indent();
+  }
+  printer->Print("return input->Skip(kFlatByteSize);\n");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    printer->Outdent();
+    printer->Print("}\n");
+  }
+  printer->Outdent();
+  printer->Print("}\n");
+  printer->Outdent();
+
+  printer->Print(
+    "\n"
+    "  // Anything else: any order, repeated, missing or unknown fields, or\n"
+    "  // split across buffers.  A struct has no has-bits, so missing fields\n"
+    "  // read as their defaults.\n");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = descriptor_->field(i);
+    printer->Print("  value->$name$ = $default$;\n",
+                   "name", FieldName(field),
+                   "default", DefaultValue(field));
+  }
+  printer->Print(
+    "  ::google::protobuf::io::CodedInputStream::Limit limit =\n"
+    "      input->PushLimit(length);\n"
+    "  ::google::protobuf::uint32 tag;\n"
+    "  while ((tag = input->ReadTag()) != 0) {\n"
+    "    switch (tag) {\n");
+  printer->Indent();
+  printer->Indent();
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    map<string, string> field_vars;
+    SetFlatFieldVariables(descriptor_->field(i), &field_vars);
+    printer->Print(field_vars,
+      "case $tag$:\n"
+      "  DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<\n"
+      "          $type$, $wire_format_field_type$>(\n"
+      "        input, &value->$name$)));\n"
+      "  break;\n");
+  }
+  printer->Print(
+    "default:\n"
+    "  if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==\n"
+    "      ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {\n"
+    "    return false;\n"
+    "  }\n"
+    "  DO_(::google::protobuf::internal::WireFormatLite::SkipField(input, tag));\n"
+    "  break;\n");
+  printer->Outdent();
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(vars,
+    "    }\n"
+    "  }\n"
+    "  DO_(input->ConsumedEntireMessage());\n"
+    "  input->PopLimit(limit);\n"
+    "  return true;\n"
+    "#undef DO_\n"
+    "}\n"
+    "\n");
+
+  printer->Print(vars,
+    "void $classname$::WriteFlat(\n"
+    "    int field_number, const Flat& value,\n"
+    "    ::google::protobuf::io::CodedOutputStream* output) {\n"
+    "  ::google::protobuf::internal::WireFormatLite::WriteTag(field_number,\n"
+    "      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,\n"
+    "      output);\n"
+    "  output->WriteVarint32(kFlatByteSize);\n"
+    "  ::google::protobuf::uint8* target =\n"
+    "      output->GetDirectBufferForNBytesAndAdvance(kFlatByteSize);\n"
+    "  if (target != NULL) {\n");
+  printer->Indent();
+  printer->Indent();
+  GenerateFlatFieldsToArray(printer);
+  printer->Outdent();
+  printer->Print("  return;\n"
+                 "}\n");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    map<string, string> field_vars;
+    SetFlatFieldVariables(descriptor_->field(i), &field_vars);
+    printer->Print(field_vars,
+      "::google::protobuf::internal::WireFormatLite::Write$declared_type$(\n"
+      "  $number$, value.$name$, output);\n");
+  }
+  printer->Outdent();
+  printer->Print(
+    "}\n"
+    "\n");
+
+  printer->Print(vars,
+    "::google::protobuf::uint8* $classname$::WriteFlatToArray(\n"
+    "    int field_number, const Flat& value,\n"
+    "    ::google::protobuf::uint8* target) {\n"
+    "  target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(\n"
+    "      field_number,\n"
+    "      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,\n"
+    "      target);\n"
+    "  target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(\n"
+    "      kFlatByteSize, target);\n");
+  printer->Indent();
+  GenerateFlatFieldsToArray(printer);
+  printer->Outdent();
+  printer->Print(
+    "  return target;\n"
+    "}\n");
+}
+
+void MessageGenerator::
+GenerateFlatFieldsToArray(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    map<string, string> field_vars;
+    SetFlatFieldVariables(descriptor_->field(i), &field_vars);
+    printer->Print(field_vars,
+      "target = ::google::protobuf::internal::WireFormatLite::\n"
+      "  Write$declared_type$ToArray($number$, value.$name$, target);\n");
+  }
+}
+
 void MessageGenerator::
 GenerateIsInitialized(io::Printer* printer) {
   printer->Print(
@@ -1897,6 +2827,7 @@ GenerateIsInitialized(io::Printer* printer) {
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = descriptor_->field(i);
     if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        !IsFlatField(field) &&
         HasRequiredFields(field->message_type())) {
       if (field->is_repeated()) {
         printer->Print(
@@ -65,6 +65,11 @@ class MessageGenerator {
   // Generate foward declarations for this class and all its nested types.
   void GenerateForwardDeclaration(io::Printer* printer);
 
+  // Generate the plain structs [flat = true] fields store this message and
+  // its nested types as (must come before class definitions because fields
+  // of other classes hold arrays of them).
+  void GenerateFlatStructDefinitions(io::Printer* printer);
+
   // Generate definitions of all nested enums (must come before class
   // definitions because those classes use the enums definitions).
   void GenerateEnumDefinitions(io::Printer* printer);
@@ -114,11 +119,16 @@ class MessageGenerator {
   void GenerateFieldAccessorDeclarations(io::Printer* printer);
   void GenerateFieldAccessorDefinitions(io::Printer* printer);
 
+  // Generate the Fields types and VisitFields() of lite classes.
+  void GenerateFieldVisitor(io::Printer* printer);
+
   // Generate the field offsets array.
   void GenerateOffsets(io::Printer* printer);
 
   // Generate constructors and destructor.
   void GenerateStructors(io::Printer* printer);
+  // Generate the constructor Arena::CreateMessage() uses (lite only).
+  void GenerateArenaConstructor(io::Printer* printer);
 
   // The compiler typically generates multiple copies of each constructor and
   // destructor: http://gcc.gnu.org/bugs.html#nonbugs_cxx
@@ -132,15 +142,21 @@ class MessageGenerator {
   // Generate standard Message methods.
   void GenerateClear(io::Printer* printer);
   void GenerateMergeFromCodedStream(io::Printer* printer);
+  // Generate the ParseTable and fallback parser (table-driven parsing only).
+  void GenerateTableDrivenMergeFromCodedStream(io::Printer* printer);
   void GenerateSerializeWithCachedSizes(io::Printer* printer);
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer);
   void GenerateSerializeWithCachedSizesBody(io::Printer* printer,
                                             bool to_array);
+  void GenerateSerializeReverse(io::Printer* printer);
   void GenerateByteSize(io::Printer* printer);
   void GenerateMergeFrom(io::Printer* printer);
   void GenerateCopyFrom(io::Printer* printer);
   void GenerateSwap(io::Printer* printer);
   void GenerateIsInitialized(io::Printer* printer);
+  // Generate ReadFlat(), WriteFlat() and WriteFlatToArray() (flat only).
+  void GenerateFlatMethods(io::Printer* printer);
+  void GenerateFlatFieldsToArray(io::Printer* printer);
 
   // Helpers for GenerateSerializeWithCachedSizes().
   void GenerateSerializeOneField(io::Printer* printer,
@@ -149,6 +165,11 @@ class MessageGenerator {
   void GenerateSerializeOneExtensionRange(
       io::Printer* printer, const Descriptor::ExtensionRange* range,
       bool unbounded);
+  // Helpers for GenerateSerializeReverse().
+  void GenerateSerializeReverseOneField(io::Printer* printer,
+                                        const FieldDescriptor* field);
+  void GenerateSerializeReverseOneExtensionRange(
+      io::Printer* printer, const Descriptor::ExtensionRange* range);
 
 
   const Descriptor* descriptor_;
@@ -52,6 +52,10 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
       (HasFastArraySerialization(descriptor->message_type()->file()) ?
        "MaybeToArray" :
        "");
+  (*variables)["new_message"] = HasArenaSupport(descriptor->file()) ?
+      "::google::protobuf::Arena::CreateMessage< " + (*variables)["type"] +
+          " >(arena_)" :
+      "new " + (*variables)["type"];
 }
 
 }  // namespace
@@ -77,6 +81,18 @@ GenerateAccessorDeclarations(io::Printer* printer) const {
     "inline const $type$& $name$() const$deprecation$;\n"
     "inline $type$* mutable_$name$()$deprecation$;\n"
     "inline $type$* release_$name$()$deprecation$;\n");
+  if (HasArenaSupport(descriptor_->file())) {
+    if (HasArenaSupport(descriptor_->message_type()->file())) {
+      printer->Print(variables_,
+        "// Takes over \"$name$\" if it is on the heap or in this message's\n"
+        "// arena; one in another arena is copied and left to that arena.\n");
+    } else {
+      printer->Print(variables_,
+        "// \"$name$\" must have been allocated with new.\n");
+    }
+  }
+  printer->Print(variables_,
+    "inline void set_allocated_$name$($type$* $name$)$deprecation$;\n");
 }
 
 void MessageFieldGenerator::
@@ -87,14 +103,59 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "}\n"
     "inline $type$* $classname$::mutable_$name$() {\n"
     "  set_has_$name$();\n"
-    "  if ($name$_ == NULL) $name$_ = new $type$;\n"
+    "  if ($name$_ == NULL) $name$_ = $new_message$;\n"
     "  return $name$_;\n"
     "}\n"
     "inline $type$* $classname$::release_$name$() {\n"
     "  clear_has_$name$();\n"
-    "  $type$* temp = $name$_;\n"
+    "  $type$* temp = $name$_;\n");
+  if (HasArenaSupport(descriptor_->file())) {
+    // The caller takes ownership, which it can't have of arena memory.
+    printer->Print(variables_,
+      "  if (arena_ != NULL && temp != NULL) temp = new $type$(*temp);\n");
+  }
+  printer->Print(variables_,
     "  $name$_ = NULL;\n"
     "  return temp;\n"
+    "}\n"
+    "inline void $classname$::set_allocated_$name$($type$* $name$) {\n");
+  if (HasArenaSupport(descriptor_->message_type()->file())) {
+    // Fields of arena messages are freed with the arena.  The new value must
+    // end up where the message is: the arena takes over one on the heap, and
+    // one in another arena, which can't be handed over, is copied.
+    printer->Print(variables_,
+      "  if (arena_ == NULL) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if ($name$ != NULL && $name$->GetArena() != arena_) {\n"
+      "    if ($name$->GetArena() == NULL) {\n"
+      "      arena_->Own($name$);\n"
+      "    } else {\n"
+      "      $type$* temp = $new_message$;\n"
+      "      temp->CopyFrom(*$name$);\n"
+      "      $name$ = temp;\n"
+      "    }\n"
+      "  }\n");
+  } else if (HasArenaSupport(descriptor_->file())) {
+    // The type isn't arena-aware, so the value can only be a heap object,
+    // which the arena takes over.
+    printer->Print(variables_,
+      "  if (arena_ == NULL) {\n"
+      "    delete $name$_;\n"
+      "  } else if ($name$ != NULL) {\n"
+      "    arena_->Own($name$);\n"
+      "  }\n");
+  } else {
+    printer->Print(variables_,
+      "  delete $name$_;\n");
+  }
+  printer->Print(variables_,
+    "  $name$_ = $name$;\n"
+    "  if ($name$ != NULL) {\n"
+    "    set_has_$name$();\n"
+    "  } else {\n"
+    "    clear_has_$name$();\n"
+    "  }\n"
     "}\n");
 }
 
@@ -140,6 +201,13 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
     "  $number$, this->$name$(), output);\n");
 }
 
+void MessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::Write$declared_type$NoVirtual(\n"
+    "  $number$, this->$name$(), output);\n");
+}
+
 void MessageFieldGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   printer->Print(variables_,
@@ -250,6 +318,15 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
     "}\n");
 }
 
+void RepeatedMessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+    "  ::google::protobuf::internal::WireFormatLite::\n"
+    "    Write$declared_type$NoVirtual($number$, this->$name$(i), output);\n"
+    "}\n");
+}
+
 void RepeatedMessageFieldGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   printer->Print(variables_,
@@ -271,6 +348,145 @@ GenerateByteSize(io::Printer* printer) const {
     "}\n");
 }
 
+// ===================================================================
+
+RepeatedFlatMessageFieldGenerator::
+RepeatedFlatMessageFieldGenerator(const FieldDescriptor* descriptor)
+  : descriptor_(descriptor) {
+  SetMessageVariables(descriptor, &variables_);
+  variables_["flat_type"] = variables_["type"] + "_Flat";
+}
+
+RepeatedFlatMessageFieldGenerator::~RepeatedFlatMessageFieldGenerator() {}
+
+void RepeatedFlatMessageFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::RepeatedField< $flat_type$ > $name$_;\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $flat_type$& $name$(int index) const$deprecation$;\n"
+    "inline $flat_type$* mutable_$name$(int index)$deprecation$;\n"
+    "inline $flat_type$* add_$name$()$deprecation$;\n"
+    "inline void add_$name$(const $flat_type$& value)$deprecation$;\n");
+  printer->Print(variables_,
+    "inline const ::google::protobuf::RepeatedField< $flat_type$ >&\n"
+    "    $name$() const$deprecation$;\n"
+    "inline ::google::protobuf::RepeatedField< $flat_type$ >*\n"
+    "    mutable_$name$()$deprecation$;\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $flat_type$& $classname$::$name$(int index) const {\n"
+    "  return $name$_.Get(index);\n"
+    "}\n"
+    "inline $flat_type$* $classname$::mutable_$name$(int index) {\n"
+    "  return $name$_.Mutable(index);\n"
+    "}\n"
+    "inline $flat_type$* $classname$::add_$name$() {\n"
+    "  $flat_type$* value = $name$_.Add();\n");
+  // RepeatedField hands back whatever the slot last held, so start the new
+  // element from the message's defaults like add_ on a message field does.
+  const Descriptor* type = descriptor_->message_type();
+  for (int i = 0; i < type->field_count(); i++) {
+    printer->Print("  value->$field$ = $default$;\n",
+                   "field", FieldName(type->field(i)),
+                   "default", DefaultValue(type->field(i)));
+  }
+  printer->Print(variables_,
+    "  return value;\n"
+    "}\n"
+    "inline void $classname$::add_$name$(const $flat_type$& value) {\n"
+    "  $name$_.Add(value);\n"
+    "}\n");
+  printer->Print(variables_,
+    "inline const ::google::protobuf::RepeatedField< $flat_type$ >&\n"
+    "$classname$::$name$() const {\n"
+    "  return $name$_;\n"
+    "}\n"
+    "inline ::google::protobuf::RepeatedField< $flat_type$ >*\n"
+    "$classname$::mutable_$name$() {\n"
+    "  return &$name$_;\n"
+    "}\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Clear();\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.MergeFrom(from.$name$_);\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  // Not needed for repeated fields.
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  // ReadFlat() fills in every field, missing ones with their defaults, so
+  // the slot needs none.
+  printer->Print(variables_,
+    "DO_($type$::ReadFlat(input, $name$_.Add()));\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = 0; i < this->$name$_size(); i++) {\n"
+    "  $type$::WriteFlat($number$, this->$name$(i), output);\n"
+    "}\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  // Every element encodes to the same size, so they can all be written
+  // forwards into one reserved block.
+  printer->Print(variables_,
+    "if (this->$name$_size() > 0) {\n"
+    "  const int element_size = $tag_size$ +\n"
+    "    ::google::protobuf::io::CodedOutputStream::VarintSize32(\n"
+    "      $type$::kFlatByteSize) +\n"
+    "    $type$::kFlatByteSize;\n"
+    "  ::google::protobuf::uint8* target =\n"
+    "    output->Prepend(element_size * this->$name$_size());\n"
+    "  for (int i = 0; i < this->$name$_size(); i++) {\n"
+    "    target = $type$::WriteFlatToArray($number$, this->$name$(i), target);\n"
+    "  }\n"
+    "}\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = 0; i < this->$name$_size(); i++) {\n"
+    "  target = $type$::WriteFlatToArray($number$, this->$name$(i), target);\n"
+    "}\n");
+}
+
+void RepeatedFlatMessageFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  // Every element encodes to the same size, so there is nothing to cache.
+  printer->Print(variables_,
+    "total_size += ($tag_size$ +\n"
+    "  ::google::protobuf::io::CodedOutputStream::VarintSize32(\n"
+    "    $type$::kFlatByteSize) +\n"
+    "  $type$::kFlatByteSize) * this->$name$_size();\n");
+}
+
 }  // namespace cpp
 }  // namespace compiler
 }  // namespace protobuf
@@ -314,6 +314,49 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
   printer->Print("}\n");
 }
 
+void RepeatedPrimitiveFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  if (!descriptor_->options().packed()) {
+    printer->Print(variables_,
+      "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "  ::google::protobuf::internal::WireFormatLite::Write$declared_type$(\n"
+      "    $number$, this->$name$(i), output);\n"
+      "}\n");
+    return;
+  }
+
+  printer->Print(variables_,
+    "if (this->$name$_size() > 0) {\n");
+  printer->Indent();
+  if (FixedSize(descriptor_->type()) == -1) {
+    printer->Print(variables_,
+      "const int end = output->ByteCount();\n"
+      "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "  ::google::protobuf::internal::WireFormatLite::Write$declared_type$NoTag(\n"
+      "    this->$name$(i), output);\n"
+      "}\n"
+      "output->WriteVarint32(output->ByteCount() - end);\n");
+  } else {
+    // The elements' total size is known up front, so they can be written
+    // forwards into space reserved for all of them.
+    printer->Print(variables_,
+      "::google::protobuf::uint8* target =\n"
+      "  output->Prepend($fixed_size$ * this->$name$_size());\n"
+      "for (int i = 0; i < this->$name$_size(); i++) {\n"
+      "  target = ::google::protobuf::internal::WireFormatLite::\n"
+      "    Write$declared_type$NoTagToArray(this->$name$(i), target);\n"
+      "}\n"
+      "output->WriteVarint32($fixed_size$ * this->$name$_size());\n");
+  }
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::WriteTag(\n"
+    "  $number$,\n"
+    "  ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,\n"
+    "  output);\n");
+  printer->Outdent();
+  printer->Print("}\n");
+}
+
 void RepeatedPrimitiveFieldGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   if (descriptor_->options().packed()) {
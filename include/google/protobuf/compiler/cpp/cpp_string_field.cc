@@ -49,11 +49,85 @@ void SetStringVariables(const FieldDescriptor* descriptor,
                         map<string, string>* variables) {
   SetCommonFieldVariables(descriptor, variables);
   (*variables)["default"] = DefaultValue(descriptor);
+  (*variables)["full_name"] = descriptor->full_name();
   (*variables)["default_variable"] = descriptor->default_value_string().empty()
       ? "::google::protobuf::internal::kEmptyString"
       : "_default_" + FieldName(descriptor) + "_";
   (*variables)["pointer_type"] =
       descriptor->type() == FieldDescriptor::TYPE_BYTES ? "void" : "char";
+  if (HasArenaSupport(descriptor->file())) {
+    (*variables)["new_string"] =
+        "::google::protobuf::Arena::Create< ::std::string>(arena_)";
+    (*variables)["new_default_string"] =
+        "::google::protobuf::Arena::Create< ::std::string>(arena_, " +
+        (*variables)["default_variable"] + ")";
+  } else {
+    (*variables)["new_string"] = "new ::std::string";
+    (*variables)["new_default_string"] =
+        "new ::std::string(" + (*variables)["default_variable"] + ")";
+  }
+}
+
+// Prints the set_allocated_$name$() declaration of a singular field.  An
+// arena can't tell its own strings from others, so on an arena only heap
+// strings can be handed over.
+void PrintSetAllocatedDeclaration(const FieldDescriptor* descriptor,
+                                  const map<string, string>& variables,
+                                  io::Printer* printer) {
+  if (HasArenaSupport(descriptor->file())) {
+    printer->Print(variables,
+      "// \"value\" must have been allocated with new.  It is deleted with\n"
+      "// this message, or with its arena.\n");
+  }
+  printer->Print(variables,
+    "inline void set_allocated_$name$(::std::string* value)$deprecation$;\n");
+}
+
+// Prints the set_$name$(string&&) and set_allocated_$name$() definitions of
+// a singular field, which take over "value" rather than copying it.  An
+// aliased field stops aliasing, like the other setters.
+void PrintOwningSetters(const FieldDescriptor* descriptor,
+                        const map<string, string>& variables,
+                        bool has_alias, io::Printer* printer) {
+  string drop_alias = has_alias ? "  $name$_alias_ = NULL;\n" : "";
+  printer->Print(variables,
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n"
+    "inline void $classname$::set_$name$(::std::string&& value) {\n"
+    "  set_has_$name$();\n");
+  printer->Print(variables, drop_alias.c_str());
+  printer->Print(variables,
+    "  if ($name$_ == &$default_variable$) {\n"
+    "    $name$_ = $new_string$;\n"
+    "  }\n"
+    "  *$name$_ = ::std::move(value);\n"
+    "}\n"
+    "#endif\n"
+    "inline void $classname$::set_allocated_$name$(::std::string* value) {\n");
+  printer->Print(variables, drop_alias.c_str());
+  // Fields of arena messages are freed with the arena, which also takes
+  // over "value".
+  if (HasArenaSupport(descriptor->file())) {
+    printer->Print(variables,
+      "  if ($name$_ != &$default_variable$ && arena_ == NULL) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if (value != NULL) {\n"
+      "    if (arena_ != NULL) arena_->Own(value);\n");
+  } else {
+    printer->Print(variables,
+      "  if ($name$_ != &$default_variable$) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if (value != NULL) {\n");
+  }
+  printer->Print(variables,
+    "    set_has_$name$();\n"
+    "    $name$_ = value;\n"
+    "  } else {\n"
+    "    clear_has_$name$();\n"
+    "    $name$_ = const_cast< ::std::string*>(&$default_variable$);\n"
+    "  }\n"
+    "}\n");
 }
 
 }  // namespace
@@ -80,7 +154,8 @@ void StringFieldGenerator::
 GenerateAccessorDeclarations(io::Printer* printer) const {
   // If we're using StringFieldGenerator for a field with a ctype, it's
   // because that ctype isn't actually implemented.  In particular, this is
-  // true of ctype=CORD and ctype=STRING_PIECE in the open source release.
+  // true of ctype=CORD, and of ctype=STRING_PIECE outside singular fields of
+  // lite files (see StringPieceFieldGenerator).
   // We aren't releasing Cord because it has too many Google-specific
   // dependencies and we aren't releasing StringPiece because it's hardly
   // useful outside of Google and because it would get confusing to have
@@ -107,9 +182,16 @@ GenerateAccessorDeclarations(io::Printer* printer) const {
     "inline void set_$name$(const ::std::string& value)$deprecation$;\n"
     "inline void set_$name$(const char* value)$deprecation$;\n"
     "inline void set_$name$(const $pointer_type$* value, size_t size)"
-                 "$deprecation$;\n"
+                 "$deprecation$;\n");
+  PrintClassBodyDirective(printer,
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n");
+  printer->Print(variables_,
+    "inline void set_$name$(::std::string&& value)$deprecation$;\n");
+  PrintClassBodyDirective(printer, "#endif\n");
+  printer->Print(variables_,
     "inline ::std::string* mutable_$name$()$deprecation$;\n"
     "inline ::std::string* release_$name$()$deprecation$;\n");
+  PrintSetAllocatedDeclaration(descriptor_, variables_, printer);
 
   if (descriptor_->options().ctype() != FieldOptions::STRING) {
     printer->Outdent();
@@ -127,14 +209,14 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void $classname$::set_$name$(const ::std::string& value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
     "inline void $classname$::set_$name$(const char* value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
@@ -142,7 +224,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(reinterpret_cast<const char*>(value), size);\n"
     "}\n"
@@ -151,10 +233,10 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if ($name$_ == &$default_variable$) {\n");
   if (descriptor_->default_value_string().empty()) {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string;\n");
+      "    $name$_ = $new_string$;\n");
   } else {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string($default_variable$);\n");
+      "    $name$_ = $new_default_string$;\n");
   }
   printer->Print(variables_,
     "  }\n"
@@ -166,10 +248,17 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "    return NULL;\n"
     "  } else {\n"
     "    ::std::string* temp = $name$_;\n"
-    "    $name$_ = const_cast< ::std::string*>(&$default_variable$);\n"
+    "    $name$_ = const_cast< ::std::string*>(&$default_variable$);\n");
+  if (HasArenaSupport(descriptor_->file())) {
+    // The caller takes ownership, which it can't have of arena memory.
+    printer->Print(variables_,
+      "    if (arena_ != NULL) temp = new ::std::string(*temp);\n");
+  }
+  printer->Print(variables_,
     "    return temp;\n"
     "  }\n"
     "}\n");
+  PrintOwningSetters(descriptor_, variables_, false, printer);
 }
 
 void StringFieldGenerator::
@@ -222,6 +311,7 @@ GenerateDestructorCode(io::Printer* printer) const {
 void StringFieldGenerator::
 GenerateMergeFromCodedStream(io::Printer* printer) const {
   printer->Print(variables_,
+    "input->BeginBytesField(\"$full_name$\");\n"
     "DO_(::google::protobuf::internal::WireFormatLite::Read$declared_type$(\n"
     "      input, this->mutable_$name$()));\n");
   if (HasUtf8Verification(descriptor_->file()) &&
@@ -272,6 +362,249 @@ GenerateByteSize(io::Printer* printer) const {
 
 // ===================================================================
 
+StringPieceFieldGenerator::
+StringPieceFieldGenerator(const FieldDescriptor* descriptor)
+  : descriptor_(descriptor) {
+  SetStringVariables(descriptor, &variables_);
+}
+
+StringPieceFieldGenerator::~StringPieceFieldGenerator() {}
+
+void StringPieceFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  // The string holds the value unless $name$_alias_ is non-NULL, in which
+  // case the value is the $name$_alias_size_ bytes it points at.
+  printer->Print(variables_,
+    "::std::string* $name$_;\n"
+    "const char* $name$_alias_;\n"
+    "int $name$_alias_size_;\n");
+  if (!descriptor_->default_value_string().empty()) {
+    printer->Print(variables_, "static const ::std::string $default_variable$;\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $name$() const$deprecation$;\n"
+    "inline void set_$name$(const ::std::string& value)$deprecation$;\n"
+    "inline void set_$name$(const char* value)$deprecation$;\n"
+    "inline void set_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline void set_aliased_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline bool $name$_is_aliased() const$deprecation$;\n");
+  PrintClassBodyDirective(printer,
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n");
+  printer->Print(variables_,
+    "inline void set_$name$(::std::string&& value)$deprecation$;\n");
+  PrintClassBodyDirective(printer, "#endif\n");
+  printer->Print(variables_,
+    "inline ::std::string* mutable_$name$()$deprecation$;\n"
+    "inline ::std::string* release_$name$()$deprecation$;\n");
+  PrintSetAllocatedDeclaration(descriptor_, variables_, printer);
+}
+
+void StringPieceFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $classname$::$name$() const {\n"
+    "  if ($name$_alias_ != NULL) {\n"
+    "    return ::google::protobuf::StringPiece($name$_alias_, $name$_alias_size_);\n"
+    "  }\n"
+    "  return ::google::protobuf::StringPiece(*$name$_);\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const ::std::string& value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_alias_ = NULL;\n"
+    "  if ($name$_ == &$default_variable$) {\n"
+    "    $name$_ = $new_string$;\n"
+    "  }\n"
+    "  $name$_->assign(value);\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const char* value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_alias_ = NULL;\n"
+    "  if ($name$_ == &$default_variable$) {\n"
+    "    $name$_ = $new_string$;\n"
+    "  }\n"
+    "  $name$_->assign(value);\n"
+    "}\n"
+    "inline "
+    "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_alias_ = NULL;\n"
+    "  if ($name$_ == &$default_variable$) {\n"
+    "    $name$_ = $new_string$;\n"
+    "  }\n"
+    "  $name$_->assign(reinterpret_cast<const char*>(value), size);\n"
+    "}\n"
+    "inline void $classname$::set_aliased_$name$(\n"
+    "    const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_alias_ = size == 0 ? \"\" : reinterpret_cast<const char*>(value);\n"
+    "  $name$_alias_size_ = size;\n"
+    "}\n"
+    "inline bool $classname$::$name$_is_aliased() const {\n"
+    "  return $name$_alias_ != NULL;\n"
+    "}\n"
+    "inline ::std::string* $classname$::mutable_$name$() {\n"
+    "  set_has_$name$();\n"
+    "  if ($name$_ == &$default_variable$) {\n");
+  if (descriptor_->default_value_string().empty()) {
+    printer->Print(variables_,
+      "    $name$_ = $new_string$;\n");
+  } else {
+    printer->Print(variables_,
+      "    $name$_ = $new_default_string$;\n");
+  }
+  printer->Print(variables_,
+    "  }\n"
+    "  if ($name$_alias_ != NULL) {\n"
+    "    $name$_->assign($name$_alias_, $name$_alias_size_);\n"
+    "    $name$_alias_ = NULL;\n"
+    "  }\n"
+    "  return $name$_;\n"
+    "}\n"
+    "inline ::std::string* $classname$::release_$name$() {\n"
+    "  if ($name$_alias_ != NULL) {\n"
+    "    mutable_$name$();\n"
+    "  }\n"
+    "  clear_has_$name$();\n"
+    "  if ($name$_ == &$default_variable$) {\n"
+    "    return NULL;\n"
+    "  } else {\n"
+    "    ::std::string* temp = $name$_;\n"
+    "    $name$_ = const_cast< ::std::string*>(&$default_variable$);\n");
+  if (HasArenaSupport(descriptor_->file())) {
+    // The caller takes ownership, which it can't have of arena memory.
+    printer->Print(variables_,
+      "    if (arena_ != NULL) temp = new ::std::string(*temp);\n");
+  }
+  printer->Print(variables_,
+    "    return temp;\n"
+    "  }\n"
+    "}\n");
+  PrintOwningSetters(descriptor_, variables_, true, printer);
+}
+
+void StringPieceFieldGenerator::
+GenerateNonInlineAccessorDefinitions(io::Printer* printer) const {
+  if (!descriptor_->default_value_string().empty()) {
+    printer->Print(variables_,
+      "const ::std::string $classname$::$default_variable$($default$);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_alias_ = NULL;\n");
+  if (descriptor_->default_value_string().empty()) {
+    printer->Print(variables_,
+      "if ($name$_ != &$default_variable$) {\n"
+      "  $name$_->clear();\n"
+      "}\n");
+  } else {
+    printer->Print(variables_,
+      "if ($name$_ != &$default_variable$) {\n"
+      "  $name$_->assign($default_variable$);\n"
+      "}\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  // Copies never alias: they must not depend on the source's input buffer.
+  printer->Print(variables_,
+    "set_$name$(from.$name$().data(), from.$name$().size());\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "std::swap($name$_, other->$name$_);\n"
+    "std::swap($name$_alias_, other->$name$_alias_);\n"
+    "std::swap($name$_alias_size_, other->$name$_alias_size_);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_ = const_cast< ::std::string*>(&$default_variable$);\n"
+    "$name$_alias_ = NULL;\n"
+    "$name$_alias_size_ = 0;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateDestructorCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "if ($name$_ != &$default_variable$) {\n"
+    "  delete $name$_;\n"
+    "}\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "input->BeginBytesField(\"$full_name$\");\n"
+    "if (input->AliasingEnabled()) {\n"
+    "  const void* alias;\n"
+    "  int alias_size;\n"
+    "  DO_(::google::protobuf::internal::WireFormatLite::ReadStringPieceAliased(\n"
+    "        input, &alias, &alias_size));\n"
+    "  set_aliased_$name$(static_cast<const char*>(alias), alias_size);\n"
+    "} else {\n"
+    "  DO_(::google::protobuf::internal::WireFormatLite::Read$declared_type$(\n"
+    "        input, this->mutable_$name$()));\n"
+    "}\n");
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::PARSE);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::WriteStringPiece(\n"
+    "  $number$, this->$name$(), output);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "target =\n"
+    "  ::google::protobuf::internal::WireFormatLite::WriteStringPieceToArray(\n"
+    "    $number$, this->$name$(), target);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ +\n"
+    "  ::google::protobuf::internal::WireFormatLite::StringPieceSize(\n"
+    "    this->$name$());\n");
+}
+
+// ===================================================================
+
 RepeatedStringFieldGenerator::
 RepeatedStringFieldGenerator(const FieldDescriptor* descriptor)
   : descriptor_(descriptor) {
@@ -310,6 +643,12 @@ GenerateAccessorDeclarations(io::Printer* printer) const {
     "inline void add_$name$(const char* value)$deprecation$;\n"
     "inline void add_$name$(const $pointer_type$* value, size_t size)"
                  "$deprecation$;\n");
+  PrintClassBodyDirective(printer,
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n");
+  printer->Print(variables_,
+    "inline void set_$name$(int index, ::std::string&& value)$deprecation$;\n"
+    "inline void add_$name$(::std::string&& value)$deprecation$;\n");
+  PrintClassBodyDirective(printer, "#endif\n");
 
   printer->Print(variables_,
     "inline const ::google::protobuf::RepeatedPtrField< ::std::string>& $name$() const"
@@ -357,7 +696,15 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void "
     "$classname$::add_$name$(const $pointer_type$* value, size_t size) {\n"
     "  $name$_.Add()->assign(reinterpret_cast<const char*>(value), size);\n"
-    "}\n");
+    "}\n"
+    "#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES\n"
+    "inline void $classname$::set_$name$(int index, ::std::string&& value) {\n"
+    "  *$name$_.Mutable(index) = ::std::move(value);\n"
+    "}\n"
+    "inline void $classname$::add_$name$(::std::string&& value) {\n"
+    "  *$name$_.Add() = ::std::move(value);\n"
+    "}\n"
+    "#endif\n");
   printer->Print(variables_,
     "inline const ::google::protobuf::RepeatedPtrField< ::std::string>&\n"
     "$classname$::$name$() const {\n"
@@ -392,6 +739,7 @@ GenerateConstructorCode(io::Printer* printer) const {
 void RepeatedStringFieldGenerator::
 GenerateMergeFromCodedStream(io::Printer* printer) const {
   printer->Print(variables_,
+    "input->BeginBytesField(\"$full_name$\");\n"
     "DO_(::google::protobuf::internal::WireFormatLite::Read$declared_type$(\n"
     "      input, this->add_$name$()));\n");
   if (HasUtf8Verification(descriptor_->file()) &&
@@ -420,6 +768,16 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
     "}\n");
 }
 
+void RepeatedStringFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  // Only lite messages serialize in reverse, so there is no UTF-8 check.
+  printer->Print(variables_,
+    "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+    "  ::google::protobuf::internal::WireFormatLite::Write$declared_type$(\n"
+    "    $number$, this->$name$(i), output);\n"
+    "}\n");
+}
+
 void RepeatedStringFieldGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   printer->Print(variables_,
@@ -44,8 +44,10 @@
 // correctly and produces the interfaces we expect, which is why this test
 // is written this way.
 
+#include <map>
 #include <vector>
 
+#include <google/protobuf/compiler/cpp/cpp_generator.h>
 #include <google/protobuf/unittest.pb.h>
 #include <google/protobuf/unittest_optimize_for.pb.h>
 #include <google/protobuf/unittest_embed_optimize_for.pb.h>
@@ -58,6 +60,7 @@
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/text_format.h>
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
@@ -1252,6 +1255,152 @@ TEST_F(GeneratedServiceTest, NoGenericServices) {
   EXPECT_EQ("Foo", file->service(0)->method(0)->name());
 }
 
+// ===================================================================
+
+// The options in cpp_options.proto are checked by the generator, not by
+// DescriptorPool, so these tests run it on descriptors built on the fly.
+class CppOptionsTest : public testing::Test {
+ protected:
+  class MockGeneratorContext : public GeneratorContext {
+   public:
+    map<string, string> files_;
+
+    // implements GeneratorContext -------------------------------------
+    io::ZeroCopyOutputStream* Open(const string& filename) {
+      files_[filename].clear();
+      return new io::StringOutputStream(&files_[filename]);
+    }
+  };
+
+  virtual void SetUp() {
+    FileDescriptorProto descriptor_proto;
+    FileDescriptorProto cpp_options_proto;
+    FileDescriptorProto::descriptor()->file()->CopyTo(&descriptor_proto);
+    DescriptorPool::generated_pool()->FindFileByName(
+        "google/protobuf/cpp_options.proto")->CopyTo(&cpp_options_proto);
+    ASSERT_TRUE(pool_.BuildFile(descriptor_proto) != NULL);
+    ASSERT_TRUE(pool_.BuildFile(cpp_options_proto) != NULL);
+  }
+
+  // Builds the file described by "file_text", a FileDescriptorProto in text
+  // format, and runs the C++ generator on it.
+  bool Generate(const string& file_text) {
+    FileDescriptorProto file_proto;
+    EXPECT_TRUE(TextFormat::ParseFromString(file_text, &file_proto));
+    const FileDescriptor* file = pool_.BuildFile(file_proto);
+    EXPECT_TRUE(file != NULL);
+    if (file == NULL) return false;
+    CppGenerator generator;
+    return generator.Generate(file, "", &context_, &error_);
+  }
+
+  DescriptorPool pool_;
+  MockGeneratorContext context_;
+  string error_;
+};
+
+TEST_F(CppOptionsTest, FlatField) {
+  ASSERT_TRUE(Generate(
+    "name: \"foo.proto\" "
+    "dependency: \"google/protobuf/cpp_options.proto\" "
+    "options { optimize_for: LITE_RUNTIME } "
+    "message_type {"
+    "  name: \"Point\""
+    "  field { name:\"x\" number:1 label:LABEL_REQUIRED type:TYPE_FLOAT }"
+    "  field { name:\"y\" number:2 label:LABEL_REQUIRED type:TYPE_DOUBLE }"
+    "}"
+    "message_type {"
+    "  name: \"Polygon\""
+    "  field { name:\"vertex\" number:1 label:LABEL_REPEATED "
+    "          type_name: \"Point\" "
+    "          options { [google.protobuf.flat]: true } }"
+    "}"));
+
+  const string& header = context_.files_["foo.pb.h"];
+  EXPECT_NE(string::npos,
+            header.find("::google::protobuf::RepeatedField< ::Point_Flat >"));
+  // The lite code doesn't depend on cpp_options.proto, which isn't lite.
+  EXPECT_EQ(string::npos, header.find("cpp_options.pb.h"));
+  EXPECT_EQ(string::npos,
+            context_.files_["foo.pb.cc"].find("cpp_5foptions"));
+}
+
+TEST_F(CppOptionsTest, FlatFieldWithDescriptors) {
+  // Files with descriptors keep message objects, which reflection needs.
+  ASSERT_TRUE(Generate(
+    "name: \"foo.proto\" "
+    "dependency: \"google/protobuf/cpp_options.proto\" "
+    "message_type {"
+    "  name: \"Point\""
+    "  field { name:\"x\" number:1 label:LABEL_REQUIRED type:TYPE_FLOAT }"
+    "}"
+    "message_type {"
+    "  name: \"Polygon\""
+    "  field { name:\"vertex\" number:1 label:LABEL_REPEATED "
+    "          type_name: \"Point\" "
+    "          options { [google.protobuf.flat]: true } }"
+    "}"));
+
+  const string& header = context_.files_["foo.pb.h"];
+  EXPECT_EQ(string::npos, header.find("Point_Flat"));
+  EXPECT_NE(string::npos,
+            header.find("#include \"google/protobuf/cpp_options.pb.h\""));
+}
+
+TEST_F(CppOptionsTest, TableDrivenParsing) {
+  ASSERT_TRUE(Generate(
+    "name: \"foo.proto\" "
+    "dependency: \"google/protobuf/cpp_options.proto\" "
+    "options { optimize_for: LITE_RUNTIME "
+    "          [google.protobuf.cc_table_driven_parsing]: true } "
+    "message_type {"
+    "  name: \"Foo\""
+    "  field { name:\"bar\" number:1 label:LABEL_OPTIONAL type:TYPE_INT32 }"
+    "}"));
+
+  EXPECT_NE(string::npos, context_.files_["foo.pb.h"].find(
+      "#include <google/protobuf/generated_message_table_driven.h>"));
+  EXPECT_NE(string::npos,
+            context_.files_["foo.pb.cc"].find("TableDrivenParser"));
+}
+
+TEST_F(CppOptionsTest, IllegalFlatField) {
+  EXPECT_FALSE(Generate(
+    "name: \"foo.proto\" "
+    "dependency: \"google/protobuf/cpp_options.proto\" "
+    "options { optimize_for: LITE_RUNTIME } "
+    "message_type {"
+    "  name: \"Point\""
+    "  field { name:\"x\" number:1 label:LABEL_REQUIRED type:TYPE_FLOAT }"
+    "}"
+    "message_type {"
+    "  name: \"Foo\""
+    "  field { name:\"optional_point\" number:1 label:LABEL_OPTIONAL "
+    "          type_name: \"Point\" "
+    "          options { [google.protobuf.flat]: true } }"
+    "}"));
+  EXPECT_EQ("Foo.optional_point: [(google.protobuf.flat) = true] can only be "
+            "specified for repeated message fields.", error_);
+}
+
+TEST_F(CppOptionsTest, IllegalFlatFieldType) {
+  EXPECT_FALSE(Generate(
+    "name: \"foo.proto\" "
+    "dependency: \"google/protobuf/cpp_options.proto\" "
+    "options { optimize_for: LITE_RUNTIME } "
+    "message_type {"
+    "  name: \"Foo\""
+    "  field { name:\"bar\" number:1 label:LABEL_OPTIONAL type:TYPE_INT32 }"
+    "  field { name:\"flat_foo\" number:2 label:LABEL_REPEATED "
+    "          type_name: \"Foo\" "
+    "          options { [google.protobuf.flat]: true } }"
+    "}"));
+  EXPECT_EQ("Foo.flat_foo: [(google.protobuf.flat) = true] requires \"Foo\" "
+            "to have between 1 and 32 fields, all of them required float, "
+            "double, fixed32, fixed64, sfixed32 or sfixed64, and no nested "
+            "types or extension ranges.", error_);
+}
+
 #endif  // !PROTOBUF_TEST_NO_DESCRIPTORS
 
 // ===================================================================
@@ -178,6 +178,14 @@ CodeGeneratorRequest::CodeGeneratorRequest(const CodeGeneratorRequest& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+CodeGeneratorRequest::CodeGeneratorRequest(CodeGeneratorRequest&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void CodeGeneratorRequest::SharedCtor() {
   _cached_size_ = 0;
   parameter_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -241,6 +249,7 @@ bool CodeGeneratorRequest::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_file_to_generate:
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorRequest.file_to_generate");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->add_file_to_generate()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -259,6 +268,7 @@ bool CodeGeneratorRequest::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_parameter:
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorRequest.parameter");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_parameter()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -493,6 +503,14 @@ CodeGeneratorResponse_File::CodeGeneratorResponse_File(const CodeGeneratorRespon
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+CodeGeneratorResponse_File::CodeGeneratorResponse_File(CodeGeneratorResponse_File&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void CodeGeneratorResponse_File::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -571,6 +589,7 @@ bool CodeGeneratorResponse_File::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorResponse.File.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -588,6 +607,7 @@ bool CodeGeneratorResponse_File::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_insertion_point:
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorResponse.File.insertion_point");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_insertion_point()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -605,6 +625,7 @@ bool CodeGeneratorResponse_File::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_content:
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorResponse.File.content");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_content()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -830,6 +851,14 @@ CodeGeneratorResponse::CodeGeneratorResponse(const CodeGeneratorResponse& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+CodeGeneratorResponse::CodeGeneratorResponse(CodeGeneratorResponse&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void CodeGeneratorResponse::SharedCtor() {
   _cached_size_ = 0;
   error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -891,6 +920,7 @@ bool CodeGeneratorResponse::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.compiler.CodeGeneratorResponse.error");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_error()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -53,6 +53,15 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  CodeGeneratorRequest(CodeGeneratorRequest&& from);
+  
+  inline CodeGeneratorRequest& operator=(CodeGeneratorRequest&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -108,6 +117,10 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
   inline void add_file_to_generate(const ::std::string& value);
   inline void add_file_to_generate(const char* value);
   inline void add_file_to_generate(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_file_to_generate(int index, ::std::string&& value);
+  inline void add_file_to_generate(::std::string&& value);
+  #endif
   inline const ::google::protobuf::RepeatedPtrField< ::std::string>& file_to_generate() const;
   inline ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_file_to_generate();
   
@@ -119,8 +132,12 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
   inline void set_parameter(const ::std::string& value);
   inline void set_parameter(const char* value);
   inline void set_parameter(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_parameter(::std::string&& value);
+  #endif
   inline ::std::string* mutable_parameter();
   inline ::std::string* release_parameter();
+  inline void set_allocated_parameter(::std::string* value);
   
   // repeated .google.protobuf.FileDescriptorProto proto_file = 15;
   inline int proto_file_size() const;
@@ -169,6 +186,15 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  CodeGeneratorResponse_File(CodeGeneratorResponse_File&& from);
+  
+  inline CodeGeneratorResponse_File& operator=(CodeGeneratorResponse_File&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -219,8 +245,12 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // optional string insertion_point = 2;
   inline bool has_insertion_point() const;
@@ -230,8 +260,12 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   inline void set_insertion_point(const ::std::string& value);
   inline void set_insertion_point(const char* value);
   inline void set_insertion_point(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_insertion_point(::std::string&& value);
+  #endif
   inline ::std::string* mutable_insertion_point();
   inline ::std::string* release_insertion_point();
+  inline void set_allocated_insertion_point(::std::string* value);
   
   // optional string content = 15;
   inline bool has_content() const;
@@ -241,8 +275,12 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   inline void set_content(const ::std::string& value);
   inline void set_content(const char* value);
   inline void set_content(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_content(::std::string&& value);
+  #endif
   inline ::std::string* mutable_content();
   inline ::std::string* release_content();
+  inline void set_allocated_content(::std::string* value);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.compiler.CodeGeneratorResponse.File)
  private:
@@ -283,6 +321,15 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse : public ::google::protobuf::Messag
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  CodeGeneratorResponse(CodeGeneratorResponse&& from);
+  
+  inline CodeGeneratorResponse& operator=(CodeGeneratorResponse&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -335,8 +382,12 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse : public ::google::protobuf::Messag
   inline void set_error(const ::std::string& value);
   inline void set_error(const char* value);
   inline void set_error(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_error(::std::string&& value);
+  #endif
   inline ::std::string* mutable_error();
   inline ::std::string* release_error();
+  inline void set_allocated_error(::std::string* value);
   
   // repeated .google.protobuf.compiler.CodeGeneratorResponse.File file = 15;
   inline int file_size() const;
@@ -412,6 +463,14 @@ inline void CodeGeneratorRequest::add_file_to_generate(const char* value) {
 inline void CodeGeneratorRequest::add_file_to_generate(const char* value, size_t size) {
   file_to_generate_.Add()->assign(reinterpret_cast<const char*>(value), size);
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorRequest::set_file_to_generate(int index, ::std::string&& value) {
+  *file_to_generate_.Mutable(index) = ::std::move(value);
+}
+inline void CodeGeneratorRequest::add_file_to_generate(::std::string&& value) {
+  *file_to_generate_.Add() = ::std::move(value);
+}
+#endif
 inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
 CodeGeneratorRequest::file_to_generate() const {
   return file_to_generate_;
@@ -478,6 +537,27 @@ inline ::std::string* CodeGeneratorRequest::release_parameter() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorRequest::set_parameter(::std::string&& value) {
+  set_has_parameter();
+  if (parameter_ == &::google::protobuf::internal::kEmptyString) {
+    parameter_ = new ::std::string;
+  }
+  *parameter_ = ::std::move(value);
+}
+#endif
+inline void CodeGeneratorRequest::set_allocated_parameter(::std::string* value) {
+  if (parameter_ != &::google::protobuf::internal::kEmptyString) {
+    delete parameter_;
+  }
+  if (value != NULL) {
+    set_has_parameter();
+    parameter_ = value;
+  } else {
+    clear_has_parameter();
+    parameter_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.FileDescriptorProto proto_file = 15;
 inline int CodeGeneratorRequest::proto_file_size() const {
@@ -565,6 +645,27 @@ inline ::std::string* CodeGeneratorResponse_File::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorResponse_File::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void CodeGeneratorResponse_File::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string insertion_point = 2;
 inline bool CodeGeneratorResponse_File::has_insertion_point() const {
@@ -623,6 +724,27 @@ inline ::std::string* CodeGeneratorResponse_File::release_insertion_point() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorResponse_File::set_insertion_point(::std::string&& value) {
+  set_has_insertion_point();
+  if (insertion_point_ == &::google::protobuf::internal::kEmptyString) {
+    insertion_point_ = new ::std::string;
+  }
+  *insertion_point_ = ::std::move(value);
+}
+#endif
+inline void CodeGeneratorResponse_File::set_allocated_insertion_point(::std::string* value) {
+  if (insertion_point_ != &::google::protobuf::internal::kEmptyString) {
+    delete insertion_point_;
+  }
+  if (value != NULL) {
+    set_has_insertion_point();
+    insertion_point_ = value;
+  } else {
+    clear_has_insertion_point();
+    insertion_point_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string content = 15;
 inline bool CodeGeneratorResponse_File::has_content() const {
@@ -681,6 +803,27 @@ inline ::std::string* CodeGeneratorResponse_File::release_content() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorResponse_File::set_content(::std::string&& value) {
+  set_has_content();
+  if (content_ == &::google::protobuf::internal::kEmptyString) {
+    content_ = new ::std::string;
+  }
+  *content_ = ::std::move(value);
+}
+#endif
+inline void CodeGeneratorResponse_File::set_allocated_content(::std::string* value) {
+  if (content_ != &::google::protobuf::internal::kEmptyString) {
+    delete content_;
+  }
+  if (value != NULL) {
+    set_has_content();
+    content_ = value;
+  } else {
+    clear_has_content();
+    content_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -743,6 +886,27 @@ inline ::std::string* CodeGeneratorResponse::release_error() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void CodeGeneratorResponse::set_error(::std::string&& value) {
+  set_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    error_ = new ::std::string;
+  }
+  *error_ = ::std::move(value);
+}
+#endif
+inline void CodeGeneratorResponse::set_allocated_error(::std::string* value) {
+  if (error_ != &::google::protobuf::internal::kEmptyString) {
+    delete error_;
+  }
+  if (value != NULL) {
+    set_has_error();
+    error_ = value;
+  } else {
+    clear_has_error();
+    error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.compiler.CodeGeneratorResponse.File file = 15;
 inline int CodeGeneratorResponse::file_size() const {
@@ -0,0 +1,95 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+
+#define INTERNAL_SUPPRESS_PROTOBUF_FIELD_DEPRECATION
+#include "google/protobuf/cpp_options.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/stubs/once.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+
+namespace google {
+namespace protobuf {
+
+namespace {
+
+
+}  // namespace
+
+
+void protobuf_AssignDesc_google_2fprotobuf_2fcpp_5foptions_2eproto() {
+  protobuf_AddDesc_google_2fprotobuf_2fcpp_5foptions_2eproto();
+  const ::google::protobuf::FileDescriptor* file =
+    ::google::protobuf::DescriptorPool::generated_pool()->FindFileByName(
+      "google/protobuf/cpp_options.proto");
+  GOOGLE_CHECK(file != NULL);
+}
+
+namespace {
+
+GOOGLE_PROTOBUF_DECLARE_ONCE(protobuf_AssignDescriptors_once_);
+inline void protobuf_AssignDescriptorsOnce() {
+  ::google::protobuf::GoogleOnceInit(&protobuf_AssignDescriptors_once_,
+                 &protobuf_AssignDesc_google_2fprotobuf_2fcpp_5foptions_2eproto);
+}
+
+void protobuf_RegisterTypes(const ::std::string&) {
+  protobuf_AssignDescriptorsOnce();
+}
+
+}  // namespace
+
+void protobuf_ShutdownFile_google_2fprotobuf_2fcpp_5foptions_2eproto() {
+}
+
+void protobuf_AddDesc_google_2fprotobuf_2fcpp_5foptions_2eproto() {
+  static bool already_here = false;
+  if (already_here) return;
+  already_here = true;
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+  ::google::protobuf::protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto();
+  ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
+    "\n!google/protobuf/cpp_options.proto\022\017goo"
+    "gle.protobuf\032 google/protobuf/descriptor"
+    ".proto:F\n\027cc_table_driven_parsing\022\034.goog"
+    "le.protobuf.FileOptions\030\322\206\003 \001(\010:\005false:4"
+    "\n\004flat\022\035.google.protobuf.FieldOptions\030\321\206"
+    "\003 \001(\010:\005falseB\'\n\023com.google.protobufB\020Cpp"
+    "OptionsProtos", 253);
+  ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
+    "google/protobuf/cpp_options.proto", &protobuf_RegisterTypes);
+  ::google::protobuf::internal::ExtensionSet::RegisterExtension(
+    &::google::protobuf::FileOptions::default_instance(),
+    50002, 8, false, false);
+  ::google::protobuf::internal::ExtensionSet::RegisterExtension(
+    &::google::protobuf::FieldOptions::default_instance(),
+    50001, 8, false, false);
+  ::google::protobuf::internal::OnShutdown(&protobuf_ShutdownFile_google_2fprotobuf_2fcpp_5foptions_2eproto);
+}
+
+// Force AddDescriptors() to be called at static initialization time.
+struct StaticDescriptorInitializer_google_2fprotobuf_2fcpp_5foptions_2eproto {
+  StaticDescriptorInitializer_google_2fprotobuf_2fcpp_5foptions_2eproto() {
+    protobuf_AddDesc_google_2fprotobuf_2fcpp_5foptions_2eproto();
+  }
+} static_descriptor_initializer_google_2fprotobuf_2fcpp_5foptions_2eproto_;
+
+::google::protobuf::internal::ExtensionIdentifier< ::google::protobuf::FileOptions,
+    ::google::protobuf::internal::PrimitiveTypeTraits< bool >, 8, false >
+  cc_table_driven_parsing(kCcTableDrivenParsingFieldNumber, false);
+::google::protobuf::internal::ExtensionIdentifier< ::google::protobuf::FieldOptions,
+    ::google::protobuf::internal::PrimitiveTypeTraits< bool >, 8, false >
+  flat(kFlatFieldNumber, false);
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace protobuf
+}  // namespace google
+
+// @@protoc_insertion_point(global_scope)
@@ -186,7 +186,7 @@ struct PointerIntegerPairHash {
     return reinterpret_cast<intptr_t>(p.first) * ((1 << 16) - 1) + p.second;
   }
 
-  // Used only by MSVC and platforms where hash_map is not available.
+  // Used only by MSVC.
   static const size_t bucket_size = 4;
   static const size_t min_buckets = 8;
   inline bool operator()(const PairType& a, const PairType& b) const {
@@ -207,7 +207,7 @@ struct PointerStringPairHash {
            cstring_hash(p.second);
   }
 
-  // Used only by MSVC and platforms where hash_map is not available.
+  // Used only by MSVC.
   static const size_t bucket_size = 4;
   static const size_t min_buckets = 8;
   inline bool operator()(const PointerStringPair& a,
@@ -301,6 +301,131 @@ typedef hash_map<EnumIntPair, const EnumValueDescriptor*,
 typedef map<DescriptorIntPair, const FieldDescriptor*>
   ExtensionsGroupedByDescriptorMap;
 
+// Loads and stores of the pointers in a PublishedMap, which threads read
+// without holding the pool's mutex.  A load that sees a stored pointer also
+// sees everything the storing thread wrote before the store.
+template <typename Type>
+inline Type AcquireLoad(const Type* location) {
+#if defined(__ATOMIC_ACQUIRE)
+  return __atomic_load_n(location, __ATOMIC_ACQUIRE);
+#elif defined(__GNUC__)
+  Type value = *static_cast<const volatile Type*>(location);
+  __sync_synchronize();
+  return value;
+#else
+  // MSVC gives volatile accesses acquire and release semantics.
+  return *static_cast<const volatile Type*>(location);
+#endif
+}
+
+template <typename Type>
+inline void ReleaseStore(Type* location, Type value) {
+#if defined(__ATOMIC_RELEASE)
+  __atomic_store_n(location, value, __ATOMIC_RELEASE);
+#elif defined(__GNUC__)
+  __sync_synchronize();
+  *static_cast<volatile Type*>(location) = value;
+#else
+  *static_cast<volatile Type*>(location) = value;
+#endif
+}
+
+template <typename Type>
+struct PairEqual {
+  bool operator()(const Type& a, const Type& b) const {
+    return a.first == b.first && a.second == b.second;
+  }
+};
+
+// An insert-only hash map that can be read without a lock while one thread
+// at a time inserts into it.  Entries are immutable and published into the
+// free slots of an open-addressing table with release stores.  When the
+// table fills up, a larger copy replaces it as a whole, through another
+// release store.  Replaced tables are kept until the map is destroyed,
+// since readers may still be probing them; with the size doubling each
+// time, they add up to less than the current one.
+template <typename Key, typename Value, typename Hash, typename Equal>
+class PublishedMap {
+ public:
+  PublishedMap() : table_(NULL), size_(0) {}
+  ~PublishedMap() {
+    STLDeleteElements(&entries_);
+    for (int i = 0; i < tables_.size(); i++) {
+      operator delete(tables_[i]);
+    }
+  }
+
+  // Returns NULL if not found.  Safe to call from any thread.
+  const Value* Find(const Key& key) const {
+    const Table* table = AcquireLoad(&table_);
+    if (table == NULL) return NULL;
+    for (size_t i = Hash()(key) & table->mask; ; i = (i + 1) & table->mask) {
+      const Entry* entry = AcquireLoad(&table->slots[i]);
+      if (entry == NULL) return NULL;
+      if (Equal()(entry->key, key)) return &entry->value;
+    }
+  }
+
+  // "key" must not be in the map yet.  Only one thread may insert at a time.
+  void Insert(const Key& key, const Value& value) {
+    // Keep at least half of the slots free, so probes end quickly.
+    if (table_ == NULL || (size_ + 1) * 2 > table_->mask + 1) {
+      Grow();
+    }
+    Entry* entry = new Entry;
+    entry->key = key;
+    entry->value = value;
+    entries_.push_back(entry);
+    Place(table_, entry);
+    ++size_;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+  };
+
+  struct Table {
+    size_t mask;  // The number of slots, minus one.
+    const Entry* slots[1];
+  };
+
+  void Place(Table* table, const Entry* entry) {
+    size_t i = Hash()(entry->key) & table->mask;
+    while (table->slots[i] != NULL) i = (i + 1) & table->mask;
+    ReleaseStore(&table->slots[i], entry);
+  }
+
+  void Grow() {
+    size_t slot_count = (table_ == NULL) ? 16 : (table_->mask + 1) * 2;
+    size_t bytes = sizeof(Table) + (slot_count - 1) * sizeof(const Entry*);
+    Table* table = static_cast<Table*>(operator new(bytes));
+    memset(table, 0, bytes);
+    table->mask = slot_count - 1;
+    for (int i = 0; i < entries_.size(); i++) {
+      Place(table, entries_[i]);
+    }
+    tables_.push_back(table);
+    ReleaseStore(&table_, table);
+  }
+
+  Table* table_;
+  int size_;
+  vector<const Entry*> entries_;  // All entries, in order of insertion.
+  vector<Table*> tables_;         // All tables, including table_.
+};
+
+typedef PublishedMap<const char*, Symbol, hash<const char*>, streq>
+  PublishedSymbolsMap;
+typedef PublishedMap<const char*, const FileDescriptor*,
+                     hash<const char*>, streq>
+  PublishedFilesMap;
+typedef PublishedMap<DescriptorIntPair, const FieldDescriptor*,
+                     PointerIntegerPairHash<DescriptorIntPair>,
+                     PairEqual<DescriptorIntPair> >
+  PublishedExtensionsMap;
+
 }  // anonymous namespace
 
 // ===================================================================
@@ -323,6 +448,11 @@ class DescriptorPool::Tables {
   // everything that was added after that point.
   void Rollback();
 
+  // Make the symbols, files and extensions added since the last Checkpoint()
+  // visible to the FindPublished*() methods.  Pools with a fallback database
+  // call this for each file they finish building, before Checkpoint().
+  void Publish();
+
   // The stack of files which are currently being built.  Used to detect
   // cyclic dependencies when loading files from a DescriptorDatabase.  Not
   // used when fallback_database_ == NULL.
@@ -358,6 +488,15 @@ class DescriptorPool::Tables {
   inline void FindAllExtensions(const Descriptor* extendee,
                                 vector<const FieldDescriptor*>* out) const;
 
+  // Like FindSymbol(), FindFile() and FindExtension(), but they only see
+  // what Publish() has published, and need not hold the pool's mutex.  The
+  // Find*() methods of pools with a fallback database try these first, so
+  // that looking up something that is already loaded doesn't lock.
+  inline Symbol FindPublishedSymbol(const string& key) const;
+  inline const FileDescriptor* FindPublishedFile(const string& key) const;
+  inline const FieldDescriptor* FindPublishedExtension(
+      const Descriptor* extendee, int number) const;
+
   // -----------------------------------------------------------------
   // Adding items.
 
@@ -413,6 +552,10 @@ class DescriptorPool::Tables {
   vector<const char*      > files_after_checkpoint_;
   vector<DescriptorIntPair> extensions_after_checkpoint_;
 
+  PublishedSymbolsMap    published_symbols_;
+  PublishedFilesMap      published_files_;
+  PublishedExtensionsMap published_extensions_;
+
   // Allocate some bytes which will be reclaimed when the pool is
   // destroyed.
   void* AllocateBytes(int size);
@@ -543,6 +686,22 @@ void DescriptorPool::Tables::Rollback() {
   allocations_.resize(allocations_before_checkpoint_);
 }
 
+void DescriptorPool::Tables::Publish() {
+  for (int i = 0; i < symbols_after_checkpoint_.size(); i++) {
+    const char* name = symbols_after_checkpoint_[i];
+    published_symbols_.Insert(
+        name, FindWithDefault(symbols_by_name_, name, kNullSymbol));
+  }
+  for (int i = 0; i < files_after_checkpoint_.size(); i++) {
+    const char* name = files_after_checkpoint_[i];
+    published_files_.Insert(name, FindPtrOrNull(files_by_name_, name));
+  }
+  for (int i = 0; i < extensions_after_checkpoint_.size(); i++) {
+    const DescriptorIntPair& key = extensions_after_checkpoint_[i];
+    published_extensions_.Insert(key, FindPtrOrNull(extensions_, key));
+  }
+}
+
 // -------------------------------------------------------------------
 
 inline Symbol DescriptorPool::Tables::FindSymbol(const string& key) const {
@@ -572,8 +731,23 @@ inline Symbol FileDescriptorTables::FindNestedSymbolOfType(
   return result;
 }
 
+inline Symbol DescriptorPool::Tables::FindPublishedSymbol(
+    const string& key) const {
+  const Symbol* result = published_symbols_.Find(key.c_str());
+  if (result == NULL) {
+    return kNullSymbol;
+  } else {
+    return *result;
+  }
+}
+
 Symbol DescriptorPool::Tables::FindByNameHelper(
     const DescriptorPool* pool, const string& name) const {
+  if (pool->mutex_ != NULL) {
+    Symbol result = FindPublishedSymbol(name);
+    if (!result.IsNull()) return result;
+  }
+
   MutexLockMaybe lock(pool->mutex_);
   Symbol result = FindSymbol(name);
 
@@ -598,6 +772,12 @@ inline const FileDescriptor* DescriptorPool::Tables::FindFile(
   return FindPtrOrNull(files_by_name_, key.c_str());
 }
 
+inline const FileDescriptor* DescriptorPool::Tables::FindPublishedFile(
+    const string& key) const {
+  const FileDescriptor* const* result = published_files_.Find(key.c_str());
+  return (result == NULL) ? NULL : *result;
+}
+
 inline const FieldDescriptor* FileDescriptorTables::FindFieldByNumber(
     const Descriptor* parent, int number) const {
   return FindPtrOrNull(fields_by_number_, make_pair(parent, number));
@@ -625,6 +805,13 @@ inline const FieldDescriptor* DescriptorPool::Tables::FindExtension(
   return FindPtrOrNull(extensions_, make_pair(extendee, number));
 }
 
+inline const FieldDescriptor* DescriptorPool::Tables::FindPublishedExtension(
+    const Descriptor* extendee, int number) const {
+  const FieldDescriptor* const* result =
+      published_extensions_.Find(make_pair(extendee, number));
+  return (result == NULL) ? NULL : *result;
+}
+
 inline void DescriptorPool::Tables::FindAllExtensions(
     const Descriptor* extendee, vector<const FieldDescriptor*>* out) const {
   ExtensionsGroupedByDescriptorMap::const_iterator it =
@@ -791,6 +978,9 @@ void DescriptorPool::InternalDontEnforceDependencies() {
 }
 
 bool DescriptorPool::InternalIsFileLoaded(const string& filename) const {
+  if (mutex_ != NULL && tables_->FindPublishedFile(filename) != NULL) {
+    return true;
+  }
   MutexLockMaybe lock(mutex_);
   return tables_->FindFile(filename) != NULL;
 }
@@ -870,6 +1060,10 @@ void DescriptorPool::InternalAddGeneratedFile(
 //   there's nothing more important to do (read: never).
 
 const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
+  if (mutex_ != NULL) {
+    const FileDescriptor* result = tables_->FindPublishedFile(name);
+    if (result != NULL) return result;
+  }
   MutexLockMaybe lock(mutex_);
   const FileDescriptor* result = tables_->FindFile(name);
   if (result != NULL) return result;
@@ -886,6 +1080,10 @@ const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
 
 const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
     const string& symbol_name) const {
+  if (mutex_ != NULL) {
+    Symbol result = tables_->FindPublishedSymbol(symbol_name);
+    if (!result.IsNull()) return result.GetFile();
+  }
   MutexLockMaybe lock(mutex_);
   Symbol result = tables_->FindSymbol(symbol_name);
   if (!result.IsNull()) return result.GetFile();
@@ -956,6 +1154,11 @@ const MethodDescriptor* DescriptorPool::FindMethodByName(
 
 const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
     const Descriptor* extendee, int number) const {
+  if (mutex_ != NULL) {
+    const FieldDescriptor* result =
+        tables_->FindPublishedExtension(extendee, number);
+    if (result != NULL) return result;
+  }
   MutexLockMaybe lock(mutex_);
   const FieldDescriptor* result = tables_->FindExtension(extendee, number);
   if (result != NULL) {
@@ -2873,6 +3076,8 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
     tables_->Rollback();
     return NULL;
   } else {
+    // Only pools with a mutex have readers that don't take it.
+    if (pool_->mutex_ != NULL) tables_->Publish();
     tables_->Checkpoint();
     return result;
   }
@@ -1148,7 +1148,10 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
     const FileDescriptorProto& proto) const;
 
   // If fallback_database_ is NULL, this is NULL.  Otherwise, this is a mutex
-  // which must be locked while accessing tables_.
+  // which must be locked while accessing tables_, except for the lookups of
+  // already-built files and symbols that tables_ publishes for lock-free
+  // reading (see Tables::Publish() in descriptor.cc).  Only building files
+  // from the fallback database, and looking up what isn't built yet, lock.
   Mutex* mutex_;
 
   // See constructor.
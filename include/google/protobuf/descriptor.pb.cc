@@ -727,6 +727,14 @@ FileDescriptorSet::FileDescriptorSet(const FileDescriptorSet& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+FileDescriptorSet::FileDescriptorSet(FileDescriptorSet&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void FileDescriptorSet::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -942,6 +950,14 @@ FileDescriptorProto::FileDescriptorProto(const FileDescriptorProto& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+FileDescriptorProto::FileDescriptorProto(FileDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void FileDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -1028,6 +1044,7 @@ bool FileDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.FileDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -1045,6 +1062,7 @@ bool FileDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_package:
+          input->BeginBytesField("google.protobuf.FileDescriptorProto.package");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_package()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -1062,6 +1080,7 @@ bool FileDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_dependency:
+          input->BeginBytesField("google.protobuf.FileDescriptorProto.dependency");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->add_dependency()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -1532,6 +1551,14 @@ DescriptorProto_ExtensionRange::DescriptorProto_ExtensionRange(const DescriptorP
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+DescriptorProto_ExtensionRange::DescriptorProto_ExtensionRange(DescriptorProto_ExtensionRange&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void DescriptorProto_ExtensionRange::SharedCtor() {
   _cached_size_ = 0;
   start_ = 0;
@@ -1785,6 +1812,14 @@ DescriptorProto::DescriptorProto(const DescriptorProto& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+DescriptorProto::DescriptorProto(DescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void DescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -1855,6 +1890,7 @@ bool DescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.DescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -2346,6 +2382,14 @@ FieldDescriptorProto::FieldDescriptorProto(const FieldDescriptorProto& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+FieldDescriptorProto::FieldDescriptorProto(FieldDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void FieldDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -2444,6 +2488,7 @@ bool FieldDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.FieldDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -2461,6 +2506,7 @@ bool FieldDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_extendee:
+          input->BeginBytesField("google.protobuf.FieldDescriptorProto.extendee");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_extendee()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -2536,6 +2582,7 @@ bool FieldDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_type_name:
+          input->BeginBytesField("google.protobuf.FieldDescriptorProto.type_name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_type_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -2553,6 +2600,7 @@ bool FieldDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_default_value:
+          input->BeginBytesField("google.protobuf.FieldDescriptorProto.default_value");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_default_value()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -2916,6 +2964,14 @@ EnumDescriptorProto::EnumDescriptorProto(const EnumDescriptorProto& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+EnumDescriptorProto::EnumDescriptorProto(EnumDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void EnumDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -2982,6 +3038,7 @@ bool EnumDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.EnumDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -3231,6 +3288,14 @@ EnumValueDescriptorProto::EnumValueDescriptorProto(const EnumValueDescriptorProt
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+EnumValueDescriptorProto::EnumValueDescriptorProto(EnumValueDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void EnumValueDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -3298,6 +3363,7 @@ bool EnumValueDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.EnumValueDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -3543,6 +3609,14 @@ ServiceDescriptorProto::ServiceDescriptorProto(const ServiceDescriptorProto& fro
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+ServiceDescriptorProto::ServiceDescriptorProto(ServiceDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void ServiceDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -3609,6 +3683,7 @@ bool ServiceDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.ServiceDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -3859,6 +3934,14 @@ MethodDescriptorProto::MethodDescriptorProto(const MethodDescriptorProto& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+MethodDescriptorProto::MethodDescriptorProto(MethodDescriptorProto&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void MethodDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -3942,6 +4025,7 @@ bool MethodDescriptorProto::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.MethodDescriptorProto.name");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -3959,6 +4043,7 @@ bool MethodDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_input_type:
+          input->BeginBytesField("google.protobuf.MethodDescriptorProto.input_type");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_input_type()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -3976,6 +4061,7 @@ bool MethodDescriptorProto::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_output_type:
+          input->BeginBytesField("google.protobuf.MethodDescriptorProto.output_type");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_output_type()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -4272,6 +4358,14 @@ FileOptions::FileOptions(const FileOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+FileOptions::FileOptions(FileOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void FileOptions::SharedCtor() {
   _cached_size_ = 0;
   java_package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -4355,6 +4449,7 @@ bool FileOptions::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.FileOptions.java_package");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_java_package()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -4372,6 +4467,7 @@ bool FileOptions::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_java_outer_classname:
+          input->BeginBytesField("google.protobuf.FileOptions.java_outer_classname");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_java_outer_classname()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -4845,6 +4941,14 @@ MessageOptions::MessageOptions(const MessageOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+MessageOptions::MessageOptions(MessageOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void MessageOptions::SharedCtor() {
   _cached_size_ = 0;
   message_set_wire_format_ = false;
@@ -5175,6 +5279,14 @@ FieldOptions::FieldOptions(const FieldOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+FieldOptions::FieldOptions(FieldOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void FieldOptions::SharedCtor() {
   _cached_size_ = 0;
   ctype_ = 0;
@@ -5296,6 +5408,7 @@ bool FieldOptions::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_experimental_map_key:
+          input->BeginBytesField("google.protobuf.FieldOptions.experimental_map_key");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_experimental_map_key()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -5579,6 +5692,14 @@ EnumOptions::EnumOptions(const EnumOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+EnumOptions::EnumOptions(EnumOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void EnumOptions::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -5803,6 +5924,14 @@ EnumValueOptions::EnumValueOptions(const EnumValueOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+EnumValueOptions::EnumValueOptions(EnumValueOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void EnumValueOptions::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -6027,6 +6156,14 @@ ServiceOptions::ServiceOptions(const ServiceOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+ServiceOptions::ServiceOptions(ServiceOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void ServiceOptions::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -6251,6 +6388,14 @@ MethodOptions::MethodOptions(const MethodOptions& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+MethodOptions::MethodOptions(MethodOptions&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void MethodOptions::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -6476,6 +6621,14 @@ UninterpretedOption_NamePart::UninterpretedOption_NamePart(const UninterpretedOp
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+UninterpretedOption_NamePart::UninterpretedOption_NamePart(UninterpretedOption_NamePart&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void UninterpretedOption_NamePart::SharedCtor() {
   _cached_size_ = 0;
   name_part_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -6538,6 +6691,7 @@ bool UninterpretedOption_NamePart::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("google.protobuf.UninterpretedOption.NamePart.name_part");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_name_part()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -6744,6 +6898,14 @@ UninterpretedOption::UninterpretedOption(const UninterpretedOption& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+UninterpretedOption::UninterpretedOption(UninterpretedOption&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void UninterpretedOption::SharedCtor() {
   _cached_size_ = 0;
   identifier_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
@@ -6845,6 +7007,7 @@ bool UninterpretedOption::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_identifier_value:
+          input->BeginBytesField("google.protobuf.UninterpretedOption.identifier_value");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_identifier_value()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -6910,6 +7073,7 @@ bool UninterpretedOption::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_string_value:
+          input->BeginBytesField("google.protobuf.UninterpretedOption.string_value");
           DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
                 input, this->mutable_string_value()));
         } else {
@@ -6924,6 +7088,7 @@ bool UninterpretedOption::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_aggregate_value:
+          input->BeginBytesField("google.protobuf.UninterpretedOption.aggregate_value");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_aggregate_value()));
           ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -7230,6 +7395,14 @@ SourceCodeInfo_Location::SourceCodeInfo_Location(const SourceCodeInfo_Location&
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+SourceCodeInfo_Location::SourceCodeInfo_Location(SourceCodeInfo_Location&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void SourceCodeInfo_Location::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -7518,6 +7691,14 @@ SourceCodeInfo::SourceCodeInfo(const SourceCodeInfo& from)
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+SourceCodeInfo::SourceCodeInfo(SourceCodeInfo&& from)
+  : ::google::protobuf::Message() {
+  SharedCtor();
+  Swap(&from);
+}
+#endif
+
 void SourceCodeInfo::SharedCtor() {
   _cached_size_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
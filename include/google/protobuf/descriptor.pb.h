@@ -163,6 +163,15 @@ class LIBPROTOBUF_EXPORT FileDescriptorSet : public ::google::protobuf::Message
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  FileDescriptorSet(FileDescriptorSet&& from);
+  
+  inline FileDescriptorSet& operator=(FileDescriptorSet&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -248,6 +257,15 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  FileDescriptorProto(FileDescriptorProto&& from);
+  
+  inline FileDescriptorProto& operator=(FileDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -298,8 +316,12 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // optional string package = 2;
   inline bool has_package() const;
@@ -309,8 +331,12 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline void set_package(const ::std::string& value);
   inline void set_package(const char* value);
   inline void set_package(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_package(::std::string&& value);
+  #endif
   inline ::std::string* mutable_package();
   inline ::std::string* release_package();
+  inline void set_allocated_package(::std::string* value);
   
   // repeated string dependency = 3;
   inline int dependency_size() const;
@@ -325,6 +351,10 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline void add_dependency(const ::std::string& value);
   inline void add_dependency(const char* value);
   inline void add_dependency(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_dependency(int index, ::std::string&& value);
+  inline void add_dependency(::std::string&& value);
+  #endif
   inline const ::google::protobuf::RepeatedPtrField< ::std::string>& dependency() const;
   inline ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_dependency();
   
@@ -383,6 +413,7 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline const ::google::protobuf::FileOptions& options() const;
   inline ::google::protobuf::FileOptions* mutable_options();
   inline ::google::protobuf::FileOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::FileOptions* options);
   
   // optional .google.protobuf.SourceCodeInfo source_code_info = 9;
   inline bool has_source_code_info() const;
@@ -391,6 +422,7 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline const ::google::protobuf::SourceCodeInfo& source_code_info() const;
   inline ::google::protobuf::SourceCodeInfo* mutable_source_code_info();
   inline ::google::protobuf::SourceCodeInfo* release_source_code_info();
+  inline void set_allocated_source_code_info(::google::protobuf::SourceCodeInfo* source_code_info);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.FileDescriptorProto)
  private:
@@ -439,6 +471,15 @@ class LIBPROTOBUF_EXPORT DescriptorProto_ExtensionRange : public ::google::proto
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  DescriptorProto_ExtensionRange(DescriptorProto_ExtensionRange&& from);
+  
+  inline DescriptorProto_ExtensionRange& operator=(DescriptorProto_ExtensionRange&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -531,6 +572,15 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  DescriptorProto(DescriptorProto&& from);
+  
+  inline DescriptorProto& operator=(DescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -583,8 +633,12 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // repeated .google.protobuf.FieldDescriptorProto field = 2;
   inline int field_size() const;
@@ -653,6 +707,7 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
   inline const ::google::protobuf::MessageOptions& options() const;
   inline ::google::protobuf::MessageOptions* mutable_options();
   inline ::google::protobuf::MessageOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::MessageOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.DescriptorProto)
  private:
@@ -695,6 +750,15 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  FieldDescriptorProto(FieldDescriptorProto&& from);
+  
+  inline FieldDescriptorProto& operator=(FieldDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -810,8 +874,12 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // optional int32 number = 3;
   inline bool has_number() const;
@@ -842,8 +910,12 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline void set_type_name(const ::std::string& value);
   inline void set_type_name(const char* value);
   inline void set_type_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_type_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_type_name();
   inline ::std::string* release_type_name();
+  inline void set_allocated_type_name(::std::string* value);
   
   // optional string extendee = 2;
   inline bool has_extendee() const;
@@ -853,8 +925,12 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline void set_extendee(const ::std::string& value);
   inline void set_extendee(const char* value);
   inline void set_extendee(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_extendee(::std::string&& value);
+  #endif
   inline ::std::string* mutable_extendee();
   inline ::std::string* release_extendee();
+  inline void set_allocated_extendee(::std::string* value);
   
   // optional string default_value = 7;
   inline bool has_default_value() const;
@@ -864,8 +940,12 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline void set_default_value(const ::std::string& value);
   inline void set_default_value(const char* value);
   inline void set_default_value(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_default_value(::std::string&& value);
+  #endif
   inline ::std::string* mutable_default_value();
   inline ::std::string* release_default_value();
+  inline void set_allocated_default_value(::std::string* value);
   
   // optional .google.protobuf.FieldOptions options = 8;
   inline bool has_options() const;
@@ -874,6 +954,7 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline const ::google::protobuf::FieldOptions& options() const;
   inline ::google::protobuf::FieldOptions* mutable_options();
   inline ::google::protobuf::FieldOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::FieldOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.FieldDescriptorProto)
  private:
@@ -929,6 +1010,15 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  EnumDescriptorProto(EnumDescriptorProto&& from);
+  
+  inline EnumDescriptorProto& operator=(EnumDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -979,8 +1069,12 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // repeated .google.protobuf.EnumValueDescriptorProto value = 2;
   inline int value_size() const;
@@ -1001,6 +1095,7 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
   inline const ::google::protobuf::EnumOptions& options() const;
   inline ::google::protobuf::EnumOptions* mutable_options();
   inline ::google::protobuf::EnumOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::EnumOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.EnumDescriptorProto)
  private:
@@ -1039,6 +1134,15 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  EnumValueDescriptorProto(EnumValueDescriptorProto&& from);
+  
+  inline EnumValueDescriptorProto& operator=(EnumValueDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1089,8 +1193,12 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // optional int32 number = 2;
   inline bool has_number() const;
@@ -1106,6 +1214,7 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
   inline const ::google::protobuf::EnumValueOptions& options() const;
   inline ::google::protobuf::EnumValueOptions* mutable_options();
   inline ::google::protobuf::EnumValueOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::EnumValueOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.EnumValueDescriptorProto)
  private:
@@ -1146,6 +1255,15 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  ServiceDescriptorProto(ServiceDescriptorProto&& from);
+  
+  inline ServiceDescriptorProto& operator=(ServiceDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1196,8 +1314,12 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // repeated .google.protobuf.MethodDescriptorProto method = 2;
   inline int method_size() const;
@@ -1218,6 +1340,7 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
   inline const ::google::protobuf::ServiceOptions& options() const;
   inline ::google::protobuf::ServiceOptions* mutable_options();
   inline ::google::protobuf::ServiceOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::ServiceOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.ServiceDescriptorProto)
  private:
@@ -1256,6 +1379,15 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  MethodDescriptorProto(MethodDescriptorProto&& from);
+  
+  inline MethodDescriptorProto& operator=(MethodDescriptorProto&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1306,8 +1438,12 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   inline void set_name(const ::std::string& value);
   inline void set_name(const char* value);
   inline void set_name(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
+  inline void set_allocated_name(::std::string* value);
   
   // optional string input_type = 2;
   inline bool has_input_type() const;
@@ -1317,8 +1453,12 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   inline void set_input_type(const ::std::string& value);
   inline void set_input_type(const char* value);
   inline void set_input_type(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_input_type(::std::string&& value);
+  #endif
   inline ::std::string* mutable_input_type();
   inline ::std::string* release_input_type();
+  inline void set_allocated_input_type(::std::string* value);
   
   // optional string output_type = 3;
   inline bool has_output_type() const;
@@ -1328,8 +1468,12 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   inline void set_output_type(const ::std::string& value);
   inline void set_output_type(const char* value);
   inline void set_output_type(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_output_type(::std::string&& value);
+  #endif
   inline ::std::string* mutable_output_type();
   inline ::std::string* release_output_type();
+  inline void set_allocated_output_type(::std::string* value);
   
   // optional .google.protobuf.MethodOptions options = 4;
   inline bool has_options() const;
@@ -1338,6 +1482,7 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   inline const ::google::protobuf::MethodOptions& options() const;
   inline ::google::protobuf::MethodOptions* mutable_options();
   inline ::google::protobuf::MethodOptions* release_options();
+  inline void set_allocated_options(::google::protobuf::MethodOptions* options);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.MethodDescriptorProto)
  private:
@@ -1381,6 +1526,15 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  FileOptions(FileOptions&& from);
+  
+  inline FileOptions& operator=(FileOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1456,8 +1610,12 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
   inline void set_java_package(const ::std::string& value);
   inline void set_java_package(const char* value);
   inline void set_java_package(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_java_package(::std::string&& value);
+  #endif
   inline ::std::string* mutable_java_package();
   inline ::std::string* release_java_package();
+  inline void set_allocated_java_package(::std::string* value);
   
   // optional string java_outer_classname = 8;
   inline bool has_java_outer_classname() const;
@@ -1467,8 +1625,12 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
   inline void set_java_outer_classname(const ::std::string& value);
   inline void set_java_outer_classname(const char* value);
   inline void set_java_outer_classname(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_java_outer_classname(::std::string&& value);
+  #endif
   inline ::std::string* mutable_java_outer_classname();
   inline ::std::string* release_java_outer_classname();
+  inline void set_allocated_java_outer_classname(::std::string* value);
   
   // optional bool java_multiple_files = 10 [default = false];
   inline bool has_java_multiple_files() const;
@@ -1582,6 +1744,15 @@ class LIBPROTOBUF_EXPORT MessageOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  MessageOptions(MessageOptions&& from);
+  
+  inline MessageOptions& operator=(MessageOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1690,6 +1861,15 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  FieldOptions(FieldOptions&& from);
+  
+  inline FieldOptions& operator=(FieldOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1786,8 +1966,12 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
   inline void set_experimental_map_key(const ::std::string& value);
   inline void set_experimental_map_key(const char* value);
   inline void set_experimental_map_key(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_experimental_map_key(::std::string&& value);
+  #endif
   inline ::std::string* mutable_experimental_map_key();
   inline ::std::string* release_experimental_map_key();
+  inline void set_allocated_experimental_map_key(::std::string* value);
   
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   inline int uninterpreted_option_size() const;
@@ -1847,6 +2031,15 @@ class LIBPROTOBUF_EXPORT EnumOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  EnumOptions(EnumOptions&& from);
+  
+  inline EnumOptions& operator=(EnumOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -1935,6 +2128,15 @@ class LIBPROTOBUF_EXPORT EnumValueOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  EnumValueOptions(EnumValueOptions&& from);
+  
+  inline EnumValueOptions& operator=(EnumValueOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2023,6 +2225,15 @@ class LIBPROTOBUF_EXPORT ServiceOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  ServiceOptions(ServiceOptions&& from);
+  
+  inline ServiceOptions& operator=(ServiceOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2111,6 +2322,15 @@ class LIBPROTOBUF_EXPORT MethodOptions : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  MethodOptions(MethodOptions&& from);
+  
+  inline MethodOptions& operator=(MethodOptions&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2199,6 +2419,15 @@ class LIBPROTOBUF_EXPORT UninterpretedOption_NamePart : public ::google::protobu
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  UninterpretedOption_NamePart(UninterpretedOption_NamePart&& from);
+  
+  inline UninterpretedOption_NamePart& operator=(UninterpretedOption_NamePart&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2249,8 +2478,12 @@ class LIBPROTOBUF_EXPORT UninterpretedOption_NamePart : public ::google::protobu
   inline void set_name_part(const ::std::string& value);
   inline void set_name_part(const char* value);
   inline void set_name_part(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_name_part(::std::string&& value);
+  #endif
   inline ::std::string* mutable_name_part();
   inline ::std::string* release_name_part();
+  inline void set_allocated_name_part(::std::string* value);
   
   // required bool is_extension = 2;
   inline bool has_is_extension() const;
@@ -2295,6 +2528,15 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  UninterpretedOption(UninterpretedOption&& from);
+  
+  inline UninterpretedOption& operator=(UninterpretedOption&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2359,8 +2601,12 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   inline void set_identifier_value(const ::std::string& value);
   inline void set_identifier_value(const char* value);
   inline void set_identifier_value(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_identifier_value(::std::string&& value);
+  #endif
   inline ::std::string* mutable_identifier_value();
   inline ::std::string* release_identifier_value();
+  inline void set_allocated_identifier_value(::std::string* value);
   
   // optional uint64 positive_int_value = 4;
   inline bool has_positive_int_value() const;
@@ -2391,8 +2637,12 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   inline void set_string_value(const ::std::string& value);
   inline void set_string_value(const char* value);
   inline void set_string_value(const void* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_string_value(::std::string&& value);
+  #endif
   inline ::std::string* mutable_string_value();
   inline ::std::string* release_string_value();
+  inline void set_allocated_string_value(::std::string* value);
   
   // optional string aggregate_value = 8;
   inline bool has_aggregate_value() const;
@@ -2402,8 +2652,12 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   inline void set_aggregate_value(const ::std::string& value);
   inline void set_aggregate_value(const char* value);
   inline void set_aggregate_value(const char* value, size_t size);
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_aggregate_value(::std::string&& value);
+  #endif
   inline ::std::string* mutable_aggregate_value();
   inline ::std::string* release_aggregate_value();
+  inline void set_allocated_aggregate_value(::std::string* value);
   
   // @@protoc_insertion_point(class_scope:google.protobuf.UninterpretedOption)
  private:
@@ -2454,6 +2708,15 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo_Location : public ::google::protobuf::Me
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  SourceCodeInfo_Location(SourceCodeInfo_Location&& from);
+  
+  inline SourceCodeInfo_Location& operator=(SourceCodeInfo_Location&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2554,6 +2817,15 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo : public ::google::protobuf::Message {
     return *this;
   }
   
+  #if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  SourceCodeInfo(SourceCodeInfo&& from);
+  
+  inline SourceCodeInfo& operator=(SourceCodeInfo&& from) {
+    Swap(&from);
+    return *this;
+  }
+  #endif
+  
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
@@ -2720,6 +2992,27 @@ inline ::std::string* FileDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FileDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void FileDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string package = 2;
 inline bool FileDescriptorProto::has_package() const {
@@ -2778,6 +3071,27 @@ inline ::std::string* FileDescriptorProto::release_package() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FileDescriptorProto::set_package(::std::string&& value) {
+  set_has_package();
+  if (package_ == &::google::protobuf::internal::kEmptyString) {
+    package_ = new ::std::string;
+  }
+  *package_ = ::std::move(value);
+}
+#endif
+inline void FileDescriptorProto::set_allocated_package(::std::string* value) {
+  if (package_ != &::google::protobuf::internal::kEmptyString) {
+    delete package_;
+  }
+  if (value != NULL) {
+    set_has_package();
+    package_ = value;
+  } else {
+    clear_has_package();
+    package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated string dependency = 3;
 inline int FileDescriptorProto::dependency_size() const {
@@ -2814,6 +3128,14 @@ inline void FileDescriptorProto::add_dependency(const char* value) {
 inline void FileDescriptorProto::add_dependency(const char* value, size_t size) {
   dependency_.Add()->assign(reinterpret_cast<const char*>(value), size);
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FileDescriptorProto::set_dependency(int index, ::std::string&& value) {
+  *dependency_.Mutable(index) = ::std::move(value);
+}
+inline void FileDescriptorProto::add_dependency(::std::string&& value) {
+  *dependency_.Add() = ::std::move(value);
+}
+#endif
 inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
 FileDescriptorProto::dependency() const {
   return dependency_;
@@ -2951,6 +3273,15 @@ inline ::google::protobuf::FileOptions* FileDescriptorProto::release_options() {
   options_ = NULL;
   return temp;
 }
+inline void FileDescriptorProto::set_allocated_options(::google::protobuf::FileOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // optional .google.protobuf.SourceCodeInfo source_code_info = 9;
 inline bool FileDescriptorProto::has_source_code_info() const {
@@ -2980,6 +3311,15 @@ inline ::google::protobuf::SourceCodeInfo* FileDescriptorProto::release_source_c
   source_code_info_ = NULL;
   return temp;
 }
+inline void FileDescriptorProto::set_allocated_source_code_info(::google::protobuf::SourceCodeInfo* source_code_info) {
+  delete source_code_info_;
+  source_code_info_ = source_code_info;
+  if (source_code_info != NULL) {
+    set_has_source_code_info();
+  } else {
+    clear_has_source_code_info();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3090,6 +3430,27 @@ inline ::std::string* DescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void DescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void DescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.FieldDescriptorProto field = 2;
 inline int DescriptorProto::field_size() const {
@@ -3244,6 +3605,15 @@ inline ::google::protobuf::MessageOptions* DescriptorProto::release_options() {
   options_ = NULL;
   return temp;
 }
+inline void DescriptorProto::set_allocated_options(::google::protobuf::MessageOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3306,6 +3676,27 @@ inline ::std::string* FieldDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FieldDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void FieldDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional int32 number = 3;
 inline bool FieldDescriptorProto::has_number() const {
@@ -3432,6 +3823,27 @@ inline ::std::string* FieldDescriptorProto::release_type_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FieldDescriptorProto::set_type_name(::std::string&& value) {
+  set_has_type_name();
+  if (type_name_ == &::google::protobuf::internal::kEmptyString) {
+    type_name_ = new ::std::string;
+  }
+  *type_name_ = ::std::move(value);
+}
+#endif
+inline void FieldDescriptorProto::set_allocated_type_name(::std::string* value) {
+  if (type_name_ != &::google::protobuf::internal::kEmptyString) {
+    delete type_name_;
+  }
+  if (value != NULL) {
+    set_has_type_name();
+    type_name_ = value;
+  } else {
+    clear_has_type_name();
+    type_name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string extendee = 2;
 inline bool FieldDescriptorProto::has_extendee() const {
@@ -3490,6 +3902,27 @@ inline ::std::string* FieldDescriptorProto::release_extendee() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FieldDescriptorProto::set_extendee(::std::string&& value) {
+  set_has_extendee();
+  if (extendee_ == &::google::protobuf::internal::kEmptyString) {
+    extendee_ = new ::std::string;
+  }
+  *extendee_ = ::std::move(value);
+}
+#endif
+inline void FieldDescriptorProto::set_allocated_extendee(::std::string* value) {
+  if (extendee_ != &::google::protobuf::internal::kEmptyString) {
+    delete extendee_;
+  }
+  if (value != NULL) {
+    set_has_extendee();
+    extendee_ = value;
+  } else {
+    clear_has_extendee();
+    extendee_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string default_value = 7;
 inline bool FieldDescriptorProto::has_default_value() const {
@@ -3548,6 +3981,27 @@ inline ::std::string* FieldDescriptorProto::release_default_value() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FieldDescriptorProto::set_default_value(::std::string&& value) {
+  set_has_default_value();
+  if (default_value_ == &::google::protobuf::internal::kEmptyString) {
+    default_value_ = new ::std::string;
+  }
+  *default_value_ = ::std::move(value);
+}
+#endif
+inline void FieldDescriptorProto::set_allocated_default_value(::std::string* value) {
+  if (default_value_ != &::google::protobuf::internal::kEmptyString) {
+    delete default_value_;
+  }
+  if (value != NULL) {
+    set_has_default_value();
+    default_value_ = value;
+  } else {
+    clear_has_default_value();
+    default_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional .google.protobuf.FieldOptions options = 8;
 inline bool FieldDescriptorProto::has_options() const {
@@ -3577,6 +4031,15 @@ inline ::google::protobuf::FieldOptions* FieldDescriptorProto::release_options()
   options_ = NULL;
   return temp;
 }
+inline void FieldDescriptorProto::set_allocated_options(::google::protobuf::FieldOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3639,6 +4102,27 @@ inline ::std::string* EnumDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void EnumDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void EnumDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.EnumValueDescriptorProto value = 2;
 inline int EnumDescriptorProto::value_size() const {
@@ -3693,6 +4177,15 @@ inline ::google::protobuf::EnumOptions* EnumDescriptorProto::release_options() {
   options_ = NULL;
   return temp;
 }
+inline void EnumDescriptorProto::set_allocated_options(::google::protobuf::EnumOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3755,6 +4248,27 @@ inline ::std::string* EnumValueDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void EnumValueDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void EnumValueDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional int32 number = 2;
 inline bool EnumValueDescriptorProto::has_number() const {
@@ -3806,6 +4320,15 @@ inline ::google::protobuf::EnumValueOptions* EnumValueDescriptorProto::release_o
   options_ = NULL;
   return temp;
 }
+inline void EnumValueDescriptorProto::set_allocated_options(::google::protobuf::EnumValueOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3868,6 +4391,27 @@ inline ::std::string* ServiceDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void ServiceDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void ServiceDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.MethodDescriptorProto method = 2;
 inline int ServiceDescriptorProto::method_size() const {
@@ -3922,6 +4466,15 @@ inline ::google::protobuf::ServiceOptions* ServiceDescriptorProto::release_optio
   options_ = NULL;
   return temp;
 }
+inline void ServiceDescriptorProto::set_allocated_options(::google::protobuf::ServiceOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -3984,6 +4537,27 @@ inline ::std::string* MethodDescriptorProto::release_name() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void MethodDescriptorProto::set_name(::std::string&& value) {
+  set_has_name();
+  if (name_ == &::google::protobuf::internal::kEmptyString) {
+    name_ = new ::std::string;
+  }
+  *name_ = ::std::move(value);
+}
+#endif
+inline void MethodDescriptorProto::set_allocated_name(::std::string* value) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (value != NULL) {
+    set_has_name();
+    name_ = value;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string input_type = 2;
 inline bool MethodDescriptorProto::has_input_type() const {
@@ -4042,6 +4616,27 @@ inline ::std::string* MethodDescriptorProto::release_input_type() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void MethodDescriptorProto::set_input_type(::std::string&& value) {
+  set_has_input_type();
+  if (input_type_ == &::google::protobuf::internal::kEmptyString) {
+    input_type_ = new ::std::string;
+  }
+  *input_type_ = ::std::move(value);
+}
+#endif
+inline void MethodDescriptorProto::set_allocated_input_type(::std::string* value) {
+  if (input_type_ != &::google::protobuf::internal::kEmptyString) {
+    delete input_type_;
+  }
+  if (value != NULL) {
+    set_has_input_type();
+    input_type_ = value;
+  } else {
+    clear_has_input_type();
+    input_type_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string output_type = 3;
 inline bool MethodDescriptorProto::has_output_type() const {
@@ -4100,6 +4695,27 @@ inline ::std::string* MethodDescriptorProto::release_output_type() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void MethodDescriptorProto::set_output_type(::std::string&& value) {
+  set_has_output_type();
+  if (output_type_ == &::google::protobuf::internal::kEmptyString) {
+    output_type_ = new ::std::string;
+  }
+  *output_type_ = ::std::move(value);
+}
+#endif
+inline void MethodDescriptorProto::set_allocated_output_type(::std::string* value) {
+  if (output_type_ != &::google::protobuf::internal::kEmptyString) {
+    delete output_type_;
+  }
+  if (value != NULL) {
+    set_has_output_type();
+    output_type_ = value;
+  } else {
+    clear_has_output_type();
+    output_type_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional .google.protobuf.MethodOptions options = 4;
 inline bool MethodDescriptorProto::has_options() const {
@@ -4129,6 +4745,15 @@ inline ::google::protobuf::MethodOptions* MethodDescriptorProto::release_options
   options_ = NULL;
   return temp;
 }
+inline void MethodDescriptorProto::set_allocated_options(::google::protobuf::MethodOptions* options) {
+  delete options_;
+  options_ = options;
+  if (options != NULL) {
+    set_has_options();
+  } else {
+    clear_has_options();
+  }
+}
 
 // -------------------------------------------------------------------
 
@@ -4191,6 +4816,27 @@ inline ::std::string* FileOptions::release_java_package() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FileOptions::set_java_package(::std::string&& value) {
+  set_has_java_package();
+  if (java_package_ == &::google::protobuf::internal::kEmptyString) {
+    java_package_ = new ::std::string;
+  }
+  *java_package_ = ::std::move(value);
+}
+#endif
+inline void FileOptions::set_allocated_java_package(::std::string* value) {
+  if (java_package_ != &::google::protobuf::internal::kEmptyString) {
+    delete java_package_;
+  }
+  if (value != NULL) {
+    set_has_java_package();
+    java_package_ = value;
+  } else {
+    clear_has_java_package();
+    java_package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string java_outer_classname = 8;
 inline bool FileOptions::has_java_outer_classname() const {
@@ -4249,6 +4895,27 @@ inline ::std::string* FileOptions::release_java_outer_classname() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FileOptions::set_java_outer_classname(::std::string&& value) {
+  set_has_java_outer_classname();
+  if (java_outer_classname_ == &::google::protobuf::internal::kEmptyString) {
+    java_outer_classname_ = new ::std::string;
+  }
+  *java_outer_classname_ = ::std::move(value);
+}
+#endif
+inline void FileOptions::set_allocated_java_outer_classname(::std::string* value) {
+  if (java_outer_classname_ != &::google::protobuf::internal::kEmptyString) {
+    delete java_outer_classname_;
+  }
+  if (value != NULL) {
+    set_has_java_outer_classname();
+    java_outer_classname_ = value;
+  } else {
+    clear_has_java_outer_classname();
+    java_outer_classname_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional bool java_multiple_files = 10 [default = false];
 inline bool FileOptions::has_java_multiple_files() const {
@@ -4609,6 +5276,27 @@ inline ::std::string* FieldOptions::release_experimental_map_key() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void FieldOptions::set_experimental_map_key(::std::string&& value) {
+  set_has_experimental_map_key();
+  if (experimental_map_key_ == &::google::protobuf::internal::kEmptyString) {
+    experimental_map_key_ = new ::std::string;
+  }
+  *experimental_map_key_ = ::std::move(value);
+}
+#endif
+inline void FieldOptions::set_allocated_experimental_map_key(::std::string* value) {
+  if (experimental_map_key_ != &::google::protobuf::internal::kEmptyString) {
+    delete experimental_map_key_;
+  }
+  if (value != NULL) {
+    set_has_experimental_map_key();
+    experimental_map_key_ = value;
+  } else {
+    clear_has_experimental_map_key();
+    experimental_map_key_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
 inline int FieldOptions::uninterpreted_option_size() const {
@@ -4812,6 +5500,27 @@ inline ::std::string* UninterpretedOption_NamePart::release_name_part() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void UninterpretedOption_NamePart::set_name_part(::std::string&& value) {
+  set_has_name_part();
+  if (name_part_ == &::google::protobuf::internal::kEmptyString) {
+    name_part_ = new ::std::string;
+  }
+  *name_part_ = ::std::move(value);
+}
+#endif
+inline void UninterpretedOption_NamePart::set_allocated_name_part(::std::string* value) {
+  if (name_part_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_part_;
+  }
+  if (value != NULL) {
+    set_has_name_part();
+    name_part_ = value;
+  } else {
+    clear_has_name_part();
+    name_part_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // required bool is_extension = 2;
 inline bool UninterpretedOption_NamePart::has_is_extension() const {
@@ -4921,6 +5630,27 @@ inline ::std::string* UninterpretedOption::release_identifier_value() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void UninterpretedOption::set_identifier_value(::std::string&& value) {
+  set_has_identifier_value();
+  if (identifier_value_ == &::google::protobuf::internal::kEmptyString) {
+    identifier_value_ = new ::std::string;
+  }
+  *identifier_value_ = ::std::move(value);
+}
+#endif
+inline void UninterpretedOption::set_allocated_identifier_value(::std::string* value) {
+  if (identifier_value_ != &::google::protobuf::internal::kEmptyString) {
+    delete identifier_value_;
+  }
+  if (value != NULL) {
+    set_has_identifier_value();
+    identifier_value_ = value;
+  } else {
+    clear_has_identifier_value();
+    identifier_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional uint64 positive_int_value = 4;
 inline bool UninterpretedOption::has_positive_int_value() const {
@@ -5045,6 +5775,27 @@ inline ::std::string* UninterpretedOption::release_string_value() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void UninterpretedOption::set_string_value(::std::string&& value) {
+  set_has_string_value();
+  if (string_value_ == &::google::protobuf::internal::kEmptyString) {
+    string_value_ = new ::std::string;
+  }
+  *string_value_ = ::std::move(value);
+}
+#endif
+inline void UninterpretedOption::set_allocated_string_value(::std::string* value) {
+  if (string_value_ != &::google::protobuf::internal::kEmptyString) {
+    delete string_value_;
+  }
+  if (value != NULL) {
+    set_has_string_value();
+    string_value_ = value;
+  } else {
+    clear_has_string_value();
+    string_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string aggregate_value = 8;
 inline bool UninterpretedOption::has_aggregate_value() const {
@@ -5103,6 +5854,27 @@ inline ::std::string* UninterpretedOption::release_aggregate_value() {
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void UninterpretedOption::set_aggregate_value(::std::string&& value) {
+  set_has_aggregate_value();
+  if (aggregate_value_ == &::google::protobuf::internal::kEmptyString) {
+    aggregate_value_ = new ::std::string;
+  }
+  *aggregate_value_ = ::std::move(value);
+}
+#endif
+inline void UninterpretedOption::set_allocated_aggregate_value(::std::string* value) {
+  if (aggregate_value_ != &::google::protobuf::internal::kEmptyString) {
+    delete aggregate_value_;
+  }
+  if (value != NULL) {
+    set_has_aggregate_value();
+    aggregate_value_ = value;
+  } else {
+    clear_has_aggregate_value();
+    aggregate_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // -------------------------------------------------------------------
 
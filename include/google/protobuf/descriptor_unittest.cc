@@ -3931,6 +3931,41 @@ TEST_F(DatabaseBackedPoolTest, UnittestProto) {
             file_from_database_proto.DebugString());
 }
 
+TEST_F(DatabaseBackedPoolTest, FindsLoadedDescriptorsAgain) {
+  // Once a file is built, lookups of what it defines don't take the mutex
+  // but read what the builder published.  unittest.proto and its import
+  // define enough symbols to grow those tables a few times.
+  DescriptorPoolDatabase database(*DescriptorPool::generated_pool());
+  CallCountingDatabase call_counter(&database);
+  DescriptorPool pool(&call_counter);
+  const FileDescriptor* file = pool.FindFileByName(
+    protobuf_unittest::TestAllTypes::descriptor()->file()->name());
+  ASSERT_TRUE(file != NULL);
+  call_counter.Clear();
+
+  EXPECT_EQ(file, pool.FindFileByName(file->name()));
+  for (int i = 0; i < file->dependency_count(); i++) {
+    EXPECT_EQ(file->dependency(i),
+              pool.FindFileByName(file->dependency(i)->name()));
+  }
+  for (int i = 0; i < file->message_type_count(); i++) {
+    const Descriptor* type = file->message_type(i);
+    EXPECT_EQ(type, pool.FindMessageTypeByName(type->full_name()));
+    EXPECT_EQ(file, pool.FindFileContainingSymbol(type->full_name()));
+    for (int j = 0; j < type->field_count(); j++) {
+      EXPECT_EQ(type->field(j),
+                pool.FindFieldByName(type->field(j)->full_name()));
+    }
+  }
+  for (int i = 0; i < file->extension_count(); i++) {
+    const FieldDescriptor* extension = file->extension(i);
+    EXPECT_EQ(extension, pool.FindExtensionByName(extension->full_name()));
+    EXPECT_EQ(extension, pool.FindExtensionByNumber(
+        extension->containing_type(), extension->number()));
+  }
+  EXPECT_EQ(0, call_counter.call_count_);
+}
+
 TEST_F(DatabaseBackedPoolTest, DoesntRetryDbUnnecessarily) {
   // Searching for a child of an existing descriptor should never fall back
   // to the DescriptorDatabase even if it isn't found, because we know all
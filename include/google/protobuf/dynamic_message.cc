@@ -37,7 +37,11 @@
 // Then, we use GeneratedMessageReflection to implement our reflection
 // interface.  All the other operations we need to implement (e.g.
 // parsing, copying, etc.) are already implemented in terms of
-// Reflection, so the rest is easy.
+// Reflection, so the rest is easy.  Parsing, being the hot path for
+// messages whose types are only known at run time, is the exception: it
+// goes through a ParseTable built from the same offsets (see
+// generated_message_table_driven.h), and only falls back to reflection for
+// the fields the table can't read.
 //
 // The up side of this strategy is that it's very efficient.  We don't
 // need to use hash_maps or generic representations of fields.  The
@@ -72,10 +76,12 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/generated_message_table_driven.h>
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite.h>
 
 namespace google {
 namespace protobuf {
@@ -83,6 +89,10 @@ namespace protobuf {
 using internal::WireFormat;
 using internal::ExtensionSet;
 using internal::GeneratedMessageReflection;
+using internal::ParseTable;
+using internal::ParseTableField;
+using internal::TableDrivenParser;
+using internal::WireFormatLite;
 
 
 // ===================================================================
@@ -157,6 +167,55 @@ inline int AlignOffset(int offset) {
 
 #define bitsizeof(T) (sizeof(T) * 8)
 
+// Returns the ParseTableField::type a DynamicMessage parses "field" with.
+// Strings are left to WireFormat::ParseAndMergeField() when it checks them
+// for UTF-8.
+uint8 ParseTableType(const FieldDescriptor* field) {
+  switch (field->type()) {
+#ifdef GOOGLE_PROTOBUF_UTF8_VALIDATION_ENABLED
+    case FieldDescriptor::TYPE_STRING:
+      return internal::kParseTableFallback;
+#endif
+    default:
+      return static_cast<uint8>(field->type());
+  }
+}
+
+// ParseTableEnum::is_valid_value; "values" is the EnumDescriptor.
+bool IsEnumValue(const void* values, int value) {
+  return static_cast<const EnumDescriptor*>(values)->
+      FindValueByNumber(value) != NULL;
+}
+
+bool CompareFieldNumbers(const FieldDescriptor* a, const FieldDescriptor* b) {
+  return a->number() < b->number();
+}
+
+bool FieldNumberLess(const FieldDescriptor* field, int number) {
+  return field->number() < number;
+}
+
+// Can an instance of "type", or of any message it contains, be missing a
+// required field?  Like the code generator's HasRequiredFields().
+bool HasRequiredFields(const Descriptor* type,
+                       hash_set<const Descriptor*>* already_seen) {
+  if (already_seen->count(type) > 0) return false;
+  already_seen->insert(type);
+
+  // An extension could have required fields.
+  if (type->extension_range_count() > 0) return true;
+
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    if (field->is_required()) return true;
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        HasRequiredFields(field->message_type(), already_seen)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 // ===================================================================
@@ -169,14 +228,39 @@ class DynamicMessage : public Message {
     int unknown_fields_offset;
     int extensions_offset;
 
+    // Whether IsInitialized() has anything to check.
+    bool has_required_fields;
+
+    // Indices of the fields that are more than a number: repeated fields,
+    // strings and messages.  Other instances than the prototype copy the
+    // rest from it, and only construct and destroy these.
+    scoped_array<int> managed_fields;
+    int managed_field_count;
+
     // Not owned by the TypeInfo.
     DynamicMessageFactory* factory;  // The factory that created this object.
     const DescriptorPool* pool;      // The factory's DescriptorPool.
     const Descriptor* type;          // Type of this DynamicMessage.
 
+    // What MergePartialFromCodedStream() parses with.  parse_table_fields
+    // is NULL for MessageSets, which are left to WireFormat.  Message and
+    // group fields point at their entry of parse_table_messages, indexed
+    // like offsets, which CrossLinkPrototypes() fills in, and enum fields at
+    // theirs in parse_table_enums.  fields_by_number holds the descriptor of
+    // each entry, for ParseFallback() to look fields up in.
+    scoped_array<ParseTableField> parse_table_fields;
+    scoped_array<internal::ParseTableMessage> parse_table_messages;
+    scoped_array<internal::ParseTableEnum> parse_table_enums;
+    scoped_array<const FieldDescriptor*> fields_by_number;
+    ParseTable parse_table;
+
     // Warning:  The order in which the following pointers are defined is
     //   important (the prototype must be deleted *before* the offsets).
     scoped_array<int> offsets;
+    // Where each field lives, indexed like offsets, for Clear() and for
+    // DynamicField and DynamicRepeatedField handles.  The reflection and
+    // message prototypes are filled in once they exist.
+    scoped_array<internal::DynamicFieldLayout> layouts;
     scoped_ptr<const GeneratedMessageReflection> reflection;
     scoped_ptr<const DynamicMessage> prototype;
   };
@@ -187,10 +271,17 @@ class DynamicMessage : public Message {
   // Called on the prototype after construction to initialize message fields.
   void CrossLinkPrototypes();
 
+  // Fills in type_info->parse_table once the offsets are known.
+  static void InitParseTable(TypeInfo* type_info);
+
   // implements Message ----------------------------------------------
 
   Message* New() const;
 
+  void Clear();
+  bool IsInitialized() const;
+  bool MergePartialFromCodedStream(io::CodedInputStream* input);
+
   int GetCachedSize() const;
   void SetCachedSize(int size) const;
 
@@ -199,6 +290,15 @@ class DynamicMessage : public Message {
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DynamicMessage);
 
+  // ParseTable::fallback: parses the fields InitParseTable() didn't give a
+  // type, extensions, and unknown fields.
+  static bool ParseFallback(MessageLite* msg, uint32 tag,
+                            io::CodedInputStream* input);
+
+  // ParseTableEnum::add_unknown: keeps the value in the UnknownFieldSet, as
+  // WireFormat does.
+  static void AddUnknownEnum(MessageLite* msg, int number, int value);
+
   inline bool is_prototype() const {
     return type_info_->prototype == this ||
            // If type_info_->prototype is NULL, then we must be constructing
@@ -215,12 +315,22 @@ class DynamicMessage : public Message {
 
   const TypeInfo* type_info_;
 
+  // Always NULL.  It is where the ParseTable looks for the arena to create
+  // strings on.
+  Arena* const arena_;
+
   // TODO(kenton):  Make this an atomic<int> when C++ supports it.
   mutable int cached_byte_size_;
 };
 
+struct DynamicMessageFactory::PrototypeMap {
+  typedef hash_map<const Descriptor*, const DynamicMessage::TypeInfo*> Map;
+  Map map_;
+};
+
 DynamicMessage::DynamicMessage(const TypeInfo* type_info)
   : type_info_(type_info),
+    arena_(NULL),
     cached_byte_size_(0) {
   // We need to call constructors for various fields manually and set
   // default values where appropriate.  We use placement new to call
@@ -233,13 +343,26 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
 
   const Descriptor* descriptor = type_info_->type;
 
+  // The prototype sets every field.  Other instances take the defaults from
+  // the prototype in one go and then only construct the managed fields.
+  const int* fields = NULL;
+  int field_count = descriptor->field_count();
+  if (!is_prototype()) {
+    memcpy(OffsetToPointer(type_info_->has_bits_offset),
+           type_info_->prototype->OffsetToPointer(type_info_->has_bits_offset),
+           type_info_->unknown_fields_offset - type_info_->has_bits_offset);
+    fields = type_info_->managed_fields.get();
+    field_count = type_info_->managed_field_count;
+  }
+
   new(OffsetToPointer(type_info_->unknown_fields_offset)) UnknownFieldSet;
 
   if (type_info_->extensions_offset != -1) {
     new(OffsetToPointer(type_info_->extensions_offset)) ExtensionSet;
   }
 
-  for (int i = 0; i < descriptor->field_count(); i++) {
+  for (int j = 0; j < field_count; j++) {
+    int i = (fields == NULL) ? j : fields[j];
     const FieldDescriptor* field = descriptor->field(i);
     void* field_ptr = OffsetToPointer(type_info_->offsets[i]);
     switch (field->cpp_type()) {
@@ -318,8 +441,9 @@ DynamicMessage::~DynamicMessage() {
   // Additionally, if any singular embedded messages have been allocated, we
   // need to delete them, UNLESS we are the prototype message of this type,
   // in which case any embedded messages are other prototypes and shouldn't
-  // be touched.
-  for (int i = 0; i < descriptor->field_count(); i++) {
+  // be touched.  Numbers need nothing, so only managed fields are visited.
+  for (int j = 0; j < type_info_->managed_field_count; j++) {
+    int i = type_info_->managed_fields[j];
     const FieldDescriptor* field = descriptor->field(i);
     void* field_ptr = OffsetToPointer(type_info_->offsets[i]);
 
@@ -399,15 +523,284 @@ void DynamicMessage::CrossLinkPrototypes() {
       *reinterpret_cast<const Message**>(field_ptr) =
         factory->GetPrototypeNoLock(field->message_type());
     }
+
+    // Handles and the parse table create sub-messages from the same
+    // prototypes.  The table parses them with their own table, if they are
+    // DynamicMessages that have one.
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      type_info_->layouts[i].default_value =
+        factory->GetPrototypeNoLock(field->message_type());
+      if (type_info_->parse_table_messages != NULL) {
+        internal::ParseTableMessage* aux =
+          &type_info_->parse_table_messages[i];
+        aux->prototype = factory->GetPrototypeNoLock(field->message_type());
+        DynamicMessageFactory::PrototypeMap::Map::const_iterator iter =
+          factory->prototypes_->map_.find(field->message_type());
+        if (iter != factory->prototypes_->map_.end() &&
+            iter->second->parse_table_fields != NULL) {
+          aux->table = &iter->second->parse_table;
+          aux->fixed_size =
+            internal::TableDrivenParser::FixedSize(*aux->table);
+        }
+      }
+    }
+  }
+}
+
+void DynamicMessage::InitParseTable(TypeInfo* type_info) {
+  const Descriptor* descriptor = type_info->type;
+  if (descriptor->options().message_set_wire_format()) return;
+
+  const FieldDescriptor** fields =
+      new const FieldDescriptor*[descriptor->field_count()];
+  type_info->fields_by_number.reset(fields);
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    fields[i] = descriptor->field(i);
   }
+  sort(fields, fields + descriptor->field_count(), CompareFieldNumbers);
+
+  ParseTableField* entries = new ParseTableField[descriptor->field_count()];
+  type_info->parse_table_fields.reset(entries);
+  internal::ParseTableMessage* messages =
+      new internal::ParseTableMessage[descriptor->field_count()];
+  type_info->parse_table_messages.reset(messages);
+  internal::ParseTableEnum* enums =
+      new internal::ParseTableEnum[descriptor->field_count()];
+  type_info->parse_table_enums.reset(enums);
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const FieldDescriptor* field = fields[i];
+    ParseTableField* entry = entries + i;
+    entry->tag = WireFormat::MakeTag(field);
+    entry->offset = type_info->offsets[field->index()];
+    entry->type = ParseTableType(field);
+    entry->aux = NULL;
+    entry->name = field->cpp_type() == FieldDescriptor::CPPTYPE_STRING
+                      ? field->full_name().c_str() : NULL;
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      messages[field->index()].create = NULL;
+      messages[field->index()].prototype = NULL;
+      messages[field->index()].table = NULL;
+      messages[field->index()].fixed_size = 0;
+      entry->aux = &messages[field->index()];
+    } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+      enums[field->index()].is_valid = NULL;
+      enums[field->index()].is_valid_value = &IsEnumValue;
+      enums[field->index()].values = field->enum_type();
+      enums[field->index()].add_unknown = &AddUnknownEnum;
+      entry->aux = &enums[field->index()];
+    }
+    if (field->is_repeated()) {
+      entry->has_bit = -1;
+      entry->flags = internal::kParseTableRepeated;
+      if (field->options().packed()) {
+        entry->flags |= internal::kParseTablePacked;
+      }
+    } else {
+      entry->has_bit = field->index();
+      entry->flags = 0;
+      if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+        // What the prototype's member points to, see the constructor.
+        entry->aux = &field->default_value_string();
+      }
+    }
+  }
+
+  ParseTable* table = &type_info->parse_table;
+  table->fields = entries;
+  table->field_count = descriptor->field_count();
+  table->has_bits_offset = type_info->has_bits_offset;
+  table->arena_offset = GOOGLE_PROTOBUF_PARSE_TABLE_OFFSET(DynamicMessage,
+                                                           arena_);
+  table->fallback = &ParseFallback;
+}
+
+bool DynamicMessage::ParseFallback(MessageLite* msg, uint32 tag,
+                                   io::CodedInputStream* input) {
+  // Like WireFormat::ParseAndMergePartial(), for a single field.
+  DynamicMessage* message = static_cast<DynamicMessage*>(msg);
+  const TypeInfo* type_info = message->type_info_;
+  const Descriptor* descriptor = type_info->type;
+  int field_number = WireFormatLite::GetTagFieldNumber(tag);
+  const FieldDescriptor* const* fields = type_info->fields_by_number.get();
+  const FieldDescriptor* const* end = fields + descriptor->field_count();
+  const FieldDescriptor* const* found =
+      lower_bound(fields, end, field_number, FieldNumberLess);
+  const FieldDescriptor* field = NULL;
+  if (found != end && (*found)->number() == field_number) {
+    field = *found;
+  } else if (descriptor->IsExtensionNumber(field_number)) {
+    if (input->GetExtensionPool() == NULL) {
+      field = type_info->reflection->FindKnownExtensionByNumber(field_number);
+    } else {
+      field = input->GetExtensionPool()->
+          FindExtensionByNumber(descriptor, field_number);
+    }
+  }
+  return WireFormat::ParseAndMergeField(tag, field, message, input);
+}
+
+void DynamicMessage::AddUnknownEnum(MessageLite* msg, int number,
+                                    int value) {
+  DynamicMessage* message = static_cast<DynamicMessage*>(msg);
+  reinterpret_cast<UnknownFieldSet*>(message->OffsetToPointer(
+      message->type_info_->unknown_fields_offset))->AddVarint(number, value);
 }
 
 Message* DynamicMessage::New() const {
+  // No need to clear the memory as for the prototype; the constructor
+  // copies the fields from it.
   void* new_base = reinterpret_cast<uint8*>(operator new(type_info_->size));
-  memset(new_base, 0, type_info_->size);
   return new(new_base) DynamicMessage(type_info_);
 }
 
+void DynamicMessage::Clear() {
+  // Like ReflectionOps::Clear(), but straight from the layouts instead of
+  // listing the set fields and clearing each through reflection: numbers get
+  // their defaults back from the prototype, strings and sub-messages are
+  // cleared in place and repeated fields emptied.
+  const Descriptor* descriptor = type_info_->type;
+  const internal::DynamicFieldLayout* layouts = type_info_->layouts.get();
+  const DynamicMessage* prototype = type_info_->prototype.get();
+  uint32* has_bits = reinterpret_cast<uint32*>(
+      OffsetToPointer(type_info_->has_bits_offset));
+  if (type_info_->managed_field_count == 0 &&
+      type_info_->extensions_offset == -1) {
+    // Only numbers: put back the prototype's has-bits and fields, as the
+    // constructor copies them.
+    memcpy(has_bits, prototype->OffsetToPointer(type_info_->has_bits_offset),
+           type_info_->unknown_fields_offset - type_info_->has_bits_offset);
+  } else {
+    for (int i = 0; i < descriptor->field_count(); i++) {
+      const FieldDescriptor* field = descriptor->field(i);
+      int offset = layouts[i].offset;
+      void* field_ptr = OffsetToPointer(offset);
+
+      if (field->is_repeated()) {
+        switch (field->cpp_type()) {
+#define HANDLE_TYPE(UPPERCASE, LOWERCASE)                                   \
+          case FieldDescriptor::CPPTYPE_##UPPERCASE :                         \
+            reinterpret_cast<RepeatedField<LOWERCASE>*>(field_ptr)->Clear();  \
+            break
+
+          HANDLE_TYPE( INT32,  int32);
+          HANDLE_TYPE( INT64,  int64);
+          HANDLE_TYPE(UINT32, uint32);
+          HANDLE_TYPE(UINT64, uint64);
+          HANDLE_TYPE(DOUBLE, double);
+          HANDLE_TYPE( FLOAT,  float);
+          HANDLE_TYPE(  BOOL,   bool);
+          HANDLE_TYPE(  ENUM,    int);
+#undef HANDLE_TYPE
+
+          case FieldDescriptor::CPPTYPE_STRING:
+            reinterpret_cast<RepeatedPtrField<string>*>(field_ptr)->Clear();
+            break;
+
+          case FieldDescriptor::CPPTYPE_MESSAGE:
+            reinterpret_cast<RepeatedPtrField<Message>*>(field_ptr)->Clear();
+            break;
+        }
+        continue;
+      }
+
+      if ((has_bits[i / bitsizeof(uint32)] &
+           (1u << (i % bitsizeof(uint32)))) == 0) {
+        continue;
+      }
+      switch (field->cpp_type()) {
+#define HANDLE_TYPE(UPPERCASE, LOWERCASE)                                   \
+        case FieldDescriptor::CPPTYPE_##UPPERCASE :                           \
+          *reinterpret_cast<LOWERCASE*>(field_ptr) =                          \
+              *reinterpret_cast<const LOWERCASE*>(                            \
+                  prototype->OffsetToPointer(offset));                        \
+          break
+
+        HANDLE_TYPE( INT32,  int32);
+        HANDLE_TYPE( INT64,  int64);
+        HANDLE_TYPE(UINT32, uint32);
+        HANDLE_TYPE(UINT64, uint64);
+        HANDLE_TYPE(DOUBLE, double);
+        HANDLE_TYPE( FLOAT,  float);
+        HANDLE_TYPE(  BOOL,   bool);
+        HANDLE_TYPE(  ENUM,    int);
+#undef HANDLE_TYPE
+
+        case FieldDescriptor::CPPTYPE_STRING: {
+          string* value = *reinterpret_cast<string**>(field_ptr);
+          if (value != layouts[i].default_value) {
+            if (field->has_default_value()) {
+              value->assign(field->default_value_string());
+            } else {
+              value->clear();
+            }
+          }
+          break;
+        }
+
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          (*reinterpret_cast<Message**>(field_ptr))->Clear();
+          break;
+      }
+    }
+    memset(has_bits, 0,
+           DivideRoundingUp(descriptor->field_count(), bitsizeof(uint32)) *
+           sizeof(uint32));
+  }
+
+  if (type_info_->extensions_offset != -1) {
+    reinterpret_cast<ExtensionSet*>(
+        OffsetToPointer(type_info_->extensions_offset))->Clear();
+  }
+  reinterpret_cast<UnknownFieldSet*>(
+      OffsetToPointer(type_info_->unknown_fields_offset))->Clear();
+}
+
+bool DynamicMessage::IsInitialized() const {
+  // Like ReflectionOps::IsInitialized(), but reading the has-bits and
+  // sub-messages directly instead of listing the set fields first.
+  if (!type_info_->has_required_fields) return true;
+
+  const Descriptor* descriptor = type_info_->type;
+  const uint32* has_bits = reinterpret_cast<const uint32*>(
+      OffsetToPointer(type_info_->has_bits_offset));
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    bool has = (has_bits[i / bitsizeof(uint32)] &
+                (1u << (i % bitsizeof(uint32)))) != 0;
+    if (field->is_required() && !has) return false;
+    if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) continue;
+
+    const void* field_ptr = OffsetToPointer(type_info_->offsets[i]);
+    if (field->is_repeated()) {
+      const RepeatedPtrField<Message>& repeated =
+          *reinterpret_cast<const RepeatedPtrField<Message>*>(field_ptr);
+      for (int j = 0; j < repeated.size(); j++) {
+        if (!repeated.Get(j).IsInitialized()) return false;
+      }
+    } else if (has) {
+      if (!(*reinterpret_cast<const Message* const*>(field_ptr))
+              ->IsInitialized()) {
+        return false;
+      }
+    }
+  }
+
+  if (type_info_->extensions_offset != -1) {
+    return reinterpret_cast<const ExtensionSet*>(
+        OffsetToPointer(type_info_->extensions_offset))->IsInitialized();
+  }
+  return true;
+}
+
+bool DynamicMessage::MergePartialFromCodedStream(
+    io::CodedInputStream* input) {
+  if (type_info_->parse_table_fields == NULL) {
+    return Message::MergePartialFromCodedStream(input);
+  }
+  return TableDrivenParser::MergePartialFromCodedStream(
+      this, type_info_->parse_table, input);
+}
+
 int DynamicMessage::GetCachedSize() const {
   return cached_byte_size_;
 }
@@ -428,11 +821,6 @@ Metadata DynamicMessage::GetMetadata() const {
 
 // ===================================================================
 
-struct DynamicMessageFactory::PrototypeMap {
-  typedef hash_map<const Descriptor*, const DynamicMessage::TypeInfo*> Map;
-  Map map_;
-};
-
 DynamicMessageFactory::DynamicMessageFactory()
   : pool_(NULL), delegate_to_generated_factory_(false),
     prototypes_(new PrototypeMap) {
@@ -511,12 +899,22 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   }
 
   // All the fields.
+  int* managed_fields = new int[type->field_count()];
+  type_info->managed_fields.reset(managed_fields);
+  type_info->managed_field_count = 0;
   for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
     // Make sure field is aligned to avoid bus errors.
-    int field_size = FieldSpaceUsed(type->field(i));
+    int field_size = FieldSpaceUsed(field);
     size = AlignTo(size, min(kSafeAlignment, field_size));
     offsets[i] = size;
     size += field_size;
+
+    if (field->is_repeated() ||
+        field->cpp_type() == FieldDescriptor::CPPTYPE_STRING ||
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      managed_fields[type_info->managed_field_count++] = i;
+    }
   }
 
   // Add the UnknownFieldSet to the end.
@@ -524,11 +922,30 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   type_info->unknown_fields_offset = size;
   size += sizeof(UnknownFieldSet);
 
+  internal::DynamicFieldLayout* layouts =
+    new internal::DynamicFieldLayout[type->field_count()];
+  type_info->layouts.reset(layouts);
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    layouts[i].offset = offsets[i];
+    layouts[i].has_bits_offset = type_info->has_bits_offset;
+    layouts[i].has_bit = field->is_repeated() ? -1 : i;
+    layouts[i].default_value =
+      (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING &&
+       !field->is_repeated()) ? &field->default_value_string() : NULL;
+    layouts[i].reflection = NULL;
+    layouts[i].field = field;
+  }
+
   // Align the final size to make sure no clever allocators think that
   // alignment is not necessary.
   size = AlignOffset(size);
   type_info->size = size;
 
+  hash_set<const Descriptor*> already_seen;
+  type_info->has_required_fields = HasRequiredFields(type, &already_seen);
+  DynamicMessage::InitParseTable(type_info);
+
   // Allocate the prototype.
   void* base = operator new(size);
   memset(base, 0, size);
@@ -547,6 +964,9 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
       type_info->pool,
       this,
       type_info->size));
+  for (int i = 0; i < type->field_count(); i++) {
+    layouts[i].reflection = type_info->reflection.get();
+  }
 
   // Cross link prototypes.
   prototype->CrossLinkPrototypes();
@@ -554,5 +974,90 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   return prototype;
 }
 
+const internal::DynamicFieldLayout* DynamicMessageFactory::GetFieldLayout(
+    const FieldDescriptor* field) {
+  GOOGLE_CHECK(!field->is_extension())
+      << "Extension " << field->full_name() << " has no field layout.";
+  const Descriptor* type = field->containing_type();
+  MutexLock lock(&prototypes_mutex_);
+  GetPrototypeNoLock(type);
+  PrototypeMap::Map::const_iterator iter = prototypes_->map_.find(type);
+  GOOGLE_CHECK(iter != prototypes_->map_.end())
+      << type->full_name() << " is built by the generated factory.";
+  return &iter->second->layouts[field->index()];
+}
+
+// -------------------------------------------------------------------
+
+namespace {
+
+// The FieldDescriptor::CppType that DynamicField<T> accesses.
+template <typename T> struct CppTypeOf;
+#define HANDLE_TYPE(TYPE, CPPTYPE)                                            \
+  template <> struct CppTypeOf<TYPE> {                                        \
+    static const FieldDescriptor::CppType kValue =                            \
+        FieldDescriptor::CPPTYPE_##CPPTYPE;                                   \
+  }
+
+HANDLE_TYPE(  int32,   INT32);
+HANDLE_TYPE(  int64,   INT64);
+HANDLE_TYPE( uint32,  UINT32);
+HANDLE_TYPE( uint64,  UINT64);
+HANDLE_TYPE( double,  DOUBLE);
+HANDLE_TYPE(  float,   FLOAT);
+HANDLE_TYPE(   bool,    BOOL);
+HANDLE_TYPE( string,  STRING);
+HANDLE_TYPE(Message, MESSAGE);
+#undef HANDLE_TYPE
+
+// Enums are stored as int32.
+template <typename T>
+bool HasCppType(const FieldDescriptor* field) {
+  return field->cpp_type() == CppTypeOf<T>::kValue ||
+         (CppTypeOf<T>::kValue == FieldDescriptor::CPPTYPE_INT32 &&
+          field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM);
+}
+
+}  // namespace
+
+template <typename T>
+DynamicField<T>::DynamicField(DynamicMessageFactory* factory,
+                              const FieldDescriptor* field)
+  : layout_(factory->GetFieldLayout(field)) {
+  GOOGLE_CHECK(!field->is_repeated() && HasCppType<T>(field))
+      << "DynamicField of the wrong type, or for repeated field "
+      << field->full_name() << ".";
+}
+
+template <typename T>
+DynamicRepeatedField<T>::DynamicRepeatedField(DynamicMessageFactory* factory,
+                                              const FieldDescriptor* field)
+  : layout_(factory->GetFieldLayout(field)) {
+  GOOGLE_CHECK(field->is_repeated() && HasCppType<T>(field))
+      << "DynamicRepeatedField of the wrong type, or for singular field "
+      << field->full_name() << ".";
+}
+
+// The handles DynamicMessage supports.
+template class DynamicField<int32>;
+template class DynamicField<int64>;
+template class DynamicField<uint32>;
+template class DynamicField<uint64>;
+template class DynamicField<double>;
+template class DynamicField<float>;
+template class DynamicField<bool>;
+template class DynamicField<string>;
+template class DynamicField<Message>;
+
+template class DynamicRepeatedField<int32>;
+template class DynamicRepeatedField<int64>;
+template class DynamicRepeatedField<uint32>;
+template class DynamicRepeatedField<uint64>;
+template class DynamicRepeatedField<double>;
+template class DynamicRepeatedField<float>;
+template class DynamicRepeatedField<bool>;
+template class DynamicRepeatedField<string>;
+template class DynamicRepeatedField<Message>;
+
 }  // namespace protobuf
 }  // namespace google
@@ -39,6 +39,7 @@
 #define GOOGLE_PROTOBUF_DYNAMIC_MESSAGE_H__
 
 #include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
 #include <google/protobuf/stubs/common.h>
 
 namespace google {
@@ -47,6 +48,26 @@ namespace protobuf {
 // Defined in other files.
 class Descriptor;        // descriptor.h
 class DescriptorPool;    // descriptor.h
+class FieldDescriptor;   // descriptor.h
+
+namespace internal {
+
+// Where a field lives in the DynamicMessages of its type.  DynamicField and
+// DynamicRepeatedField read and write fields through these.
+struct DynamicFieldLayout {
+  int offset;           // Of the field's member in the message.
+  int has_bits_offset;  // Of the message's has-bits.
+  int has_bit;          // The field's has-bit, or -1 if it is repeated.
+  // Singular strings: the default value, which the member points at while
+  // the field is unset.  Messages: the prototype of the field's type.
+  // Otherwise NULL.
+  const void* default_value;
+  // Of the messages the layout is for, to check handles against.
+  const Reflection* reflection;
+  const FieldDescriptor* field;
+};
+
+}  // namespace internal
 
 // Constructs implementations of Message which can emulate types which are not
 // known at compile-time.
@@ -111,6 +132,15 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   // The method is thread-safe.
   const Message* GetPrototype(const Descriptor* type);
 
+  // Returns where "field" lives in the DynamicMessages of its containing
+  // type, which must not be an extension nor a type GetPrototype() hands to
+  // the generated factory.  Use DynamicField and DynamicRepeatedField rather
+  // than calling this directly.  The layout belongs to the factory.
+  //
+  // The method is thread-safe.
+  const internal::DynamicFieldLayout* GetFieldLayout(
+      const FieldDescriptor* field);
+
  private:
   const DescriptorPool* pool_;
   bool delegate_to_generated_factory_;
@@ -130,6 +160,189 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DynamicMessageFactory);
 };
 
+namespace internal {
+
+// How DynamicField<T> and DynamicRepeatedField<T> store a T.  Numbers and
+// enums (as int32) are kept in the message.
+template <typename T>
+struct DynamicFieldTraits {
+  typedef T Member;
+  typedef RepeatedField<T> Repeated;
+  static const T& Get(const T& member, const void* /* default_value */) {
+    return member;
+  }
+  static T* Mutable(T* member, const void* /* default_value */) {
+    return member;
+  }
+  static void Set(T* value, const T& new_value) { *value = new_value; }
+  static T* Add(Repeated* repeated, Message* /* message */,
+                const DynamicFieldLayout* /* layout */) {
+    return repeated->Add();
+  }
+};
+
+// Strings point at the default value until they are first set.
+template <>
+struct DynamicFieldTraits<string> {
+  typedef string* Member;
+  typedef RepeatedPtrField<string> Repeated;
+  static const string& Get(string* member, const void* /* default_value */) {
+    return *member;
+  }
+  static string* Mutable(string** member, const void* default_value) {
+    if (*member == default_value) {
+      *member = new string(*static_cast<const string*>(default_value));
+    }
+    return *member;
+  }
+  static void Set(string* value, const string& new_value) {
+    value->assign(new_value);
+  }
+  static string* Add(Repeated* repeated, Message* /* message */,
+                     const DynamicFieldLayout* /* layout */) {
+    return repeated->Add();
+  }
+};
+
+// Messages are NULL until they are first set, and are created from the
+// prototype of their type.
+template <>
+struct DynamicFieldTraits<Message> {
+  typedef Message* Member;
+  typedef RepeatedPtrField<Message> Repeated;
+  static const Message& Get(const Message* member, const void* prototype) {
+    return member != NULL ? *member : *static_cast<const Message*>(prototype);
+  }
+  static Message* Mutable(Message** member, const void* prototype) {
+    if (*member == NULL) {
+      *member = static_cast<const Message*>(prototype)->New();
+    }
+    return *member;
+  }
+  static void Set(Message* value, const Message& new_value) {
+    value->CopyFrom(new_value);
+  }
+  // Reflection reuses cleared elements.
+  static Message* Add(Repeated* /* repeated */, Message* message,
+                      const DynamicFieldLayout* layout) {
+    return layout->reflection->AddMessage(message, layout->field);
+  }
+};
+
+template <typename T>
+inline T* DynamicFieldMember(Message* message,
+                             const DynamicFieldLayout* layout) {
+  GOOGLE_DCHECK(message->GetReflection() == layout->reflection);
+  return reinterpret_cast<T*>(
+      reinterpret_cast<char*>(message) + layout->offset);
+}
+
+template <typename T>
+inline const T& DynamicFieldMember(const Message& message,
+                                   const DynamicFieldLayout* layout) {
+  GOOGLE_DCHECK(message.GetReflection() == layout->reflection);
+  return *reinterpret_cast<const T*>(
+      reinterpret_cast<const char*>(&message) + layout->offset);
+}
+
+inline uint32* DynamicFieldHasWord(Message* message,
+                                   const DynamicFieldLayout* layout) {
+  return reinterpret_cast<uint32*>(
+      reinterpret_cast<char*>(message) + layout->has_bits_offset) +
+      layout->has_bit / 32;
+}
+
+inline const uint32* DynamicFieldHasWord(const Message& message,
+                                         const DynamicFieldLayout* layout) {
+  return reinterpret_cast<const uint32*>(
+      reinterpret_cast<const char*>(&message) + layout->has_bits_offset) +
+      layout->has_bit / 32;
+}
+
+}  // namespace internal
+
+// A singular field of the DynamicMessages a factory builds, looked up once.
+//
+// Reflection checks the field against the message and finds its offset on
+// every call.  A handle does both once, when it is made, and then reads and
+// writes the field's member directly, like a generated accessor:
+//
+//   DynamicField<int32> width(&factory, image->FindFieldByName("width"));
+//   for (int i = 0; i < images.size(); i++) {
+//     area += width.Get(*images[i]) * height.Get(*images[i]);
+//   }
+//
+// T is the field's C++ type: int32 (also for enums), int64, uint32, uint64,
+// float, double, bool, string or Message.  The constructor dies if the field
+// is of another type or repeated.  Messages passed to a handle must be
+// DynamicMessages of the field's containing type from the same factory;
+// debug builds check this.  Handles are cheap to copy and stay valid as
+// long as the factory.
+template <typename T>
+class DynamicField {
+ public:
+  DynamicField(DynamicMessageFactory* factory, const FieldDescriptor* field);
+
+  bool Has(const Message& message) const {
+    return (*internal::DynamicFieldHasWord(message, layout_) &
+            (1u << (layout_->has_bit % 32))) != 0;
+  }
+
+  // The field's value, or its default if it is not set.
+  const T& Get(const Message& message) const {
+    return Traits::Get(internal::DynamicFieldMember<typename Traits::Member>(
+                           message, layout_),
+                       layout_->default_value);
+  }
+
+  // Marks the field set and returns its value for changing.
+  T* Mutable(Message* message) const {
+    *internal::DynamicFieldHasWord(message, layout_) |=
+        1u << (layout_->has_bit % 32);
+    return Traits::Mutable(
+        internal::DynamicFieldMember<typename Traits::Member>(message,
+                                                              layout_),
+        layout_->default_value);
+  }
+
+  void Set(Message* message, const T& value) const {
+    Traits::Set(Mutable(message), value);
+  }
+
+ private:
+  typedef internal::DynamicFieldTraits<T> Traits;
+  const internal::DynamicFieldLayout* layout_;
+};
+
+// A repeated field of the DynamicMessages a factory builds, looked up once;
+// see DynamicField.  Numbers and enums (as int32) are RepeatedField<T>,
+// strings RepeatedPtrField<string> and messages RepeatedPtrField<Message>.
+template <typename T>
+class DynamicRepeatedField {
+ public:
+  typedef typename internal::DynamicFieldTraits<T>::Repeated Container;
+
+  DynamicRepeatedField(DynamicMessageFactory* factory,
+                       const FieldDescriptor* field);
+
+  const Container& Get(const Message& message) const {
+    return internal::DynamicFieldMember<Container>(message, layout_);
+  }
+
+  Container* Mutable(Message* message) const {
+    return internal::DynamicFieldMember<Container>(message, layout_);
+  }
+
+  // Appends an element, for messages a new one of the field's type.
+  T* Add(Message* message) const {
+    return Traits::Add(Mutable(message), message, layout_);
+  }
+
+ private:
+  typedef internal::DynamicFieldTraits<T> Traits;
+  const internal::DynamicFieldLayout* layout_;
+};
+
 }  // namespace protobuf
 
 }  // namespace google
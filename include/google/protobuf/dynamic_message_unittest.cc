@@ -38,7 +38,8 @@
 // GenericMessageReflection needs to use.  So, we focus on that in this
 // test.  Other tests, such as generic_message_reflection_unittest and
 // reflection_ops_unittest, cover the rest of the functionality used by
-// DynamicMessage.
+// DynamicMessage.  Parsing is the exception, as DynamicMessage does it
+// without reflection for most fields; the Parse tests below cover it.
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/dynamic_message.h>
@@ -46,6 +47,8 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/test_util.h>
 #include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include <google/protobuf/testing/googletest.h>
 #include <gtest/gtest.h>
@@ -158,5 +161,276 @@ TEST_F(DynamicMessageTest, SpaceUsed) {
   EXPECT_LT(initial_space_used, message->SpaceUsed());
 }
 
+TEST_F(DynamicMessageTest, Parse) {
+  unittest::TestAllTypes source;
+  TestUtil::SetAllFields(&source);
+  scoped_ptr<Message> message(prototype_->New());
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+  EXPECT_EQ(source.SerializeAsString(), message->SerializeAsString());
+
+  // Parsing again clears the message first.
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+
+  message->Clear();
+  reflection_tester.ExpectClearViaReflection(*message);
+  EXPECT_EQ(0, message->ByteSize());
+}
+
+TEST_F(DynamicMessageTest, ParseExtensions) {
+  unittest::TestAllExtensions source;
+  TestUtil::SetAllExtensions(&source);
+  scoped_ptr<Message> message(extensions_prototype_->New());
+  TestUtil::ReflectionTester reflection_tester(extensions_descriptor_);
+
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+}
+
+TEST_F(DynamicMessageTest, ParsePackedFields) {
+  scoped_ptr<Message> message(packed_prototype_->New());
+  TestUtil::ReflectionTester reflection_tester(packed_descriptor_);
+
+  unittest::TestPackedTypes packed;
+  TestUtil::SetPackedFields(&packed);
+  ASSERT_TRUE(message->ParseFromString(packed.SerializeAsString()));
+  reflection_tester.ExpectPackedFieldsSetViaReflection(*message);
+
+  // Packed fields must also accept values that aren't packed.
+  unittest::TestUnpackedTypes unpacked;
+  TestUtil::SetUnpackedFields(&unpacked);
+  ASSERT_TRUE(message->ParseFromString(unpacked.SerializeAsString()));
+  reflection_tester.ExpectPackedFieldsSetViaReflection(*message);
+}
+
+TEST_F(DynamicMessageTest, ParseUnknownFields) {
+  // An unknown value of optional_nested_enum, and a field TestAllTypes
+  // doesn't have.
+  unittest::TestAllTypes source;
+  source.mutable_unknown_fields()->AddVarint(21, 12345);
+  source.mutable_unknown_fields()->AddVarint(12345, 21);
+  scoped_ptr<Message> message(prototype_->New());
+
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  const Reflection* reflection = message->GetReflection();
+  EXPECT_FALSE(reflection->HasField(
+      *message, descriptor_->FindFieldByName("optional_nested_enum")));
+  EXPECT_EQ(2, reflection->GetUnknownFields(*message).field_count());
+  EXPECT_EQ(source.SerializeAsString(), message->SerializeAsString());
+}
+
+TEST_F(DynamicMessageTest, ParseUnknownPackedEnums) {
+  // A packed run of a valid and an unknown value of packed_enum.
+  unittest::TestPackedTypes source;
+  source.mutable_unknown_fields()->AddLengthDelimited(103, "\x04\xb9\x60");
+  scoped_ptr<Message> message(packed_prototype_->New());
+
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  const Reflection* reflection = message->GetReflection();
+  const FieldDescriptor* field =
+      packed_descriptor_->FindFieldByName("packed_enum");
+  ASSERT_EQ(1, reflection->FieldSize(*message, field));
+  EXPECT_EQ(unittest::FOREIGN_FOO,
+            reflection->GetRepeatedEnum(*message, field, 0)->number());
+  const UnknownFieldSet& unknown_fields =
+      reflection->GetUnknownFields(*message);
+  ASSERT_EQ(1, unknown_fields.field_count());
+  EXPECT_EQ(103, unknown_fields.field(0).number());
+  EXPECT_EQ(12345, unknown_fields.field(0).varint());
+}
+
+TEST_F(DynamicMessageTest, ParseFixedSizeMessages) {
+  // Messages of only fixed-width numbers are read straight from the buffer
+  // when they have every field once, in order, and parsed as usual when
+  // they don't.
+  FileDescriptorProto file;
+  file.set_name("points.proto");
+  DescriptorProto* point = file.add_message_type();
+  point->set_name("Point");
+  FieldDescriptorProto* x = point->add_field();
+  x->set_name("x");
+  x->set_number(1);
+  x->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  x->set_type(FieldDescriptorProto::TYPE_FLOAT);
+  FieldDescriptorProto* y = point->add_field();
+  y->set_name("y");
+  y->set_number(2);
+  y->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  y->set_type(FieldDescriptorProto::TYPE_DOUBLE);
+  DescriptorProto* shape = file.add_message_type();
+  shape->set_name("Shape");
+  FieldDescriptorProto* points = shape->add_field();
+  points->set_name("points");
+  points->set_number(1);
+  points->set_label(FieldDescriptorProto::LABEL_REPEATED);
+  points->set_type(FieldDescriptorProto::TYPE_MESSAGE);
+  points->set_type_name("Point");
+  ASSERT_TRUE(pool_.BuildFile(file) != NULL);
+
+  const Descriptor* shape_descriptor = pool_.FindMessageTypeByName("Shape");
+  const Descriptor* point_descriptor = pool_.FindMessageTypeByName("Point");
+  const FieldDescriptor* points_field =
+      shape_descriptor->FindFieldByName("points");
+  const FieldDescriptor* x_field = point_descriptor->FindFieldByName("x");
+  const FieldDescriptor* y_field = point_descriptor->FindFieldByName("y");
+  scoped_ptr<Message> source(factory_.GetPrototype(shape_descriptor)->New());
+  const Reflection* reflection = source->GetReflection();
+  Message* complete = reflection->AddMessage(source.get(), points_field);
+  complete->GetReflection()->SetFloat(complete, x_field, 1.5);
+  complete->GetReflection()->SetDouble(complete, y_field, -2.25);
+  Message* partial = reflection->AddMessage(source.get(), points_field);
+  partial->GetReflection()->SetDouble(partial, y_field, 3);
+  Message* unknown = reflection->AddMessage(source.get(), points_field);
+  unknown->GetReflection()->SetFloat(unknown, x_field, 4);
+  unknown->GetReflection()->SetDouble(unknown, y_field, 5);
+  unknown->GetReflection()->MutableUnknownFields(unknown)->AddFixed32(3, 6);
+
+  scoped_ptr<Message> message(source->New());
+  ASSERT_TRUE(message->ParseFromString(source->SerializeAsString()));
+  EXPECT_EQ(source->DebugString(), message->DebugString());
+  const Message& parsed_partial =
+      reflection->GetRepeatedMessage(*message, points_field, 1);
+  EXPECT_FALSE(
+      parsed_partial.GetReflection()->HasField(parsed_partial, x_field));
+
+  // Fields out of order.
+  string data;
+  data.push_back(internal::WireFormatLite::MakeTag(
+      1, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+  data.push_back(14);
+  data.push_back(internal::WireFormatLite::MakeTag(
+      2, internal::WireFormatLite::WIRETYPE_FIXED64));
+  data.append(8, '\0');
+  data.push_back(internal::WireFormatLite::MakeTag(
+      1, internal::WireFormatLite::WIRETYPE_FIXED32));
+  data.append(4, '\0');
+  ASSERT_TRUE(message->ParseFromString(data));
+  ASSERT_EQ(1, reflection->FieldSize(*message, points_field));
+  const Message& parsed =
+      reflection->GetRepeatedMessage(*message, points_field, 0);
+  EXPECT_TRUE(parsed.GetReflection()->HasField(parsed, x_field));
+  EXPECT_TRUE(parsed.GetReflection()->HasField(parsed, y_field));
+}
+
+TEST_F(DynamicMessageTest, FieldHandles) {
+  scoped_ptr<Message> message(prototype_->New());
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+  reflection_tester.SetAllFieldsViaReflection(message.get());
+
+  DynamicField<int32> optional_int32(
+      &factory_, descriptor_->FindFieldByName("optional_int32"));
+  DynamicField<double> optional_double(
+      &factory_, descriptor_->FindFieldByName("optional_double"));
+  DynamicField<int32> optional_nested_enum(
+      &factory_, descriptor_->FindFieldByName("optional_nested_enum"));
+  DynamicField<string> optional_string(
+      &factory_, descriptor_->FindFieldByName("optional_string"));
+  DynamicField<Message> optional_nested_message(
+      &factory_, descriptor_->FindFieldByName("optional_nested_message"));
+  DynamicRepeatedField<int64> repeated_int64(
+      &factory_, descriptor_->FindFieldByName("repeated_int64"));
+  DynamicRepeatedField<string> repeated_string(
+      &factory_, descriptor_->FindFieldByName("repeated_string"));
+  DynamicRepeatedField<Message> repeated_nested_message(
+      &factory_, descriptor_->FindFieldByName("repeated_nested_message"));
+
+  EXPECT_TRUE(optional_int32.Has(*message));
+  EXPECT_EQ(101, optional_int32.Get(*message));
+  EXPECT_EQ(112, optional_double.Get(*message));
+  EXPECT_EQ(unittest::TestAllTypes::BAZ, optional_nested_enum.Get(*message));
+  EXPECT_EQ("115", optional_string.Get(*message));
+  ASSERT_EQ(2, repeated_int64.Get(*message).size());
+  EXPECT_EQ(202, repeated_int64.Get(*message).Get(0));
+  EXPECT_EQ("215", repeated_string.Get(*message).Get(0));
+  EXPECT_EQ(2, repeated_nested_message.Get(*message).size());
+
+  optional_int32.Set(message.get(), 1);
+  optional_string.Set(message.get(), "2");
+  *repeated_int64.Add(message.get()) = 3;
+  repeated_string.Add(message.get())->assign("4");
+  Message* nested = repeated_nested_message.Add(message.get());
+  nested->GetReflection()->SetInt32(
+      nested, nested->GetDescriptor()->FindFieldByName("bb"), 5);
+
+  // The handles and reflection see the same members.
+  const Reflection* reflection = message->GetReflection();
+  EXPECT_EQ(1, reflection->GetInt32(
+      *message, descriptor_->FindFieldByName("optional_int32")));
+  EXPECT_EQ("2", reflection->GetString(
+      *message, descriptor_->FindFieldByName("optional_string")));
+  EXPECT_EQ(3, reflection->GetRepeatedInt64(
+      *message, descriptor_->FindFieldByName("repeated_int64"), 2));
+  EXPECT_EQ("4", reflection->GetRepeatedString(
+      *message, descriptor_->FindFieldByName("repeated_string"), 2));
+  const Message& added = reflection->GetRepeatedMessage(
+      *message, descriptor_->FindFieldByName("repeated_nested_message"), 2);
+  EXPECT_EQ(5, added.GetReflection()->GetInt32(
+      added, added.GetDescriptor()->FindFieldByName("bb")));
+
+  // Cleared fields read as their defaults, without being set.
+  message->Clear();
+  EXPECT_FALSE(optional_int32.Has(*message));
+  EXPECT_EQ(0, optional_int32.Get(*message));
+  EXPECT_EQ("", optional_string.Get(*message));
+  EXPECT_EQ(0, repeated_int64.Get(*message).size());
+  EXPECT_FALSE(optional_nested_message.Has(*message));
+  optional_nested_message.Mutable(message.get());
+  EXPECT_TRUE(optional_nested_message.Has(*message));
+
+  scoped_ptr<Message> empty(prototype_->New());
+  EXPECT_EQ(factory_.GetPrototype(
+                descriptor_->FindFieldByName("optional_nested_message")->
+                    message_type()),
+            &optional_nested_message.Get(*empty));
+
+  DynamicField<string> default_string(
+      &factory_, descriptor_->FindFieldByName("default_string"));
+  EXPECT_EQ("hello", default_string.Get(*message));
+  EXPECT_EQ("hello", *default_string.Mutable(message.get()));
+}
+
+#ifdef GTEST_HAS_DEATH_TEST
+TEST_F(DynamicMessageTest, FieldHandleTypes) {
+  const FieldDescriptor* optional_int32 =
+      descriptor_->FindFieldByName("optional_int32");
+  const FieldDescriptor* repeated_int32 =
+      descriptor_->FindFieldByName("repeated_int32");
+  EXPECT_DEATH(DynamicField<int64>(&factory_, optional_int32),
+               "optional_int32");
+  EXPECT_DEATH(DynamicField<int32>(&factory_, repeated_int32),
+               "repeated_int32");
+  EXPECT_DEATH(DynamicRepeatedField<int32>(&factory_, optional_int32),
+               "optional_int32");
+}
+#endif  // GTEST_HAS_DEATH_TEST
+
+TEST_F(DynamicMessageTest, IsInitialized) {
+  const Descriptor* descriptor =
+      pool_.FindMessageTypeByName("protobuf_unittest.TestRequiredForeign");
+  ASSERT_TRUE(descriptor != NULL);
+  scoped_ptr<Message> message(factory_.GetPrototype(descriptor)->New());
+  EXPECT_TRUE(message->IsInitialized());
+
+  unittest::TestRequiredForeign source;
+  source.add_repeated_message();
+  ASSERT_TRUE(
+      message->ParsePartialFromString(source.SerializePartialAsString()));
+  EXPECT_FALSE(message->IsInitialized());
+
+  source.mutable_repeated_message(0)->set_a(1);
+  source.mutable_repeated_message(0)->set_b(2);
+  source.mutable_repeated_message(0)->set_c(3);
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  EXPECT_TRUE(message->IsInitialized());
+
+  source.mutable_optional_message();
+  ASSERT_TRUE(
+      message->ParsePartialFromString(source.SerializePartialAsString()));
+  EXPECT_FALSE(message->IsInitialized());
+}
+
 }  // namespace protobuf
 }  // namespace google
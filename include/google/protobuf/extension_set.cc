@@ -1021,6 +1021,24 @@ void ExtensionSet::SerializeWithCachedSizes(
   }
 }
 
+void ExtensionSet::SerializeReverse(
+    int start_field_number, int end_field_number,
+    io::ReverseCodedOutputBuffer* output) const {
+  map<int, Extension>::const_iterator begin =
+      extensions_.lower_bound(start_field_number);
+  map<int, Extension>::const_iterator iter =
+      extensions_.lower_bound(end_field_number);
+  while (iter != begin) {
+    --iter;
+    // Extensions have no reverse writers of their own; each one is sized and
+    // then written forwards into the space reserved for it.
+    int size = iter->second.ByteSize(iter->first);
+    io::ArrayOutputStream array(output->Prepend(size), size);
+    io::CodedOutputStream coded_output(&array);
+    iter->second.SerializeFieldWithCachedSizes(iter->first, &coded_output);
+  }
+}
+
 void ExtensionSet::SerializeMessageSetWithCachedSizes(
     io::CodedOutputStream* output) const {
   map<int, Extension>::const_iterator iter;
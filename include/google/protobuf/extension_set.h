@@ -59,6 +59,7 @@ namespace protobuf {
   namespace io {
     class CodedInputStream;                              // coded_stream.h
     class CodedOutputStream;                             // coded_stream.h
+    class ReverseCodedOutputBuffer;                      // coded_stream.h
   }
   namespace internal {
     class FieldSkipper;                                  // wire_format_lite.h
@@ -361,6 +362,12 @@ class LIBPROTOBUF_EXPORT ExtensionSet {
                                          int end_field_number,
                                          uint8* target) const;
 
+  // Like SerializeWithCachedSizes, but prepends the extensions to "output"
+  // (see MessageLite::SerializeReverse()).  Does not need cached sizes.
+  void SerializeReverse(int start_field_number,
+                        int end_field_number,
+                        io::ReverseCodedOutputBuffer* output) const;
+
   // Like above but serializes in MessageSet format.
   void SerializeMessageSetWithCachedSizes(io::CodedOutputStream* output) const;
   uint8* SerializeMessageSetWithCachedSizesToArray(uint8* target) const;
@@ -0,0 +1,428 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/generated_message_table_driven.h>
+
+#include <string>
+
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/message_lite.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+template <typename Type>
+inline Type* Raw(char* base, uint32 offset) {
+  return reinterpret_cast<Type*>(base + offset);
+}
+
+inline void SetHasBit(char* base, const ParseTable& table, int has_bit) {
+  Raw<uint32>(base, table.has_bits_offset)[has_bit >> 5] |=
+      1u << (has_bit & 31);
+}
+
+template <typename CType, WireFormatLite::FieldType DeclaredType>
+inline bool ParseScalar(char* base, const ParseTable& table,
+                        const ParseTableField& field, bool packed,
+                        io::CodedInputStream* input) {
+  if (packed) {
+    return WireFormatLite::ReadPackedPrimitive<CType, DeclaredType>(
+        input, Raw<RepeatedField<CType> >(base, field.offset));
+  }
+  if (field.flags & kParseTableRepeated) {
+    CType value;
+    if (!WireFormatLite::ReadPrimitive<CType, DeclaredType>(input, &value)) {
+      return false;
+    }
+    Raw<RepeatedField<CType> >(base, field.offset)->Add(value);
+    return true;
+  }
+  SetHasBit(base, table, field.has_bit);
+  return WireFormatLite::ReadPrimitive<CType, DeclaredType>(
+      input, Raw<CType>(base, field.offset));
+}
+
+inline bool IsValidEnum(const ParseTableEnum& aux, int value) {
+  return aux.is_valid != NULL ? aux.is_valid(value)
+                              : aux.is_valid_value(aux.values, value);
+}
+
+// Adds "value" to the enum field "field" if it is valid, and otherwise
+// hands it to aux.add_unknown, if any.
+inline void AddEnum(MessageLite* msg, const ParseTable& table,
+                    const ParseTableField& field, uint32 tag, int value) {
+  const ParseTableEnum& aux = *static_cast<const ParseTableEnum*>(field.aux);
+  char* base = reinterpret_cast<char*>(msg);
+  if (IsValidEnum(aux, value)) {
+    if (field.flags & kParseTableRepeated) {
+      Raw<RepeatedField<int> >(base, field.offset)->Add(value);
+    } else {
+      *Raw<int>(base, field.offset) = value;
+      SetHasBit(base, table, field.has_bit);
+    }
+  } else if (aux.add_unknown != NULL) {
+    aux.add_unknown(msg, WireFormatLite::GetTagFieldNumber(tag), value);
+  }
+}
+
+inline bool IsFixed32(const ParseTableField& field) {
+  return field.type == WireFormatLite::TYPE_FLOAT ||
+         field.type == WireFormatLite::TYPE_FIXED32 ||
+         field.type == WireFormatLite::TYPE_SFIXED32;
+}
+
+inline bool IsFixed64(const ParseTableField& field) {
+  return field.type == WireFormatLite::TYPE_DOUBLE ||
+         field.type == WireFormatLite::TYPE_FIXED64 ||
+         field.type == WireFormatLite::TYPE_SFIXED64;
+}
+
+// Finds the entry for "number" once the predicted one turned out wrong.
+inline const ParseTableField* FindField(const ParseTable& table, int number) {
+  const ParseTableField* fields = table.fields;
+  // Most messages number their fields 1 to n, putting each at its index.
+  if (number > 0 && number <= table.field_count) {
+    const ParseTableField* field = fields + (number - 1);
+    if (WireFormatLite::GetTagFieldNumber(field->tag) == number) return field;
+  }
+  int low = 0;
+  int high = table.field_count;
+  while (low < high) {
+    int middle = (low + high) / 2;
+    int middle_number = WireFormatLite::GetTagFieldNumber(fields[middle].tag);
+    if (middle_number == number) return fields + middle;
+    if (middle_number < number) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return NULL;
+}
+
+// Reads a value of the type "table" describes that has each of its fields
+// once, in order, and nothing else, and so is "size" bytes long (see
+// ParseTableMessage::fixed_size), straight from the buffer, like the
+// ReadFlat() of generated flat types.  Returns false, having read nothing,
+// if the value isn't laid out like that or isn't all in the buffer.
+inline bool ReadFixed(MessageLite* msg, const ParseTable& table, int size,
+                      io::CodedInputStream* input) {
+  const void* data;
+  int buffer_size;
+  input->GetDirectBufferPointerInline(&data, &buffer_size);
+  if (buffer_size < size) return false;
+  const ParseTableField* end = table.fields + table.field_count;
+  const uint8* ptr = static_cast<const uint8*>(data);
+  for (const ParseTableField* field = table.fields; field != end; ++field) {
+    if (*ptr != field->tag) return false;
+    ptr += 1 + (IsFixed32(*field) ? sizeof(uint32) : sizeof(uint64));
+  }
+
+  char* base = reinterpret_cast<char*>(msg);
+  ptr = static_cast<const uint8*>(data);
+  for (const ParseTableField* field = table.fields; field != end; ++field) {
+    ++ptr;
+    if (IsFixed32(*field)) {
+      uint32 value;
+      ptr = io::CodedInputStream::ReadLittleEndian32FromArray(ptr, &value);
+      memcpy(base + field->offset, &value, sizeof(value));
+    } else {
+      uint64 value;
+      ptr = io::CodedInputStream::ReadLittleEndian64FromArray(ptr, &value);
+      memcpy(base + field->offset, &value, sizeof(value));
+    }
+    SetHasBit(base, table, field->has_bit);
+  }
+  return input->Skip(size);
+}
+
+// Is "tag" the other encoding of a packable repeated field, i.e. a packed run
+// of a field declared unpacked, or a single value of one declared packed?
+// Parsers must accept both.
+inline bool IsOtherEncoding(const ParseTableField& field, uint32 tag) {
+  if (!(field.flags & kParseTableRepeated)) return false;
+  WireFormatLite::FieldType type =
+      static_cast<WireFormatLite::FieldType>(field.type);
+  switch (static_cast<int>(type)) {
+    case kParseTableFallback:
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES:
+    case WireFormatLite::TYPE_MESSAGE:
+    case WireFormatLite::TYPE_GROUP:
+      return false;
+    default:
+      break;
+  }
+  WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+  if (field.flags & kParseTablePacked) {
+    return wire_type == WireFormatLite::WireTypeForFieldType(type);
+  } else {
+    return wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+  }
+}
+
+}  // namespace
+
+bool TableDrivenParser::ParseField(MessageLite* msg, const ParseTable& table,
+                                   const ParseTableField& field, uint32 tag,
+                                   bool packed, io::CodedInputStream* input) {
+  char* base = reinterpret_cast<char*>(msg);
+  switch (field.type) {
+    case kParseTableFallback:
+      return table.fallback(msg, tag, input);
+
+#define HANDLE_TYPE(TYPE, CPPTYPE)                                          \
+    case WireFormatLite::TYPE_##TYPE:                                       \
+      return ParseScalar<CPPTYPE, WireFormatLite::TYPE_##TYPE>(             \
+          base, table, field, packed, input);
+
+    HANDLE_TYPE( INT32,  int32)
+    HANDLE_TYPE( INT64,  int64)
+    HANDLE_TYPE(SINT32,  int32)
+    HANDLE_TYPE(SINT64,  int64)
+    HANDLE_TYPE(UINT32, uint32)
+    HANDLE_TYPE(UINT64, uint64)
+
+    HANDLE_TYPE( FIXED32, uint32)
+    HANDLE_TYPE( FIXED64, uint64)
+    HANDLE_TYPE(SFIXED32,  int32)
+    HANDLE_TYPE(SFIXED64,  int64)
+
+    HANDLE_TYPE(FLOAT , float )
+    HANDLE_TYPE(DOUBLE, double)
+
+    HANDLE_TYPE(BOOL, bool)
+#undef HANDLE_TYPE
+
+    case WireFormatLite::TYPE_ENUM: {
+      const ParseTableEnum* aux = static_cast<const ParseTableEnum*>(field.aux);
+      int value;
+      if (packed && aux->is_valid != NULL && aux->add_unknown == NULL) {
+        return WireFormatLite::ReadPackedEnumNoInline(
+            input, aux->is_valid, Raw<RepeatedField<int> >(base, field.offset));
+      }
+      if (packed) {
+        // Like ReadPackedEnumNoInline(), keeping the values it would drop.
+        uint32 length;
+        if (!input->ReadVarint32(&length)) return false;
+        io::CodedInputStream::Limit limit = input->PushLimit(length);
+        while (input->BytesUntilLimit() > 0) {
+          if (!WireFormatLite::ReadPrimitive<int, WireFormatLite::TYPE_ENUM>(
+                  input, &value)) {
+            return false;
+          }
+          AddEnum(msg, table, field, tag, value);
+        }
+        input->PopLimit(limit);
+        return true;
+      }
+      if (!WireFormatLite::ReadPrimitive<int, WireFormatLite::TYPE_ENUM>(
+              input, &value)) {
+        return false;
+      }
+      AddEnum(msg, table, field, tag, value);
+      return true;
+    }
+
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES: {
+      string* value;
+      if (field.flags & kParseTableRepeated) {
+        value = Raw<RepeatedPtrField<string> >(base, field.offset)->Add();
+      } else {
+        // Like the generated mutable_foo(), without copying a default value
+        // the read is about to replace.
+        string** member = Raw<string*>(base, field.offset);
+        const string* default_value = field.aux == NULL ? &kEmptyString :
+            static_cast<const string*>(field.aux);
+        if (*member == default_value) {
+          *member = Arena::Create<string>(
+              *Raw<Arena*>(base, table.arena_offset));
+        }
+        SetHasBit(base, table, field.has_bit);
+        value = *member;
+      }
+      // Lite strings are not checked for UTF-8, so strings read like bytes.
+      input->BeginBytesField(field.name);
+      return WireFormatLite::ReadBytes(input, value);
+    }
+
+    case WireFormatLite::TYPE_MESSAGE:
+    case WireFormatLite::TYPE_GROUP: {
+      const ParseTableMessage* aux =
+          static_cast<const ParseTableMessage*>(field.aux);
+      MessageLite* value;
+      if (field.flags & kParseTableRepeated) {
+        RepeatedPtrFieldBase* repeated =
+            Raw<RepeatedPtrFieldBase>(base, field.offset);
+        if (aux->create != NULL) {
+          value = repeated->
+              AddFromFactory<GenericTypeHandler<MessageLite> >(aux->create);
+        } else {
+          value = repeated->AddFromCleared<GenericTypeHandler<MessageLite> >();
+          if (value == NULL) {
+            value = aux->prototype->New();
+            repeated->AddAllocated<GenericTypeHandler<MessageLite> >(value);
+          }
+        }
+      } else {
+        MessageLite** member = Raw<MessageLite*>(base, field.offset);
+        if (*member == NULL) {
+          *member = aux->create != NULL ?
+              aux->create(*Raw<Arena*>(base, table.arena_offset)) :
+              aux->prototype->New();
+        }
+        SetHasBit(base, table, field.has_bit);
+        value = *member;
+      }
+      if (field.type == WireFormatLite::TYPE_GROUP) {
+        return WireFormatLite::ReadGroup(WireFormatLite::GetTagFieldNumber(tag),
+                                         input, value);
+      }
+      if (aux->table != NULL) {
+        // ReadMessage(), without the virtual call to get to the table.
+        uint32 length;
+        if (!input->ReadVarint32(&length)) return false;
+        if (aux->fixed_size != 0 && length == aux->fixed_size &&
+            ReadFixed(value, *aux->table, aux->fixed_size, input)) {
+          return true;
+        }
+        if (!input->CheckMessageLength(length)) return false;
+        if (!input->IncrementRecursionDepth()) return false;
+        io::CodedInputStream::Limit limit = input->PushLimit(length);
+        if (!MergePartialFromCodedStream(value, *aux->table, input)) {
+          return false;
+        }
+        if (!input->ConsumedEntireMessage()) return false;
+        input->PopLimit(limit);
+        input->DecrementRecursionDepth();
+        return true;
+      }
+      return WireFormatLite::ReadMessage(input, value);
+    }
+
+    default:
+      GOOGLE_LOG(DFATAL) << "Field type " << static_cast<int>(field.type)
+                         << " can't be parsed from a table.";
+      return false;
+  }
+}
+
+int TableDrivenParser::FixedSize(const ParseTable& table) {
+  int size = 0;
+  for (int i = 0; i < table.field_count; i++) {
+    const ParseTableField& field = table.fields[i];
+    // One-byte tags only, i.e. field numbers up to 15.
+    if (field.flags != 0 || field.tag >= 0x80) return 0;
+    if (IsFixed32(field)) {
+      size += 1 + sizeof(uint32);
+    } else if (IsFixed64(field)) {
+      size += 1 + sizeof(uint64);
+    } else {
+      return 0;
+    }
+  }
+  return size;
+}
+
+bool TableDrivenParser::MergePartialFromCodedStream(
+    MessageLite* msg, const ParseTable& table, io::CodedInputStream* input) {
+  const ParseTableField* end = table.fields + table.field_count;
+  // Fields are usually written in order of number, and repeated ones one
+  // element after another, so the next tag is predicted from the last one
+  // and checked with a single comparison, like the ExpectTag() chains of
+  // generated parsers.
+  const ParseTableField* next = table.fields;
+  uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    const ParseTableField* field = next;
+    bool packed;
+    if (GOOGLE_PREDICT_TRUE(field != end && field->tag == tag)) {
+      packed = (field->flags & kParseTablePacked) != 0;
+    } else {
+      field = FindField(table, WireFormatLite::GetTagFieldNumber(tag));
+      if (field != NULL && field->tag == tag) {
+        packed = (field->flags & kParseTablePacked) != 0;
+      } else if (field != NULL && IsOtherEncoding(*field, tag)) {
+        packed = WireFormatLite::GetTagWireType(tag) ==
+                 WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+      } else {
+        if (WireFormatLite::GetTagWireType(tag) ==
+            WireFormatLite::WIRETYPE_END_GROUP) {
+          return true;
+        }
+        if (table.fallback != NULL) {
+          if (!table.fallback(msg, tag, input)) return false;
+        } else {
+          if (!WireFormatLite::SkipField(input, tag)) return false;
+        }
+        continue;
+      }
+    }
+
+    // Singular fixed-width numbers, the bulk of small messages such as
+    // points, are read here rather than through the switch in ParseField().
+    if (field->flags == 0 && !packed && IsFixed32(*field)) {
+      char* base = reinterpret_cast<char*>(msg);
+      uint32 value;
+      if (!input->ReadLittleEndian32(&value)) return false;
+      memcpy(base + field->offset, &value, sizeof(value));
+      SetHasBit(base, table, field->has_bit);
+    } else if (field->flags == 0 && !packed && IsFixed64(*field)) {
+      char* base = reinterpret_cast<char*>(msg);
+      uint64 value;
+      if (!input->ReadLittleEndian64(&value)) return false;
+      memcpy(base + field->offset, &value, sizeof(value));
+      SetHasBit(base, table, field->has_bit);
+    } else if (!ParseField(msg, table, *field, tag, packed, input)) {
+      return false;
+    }
+
+    if (field->flags == kParseTableRepeated) {
+      next = field;
+    } else {
+      next = field + 1;
+      // After the last field, the message most likely ends, and checking for
+      // that here is cheaper than ReadTag() running into the limit.
+      if (next == end && input->ExpectAtEnd()) return true;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,187 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the parse tables that lite messages generated with
+// option (google.protobuf.cc_table_driven_parsing) describe themselves with,
+// and the shared loop that parses them.  DynamicMessage builds the same
+// tables at run time.  It is used by generated code and should not be used
+// directly by users.
+//
+// A table lists a message's fields in order of field number.  Most are read
+// straight into the message's members at the offsets the table gives; the
+// rest, extensions and unknown tags are handed to a fallback.  Generated
+// tables leave groups, [flat = true] and aliased fields to a small
+// generated one.
+
+#ifndef GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
+
+namespace google {
+namespace protobuf {
+  class MessageLite;             // message_lite.h
+  namespace io {
+    class CodedInputStream;      // coded_stream.h
+  }
+}
+
+namespace protobuf {
+namespace internal {
+
+// The offset of FIELD within TYPE.  offsetof() is not allowed on classes
+// with virtual methods, so this measures it on a fake object instead, like
+// GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET does.
+#define GOOGLE_PROTOBUF_PARSE_TABLE_OFFSET(TYPE, FIELD)               \
+  static_cast< ::google::protobuf::uint32>(                          \
+    reinterpret_cast<const char*>(                                   \
+      &reinterpret_cast<const TYPE*>(16)->FIELD) -                   \
+    reinterpret_cast<const char*>(16))
+
+// Values for ParseTableField::flags.
+enum {
+  kParseTableRepeated = 1,  // The member is a RepeatedField/RepeatedPtrField.
+  kParseTablePacked   = 2   // The field is declared [packed = true].
+};
+
+// ParseTableField::type of the fields ParseTable::fallback parses.
+enum {
+  kParseTableFallback = 0
+};
+
+struct ParseTableField {
+  uint32 tag;       // The expected tag, as WireFormat::MakeTag() gives it.
+  uint32 offset;    // Of the field's member in the message.
+  int16 has_bit;    // Index of the field's has-bit, or -1 if repeated.
+  uint8 type;       // The WireFormatLite::FieldType, or kParseTableFallback.
+  uint8 flags;      // kParseTableRepeated | kParseTablePacked.
+  // TYPE_STRING and TYPE_BYTES: the singular field's default value, or NULL
+  // if it is empty.  TYPE_ENUM: a ParseTableEnum.  TYPE_MESSAGE and
+  // TYPE_GROUP: a ParseTableMessage.  Otherwise NULL.
+  const void* aux;
+  // TYPE_STRING and TYPE_BYTES: the field's full name, which is passed to
+  // CodedInputStream::BeginBytesField().  Otherwise NULL.
+  const char* name;
+};
+
+struct ParseTableEnum {
+  // Whether "value" is one of the enum's.  Tables built at run time, which
+  // have no generated Foo_IsValid(), set this to NULL and is_valid_value
+  // and values instead.
+  bool (*is_valid)(int value);
+  bool (*is_valid_value)(const void* values, int value);
+  const void* values;
+  // Called with the values that aren't valid by messages that keep them
+  // (DynamicMessage, in its UnknownFieldSet).  NULL to drop them, like lite
+  // messages do.
+  void (*add_unknown)(MessageLite* msg, int number, int value);
+};
+
+struct ParseTable;
+
+struct ParseTableMessage {
+  // Arena::CreateMessage() for the field's type, or NULL if new values are
+  // prototype->New() instead.  Only messages without an arena may use a
+  // prototype, as DynamicMessage does.
+  MessageLite* (*create)(Arena* arena);
+  const MessageLite* prototype;
+  // The table of the field's type, if values are parsed with it directly
+  // rather than through their MergePartialFromCodedStream().  Else NULL.
+  const ParseTable* table;
+  // TableDrivenParser::FixedSize(*table), or 0.  Values of that size are
+  // read without pushing a limit when their fields are laid out in order.
+  uint32 fixed_size;
+};
+
+// The aux entries of enum and message fields.  Generated tables point at
+// ParseTableEnumOf<Foo_IsValid>::kAux and ParseTableMessageOf<Foo>::kAux.
+template <bool (*IsValid)(int)>
+struct ParseTableEnumOf {
+  static const ParseTableEnum kAux;
+};
+
+template <bool (*IsValid)(int)>
+const ParseTableEnum ParseTableEnumOf<IsValid>::kAux = {
+  IsValid, NULL, NULL, NULL
+};
+
+template <typename Type>
+struct ParseTableMessageOf {
+  static MessageLite* Create(Arena* arena) {
+    return Arena::CreateMessage<Type>(arena);
+  }
+  static const ParseTableMessage kAux;
+};
+
+template <typename Type>
+const ParseTableMessage ParseTableMessageOf<Type>::kAux = {
+  &ParseTableMessageOf<Type>::Create, NULL, NULL, 0
+};
+
+struct ParseTable {
+  const ParseTableField* fields;  // Sorted by field number.
+  int field_count;
+  uint32 has_bits_offset;         // Of the message's _has_bits_.
+  uint32 arena_offset;            // Of the message's arena_.
+  // Parses kParseTableFallback fields, extensions, and tags with no entry
+  // or an unexpected wire type.  NULL if there are no fallback fields or
+  // extensions, in which case other tags are skipped.
+  bool (*fallback)(MessageLite* msg, uint32 tag, io::CodedInputStream* input);
+};
+
+class LIBPROTOBUF_EXPORT TableDrivenParser {
+ public:
+  // Implements MergePartialFromCodedStream() for a message "table"
+  // describes.
+  static bool MergePartialFromCodedStream(MessageLite* msg,
+                                          const ParseTable& table,
+                                          io::CodedInputStream* input);
+
+  // If each field of the type "table" describes is a singular float, double
+  // or [s]fixed32/64 numbered 1 to 15, returns the size of a value that has
+  // all of them.  Otherwise returns 0.
+  static int FixedSize(const ParseTable& table);
+
+ private:
+  // Reads the value of "field" that "tag" starts into "msg".  "packed" says
+  // whether it is a packed run.
+  static bool ParseField(MessageLite* msg, const ParseTable& table,
+                         const ParseTableField& field, uint32 tag,
+                         bool packed, io::CodedInputStream* input);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TableDrivenParser);
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
@@ -52,7 +52,7 @@ namespace io {
 
 namespace {
 
-static const int kMaxVarintBytes = 10;
+static const int kMaxVarintBytes = CodedInputStream::kMaxVarintBytes;
 static const int kMaxVarint32Bytes = 5;
 
 
@@ -160,6 +160,30 @@ void CodedInputStream::PrintTotalBytesLimitError() {
                 "in google/protobuf/io/coded_stream.h.";
 }
 
+void CodedInputStream::PrintLengthLimitError(const char* setter,
+                                             uint32 length, int limit) {
+  GOOGLE_LOG(ERROR) << "A protocol message was rejected because a field in it "
+                "declared a length of " << length << " bytes, more than the "
+                "limit of " << limit << ".  To increase the limit, see "
+                "CodedInputStream::" << setter << "() in "
+                "google/protobuf/io/coded_stream.h.";
+}
+
+bool CodedInputStream::CheckFieldBytesLength(uint32 length) {
+  const char* field_name = bytes_field_name_;
+  bytes_field_name_ = NULL;
+  int limit = field_length_limit_func_(field_length_limit_context_,
+                                       field_name);
+  if (limit < 0) return CheckBytesLength(length);
+  if (length <= static_cast<uint32>(limit)) return true;
+  GOOGLE_LOG(ERROR) << "A protocol message was rejected because field "
+                    << field_name << " declared a length of " << length
+                    << " bytes, more than its limit of " << limit << ".  "
+                       "See CodedInputStream::SetFieldLengthLimitFunc() in "
+                       "google/protobuf/io/coded_stream.h.";
+  return false;
+}
+
 bool CodedInputStream::Skip(int count) {
   if (count < 0) return false;  // security: count is often user-supplied
 
@@ -232,6 +256,20 @@ bool CodedInputStream::ReadStringFallback(string* buffer, int size) {
     buffer->clear();
   }
 
+  // A string running past the current limit can never be read in full, so
+  // fail before copying any of it.  One that fits can be allocated up front,
+  // but the size comes from the input, and the limit may be far larger than
+  // the input is: don't reserve more than the total bytes limit lets us read.
+  int bytes_until_limit = BytesUntilLimit();
+  if (bytes_until_limit != -1) {
+    if (size > bytes_until_limit) return false;
+    int current_position = current_limit_ - bytes_until_limit;
+    int bytes_until_total_limit = total_bytes_limit_ - current_position;
+    if (bytes_until_total_limit > 0) {
+      buffer->reserve(min(size, bytes_until_total_limit));
+    }
+  }
+
   int current_buffer_size;
   while ((current_buffer_size = BufferSize()) < size) {
     // Some STL implementations "helpfully" crash on buffer->append(NULL, 0).
@@ -287,6 +325,8 @@ bool CodedInputStream::ReadLittleEndian64Fallback(uint64* value) {
   return true;
 }
 
+const int CodedInputStream::kMaxVarintBytes;
+
 namespace {
 
 inline const uint8* ReadVarint32FromArray(
@@ -331,10 +371,16 @@ bool CodedInputStream::ReadVarint32Slow(uint32* value) {
 }
 
 bool CodedInputStream::ReadVarint32Fallback(uint32* value) {
-  if (BufferSize() >= kMaxVarintBytes ||
-      // Optimization:  If the varint ends at exactly the end of the buffer,
-      // we can detect that and still use the fast path.
-      (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
+  if (BufferSize() >= kMaxVarintBytes) {
+    uint64 temp;
+    const uint8* end = ReadVarint64FromArray(buffer_, &temp);
+    if (end == NULL) return false;
+    *value = static_cast<uint32>(temp);
+    buffer_ = end;
+    return true;
+  } else if (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80)) {
+    // Optimization:  If the varint ends at exactly the end of the buffer,
+    // we can detect that and still avoid the per-byte bounds checks.
     const uint8* end = ReadVarint32FromArray(buffer_, value);
     if (end == NULL) return false;
     buffer_ = end;
@@ -374,10 +420,17 @@ uint32 CodedInputStream::ReadTagSlow() {
 }
 
 uint32 CodedInputStream::ReadTagFallback() {
-  if (BufferSize() >= kMaxVarintBytes ||
-      // Optimization:  If the varint ends at exactly the end of the buffer,
-      // we can detect that and still use the fast path.
-      (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
+  if (BufferSize() >= kMaxVarintBytes) {
+    uint64 tag;
+    const uint8* end = ReadVarint64FromArray(buffer_, &tag);
+    if (end == NULL) {
+      return 0;
+    }
+    buffer_ = end;
+    return static_cast<uint32>(tag);
+  } else if (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80)) {
+    // Optimization:  If the varint ends at exactly the end of the buffer,
+    // we can detect that and still avoid the per-byte bounds checks.
     uint32 tag;
     const uint8* end = ReadVarint32FromArray(buffer_, &tag);
     if (end == NULL) {
@@ -425,12 +478,14 @@ bool CodedInputStream::ReadVarint64Slow(uint64* value) {
 }
 
 bool CodedInputStream::ReadVarint64Fallback(uint64* value) {
-  if (BufferSize() >= kMaxVarintBytes ||
-      // Optimization:  If the varint ends at exactly the end of the buffer,
-      // we can detect that and still use the fast path.
-      (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
-    // Fast path:  We have enough bytes left in the buffer to guarantee that
-    // this read won't cross the end, so we can skip the checks.
+  if (BufferSize() >= kMaxVarintBytes) {
+    const uint8* end = ReadVarint64FromArray(buffer_, value);
+    if (end == NULL) return false;
+    buffer_ = end;
+    return true;
+  } else if (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80)) {
+    // Optimization:  If the varint ends at exactly the end of the buffer,
+    // we can detect that and still skip the per-byte bounds checks.
 
     const uint8* ptr = buffer_;
     uint32 b;
@@ -537,7 +592,8 @@ CodedOutputStream::CodedOutputStream(ZeroCopyOutputStream* output)
     buffer_(NULL),
     buffer_size_(0),
     total_bytes_(0),
-    had_error_(false) {
+    had_error_(false),
+    aliasing_enabled_(false) {
   // Eagerly Refresh() so buffer space is immediately available.
   Refresh();
   // The Refresh() may have failed. If the client doesn't write any data,
@@ -584,6 +640,28 @@ void CodedOutputStream::WriteRaw(const void* data, int size) {
   Advance(size);
 }
 
+void CodedOutputStream::WriteRawMaybeAliased(const void* data, int size) {
+  if (!aliasing_enabled_ || size <= buffer_size_) {
+    WriteRaw(data, size);
+    return;
+  }
+
+  // Return the unused part of the buffer first, so the stream sees the
+  // aliased bytes in the right place.
+  if (buffer_size_ > 0) {
+    output_->BackUp(buffer_size_);
+    total_bytes_ -= buffer_size_;
+    buffer_ = NULL;
+    buffer_size_ = 0;
+  }
+  total_bytes_ += size;
+  had_error_ |= !output_->WriteAliasedRaw(data, size);
+}
+
+void CodedOutputStream::EnableAliasing(bool enabled) {
+  aliasing_enabled_ = enabled && output_->AllowsAliasing();
+}
+
 uint8* CodedOutputStream::WriteRawToArray(
     const void* data, int size, uint8* target) {
   memcpy(target, data, size);
@@ -834,6 +912,62 @@ int CodedOutputStream::VarintSize64(uint64 value) {
   }
 }
 
+// ReverseCodedOutputBuffer ==========================================
+
+namespace {
+
+const int kDefaultReverseBufferSize = 4096;
+
+}  // namespace
+
+ReverseCodedOutputBuffer::ReverseCodedOutputBuffer(int initial_size)
+  : buffer_(NULL),
+    position_(NULL),
+    end_(NULL),
+    owned_(true) {
+  if (initial_size <= 0) initial_size = kDefaultReverseBufferSize;
+  buffer_ = new uint8[initial_size];
+  position_ = end_ = buffer_ + initial_size;
+}
+
+ReverseCodedOutputBuffer::ReverseCodedOutputBuffer(uint8* buffer, int size)
+  : buffer_(buffer),
+    position_(buffer + size),
+    end_(buffer + size),
+    owned_(false) {
+}
+
+ReverseCodedOutputBuffer::~ReverseCodedOutputBuffer() {
+  if (owned_) delete [] buffer_;
+}
+
+void ReverseCodedOutputBuffer::Grow(int size) {
+  int used = ByteCount();
+  int capacity = end_ - buffer_;
+  int new_capacity = std::max(capacity * 2, kDefaultReverseBufferSize);
+  if (new_capacity - used < size) new_capacity = used + size;
+
+  // The output stays at the end of the allocation.
+  uint8* new_buffer = new uint8[new_capacity];
+  uint8* new_end = new_buffer + new_capacity;
+  memcpy(new_end - used, position_, used);
+  if (owned_) delete [] buffer_;
+  owned_ = true;
+  buffer_ = new_buffer;
+  position_ = new_end - used;
+  end_ = new_end;
+}
+
+void ReverseCodedOutputBuffer::WriteRaw(const void* data, int size) {
+  memcpy(Prepend(size), data, size);
+}
+
+void ReverseCodedOutputBuffer::WriteVarint64(uint64 value) {
+  uint8 bytes[kMaxVarintBytes];
+  int size = CodedOutputStream::WriteVarint64ToArray(value, bytes) - bytes;
+  memcpy(Prepend(size), bytes, size);
+}
+
 }  // namespace io
 }  // namespace protobuf
 }  // namespace google
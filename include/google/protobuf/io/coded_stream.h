@@ -141,6 +141,7 @@ namespace io {
 // Defined in this file.
 class CodedInputStream;
 class CodedOutputStream;
+class ReverseCodedOutputBuffer;
 
 // Defined in other files.
 class ZeroCopyInputStream;           // zero_copy_stream.h
@@ -189,6 +190,12 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   inline void GetDirectBufferPointerInline(const void** data,
                                            int* size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Like above, but also sets *readable to how many bytes from *data may be
+  // looked at.  This counts the rest of the buffer beyond the current limit,
+  // so *readable >= *size; only the first *size bytes may be consumed.
+  inline void GetDirectBufferPointerInline(const void** data, int* size,
+                                           int* readable) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
   // Read raw bytes, copying them into the given buffer.
   bool ReadRaw(void* buffer, int size);
 
@@ -205,6 +212,21 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   inline bool InternalReadStringInline(string* buffer,
                                        int size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Allows fields declared with [ctype=STRING_PIECE] to be parsed as
+  // pointers into the input instead of being copied.  This only takes effect
+  // on streams that read from a flat array (see the constructor above); the
+  // caller must then keep that array alive and unmodified for as long as the
+  // parsed message refers to it.  Disabled by default.
+  void EnableAliasing(bool enabled) { aliasing_enabled_ = enabled; }
+  // True if EnableAliasing(true) was called and the stream reads from a flat
+  // array, i.e. ReadRawAliased() may be used.
+  bool AliasingEnabled() const { return aliasing_enabled_ && input_ == NULL; }
+
+  // Sets *data to point at the next "size" bytes of the input and skips past
+  // them, without copying.  Must only be called while AliasingEnabled().
+  // Returns false if fewer than "size" bytes remain before the current limit.
+  inline bool ReadRawAliased(const void** data, int size);
+
 
   // Read a 32-bit little-endian integer.
   bool ReadLittleEndian32(uint32* value);
@@ -227,6 +249,16 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Read an unsigned integer with Varint encoding.
   bool ReadVarint64(uint64* value);
 
+  // The longest a varint can be on the wire.
+  static const int kMaxVarintBytes = 10;
+
+  // Read a varint from an externally provided buffer, which must have at
+  // least kMaxVarintBytes readable bytes (they need not all belong to the
+  // varint).  Returns a pointer past the varint, or NULL if it is longer
+  // than kMaxVarintBytes.
+  static const uint8* ReadVarint64FromArray(const uint8* buffer,
+                                            uint64* value);
+
   // Read a tag.  This calls ReadVarint32() and returns the result, or returns
   // zero (which is not a valid tag) if ReadVarint32() fails.  Also, it updates
   // the last tag value, which can be checked with LastTagWas().
@@ -365,6 +397,44 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Decrements the recursion depth.
   void DecrementRecursionDepth();
 
+  // Length Limits ---------------------------------------------------
+  // The total bytes limit guards the input as a whole, which stops helping
+  // once legitimate inputs grow past any value that is safe to set it to.
+  // These limits bound the length prefix of each embedded message and of
+  // each string or bytes field instead, so a corrupt or malicious length is
+  // rejected as soon as it is read, before anything is allocated for it,
+  // however large the input as a whole is allowed to be.  Combine them with
+  // a generous SetTotalBytesLimit() to parse large inputs safely.
+
+  // Sets the largest length an embedded message may declare.  The default
+  // is INT_MAX, which leaves only the total bytes limit.
+  void SetMessageLengthLimit(int limit);
+
+  // Sets the largest length a string or bytes field may declare.  The
+  // default is INT_MAX.
+  void SetBytesLengthLimit(int limit);
+
+  // Returns true if an embedded message may declare a length of "length"
+  // bytes.  Otherwise logs an error and returns false, and the caller
+  // should fail the parse.
+  bool CheckMessageLength(uint32 length);
+
+  // Like CheckMessageLength(), for string and bytes fields.
+  bool CheckBytesLength(uint32 length);
+
+  // Gives individual string and bytes fields limits of their own.  Before
+  // reading such a field, generated code (and reflection) passes its full
+  // name, e.g. "pkg.Message.field", to BeginBytesField().  "func" is then
+  // asked for that field's limit, which the next CheckBytesLength() applies
+  // in place of SetBytesLengthLimit(); a negative result leaves the field
+  // to SetBytesLengthLimit().  Passing NULL removes the function.
+  typedef int (*FieldLengthLimitFunc)(void* context, const char* field_name);
+  void SetFieldLengthLimitFunc(FieldLengthLimitFunc func, void* context);
+
+  // Called with the full name of the string or bytes field about to be read.
+  // Does nothing unless SetFieldLengthLimitFunc() was called.
+  void BeginBytesField(const char* field_name);
+
   // Extension Registry ----------------------------------------------
   // ADVANCED USAGE:  99.9% of people can ignore this section.
   //
@@ -490,6 +560,16 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Recursion depth limit, set by SetRecursionLimit().
   int recursion_limit_;
 
+  // See SetMessageLengthLimit() and SetBytesLengthLimit().
+  int message_length_limit_;
+  int bytes_length_limit_;
+
+  // See SetFieldLengthLimitFunc().  bytes_field_name_ is the field passed to
+  // BeginBytesField() that CheckBytesLength() has not checked yet, or NULL.
+  FieldLengthLimitFunc field_length_limit_func_;
+  void* field_length_limit_context_;
+  const char* bytes_field_name_;
+
   // See SetExtensionRegistry().
   const DescriptorPool* extension_pool_;
   MessageFactory* extension_factory_;
@@ -509,6 +589,13 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Writes an error message saying that we hit total_bytes_limit_.
   void PrintTotalBytesLimitError();
 
+  // Writes an error message saying that a length prefix was over one of the
+  // length limits.  "setter" names the method that sets that limit.
+  void PrintLengthLimitError(const char* setter, uint32 length, int limit);
+
+  // CheckBytesLength() for the field named by BeginBytesField().
+  bool CheckFieldBytesLength(uint32 length);
+
   // Called when the buffer runs out to request more data.  Implies an
   // Advance(BufferSize()).
   bool Refresh();
@@ -522,6 +609,8 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // message crosses multiple buffers.
   bool ReadVarint32Fallback(uint32* value);
   bool ReadVarint64Fallback(uint64* value);
+  // Packs the low seven bits of each byte of "word" into the low 56 bits.
+  static uint64 PackVarintGroups(uint64 word);
   bool ReadVarint32Slow(uint32* value);
   bool ReadVarint64Slow(uint64* value);
   bool ReadLittleEndian32Fallback(uint32* value);
@@ -635,6 +724,18 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
   // Like WriteString()  but writing directly to the target array.
   static uint8* WriteStringToArray(const string& str, uint8* target);
 
+  // If aliasing is enabled (see EnableAliasing()), hands "data" to the
+  // underlying stream by reference rather than copying it, unless it fits
+  // in the current buffer anyway.  Otherwise equivalent to WriteRaw().
+  // Used for the payloads of bytes fields, which can be large.
+  void WriteRawMaybeAliased(const void* data, int size);
+
+  // Enables WriteRawMaybeAliased() to pass data by reference, if the
+  // underlying stream supports it (ZeroCopyOutputStream::AllowsAliasing()).
+  // The caller must then keep the message being serialized alive and
+  // unmodified until the stream has written out its data.
+  void EnableAliasing(bool enabled);
+
 
   // Write a 32-bit little-endian integer.
   void WriteLittleEndian32(uint32 value);
@@ -695,6 +796,7 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
   int buffer_size_;
   int total_bytes_;  // Sum of sizes of all buffers seen so far.
   bool had_error_;   // Whether an error occurred during output.
+  bool aliasing_enabled_;  // See EnableAliasing().
 
   // Advance the buffer by a given number of bytes.
   void Advance(int amount);
@@ -720,6 +822,58 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
   static int VarintSize32Fallback(uint32 value);
 };
 
+// Class which encodes data back to front into a growable buffer.  Writing a
+// message in reverse means each submessage is complete before its length
+// has to be written, so the length is simply the number of bytes written in
+// between and no ByteSize() pass over the tree is needed first.  See
+// MessageLite::SerializeReverse().
+//
+// Every Write*() method prepends its value to what has been written so far,
+// so fields, and each field's value and tag, must be written in reverse
+// order.  The buffer can be reused after Clear() without reallocating.
+class LIBPROTOBUF_EXPORT ReverseCodedOutputBuffer {
+ public:
+  // If an initial_size is given, that many bytes are allocated up front;
+  // otherwise the buffer starts small.  It doubles whenever it runs out.
+  explicit ReverseCodedOutputBuffer(int initial_size = -1);
+  // Writes into the caller's "buffer" until more than "size" bytes are
+  // needed, then moves to a heap allocation.  The buffer must outlive this
+  // object.
+  ReverseCodedOutputBuffer(uint8* buffer, int size);
+  ~ReverseCodedOutputBuffer();
+
+  // Makes room for "size" bytes in front of the output and returns a
+  // pointer to them, which the caller must fill in.
+  inline uint8* Prepend(int size);
+
+  // Like the CodedOutputStream methods of the same names, but prepending.
+  void WriteRaw(const void* data, int size);
+  inline void WriteVarint32(uint32 value);
+  inline void WriteVarint32SignExtended(int32 value);
+  void WriteVarint64(uint64 value);
+  inline void WriteLittleEndian32(uint32 value);
+  inline void WriteLittleEndian64(uint64 value);
+  inline void WriteTag(uint32 value);
+
+  // The output so far, which starts at data() and is contiguous.
+  const uint8* data() const { return position_; }
+  int ByteCount() const { return end_ - position_; }
+
+  // Discards the output, keeping the allocation.
+  void Clear() { position_ = end_; }
+
+ private:
+  // Reallocates so at least "size" more bytes can be prepended.
+  void Grow(int size);
+
+  uint8* buffer_;    // Start of the allocation.
+  uint8* position_;  // First byte of the output; space before it is free.
+  uint8* end_;       // End of the allocation and of the output.
+  bool owned_;       // Whether buffer_ was allocated by this object.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ReverseCodedOutputBuffer);
+};
+
 // inline methods ====================================================
 // The vast majority of varints are only one byte.  These inline
 // methods optimize for that case.
@@ -744,6 +898,63 @@ inline bool CodedInputStream::ReadVarint64(uint64* value) {
   }
 }
 
+// static
+inline uint64 CodedInputStream::PackVarintGroups(uint64 word) {
+  word &= GOOGLE_ULONGLONG(0x7f7f7f7f7f7f7f7f);
+  word = ((word & GOOGLE_ULONGLONG(0x7f007f007f007f00)) >> 1) |
+          (word & GOOGLE_ULONGLONG(0x007f007f007f007f));
+  word = ((word & GOOGLE_ULONGLONG(0x3fff00003fff0000)) >> 2) |
+          (word & GOOGLE_ULONGLONG(0x00003fff00003fff));
+  word = ((word & GOOGLE_ULONGLONG(0x0fffffff00000000)) >> 4) |
+          (word & GOOGLE_ULONGLONG(0x000000000fffffff));
+  return word;
+}
+
+// static
+inline const uint8* CodedInputStream::ReadVarint64FromArray(
+    const uint8* buffer,
+    uint64* value) {
+#if defined(PROTOBUF_LITTLE_ENDIAN) && defined(__GNUC__)
+  // Look at eight bytes at once instead of branching on each one: the varint
+  // ends at the lowest byte whose high bit is clear.
+  uint64 word;
+  memcpy(&word, buffer, sizeof(word));
+  uint64 stop_bits = ~word & GOOGLE_ULONGLONG(0x8080808080808080);
+  if (GOOGLE_PREDICT_TRUE(stop_bits != 0)) {
+    // stop_bits ^ (stop_bits - 1) keeps every bit up to the first stop bit.
+    *value = PackVarintGroups(word & (stop_bits ^ (stop_bits - 1)));
+    return buffer + ((__builtin_ctzll(stop_bits) + 1) >> 3);
+  }
+  uint64 result = PackVarintGroups(word);
+#else
+  uint64 result = 0;
+  for (int i = 0; i < 8; i++) {
+    uint32 b = buffer[i];
+    result |= static_cast<uint64>(b & 0x7F) << (7 * i);
+    if (!(b & 0x80)) {
+      *value = result;
+      return buffer + i + 1;
+    }
+  }
+#endif
+  // Nine or ten bytes; only the lowest bit of the tenth still fits.
+  uint32 b = buffer[8];
+  result |= static_cast<uint64>(b & 0x7F) << 56;
+  if (!(b & 0x80)) {
+    *value = result;
+    return buffer + 9;
+  }
+  b = buffer[9];
+  result |= static_cast<uint64>(b) << 63;
+  if (!(b & 0x80)) {
+    *value = result;
+    return buffer + 10;
+  }
+  // We have overrun the maximum size of a varint (10 bytes).  Assume
+  // the data is corrupt.
+  return NULL;
+}
+
 // static
 inline const uint8* CodedInputStream::ReadLittleEndian32FromArray(
     const uint8* buffer,
@@ -872,6 +1083,24 @@ inline void CodedInputStream::GetDirectBufferPointerInline(const void** data,
   *size = buffer_end_ - buffer_;
 }
 
+inline void CodedInputStream::GetDirectBufferPointerInline(const void** data,
+                                                           int* size,
+                                                           int* readable) {
+  *data = buffer_;
+  *size = buffer_end_ - buffer_;
+  *readable = *size + buffer_size_after_limit_;
+}
+
+inline bool CodedInputStream::ReadRawAliased(const void** data, int size) {
+  GOOGLE_DCHECK(AliasingEnabled());
+  // A flat array is one buffer clipped to the current limit, so anything
+  // that is not in it now never will be.
+  if (size < 0 || size > BufferSize()) return false;
+  *data = buffer_;
+  Advance(size);
+  return true;
+}
+
 inline bool CodedInputStream::ExpectAtEnd() {
   // If we are at a limit we know no more bytes can be read.  Otherwise, it's
   // hard to say without calling Refresh(), and we'd rather not do that.
@@ -1024,6 +1253,42 @@ inline void CodedInputStream::DecrementRecursionDepth() {
   if (recursion_depth_ > 0) --recursion_depth_;
 }
 
+inline void CodedInputStream::SetMessageLengthLimit(int limit) {
+  message_length_limit_ = limit;
+}
+
+inline void CodedInputStream::SetBytesLengthLimit(int limit) {
+  bytes_length_limit_ = limit;
+}
+
+inline bool CodedInputStream::CheckMessageLength(uint32 length) {
+  if (GOOGLE_PREDICT_TRUE(length <= static_cast<uint32>(message_length_limit_))) {
+    return true;
+  }
+  PrintLengthLimitError("SetMessageLengthLimit", length, message_length_limit_);
+  return false;
+}
+
+inline void CodedInputStream::SetFieldLengthLimitFunc(
+    FieldLengthLimitFunc func, void* context) {
+  field_length_limit_func_ = func;
+  field_length_limit_context_ = context;
+  bytes_field_name_ = NULL;
+}
+
+inline void CodedInputStream::BeginBytesField(const char* field_name) {
+  if (field_length_limit_func_ != NULL) bytes_field_name_ = field_name;
+}
+
+inline bool CodedInputStream::CheckBytesLength(uint32 length) {
+  if (bytes_field_name_ != NULL) return CheckFieldBytesLength(length);
+  if (GOOGLE_PREDICT_TRUE(length <= static_cast<uint32>(bytes_length_limit_))) {
+    return true;
+  }
+  PrintLengthLimitError("SetBytesLengthLimit", length, bytes_length_limit_);
+  return false;
+}
+
 inline void CodedInputStream::SetExtensionRegistry(DescriptorPool* pool,
                                                    MessageFactory* factory) {
   extension_pool_ = pool;
@@ -1057,6 +1322,11 @@ inline CodedInputStream::CodedInputStream(ZeroCopyInputStream* input)
     total_bytes_warning_threshold_(kDefaultTotalBytesWarningThreshold),
     recursion_depth_(0),
     recursion_limit_(kDefaultRecursionLimit),
+    message_length_limit_(kint32max),
+    bytes_length_limit_(kint32max),
+    field_length_limit_func_(NULL),
+    field_length_limit_context_(NULL),
+    bytes_field_name_(NULL),
     extension_pool_(NULL),
     extension_factory_(NULL) {
   // Eagerly Refresh() so buffer space is immediately available.
@@ -1078,6 +1348,11 @@ inline CodedInputStream::CodedInputStream(const uint8* buffer, int size)
     total_bytes_warning_threshold_(kDefaultTotalBytesWarningThreshold),
     recursion_depth_(0),
     recursion_limit_(kDefaultRecursionLimit),
+    message_length_limit_(kint32max),
+    bytes_length_limit_(kint32max),
+    field_length_limit_func_(NULL),
+    field_length_limit_context_(NULL),
+    bytes_field_name_(NULL),
     extension_pool_(NULL),
     extension_factory_(NULL) {
   // Note that setting current_limit_ == size is important to prevent some
@@ -1090,6 +1365,41 @@ inline CodedInputStream::~CodedInputStream() {
   }
 }
 
+inline uint8* ReverseCodedOutputBuffer::Prepend(int size) {
+  if (position_ - buffer_ < size) Grow(size);
+  position_ -= size;
+  return position_;
+}
+
+inline void ReverseCodedOutputBuffer::WriteVarint32(uint32 value) {
+  if (GOOGLE_PREDICT_TRUE(value < 0x80 && position_ > buffer_)) {
+    *--position_ = static_cast<uint8>(value);
+  } else {
+    CodedOutputStream::WriteVarint32ToArray(
+        value, Prepend(CodedOutputStream::VarintSize32(value)));
+  }
+}
+
+inline void ReverseCodedOutputBuffer::WriteVarint32SignExtended(int32 value) {
+  if (value < 0) {
+    WriteVarint64(static_cast<uint64>(value));
+  } else {
+    WriteVarint32(static_cast<uint32>(value));
+  }
+}
+
+inline void ReverseCodedOutputBuffer::WriteLittleEndian32(uint32 value) {
+  CodedOutputStream::WriteLittleEndian32ToArray(value, Prepend(sizeof(value)));
+}
+
+inline void ReverseCodedOutputBuffer::WriteLittleEndian64(uint64 value) {
+  CodedOutputStream::WriteLittleEndian64ToArray(value, Prepend(sizeof(value)));
+}
+
+inline void ReverseCodedOutputBuffer::WriteTag(uint32 value) {
+  WriteVarint32(value);
+}
+
 }  // namespace io
 }  // namespace protobuf
 
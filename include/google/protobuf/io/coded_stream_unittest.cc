@@ -302,6 +302,25 @@ TEST_2D(CodedStreamTest, ReadVarint64, kVarintCases, kBlockSizes) {
   EXPECT_EQ(kVarintCases_case.size, input.ByteCount());
 }
 
+TEST_1D(CodedStreamTest, ReadVarint64FromArray, kVarintCases) {
+  // The bytes after the varint look like continuation bytes; they must not
+  // leak into the value.
+  memset(buffer_, 0xff, CodedInputStream::kMaxVarintBytes * 2);
+  memcpy(buffer_, kVarintCases_case.bytes, kVarintCases_case.size);
+
+  uint64 value;
+  const uint8* end = CodedInputStream::ReadVarint64FromArray(buffer_, &value);
+  EXPECT_TRUE(end == buffer_ + kVarintCases_case.size);
+  EXPECT_EQ(kVarintCases_case.value, value);
+}
+
+TEST_F(CodedStreamTest, ReadVarint64FromArrayOverlong) {
+  memset(buffer_, 0x80, CodedInputStream::kMaxVarintBytes + 1);
+
+  uint64 value;
+  EXPECT_TRUE(CodedInputStream::ReadVarint64FromArray(buffer_, &value) == NULL);
+}
+
 TEST_2D(CodedStreamTest, WriteVarint32, kVarintCases, kBlockSizes) {
   if (kVarintCases_case.value > ULL(0x00000000FFFFFFFF)) {
     // Skip this test for the 64-bit values.
@@ -676,6 +695,35 @@ TEST_F(CodedStreamTest, ReadStringImpossiblyLargeFromStringOnHeap) {
   EXPECT_FALSE(coded_input.ReadString(&str, 1 << 30));
 }
 
+TEST_F(CodedStreamTest, ReadRawAliased) {
+  memcpy(buffer_, kRawBytes, sizeof(kRawBytes));
+  CodedInputStream coded_input(buffer_, sizeof(kRawBytes));
+  EXPECT_FALSE(coded_input.AliasingEnabled());
+  coded_input.EnableAliasing(true);
+  EXPECT_TRUE(coded_input.AliasingEnabled());
+
+  const void* data;
+  EXPECT_TRUE(coded_input.ReadRawAliased(&data, 4));
+  EXPECT_EQ(buffer_, data);
+  EXPECT_TRUE(coded_input.ReadRawAliased(&data, 5));
+  EXPECT_EQ(buffer_ + 4, data);
+
+  // Never reads past the current limit.
+  CodedInputStream::Limit limit = coded_input.PushLimit(3);
+  EXPECT_FALSE(coded_input.ReadRawAliased(&data, 4));
+  EXPECT_TRUE(coded_input.ReadRawAliased(&data, 3));
+  coded_input.PopLimit(limit);
+  EXPECT_FALSE(coded_input.ReadRawAliased(&data, sizeof(kRawBytes)));
+}
+
+TEST_F(CodedStreamTest, AliasingOnlyForFlatArrays) {
+  ArrayInputStream input(buffer_, sizeof(buffer_));
+  CodedInputStream coded_input(&input);
+  coded_input.EnableAliasing(true);
+  // The buffers handed out by a ZeroCopyInputStream are not ours to keep.
+  EXPECT_FALSE(coded_input.AliasingEnabled());
+}
+
 
 // -------------------------------------------------------------------
 // Skip
@@ -1022,6 +1070,105 @@ TEST_F(CodedStreamTest, TotalBytesLimitNotValidMessageEnd) {
   EXPECT_FALSE(coded_input.ConsumedEntireMessage());
 }
 
+TEST_F(CodedStreamTest, LengthLimits) {
+  CodedInputStream coded_input(buffer_, sizeof(buffer_));
+  coded_input.SetMessageLengthLimit(16);
+  coded_input.SetBytesLengthLimit(8);
+
+  EXPECT_TRUE(coded_input.CheckMessageLength(16));
+  EXPECT_TRUE(coded_input.CheckBytesLength(8));
+
+  vector<string> errors;
+
+  {
+    ScopedMemoryLog error_log;
+    EXPECT_FALSE(coded_input.CheckMessageLength(17));
+    EXPECT_FALSE(coded_input.CheckBytesLength(0xFFFFFFFFu));
+    errors = error_log.GetMessages(ERROR);
+  }
+
+  ASSERT_EQ(2, errors.size());
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "SetMessageLengthLimit", errors[0]);
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "SetBytesLengthLimit", errors[1]);
+}
+
+int FieldLengthLimitForTest(void* context, const char* field_name) {
+  return strcmp(field_name, "pkg.Message.small") == 0 ? 4 : -1;
+}
+
+TEST_F(CodedStreamTest, FieldLengthLimits) {
+  CodedInputStream coded_input(buffer_, sizeof(buffer_));
+  coded_input.SetBytesLengthLimit(8);
+  coded_input.SetFieldLengthLimitFunc(&FieldLengthLimitForTest, NULL);
+
+  // A field's own limit replaces the bytes length limit, for the next
+  // check only.
+  coded_input.BeginBytesField("pkg.Message.small");
+  EXPECT_TRUE(coded_input.CheckBytesLength(4));
+  EXPECT_TRUE(coded_input.CheckBytesLength(8));
+  coded_input.BeginBytesField("pkg.Message.other");
+  EXPECT_TRUE(coded_input.CheckBytesLength(8));
+
+  vector<string> errors;
+
+  {
+    ScopedMemoryLog error_log;
+    coded_input.BeginBytesField("pkg.Message.small");
+    EXPECT_FALSE(coded_input.CheckBytesLength(5));
+    coded_input.BeginBytesField("pkg.Message.other");
+    EXPECT_FALSE(coded_input.CheckBytesLength(9));
+    errors = error_log.GetMessages(ERROR);
+  }
+
+  ASSERT_EQ(2, errors.size());
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "pkg.Message.small", errors[0]);
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "SetBytesLengthLimit", errors[1]);
+
+  // Without a function, BeginBytesField() does nothing.
+  coded_input.SetFieldLengthLimitFunc(NULL, NULL);
+  coded_input.BeginBytesField("pkg.Message.small");
+  EXPECT_TRUE(coded_input.CheckBytesLength(8));
+}
+
+TEST_F(CodedStreamTest, ReadStringPastLimit) {
+  // A string that runs past the current limit fails without consuming any
+  // of the input.
+  ArrayInputStream input(buffer_, sizeof(buffer_), 8);
+  CodedInputStream coded_input(&input);
+  coded_input.PushLimit(16);
+
+  string str;
+  EXPECT_FALSE(coded_input.ReadString(&str, 17));
+  EXPECT_EQ(16, coded_input.BytesUntilLimit());
+  EXPECT_TRUE(coded_input.ReadString(&str, 16));
+  EXPECT_EQ(16, str.size());
+}
+
+TEST_F(CodedStreamTest, ReadStringForgedLength) {
+  // A string length read from the input may be far larger than the input,
+  // and still within a generous limit.  ReadString() must not allocate more
+  // for it than the total bytes limit allows.
+  {
+    ArrayInputStream input(buffer_, 14);
+    CodedInputStream coded_input(&input);
+    coded_input.PushLimit(0x70000000);
+
+    string str;
+    EXPECT_FALSE(coded_input.ReadString(&str, 0x70000000));
+    EXPECT_LE(str.capacity(), 64 << 20);
+  }
+
+  {
+    ArrayInputStream input(buffer_, 14);
+    CodedInputStream coded_input(&input);
+    coded_input.SetTotalBytesLimit(1024, -1);
+    coded_input.PushLimit(0x70000000);
+
+    string str;
+    EXPECT_FALSE(coded_input.ReadString(&str, 0x70000000));
+    EXPECT_LE(str.capacity(), 1024);
+  }
+}
 
 TEST_F(CodedStreamTest, RecursionLimit) {
   ArrayInputStream input(buffer_, sizeof(buffer_));
@@ -30,14 +30,20 @@
 
 // Author: brianolson@google.com (Brian Olson)
 //
-// This file contains the implementation of classes GzipInputStream and
-// GzipOutputStream.
+// This file contains the implementation of classes GzipInputStream,
+// GzipOutputStream, ParallelGzipOutputStream and ReadaheadInputStream.
 
 #include "config.h"
 
 #if HAVE_ZLIB
 #include <google/protobuf/io/gzip_stream.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+
 #include <google/protobuf/stubs/common.h>
 
 namespace google {
@@ -328,6 +334,537 @@ bool GzipOutputStream::Close() {
   return ok;
 }
 
+#ifndef _WIN32
+
+// =========================================================================
+
+namespace {
+
+const int kParallelBlockSize = 131072;
+
+// deflate can refer back at most this far, so a block primed with this much
+// of the input before it compresses as if the stream had not been cut.
+const int kDictionarySize = 32768;
+
+// gzip member header: magic, deflate, no flags, no mtime, no extra flags,
+// OS "Unix".
+const uint8 kGzipHeader[] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3 };
+
+int OnlineProcessors() {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? static_cast<int>(count) : 1;
+}
+
+}  // namespace
+
+struct ParallelGzipOutputStream::Block {
+  string input;          // block_size bytes, of which input_size are used.
+  int input_size;
+  string dictionary;     // Input preceding this block, at most 32kB.
+  bool last;
+
+  string output;         // Raw deflate data, of which output_size is used.
+  int output_size;
+  uLong crc;             // crc32 of the input.
+  int zerror;
+  bool done;             // Guarded by Workers::mutex.
+};
+
+struct ParallelGzipOutputStream::Workers {
+  pthread_mutex_t mutex;
+  pthread_cond_t work_ready;   // Signalled when pending grows.
+  pthread_cond_t work_done;    // Broadcast when a block is done.
+  deque<Block*> pending;
+  vector<pthread_t> threads;
+  bool shutting_down;
+  int compression_level;
+  int compression_strategy;
+};
+
+ParallelGzipOutputStream::Options::Options()
+    : block_size(kParallelBlockSize),
+      compression_level(Z_DEFAULT_COMPRESSION),
+      compression_strategy(Z_DEFAULT_STRATEGY),
+      threads(OnlineProcessors()) {}
+
+ParallelGzipOutputStream::ParallelGzipOutputStream(
+    ZeroCopyOutputStream* sub_stream)
+    : sub_stream_(sub_stream), options_(), workers_(new Workers),
+      current_(NULL), current_used_(0), crc_(crc32(0, Z_NULL, 0)),
+      byte_count_(0), zerror_(Z_OK), closed_(false) {
+  StartWorkers();
+}
+
+ParallelGzipOutputStream::ParallelGzipOutputStream(
+    ZeroCopyOutputStream* sub_stream, const Options& options)
+    : sub_stream_(sub_stream), options_(options), workers_(new Workers),
+      current_(NULL), current_used_(0), crc_(crc32(0, Z_NULL, 0)),
+      byte_count_(0), zerror_(Z_OK), closed_(false) {
+  StartWorkers();
+}
+
+ParallelGzipOutputStream::~ParallelGzipOutputStream() {
+  Close();
+  for (int i = 0; i < in_flight_.size(); i++) delete in_flight_[i];
+  for (int i = 0; i < free_blocks_.size(); i++) delete free_blocks_[i];
+  delete current_;
+  pthread_cond_destroy(&workers_->work_done);
+  pthread_cond_destroy(&workers_->work_ready);
+  pthread_mutex_destroy(&workers_->mutex);
+  delete workers_;
+}
+
+void ParallelGzipOutputStream::StartWorkers() {
+  GOOGLE_CHECK_GT(options_.block_size, 0);
+  if (!WriteToSubStream(kGzipHeader, sizeof(kGzipHeader))) {
+    zerror_ = Z_BUF_ERROR;
+  }
+
+  pthread_mutex_init(&workers_->mutex, NULL);
+  pthread_cond_init(&workers_->work_ready, NULL);
+  pthread_cond_init(&workers_->work_done, NULL);
+  workers_->shutting_down = false;
+  workers_->compression_level = options_.compression_level;
+  workers_->compression_strategy = options_.compression_strategy;
+  for (int i = 0; i < options_.threads; i++) {
+    pthread_t thread;
+    // If no thread can be started, blocks are compressed by the caller.
+    if (pthread_create(&thread, NULL, &WorkerMain, workers_) != 0) break;
+    workers_->threads.push_back(thread);
+  }
+}
+
+void ParallelGzipOutputStream::StopWorkers() {
+  pthread_mutex_lock(&workers_->mutex);
+  workers_->shutting_down = true;
+  pthread_cond_broadcast(&workers_->work_ready);
+  pthread_mutex_unlock(&workers_->mutex);
+  for (int i = 0; i < workers_->threads.size(); i++) {
+    pthread_join(workers_->threads[i], NULL);
+  }
+  workers_->threads.clear();
+}
+
+void* ParallelGzipOutputStream::WorkerMain(void* arg) {
+  Workers* workers = static_cast<Workers*>(arg);
+  z_stream zcontext;
+  memset(&zcontext, 0, sizeof(zcontext));
+  // Raw deflate (negative windowBits): the stream writes the gzip framing.
+  int init_error = deflateInit2(
+      &zcontext, workers->compression_level, Z_DEFLATED, -15,
+      /* memLevel (default) */8, workers->compression_strategy);
+
+  pthread_mutex_lock(&workers->mutex);
+  while (true) {
+    while (workers->pending.empty() && !workers->shutting_down) {
+      pthread_cond_wait(&workers->work_ready, &workers->mutex);
+    }
+    // Blocks queued before shutdown are still finished.
+    if (workers->pending.empty()) break;
+    Block* block = workers->pending.front();
+    workers->pending.pop_front();
+    pthread_mutex_unlock(&workers->mutex);
+
+    int error = init_error;
+    if (error == Z_OK) error = CompressBlock(&zcontext, block);
+
+    pthread_mutex_lock(&workers->mutex);
+    block->zerror = error;
+    block->done = true;
+    pthread_cond_broadcast(&workers->work_done);
+  }
+  pthread_mutex_unlock(&workers->mutex);
+
+  if (init_error == Z_OK) deflateEnd(&zcontext);
+  return NULL;
+}
+
+int ParallelGzipOutputStream::CompressBlock(z_stream* zcontext,
+                                            Block* block) {
+  int error = deflateReset(zcontext);
+  if (error == Z_OK && !block->dictionary.empty()) {
+    error = deflateSetDictionary(
+        zcontext, reinterpret_cast<const Bytef*>(block->dictionary.data()),
+        block->dictionary.size());
+  }
+  if (error != Z_OK) return error;
+
+  // Every block but the last ends with a sync flush, which pads it to a
+  // byte boundary with an empty stored block and leaves the deflate stream
+  // open; the last one finishes it.
+  int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+  zcontext->next_in = reinterpret_cast<Bytef*>(
+      const_cast<char*>(block->input.data()));
+  zcontext->avail_in = block->input_size;
+  block->output.resize(deflateBound(zcontext, block->input_size) + 16);
+  int output_size = 0;
+  do {
+    if (output_size == block->output.size()) {
+      block->output.resize(block->output.size() * 2);
+    }
+    zcontext->next_out = reinterpret_cast<Bytef*>(&block->output[output_size]);
+    zcontext->avail_out = block->output.size() - output_size;
+    error = deflate(zcontext, flush);
+    output_size = block->output.size() - zcontext->avail_out;
+  } while (error == Z_OK && zcontext->avail_out == 0);
+
+  // A repeated sync flush with nothing left to do reports Z_BUF_ERROR.
+  if (block->last ? error != Z_STREAM_END
+                  : (error != Z_OK && error != Z_BUF_ERROR)) {
+    return error == Z_OK ? Z_BUF_ERROR : error;
+  }
+  block->output_size = output_size;
+  block->crc = crc32(0, reinterpret_cast<const Bytef*>(block->input.data()),
+                     block->input_size);
+  return Z_OK;
+}
+
+bool ParallelGzipOutputStream::SubmitBlock(bool last) {
+  if (current_ == NULL) {
+    // Close() with nothing pending still needs a final block.
+    if (free_blocks_.empty()) {
+      current_ = new Block;
+    } else {
+      current_ = free_blocks_.back();
+      free_blocks_.pop_back();
+    }
+    current_used_ = 0;
+  }
+  Block* block = current_;
+  current_ = NULL;
+  block->input_size = current_used_;
+  block->last = last;
+  block->done = false;
+  block->dictionary = dictionary_;
+  current_used_ = 0;
+
+  const char* input = block->input.data();
+  if (block->input_size >= kDictionarySize) {
+    dictionary_.assign(input + block->input_size - kDictionarySize,
+                       kDictionarySize);
+  } else {
+    dictionary_.append(input, block->input_size);
+    if (dictionary_.size() > kDictionarySize) {
+      dictionary_.erase(0, dictionary_.size() - kDictionarySize);
+    }
+  }
+  byte_count_ += block->input_size;
+  in_flight_.push_back(block);
+
+  if (workers_->threads.empty()) {
+    z_stream zcontext;
+    memset(&zcontext, 0, sizeof(zcontext));
+    block->zerror = deflateInit2(
+        &zcontext, options_.compression_level, Z_DEFLATED, -15,
+        /* memLevel (default) */8, options_.compression_strategy);
+    if (block->zerror == Z_OK) {
+      block->zerror = CompressBlock(&zcontext, block);
+      deflateEnd(&zcontext);
+    }
+    block->done = true;
+  } else {
+    pthread_mutex_lock(&workers_->mutex);
+    workers_->pending.push_back(block);
+    pthread_cond_signal(&workers_->work_ready);
+    pthread_mutex_unlock(&workers_->mutex);
+  }
+
+  // Two blocks per thread keep every thread busy while the caller fills
+  // the next one, without buffering the whole output.
+  while (in_flight_.size() > 2 * workers_->threads.size()) {
+    if (!RetireBlock()) return false;
+  }
+  return true;
+}
+
+bool ParallelGzipOutputStream::RetireBlock() {
+  Block* block = in_flight_.front();
+  pthread_mutex_lock(&workers_->mutex);
+  while (!block->done) {
+    pthread_cond_wait(&workers_->work_done, &workers_->mutex);
+  }
+  pthread_mutex_unlock(&workers_->mutex);
+  in_flight_.pop_front();
+  free_blocks_.push_back(block);
+
+  if (block->zerror != Z_OK) {
+    zerror_ = block->zerror;
+    return false;
+  }
+  if (!WriteToSubStream(block->output.data(), block->output_size)) {
+    zerror_ = Z_BUF_ERROR;
+    return false;
+  }
+  crc_ = crc32_combine(crc_, block->crc, block->input_size);
+  return true;
+}
+
+bool ParallelGzipOutputStream::WriteToSubStream(const void* data, int size) {
+  const uint8* in = static_cast<const uint8*>(data);
+  while (size > 0) {
+    void* out;
+    int out_size;
+    if (!sub_stream_->Next(&out, &out_size)) return false;
+    if (out_size > size) {
+      memcpy(out, in, size);
+      sub_stream_->BackUp(out_size - size);
+      return true;
+    }
+    memcpy(out, in, out_size);
+    in += out_size;
+    size -= out_size;
+  }
+  return true;
+}
+
+bool ParallelGzipOutputStream::Close() {
+  if (closed_) {
+    return zerror_ == Z_OK;
+  }
+  closed_ = true;
+
+  bool ok = zerror_ == Z_OK && SubmitBlock(true);
+  while (ok && !in_flight_.empty()) {
+    ok = RetireBlock();
+  }
+  if (ok) {
+    // gzip member trailer: crc32 and length mod 2^32, little-endian.
+    uint8 trailer[8];
+    uint32 length = static_cast<uint32>(byte_count_);
+    for (int i = 0; i < 4; i++) {
+      trailer[i] = static_cast<uint8>(crc_ >> (8 * i));
+      trailer[4 + i] = static_cast<uint8>(length >> (8 * i));
+    }
+    if (!WriteToSubStream(trailer, sizeof(trailer))) {
+      zerror_ = Z_BUF_ERROR;
+      ok = false;
+    }
+  }
+  StopWorkers();
+  return ok;
+}
+
+// implements ZeroCopyOutputStream ---------------------------------
+bool ParallelGzipOutputStream::Next(void** data, int* size) {
+  if (closed_ || zerror_ != Z_OK) {
+    return false;
+  }
+  if (current_ != NULL && current_used_ == options_.block_size) {
+    if (!SubmitBlock(false)) {
+      return false;
+    }
+  }
+  if (current_ == NULL) {
+    if (free_blocks_.empty()) {
+      current_ = new Block;
+    } else {
+      current_ = free_blocks_.back();
+      free_blocks_.pop_back();
+    }
+    current_->input.resize(options_.block_size);
+    current_used_ = 0;
+  }
+  *data = &current_->input[current_used_];
+  *size = options_.block_size - current_used_;
+  current_used_ = options_.block_size;
+  return true;
+}
+
+void ParallelGzipOutputStream::BackUp(int count) {
+  GOOGLE_CHECK(current_ != NULL && count <= current_used_)
+      << "BackUp() can only be called after Next().";
+  current_used_ -= count;
+}
+
+int64 ParallelGzipOutputStream::ByteCount() const {
+  return byte_count_ + (current_ == NULL ? 0 : current_used_);
+}
+
+// =========================================================================
+
+namespace {
+
+const int kReadaheadBufferSize = 65536;
+const int kReadaheadBufferCount = 4;
+
+}  // namespace
+
+struct ReadaheadInputStream::Buffer {
+  string data;   // buffer_size bytes, of which size are filled.
+  int size;
+};
+
+struct ReadaheadInputStream::Reader {
+  ZeroCopyInputStream* sub_stream;
+  bool started;                // The helper thread is running.
+  pthread_t thread;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t filled;       // Signalled when full grows or at eof.
+  pthread_cond_t emptied;      // Signalled when empty grows or stopping.
+  deque<Buffer*> full;         // Read ahead, oldest first.
+  vector<Buffer*> empty;
+  bool eof;
+  bool stopping;
+
+  // Copies from the sub-stream into buffer until it is full; returns false
+  // once the sub-stream is exhausted.
+  bool Fill(Buffer* buffer) {
+    buffer->size = 0;
+    while (buffer->size < buffer->data.size()) {
+      const void* data;
+      int size;
+      if (!sub_stream->Next(&data, &size)) return false;
+      int n = min<int>(size, buffer->data.size() - buffer->size);
+      memcpy(&buffer->data[buffer->size], data, n);
+      buffer->size += n;
+      if (n < size) sub_stream->BackUp(size - n);
+    }
+    return true;
+  }
+};
+
+ReadaheadInputStream::ReadaheadInputStream(
+    ZeroCopyInputStream* sub_stream, int buffer_size, int buffer_count)
+    : reader_(new Reader), current_(NULL), backup_bytes_(0),
+      byte_count_(0) {
+  if (buffer_size == -1) buffer_size = kReadaheadBufferSize;
+  if (buffer_count == -1) buffer_count = kReadaheadBufferCount;
+  GOOGLE_CHECK_GT(buffer_size, 0);
+  GOOGLE_CHECK_GT(buffer_count, 0);
+
+  reader_->sub_stream = sub_stream;
+  reader_->eof = false;
+  reader_->stopping = false;
+  for (int i = 0; i < buffer_count; i++) {
+    Buffer* buffer = new Buffer;
+    buffer->data.resize(buffer_size);
+    buffer->size = 0;
+    reader_->empty.push_back(buffer);
+  }
+  pthread_mutex_init(&reader_->mutex, NULL);
+  pthread_cond_init(&reader_->filled, NULL);
+  pthread_cond_init(&reader_->emptied, NULL);
+  // If the thread can't be started, Next() reads synchronously.
+  reader_->started =
+      pthread_create(&reader_->thread, NULL, &ReaderMain, reader_) == 0;
+}
+
+ReadaheadInputStream::~ReadaheadInputStream() {
+  if (reader_->started) {
+    pthread_mutex_lock(&reader_->mutex);
+    reader_->stopping = true;
+    pthread_cond_signal(&reader_->emptied);
+    pthread_mutex_unlock(&reader_->mutex);
+    pthread_join(reader_->thread, NULL);
+  }
+  for (int i = 0; i < reader_->full.size(); i++) delete reader_->full[i];
+  for (int i = 0; i < reader_->empty.size(); i++) delete reader_->empty[i];
+  delete current_;
+  pthread_cond_destroy(&reader_->emptied);
+  pthread_cond_destroy(&reader_->filled);
+  pthread_mutex_destroy(&reader_->mutex);
+  delete reader_;
+}
+
+void* ReadaheadInputStream::ReaderMain(void* arg) {
+  Reader* reader = static_cast<Reader*>(arg);
+  pthread_mutex_lock(&reader->mutex);
+  while (true) {
+    while (reader->empty.empty() && !reader->stopping) {
+      pthread_cond_wait(&reader->emptied, &reader->mutex);
+    }
+    if (reader->stopping) break;
+    Buffer* buffer = reader->empty.back();
+    reader->empty.pop_back();
+    pthread_mutex_unlock(&reader->mutex);
+
+    bool more = reader->Fill(buffer);
+
+    pthread_mutex_lock(&reader->mutex);
+    if (buffer->size > 0) {
+      reader->full.push_back(buffer);
+    } else {
+      reader->empty.push_back(buffer);
+    }
+    reader->eof = !more;
+    pthread_cond_signal(&reader->filled);
+    if (!more) break;
+  }
+  pthread_mutex_unlock(&reader->mutex);
+  return NULL;
+}
+
+// implements ZeroCopyInputStream ----------------------------------
+bool ReadaheadInputStream::Next(const void** data, int* size) {
+  if (backup_bytes_ > 0) {
+    *data = current_->data.data() + current_->size - backup_bytes_;
+    *size = backup_bytes_;
+    byte_count_ += backup_bytes_;
+    backup_bytes_ = 0;
+    return true;
+  }
+
+  if (!reader_->started) {
+    if (current_ == NULL) {
+      current_ = reader_->empty.back();
+      reader_->empty.pop_back();
+    }
+    if (reader_->eof) return false;
+    reader_->eof = !reader_->Fill(current_);
+    if (current_->size == 0) return false;
+  } else {
+    pthread_mutex_lock(&reader_->mutex);
+    if (current_ != NULL) {
+      reader_->empty.push_back(current_);
+      current_ = NULL;
+      pthread_cond_signal(&reader_->emptied);
+    }
+    while (reader_->full.empty() && !reader_->eof) {
+      pthread_cond_wait(&reader_->filled, &reader_->mutex);
+    }
+    if (!reader_->full.empty()) {
+      current_ = reader_->full.front();
+      reader_->full.pop_front();
+    }
+    pthread_mutex_unlock(&reader_->mutex);
+    if (current_ == NULL) return false;
+  }
+
+  *data = current_->data.data();
+  *size = current_->size;
+  byte_count_ += current_->size;
+  return true;
+}
+
+void ReadaheadInputStream::BackUp(int count) {
+  GOOGLE_CHECK(current_ != NULL && backup_bytes_ == 0 &&
+               count <= current_->size)
+      << "BackUp() can only be called after Next().";
+  backup_bytes_ = count;
+  byte_count_ -= count;
+}
+
+bool ReadaheadInputStream::Skip(int count) {
+  const void* data;
+  int size;
+  while (count > 0) {
+    if (!Next(&data, &size)) return false;
+    if (size > count) {
+      BackUp(size - count);
+      return true;
+    }
+    count -= size;
+  }
+  return true;
+}
+
+int64 ReadaheadInputStream::ByteCount() const {
+  return byte_count_;
+}
+
+#endif  // !_WIN32
+
 }  // namespace io
 }  // namespace protobuf
 }  // namespace google
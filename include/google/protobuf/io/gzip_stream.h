@@ -39,11 +39,17 @@
 //
 // GzipOutputStream is an ZeroCopyOutputStream that compresses data to
 // an underlying ZeroCopyOutputStream.
+//
+// ParallelGzipOutputStream does the same on several threads, and
+// ReadaheadInputStream runs a GzipInputStream (or any other input stream)
+// on a helper thread, so reading and decompressing overlap with parsing.
 
 #ifndef GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 #define GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 
 #include <zlib.h>
+#include <deque>
+#include <vector>
 
 #include <google/protobuf/io/zero_copy_stream.h>
 
@@ -200,6 +206,134 @@ class LIBPROTOBUF_EXPORT GzipOutputStream : public ZeroCopyOutputStream {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(GzipOutputStream);
 };
 
+#ifndef _WIN32
+
+// A ZeroCopyOutputStream that compresses to the gzip format on several
+// threads at once, the way pigz does.  The input is cut into blocks which
+// are deflated independently, each primed with the last 32kB of the block
+// before it as a dictionary, and ended on a byte boundary so that the
+// pieces concatenate into a single valid gzip member.  The output is a
+// little larger than GzipOutputStream's and is only written out a block at
+// a time, so Flush() is not supported.
+class LIBPROTOBUF_EXPORT ParallelGzipOutputStream
+    : public ZeroCopyOutputStream {
+ public:
+  struct Options {
+    // Uncompressed bytes per block; each is the unit of work for one
+    // thread.  Defaults to 128kB.
+    int block_size;
+
+    // As in GzipOutputStream::Options.
+    int compression_level;
+    int compression_strategy;
+
+    // Number of compressing threads.  Defaults to the number of online
+    // processors.
+    int threads;
+
+    Options();  // Initializes with default values.
+  };
+
+  // Create a ParallelGzipOutputStream with default options.
+  explicit ParallelGzipOutputStream(ZeroCopyOutputStream* sub_stream);
+
+  // Create a ParallelGzipOutputStream with the given options.
+  ParallelGzipOutputStream(
+      ZeroCopyOutputStream* sub_stream,
+      const Options& options);
+
+  virtual ~ParallelGzipOutputStream();
+
+  // Return last zlib error code, Z_BUF_ERROR if the sub-stream failed, or
+  // Z_OK.
+  inline int ZlibErrorCode() const {
+    return zerror_;
+  }
+
+  // Compresses the remaining data, writes out the gzip trailer and stops
+  // the threads.  It is the caller's responsibility to close the
+  // underlying stream if necessary.
+  // Returns true if no error.
+  bool Close();
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+
+ private:
+  struct Block;
+  struct Workers;
+
+  // Writes the gzip header and starts the threads.
+  void StartWorkers();
+  // Lets the threads finish the queued blocks and joins them.
+  void StopWorkers();
+  // Queues current_ for compression, then writes out finished blocks
+  // until no more than two per thread are outstanding.
+  bool SubmitBlock(bool last);
+  // Waits for the oldest outstanding block and writes it out.
+  bool RetireBlock();
+  bool WriteToSubStream(const void* data, int size);
+
+  static void* WorkerMain(void* workers);
+  static int CompressBlock(z_stream* zcontext, Block* block);
+
+  ZeroCopyOutputStream* sub_stream_;
+  Options options_;
+  Workers* workers_;
+
+  Block* current_;               // Being filled by Next(), or NULL.
+  int current_used_;             // Bytes of current_ handed out.
+  deque<Block*> in_flight_;      // Submitted, oldest first.
+  vector<Block*> free_blocks_;
+  string dictionary_;            // Last 32kB of the submitted input.
+
+  uLong crc_;                    // Of the blocks written out so far.
+  int64 byte_count_;             // Uncompressed bytes submitted.
+  int zerror_;
+  bool closed_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ParallelGzipOutputStream);
+};
+
+// A ZeroCopyInputStream that reads another one on a helper thread, copying
+// up to buffer_count buffers of buffer_size bytes ahead of the caller.
+// Wrapped around a GzipInputStream, decompression runs alongside whatever
+// consumes the data.  The sub-stream must not be used by anyone else
+// while this stream exists; since data is read ahead, its position
+// afterwards is unspecified.
+class LIBPROTOBUF_EXPORT ReadaheadInputStream : public ZeroCopyInputStream {
+ public:
+  // buffer_size and buffer_count may be -1 for the defaults of 64kB and 4.
+  explicit ReadaheadInputStream(
+      ZeroCopyInputStream* sub_stream,
+      int buffer_size = -1,
+      int buffer_count = -1);
+  virtual ~ReadaheadInputStream();
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size);
+  void BackUp(int count);
+  bool Skip(int count);
+  int64 ByteCount() const;
+
+ private:
+  struct Buffer;
+  struct Reader;
+
+  static void* ReaderMain(void* reader);
+
+  Reader* reader_;
+  Buffer* current_;     // Last returned by Next(), or NULL.
+  int backup_bytes_;    // Bytes at the end of current_ given back.
+  int64 byte_count_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ReadaheadInputStream);
+};
+
+#endif  // !_WIN32
+
 }  // namespace io
 }  // namespace protobuf
 
@@ -0,0 +1,298 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the implementation of classes Lz4InputStream and
+// Lz4OutputStream.
+
+#include "config.h"
+
+#if HAVE_LZ4
+#include <google/protobuf/io/lz4_stream.h>
+
+#include <string.h>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+static const int kDefaultBufferSize = 65536;
+
+static const char kTruncatedFrame[] = "LZ4 frame is truncated";
+static const char kSubStreamFailed[] = "writing the sub-stream failed";
+
+Lz4InputStream::Lz4InputStream(
+    ZeroCopyInputStream* sub_stream, int buffer_size)
+    : sub_stream_(sub_stream), context_(NULL), error_message_(NULL),
+      input_(NULL), input_size_(0), frame_pending_(0), output_full_(false),
+      output_size_(0), backup_bytes_(0), byte_count_(0) {
+  if (buffer_size == -1) {
+    output_buffer_size_ = kDefaultBufferSize;
+  } else {
+    output_buffer_size_ = buffer_size;
+  }
+  GOOGLE_CHECK_GT(output_buffer_size_, 0);
+  output_buffer_ = new uint8[output_buffer_size_];
+  LZ4F_errorCode_t error =
+      LZ4F_createDecompressionContext(&context_, LZ4F_VERSION);
+  if (LZ4F_isError(error)) {
+    error_message_ = LZ4F_getErrorName(error);
+    context_ = NULL;
+  }
+}
+
+Lz4InputStream::~Lz4InputStream() {
+  if (context_ != NULL) {
+    LZ4F_freeDecompressionContext(context_);
+  }
+  delete [] output_buffer_;
+}
+
+// implements ZeroCopyInputStream ----------------------------------
+bool Lz4InputStream::Next(const void** data, int* size) {
+  if (backup_bytes_ > 0) {
+    *data = output_buffer_ + output_size_ - backup_bytes_;
+    *size = backup_bytes_;
+    byte_count_ += backup_bytes_;
+    backup_bytes_ = 0;
+    return true;
+  }
+  if (error_message_ != NULL) {
+    return false;
+  }
+
+  while (true) {
+    // A full output buffer may have left decompressed data behind, which
+    // has to be collected before more input is given.  Once a frame is
+    // complete nothing is held back, and calling again would start on the
+    // next frame's header.
+    if (input_size_ == 0 && !output_full_) {
+      const void* in;
+      int in_size;
+      if (!sub_stream_->Next(&in, &in_size)) {
+        if (frame_pending_ != 0) {
+          error_message_ = kTruncatedFrame;
+        }
+        return false;
+      }
+      input_ = static_cast<const uint8*>(in);
+      input_size_ = in_size;
+    }
+
+    size_t out_size = output_buffer_size_;
+    size_t in_size = input_size_;
+    size_t result = LZ4F_decompress(context_, output_buffer_, &out_size,
+                                    input_, &in_size, NULL);
+    if (LZ4F_isError(result)) {
+      error_message_ = LZ4F_getErrorName(result);
+      return false;
+    }
+    input_ += in_size;
+    input_size_ -= in_size;
+    frame_pending_ = result;
+    output_full_ = out_size == output_buffer_size_ && result != 0;
+
+    if (out_size > 0) {
+      output_size_ = out_size;
+      *data = output_buffer_;
+      *size = out_size;
+      byte_count_ += out_size;
+      return true;
+    }
+  }
+}
+
+void Lz4InputStream::BackUp(int count) {
+  GOOGLE_CHECK(backup_bytes_ == 0 && count <= output_size_)
+      << "BackUp() can only be called after Next().";
+  backup_bytes_ = count;
+  byte_count_ -= count;
+}
+
+bool Lz4InputStream::Skip(int count) {
+  const void* data;
+  int size;
+  while (count > 0) {
+    if (!Next(&data, &size)) return false;
+    if (size > count) {
+      BackUp(size - count);
+      return true;
+    }
+    count -= size;
+  }
+  return true;
+}
+
+int64 Lz4InputStream::ByteCount() const {
+  return byte_count_;
+}
+
+// =========================================================================
+
+Lz4OutputStream::Options::Options()
+    : buffer_size(kDefaultBufferSize),
+      compression_level(0) {}
+
+Lz4OutputStream::Lz4OutputStream(ZeroCopyOutputStream* sub_stream) {
+  Init(sub_stream, Options());
+}
+
+Lz4OutputStream::Lz4OutputStream(ZeroCopyOutputStream* sub_stream,
+                                 const Options& options) {
+  Init(sub_stream, options);
+}
+
+void Lz4OutputStream::Init(ZeroCopyOutputStream* sub_stream,
+                           const Options& options) {
+  sub_stream_ = sub_stream;
+  context_ = NULL;
+  error_message_ = NULL;
+  closed_ = false;
+  input_size_ = 0;
+  byte_count_ = 0;
+
+  GOOGLE_CHECK_GT(options.buffer_size, 0);
+  input_buffer_size_ = options.buffer_size;
+  input_buffer_ = new uint8[input_buffer_size_];
+
+  LZ4F_preferences_t preferences;
+  memset(&preferences, 0, sizeof(preferences));
+  preferences.compressionLevel = options.compression_level;
+  output_buffer_size_ = max<size_t>(
+      LZ4F_compressBound(input_buffer_size_, &preferences),
+      LZ4F_HEADER_SIZE_MAX);
+  output_buffer_ = new uint8[output_buffer_size_];
+
+  LZ4F_errorCode_t error =
+      LZ4F_createCompressionContext(&context_, LZ4F_VERSION);
+  if (LZ4F_isError(error)) {
+    error_message_ = LZ4F_getErrorName(error);
+    context_ = NULL;
+    return;
+  }
+  WriteOutput(LZ4F_compressBegin(context_, output_buffer_,
+                                 output_buffer_size_, &preferences));
+}
+
+Lz4OutputStream::~Lz4OutputStream() {
+  Close();
+  if (context_ != NULL) {
+    LZ4F_freeCompressionContext(context_);
+  }
+  delete [] input_buffer_;
+  delete [] output_buffer_;
+}
+
+bool Lz4OutputStream::Compress() {
+  if (input_size_ == 0) {
+    return true;
+  }
+  size_t result = LZ4F_compressUpdate(context_, output_buffer_,
+                                      output_buffer_size_, input_buffer_,
+                                      input_size_, NULL);
+  byte_count_ += input_size_;
+  input_size_ = 0;
+  return WriteOutput(result);
+}
+
+bool Lz4OutputStream::WriteOutput(size_t size) {
+  if (LZ4F_isError(size)) {
+    error_message_ = LZ4F_getErrorName(size);
+    return false;
+  }
+  const uint8* in = output_buffer_;
+  while (size > 0) {
+    void* out;
+    int out_size;
+    if (!sub_stream_->Next(&out, &out_size)) {
+      error_message_ = kSubStreamFailed;
+      return false;
+    }
+    size_t avail = static_cast<size_t>(out_size);
+    if (avail > size) {
+      memcpy(out, in, size);
+      sub_stream_->BackUp(static_cast<int>(avail - size));
+      return true;
+    }
+    memcpy(out, in, avail);
+    in += avail;
+    size -= avail;
+  }
+  return true;
+}
+
+// implements ZeroCopyOutputStream ---------------------------------
+bool Lz4OutputStream::Next(void** data, int* size) {
+  if (closed_ || error_message_ != NULL) {
+    return false;
+  }
+  if (input_size_ == input_buffer_size_ && !Compress()) {
+    return false;
+  }
+  *data = input_buffer_ + input_size_;
+  *size = input_buffer_size_ - input_size_;
+  input_size_ = input_buffer_size_;
+  return true;
+}
+
+void Lz4OutputStream::BackUp(int count) {
+  GOOGLE_CHECK_GE(input_size_, count);
+  input_size_ -= count;
+}
+
+int64 Lz4OutputStream::ByteCount() const {
+  return byte_count_ + input_size_;
+}
+
+bool Lz4OutputStream::Flush() {
+  if (closed_ || error_message_ != NULL) {
+    return false;
+  }
+  return Compress() &&
+         WriteOutput(LZ4F_flush(context_, output_buffer_,
+                                output_buffer_size_, NULL));
+}
+
+bool Lz4OutputStream::Close() {
+  if (closed_ || error_message_ != NULL) {
+    return error_message_ == NULL;
+  }
+  closed_ = true;
+  return Compress() &&
+         WriteOutput(LZ4F_compressEnd(context_, output_buffer_,
+                                      output_buffer_size_, NULL));
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // HAVE_LZ4
@@ -0,0 +1,171 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the definition for classes Lz4InputStream and
+// Lz4OutputStream, which read and write the LZ4 frame format through
+// liblz4, in the same way GzipInputStream and GzipOutputStream use zlib.
+// LZ4 compresses less than gzip but decompresses several times faster,
+// which suits data that is written once and read on slow devices.
+
+#ifndef GOOGLE_PROTOBUF_IO_LZ4_STREAM_H__
+#define GOOGLE_PROTOBUF_IO_LZ4_STREAM_H__
+
+#include <lz4frame.h>
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A ZeroCopyInputStream that reads LZ4 frames.  Concatenated frames are
+// read as one stream.
+class LIBPROTOBUF_EXPORT Lz4InputStream : public ZeroCopyInputStream {
+ public:
+  // buffer_size may be -1 for the default of 64kB.
+  explicit Lz4InputStream(
+      ZeroCopyInputStream* sub_stream,
+      int buffer_size = -1);
+  virtual ~Lz4InputStream();
+
+  // Return last error message or NULL if no error.  A stream that ends in
+  // the middle of a frame is an error.
+  inline const char* ErrorMessage() const {
+    return error_message_;
+  }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size);
+  void BackUp(int count);
+  bool Skip(int count);
+  int64 ByteCount() const;
+
+ private:
+  ZeroCopyInputStream* sub_stream_;
+  LZ4F_dctx* context_;
+  const char* error_message_;
+
+  // Compressed bytes from sub_stream_ not yet decompressed.
+  const uint8* input_;
+  int input_size_;
+  // Zero once a frame is complete, otherwise what LZ4F_decompress()
+  // hinted it wants next.
+  size_t frame_pending_;
+  // The last call filled the output buffer, so more may be held back.
+  bool output_full_;
+
+  uint8* output_buffer_;
+  int output_buffer_size_;
+  int output_size_;       // Bytes of output_buffer_ filled.
+  int backup_bytes_;      // Bytes at the end given back by BackUp().
+  int64 byte_count_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Lz4InputStream);
+};
+
+
+class LIBPROTOBUF_EXPORT Lz4OutputStream : public ZeroCopyOutputStream {
+ public:
+  struct Options {
+    // What size buffer to use internally.  Defaults to 64kB.
+    int buffer_size;
+
+    // 0 (the default) selects the fast compressor; 3 to 12 select LZ4 HC
+    // at increasing levels, which compresses better at a much lower speed
+    // but decompresses just as fast.
+    int compression_level;
+
+    Options();  // Initializes with default values.
+  };
+
+  // Create an Lz4OutputStream with default options.
+  explicit Lz4OutputStream(ZeroCopyOutputStream* sub_stream);
+
+  // Create an Lz4OutputStream with the given options.
+  Lz4OutputStream(
+      ZeroCopyOutputStream* sub_stream,
+      const Options& options);
+
+  virtual ~Lz4OutputStream();
+
+  // Return last error message or NULL if no error.
+  inline const char* ErrorMessage() const {
+    return error_message_;
+  }
+
+  // Flushes data written so far to compressed data in the underlying
+  // stream.  It is the caller's responsibility to flush the underlying
+  // stream if necessary.
+  // Returns true if no error.
+  bool Flush();
+
+  // Writes out all data and ends the LZ4 frame.
+  // It is the caller's responsibility to close the underlying stream if
+  // necessary.
+  // Returns true if no error.
+  bool Close();
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+
+ private:
+  ZeroCopyOutputStream* sub_stream_;
+  LZ4F_cctx* context_;
+  const char* error_message_;
+  bool closed_;
+
+  uint8* input_buffer_;
+  int input_buffer_size_;
+  int input_size_;        // Bytes of input_buffer_ handed out.
+  int64 byte_count_;      // Bytes compressed so far.
+
+  // Large enough for LZ4F_compressBound() of a full input buffer.
+  uint8* output_buffer_;
+  int output_buffer_size_;
+
+  // Shared constructor code.
+  void Init(ZeroCopyOutputStream* sub_stream, const Options& options);
+
+  // Compresses the buffered input.  Returns false on error.
+  bool Compress();
+  // Copies the first size bytes of output_buffer_ to sub_stream_, or
+  // records the error from an LZ4F call that produced them.
+  bool WriteOutput(size_t size);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Lz4OutputStream);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_LZ4_STREAM_H__
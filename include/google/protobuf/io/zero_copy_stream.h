@@ -226,6 +226,16 @@ class LIBPROTOBUF_EXPORT ZeroCopyOutputStream {
   // Returns the total number of bytes written since this object was created.
   virtual int64 ByteCount() const = 0;
 
+  // Writes "size" bytes from "data" to the output without copying them: the
+  // stream only records where they are, so the caller must keep them alive
+  // and unchanged until the stream is done with its output (see the
+  // documentation of the implementation).  Returns false if an error
+  // occurred.  Only valid if AllowsAliasing() returns true.
+  virtual bool WriteAliasedRaw(const void* data, int size);
+
+  // Returns true if the stream implements WriteAliasedRaw().
+  virtual bool AllowsAliasing() const { return false; }
+
 
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ZeroCopyOutputStream);
@@ -38,9 +38,12 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #endif
 #include <errno.h>
+#include <limits.h>
 #include <iostream>
 #include <algorithm>
 
@@ -77,6 +80,10 @@ int close_no_eintr(int fd) {
 FileInputStream::FileInputStream(int file_descriptor, int block_size)
   : copying_input_(file_descriptor),
     impl_(&copying_input_, block_size) {
+#ifdef POSIX_FADV_SEQUENTIAL
+  // Only a hint: it fails harmlessly on pipes and sockets.
+  posix_fadvise(file_descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 }
 
 FileInputStream::~FileInputStream() {}
@@ -268,6 +275,426 @@ bool FileOutputStream::CopyingFileOutputStream::Write(
 
 // ===================================================================
 
+#ifndef _WIN32
+
+namespace {
+
+// Mapped windows start at 1MB and double up to 1GB.
+const int kDefaultMmapWindowSize = 1 << 20;
+const int kMaxMmapWindowSize = 1 << 30;
+
+#ifdef IOV_MAX
+const int kMaxWritevBatch = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+const int kMaxWritevBatch = 1024;
+#endif
+
+// O_DIRECT wants buffers, sizes and offsets aligned to the device's logical
+// block size, which is at most this in practice.
+const int kDirectAlignment = 4096;
+const int kDefaultDirectBlockSize = 1 << 16;
+const int kMaxDirectBlockSize = 1 << 20;
+
+int RoundUpToPageSize(int size) {
+  int page_size = sysconf(_SC_PAGESIZE);
+  if (page_size <= 0) page_size = 4096;
+  return (size + page_size - 1) / page_size * page_size;
+}
+
+}  // namespace
+
+DirectFileInputStream::DirectFileInputStream(int file_descriptor,
+                                             int block_size)
+  : file_(file_descriptor),
+    close_on_delete_(false),
+    is_closed_(false),
+    errno_(0),
+    eof_(false),
+    direct_(false),
+    original_flags_(-1),
+    buffer_(NULL),
+    adaptive_(block_size <= 0),
+    buffer_used_(0),
+    backup_bytes_(0),
+    position_(0) {
+  if (adaptive_) {
+    block_size_ = kDefaultDirectBlockSize;
+    buffer_capacity_ = kMaxDirectBlockSize;
+  } else {
+    block_size_ = (block_size + kDirectAlignment - 1) / kDirectAlignment *
+                  kDirectAlignment;
+    buffer_capacity_ = block_size_;
+  }
+  void* buffer;
+  if (posix_memalign(&buffer, kDirectAlignment, buffer_capacity_) != 0) {
+    errno_ = ENOMEM;
+    return;
+  }
+  buffer_ = static_cast<uint8*>(buffer);
+
+#ifdef O_DIRECT
+  original_flags_ = fcntl(file_, F_GETFL);
+  if (original_flags_ != -1 &&
+      fcntl(file_, F_SETFL, original_flags_ | O_DIRECT) == 0) {
+    direct_ = true;
+  }
+#endif
+}
+
+DirectFileInputStream::~DirectFileInputStream() {
+  if (!is_closed_) {
+    StopDirect();
+    if (close_on_delete_ && !Close()) {
+      GOOGLE_LOG(ERROR) << "close() failed: " << strerror(errno_);
+    }
+  }
+  free(buffer_);
+}
+
+void DirectFileInputStream::StopDirect() {
+  if (direct_) {
+    fcntl(file_, F_SETFL, original_flags_);
+    direct_ = false;
+  }
+}
+
+bool DirectFileInputStream::Close() {
+  GOOGLE_CHECK(!is_closed_);
+
+  StopDirect();
+  is_closed_ = true;
+  if (close_no_eintr(file_) != 0) {
+    errno_ = errno;
+    return false;
+  }
+  return true;
+}
+
+bool DirectFileInputStream::Next(const void** data, int* size) {
+  if (backup_bytes_ > 0) {
+    *data = buffer_ + buffer_used_ - backup_bytes_;
+    *size = backup_bytes_;
+    backup_bytes_ = 0;
+    return true;
+  }
+  if (is_closed_ || errno_ != 0 || eof_) {
+    return false;
+  }
+
+  if (adaptive_ && buffer_used_ == block_size_ &&
+      block_size_ < kMaxDirectBlockSize) {
+    block_size_ *= 2;
+  }
+
+  int result;
+  do {
+    result = read(file_, buffer_, block_size_);
+    if (result < 0 && errno == EINVAL && direct_) {
+      // An unaligned offset (or a file system that accepted the flag but
+      // not the read): fall back to the page cache and try again.
+      StopDirect();
+      result = read(file_, buffer_, block_size_);
+    }
+  } while (result < 0 && errno == EINTR);
+
+  if (result <= 0) {
+    if (result < 0) {
+      errno_ = errno;
+    } else {
+      eof_ = true;
+    }
+    buffer_used_ = 0;
+    return false;
+  }
+  if (result % kDirectAlignment != 0) {
+    // A short read leaves the offset unaligned, so the next direct read
+    // would fail; it is usually the end of the file anyway.
+    StopDirect();
+  }
+
+  buffer_used_ = result;
+  position_ += result;
+  *data = buffer_;
+  *size = result;
+  return true;
+}
+
+void DirectFileInputStream::BackUp(int count) {
+  GOOGLE_CHECK(backup_bytes_ == 0 && count <= buffer_used_)
+    << " BackUp() can only be called after Next().";
+  GOOGLE_CHECK_GE(count, 0)
+    << " Parameter to BackUp() can't be negative.";
+  backup_bytes_ = count;
+}
+
+bool DirectFileInputStream::Skip(int count) {
+  GOOGLE_CHECK_GE(count, 0);
+
+  const void* data;
+  int size;
+  while (count > 0) {
+    if (!Next(&data, &size)) return false;
+    if (size > count) {
+      BackUp(size - count);
+      return true;
+    }
+    count -= size;
+  }
+  return true;
+}
+
+int64 DirectFileInputStream::ByteCount() const {
+  return position_ - backup_bytes_;
+}
+
+// ===================================================================
+
+MmapFileOutputStream::MmapFileOutputStream(int file_descriptor,
+                                           int initial_size)
+  : file_(file_descriptor),
+    close_on_delete_(false),
+    is_finished_(false),
+    is_closed_(false),
+    errno_(0),
+    window_(NULL),
+    window_offset_(0),
+    window_size_(0),
+    position_(0) {
+  if (initial_size <= 0) {
+    initial_size = kDefaultMmapWindowSize;
+  } else if (initial_size > kMaxMmapWindowSize) {
+    initial_size = kMaxMmapWindowSize;
+  }
+  // The first window is never mapped with this size; Next() doubles it.
+  window_size_ = RoundUpToPageSize(initial_size) / 2;
+  window_offset_ = -window_size_;
+  position_ = window_size_;
+}
+
+MmapFileOutputStream::~MmapFileOutputStream() {
+  if (close_on_delete_ && !is_closed_) {
+    if (!Close()) {
+      GOOGLE_LOG(ERROR) << "close() failed: " << strerror(errno_);
+    }
+  } else if (!Finish()) {
+    GOOGLE_LOG(ERROR) << "Finishing mapped output failed: "
+                      << strerror(errno_);
+  }
+}
+
+bool MmapFileOutputStream::Unmap() {
+  if (window_ == NULL) return true;
+  bool ok = munmap(window_, window_size_) == 0;
+  if (!ok && errno_ == 0) errno_ = errno;
+  window_ = NULL;
+  return ok;
+}
+
+bool MmapFileOutputStream::Finish() {
+  if (is_finished_) return errno_ == 0;
+  is_finished_ = true;
+
+  int64 size = ByteCount();
+  Unmap();
+  int result;
+  do {
+    result = ftruncate(file_, size);
+  } while (result < 0 && errno == EINTR);
+  if (result < 0 && errno_ == 0) errno_ = errno;
+  return errno_ == 0;
+}
+
+bool MmapFileOutputStream::Close() {
+  GOOGLE_CHECK(!is_closed_);
+
+  bool finish_succeeded = Finish();
+  is_closed_ = true;
+  if (close_no_eintr(file_) != 0) {
+    errno_ = errno;
+    return false;
+  }
+  return finish_succeeded;
+}
+
+bool MmapFileOutputStream::Next(void** data, int* size) {
+  if (is_finished_ || errno_ != 0) return false;
+
+  if (window_ == NULL || position_ == window_size_) {
+    // Every window size is a multiple of the page size, so the next window
+    // starts page-aligned right where this one ends.
+    int64 offset = window_offset_ + window_size_;
+    int new_size = window_size_ < kMaxMmapWindowSize / 2 ?
+                   window_size_ * 2 : kMaxMmapWindowSize;
+    if (!Unmap()) return false;
+
+    // Reserve the blocks up front: a window over a hole left by ftruncate()
+    // raises SIGBUS on the first store once the disk is full.
+    // posix_fallocate() returns the error instead of setting errno.
+    int result;
+    do {
+      result = posix_fallocate(file_, offset, new_size);
+    } while (result == EINTR);
+    if (result == EOPNOTSUPP || result == ENOSYS) {
+      // The file system can't reserve blocks; just extend the file.
+      do {
+        result = ftruncate(file_, offset + new_size);
+      } while (result < 0 && errno == EINTR);
+      if (result < 0) result = errno;
+    }
+    if (result != 0) {
+      errno_ = result;
+      return false;
+    }
+
+    void* window = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        file_, offset);
+    if (window == MAP_FAILED) {
+      errno_ = errno;
+      return false;
+    }
+    window_ = reinterpret_cast<uint8*>(window);
+    window_offset_ = offset;
+    window_size_ = new_size;
+    position_ = 0;
+  }
+
+  *data = window_ + position_;
+  *size = window_size_ - position_;
+  position_ = window_size_;
+  return true;
+}
+
+void MmapFileOutputStream::BackUp(int count) {
+  GOOGLE_CHECK(window_ != NULL)
+    << " BackUp() can only be called after Next().";
+  GOOGLE_CHECK_LE(count, position_)
+    << " Can't back up over more bytes than were returned by the last call"
+       " to Next().";
+  GOOGLE_CHECK_GE(count, 0)
+    << " Parameter to BackUp() can't be negative.";
+  position_ -= count;
+}
+
+int64 MmapFileOutputStream::ByteCount() const {
+  return window_offset_ + position_;
+}
+
+// ===================================================================
+
+IovecOutputStream::IovecOutputStream(int block_size)
+  : block_size_(block_size > 0 ? block_size : 65536),
+    block_used_(0),
+    byte_count_(0) {
+}
+
+IovecOutputStream::~IovecOutputStream() {
+  for (int i = 0; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  }
+}
+
+void IovecOutputStream::Clear() {
+  for (int i = 1; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  }
+  if (!blocks_.empty()) blocks_.resize(1);
+  block_used_ = 0;
+  iovecs_.clear();
+  byte_count_ = 0;
+}
+
+bool IovecOutputStream::Next(void** data, int* size) {
+  if (blocks_.empty() || block_used_ == block_size_) {
+    blocks_.push_back(new uint8[block_size_]);
+    block_used_ = 0;
+  }
+
+  uint8* buffer = blocks_.back() + block_used_;
+  int buffer_size = block_size_ - block_used_;
+  if (!iovecs_.empty() &&
+      reinterpret_cast<uint8*>(iovecs_.back().iov_base) +
+          iovecs_.back().iov_len == buffer) {
+    iovecs_.back().iov_len += buffer_size;
+  } else {
+    struct iovec iov = { buffer, static_cast<size_t>(buffer_size) };
+    iovecs_.push_back(iov);
+  }
+
+  *data = buffer;
+  *size = buffer_size;
+  block_used_ = block_size_;
+  byte_count_ += buffer_size;
+  return true;
+}
+
+void IovecOutputStream::BackUp(int count) {
+  GOOGLE_CHECK(!iovecs_.empty())
+    << " BackUp() can only be called after Next().";
+  GOOGLE_CHECK_LE(count, block_used_)
+    << " Can't back up over more bytes than were returned by the last call"
+       " to Next().";
+  GOOGLE_CHECK_GE(count, 0)
+    << " Parameter to BackUp() can't be negative.";
+  iovecs_.back().iov_len -= count;
+  if (iovecs_.back().iov_len == 0) iovecs_.pop_back();
+  block_used_ -= count;
+  byte_count_ -= count;
+}
+
+int64 IovecOutputStream::ByteCount() const {
+  return byte_count_;
+}
+
+bool IovecOutputStream::WriteAliasedRaw(const void* data, int size) {
+  if (size > 0) {
+    struct iovec iov = { const_cast<void*>(data), static_cast<size_t>(size) };
+    iovecs_.push_back(iov);
+    byte_count_ += size;
+  }
+  return true;
+}
+
+bool IovecOutputStream::WriteTo(int file_descriptor) const {
+  struct iovec batch[kMaxWritevBatch];
+  int next = 0;        // First iovec not yet (completely) written.
+  size_t skip = 0;     // Bytes of iovecs_[next] already written.
+
+  while (next < iovecs_.size()) {
+    int count = 0;
+    for (int i = next; i < iovecs_.size() && count < kMaxWritevBatch; i++) {
+      batch[count++] = iovecs_[i];
+    }
+    batch[0].iov_base = reinterpret_cast<uint8*>(batch[0].iov_base) + skip;
+    batch[0].iov_len -= skip;
+
+    ssize_t bytes;
+    do {
+      bytes = writev(file_descriptor, batch, count);
+    } while (bytes < 0 && errno == EINTR);
+    if (bytes <= 0) {
+      // As in FileOutputStream, a write of nothing is treated as an error.
+      if (bytes == 0) errno = EIO;
+      return false;
+    }
+
+    while (bytes > 0) {
+      size_t remaining = iovecs_[next].iov_len - skip;
+      if (static_cast<size_t>(bytes) < remaining) {
+        skip += bytes;
+        break;
+      }
+      bytes -= remaining;
+      skip = 0;
+      next++;
+    }
+  }
+  return true;
+}
+
+#endif  // !_WIN32
+
+// ===================================================================
+
 IstreamInputStream::IstreamInputStream(istream* input, int block_size)
   : copying_input_(input),
     impl_(&copying_input_, block_size) {
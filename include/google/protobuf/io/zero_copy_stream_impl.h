@@ -41,7 +41,11 @@
 #define GOOGLE_PROTOBUF_IO_ZERO_COPY_STREAM_IMPL_H__
 
 #include <string>
+#include <vector>
 #include <iosfwd>
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/stubs/common.h>
@@ -65,7 +69,9 @@ class LIBPROTOBUF_EXPORT FileInputStream : public ZeroCopyInputStream {
   // Creates a stream that reads from the given Unix file descriptor.
   // If a block_size is given, it specifies the number of bytes that
   // should be read and returned with each call to Next().  Otherwise,
-  // a reasonable default is used.
+  // reads grow toward 1MB as the file is read sequentially (see
+  // CopyingInputStreamAdaptor).  Where posix_fadvise() is available, the
+  // kernel is told to expect sequential reads and to read ahead further.
   explicit FileInputStream(int file_descriptor, int block_size = -1);
   ~FileInputStream();
 
@@ -208,6 +214,191 @@ class LIBPROTOBUF_EXPORT FileOutputStream : public ZeroCopyOutputStream {
 
 // ===================================================================
 
+#ifndef _WIN32
+
+// A ZeroCopyInputStream which reads a file with O_DIRECT, straight from the
+// device into an aligned buffer the stream owns, bypassing the page cache.
+// Worth it for large files read once, where caching them would only evict
+// more useful pages; for anything else FileInputStream is faster.  Next()
+// returns the stream's buffer itself, so nothing is copied.
+//
+// The descriptor is read from its current offset, which should be a
+// multiple of 4096.  If the file system refuses O_DIRECT, or a read ends
+// unaligned, the stream carries on with ordinary reads; direct() tells
+// which.  Skip() reads through the data rather than seeking.
+class LIBPROTOBUF_EXPORT DirectFileInputStream : public ZeroCopyInputStream {
+ public:
+  // Creates a stream that reads from the given Unix file descriptor.
+  // If a block_size is given, it is rounded up to a multiple of 4096 and
+  // every read is that size.  Otherwise reads start at 64kB and double up
+  // to 1MB.
+  explicit DirectFileInputStream(int file_descriptor, int block_size = -1);
+  ~DirectFileInputStream();
+
+  // Restores the descriptor's flags and closes it.  Returns false if an
+  // error occurs during the process; use GetErrno() to examine the error.
+  // Even if an error occurs, the file descriptor is closed when this
+  // returns.
+  bool Close();
+
+  // By default, the file descriptor is not closed when the stream is
+  // destroyed, only given back its original flags.  Call
+  // SetCloseOnDelete(true) to change that.  WARNING: This leaves no way for
+  // the caller to detect if close() fails.
+  void SetCloseOnDelete(bool value) { close_on_delete_ = value; }
+
+  // If an I/O error has occurred on this file descriptor, this is the
+  // errno from that error.  Otherwise, this is zero.  Once an error
+  // occurs, the stream is broken and all subsequent operations will
+  // fail.
+  int GetErrno() { return errno_; }
+
+  // True while reads bypass the page cache.
+  bool direct() const { return direct_; }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size);
+  void BackUp(int count);
+  bool Skip(int count);
+  int64 ByteCount() const;
+
+ private:
+  // Turns O_DIRECT off again, restoring the original flags.
+  void StopDirect();
+
+  const int file_;
+  bool close_on_delete_;
+  bool is_closed_;
+  int errno_;
+  bool eof_;
+
+  bool direct_;
+  int original_flags_;   // From fcntl(F_GETFL), or -1.
+
+  uint8* buffer_;        // Aligned, buffer_capacity_ bytes, or NULL.
+  int buffer_capacity_;
+  int block_size_;       // Size of the next read.
+  const bool adaptive_;  // No block_size was given, so block_size_ grows.
+  int buffer_used_;      // Bytes read into buffer_ by the last read.
+  int backup_bytes_;     // Bytes at its end given back by BackUp().
+  int64 position_;       // Bytes read so far.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DirectFileInputStream);
+};
+
+// ===================================================================
+
+// A ZeroCopyOutputStream which writes into a file by mapping it into memory,
+// so Next() hands out pages of the file itself and nothing is copied through
+// a user-space buffer.  The file is written from offset zero; it is grown
+// one mapped window at a time (each window twice the size of the last, up
+// to a limit) and truncated to ByteCount() when the stream is closed or
+// destroyed.  The descriptor must be open for reading and writing.
+//
+// Prefer FileOutputStream for pipes, sockets and other descriptors that
+// can't be mapped.
+class LIBPROTOBUF_EXPORT MmapFileOutputStream : public ZeroCopyOutputStream {
+ public:
+  // Creates a stream that writes to the given Unix file descriptor.  If
+  // initial_size is given, the first window covers at least that many
+  // bytes; use the expected size of the output to map it all at once.
+  explicit MmapFileOutputStream(int file_descriptor, int initial_size = -1);
+  ~MmapFileOutputStream();
+
+  // Unmaps the file, truncates it to the bytes written and closes it.
+  // Returns false if an error occurs during the process; use GetErrno() to
+  // examine the error.  Even if an error occurs, the file descriptor is
+  // closed when this returns.
+  bool Close();
+
+  // Unmaps the file and truncates it to the bytes written, without closing
+  // it.  The stream can't be written to afterwards.
+  bool Finish();
+
+  // By default, the file descriptor is not closed when the stream is
+  // destroyed.  Call SetCloseOnDelete(true) to change that.  WARNING:
+  // This leaves no way for the caller to detect if close() fails.
+  void SetCloseOnDelete(bool value) { close_on_delete_ = value; }
+
+  // If an I/O error has occurred on this file descriptor, this is the
+  // errno from that error.  Otherwise, this is zero.  Once an error
+  // occurs, the stream is broken and all subsequent operations will
+  // fail.
+  int GetErrno() { return errno_; }
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+
+ private:
+  // Unmaps the current window, if any.
+  bool Unmap();
+
+  const int file_;
+  bool close_on_delete_;
+  bool is_finished_;
+  bool is_closed_;
+  int errno_;
+
+  uint8* window_;        // The mapped window, or NULL.
+  int64 window_offset_;  // File offset window_ is mapped at.
+  int window_size_;      // Size of window_; the next window is twice this.
+  int position_;         // Bytes of window_ handed out by Next().
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MmapFileOutputStream);
+};
+
+// ===================================================================
+
+// A ZeroCopyOutputStream which collects its output as a list of iovecs, to
+// be written with writev() or handed to any other scatter/gather API.
+// Next() returns space in blocks the stream owns, while WriteAliasedRaw()
+// records the caller's bytes in place, so large bytes fields serialized
+// with CodedOutputStream::EnableAliasing() are never copied; those must
+// stay alive and unchanged until the iovecs have been consumed.
+class LIBPROTOBUF_EXPORT IovecOutputStream : public ZeroCopyOutputStream {
+ public:
+  // If a block_size is given, it specifies the size of the buffers that
+  // should be returned by Next().  Otherwise, a reasonable default is used.
+  explicit IovecOutputStream(int block_size = -1);
+  ~IovecOutputStream();
+
+  // The output so far, in order.
+  const struct iovec* iovecs() const {
+    return iovecs_.empty() ? NULL : &iovecs_[0];
+  }
+  int iovec_count() const { return iovecs_.size(); }
+
+  // Writes all of the output to the given file descriptor, batching writev()
+  // calls and resuming after partial writes.  Returns false if an error
+  // occurs; errno then tells which.
+  bool WriteTo(int file_descriptor) const;
+
+  // Discards the output but keeps the first block for reuse.
+  void Clear();
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+  bool WriteAliasedRaw(const void* data, int size);
+  bool AllowsAliasing() const { return true; }
+
+ private:
+  const int block_size_;
+  vector<uint8*> blocks_;       // Owned; the last one is being filled.
+  int block_used_;              // Bytes of blocks_.back() handed out.
+  vector<struct iovec> iovecs_;
+  int64 byte_count_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(IovecOutputStream);
+};
+
+#endif  // !_WIN32
+
+// ===================================================================
+
 // A ZeroCopyInputStream which reads from a C++ istream.
 //
 // Note that for reading files (or anything represented by a file descriptor),
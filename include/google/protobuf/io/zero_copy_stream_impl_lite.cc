@@ -50,6 +50,9 @@ namespace {
 // Default block size for Copying{In,Out}putStreamAdaptor.
 static const int kDefaultBlockSize = 8192;
 
+// CopyingInputStreamAdaptor's reads grow no larger than this.
+static const int kMaxAdaptiveBlockSize = 1 << 20;
+
 }  // namespace
 
 // ===================================================================
@@ -213,6 +216,7 @@ CopyingInputStreamAdaptor::CopyingInputStreamAdaptor(
     failed_(false),
     position_(0),
     buffer_size_(block_size > 0 ? block_size : kDefaultBlockSize),
+    adaptive_(block_size <= 0),
     buffer_used_(0),
     backup_bytes_(0) {
 }
@@ -229,8 +233,6 @@ bool CopyingInputStreamAdaptor::Next(const void** data, int* size) {
     return false;
   }
 
-  AllocateBufferIfNeeded();
-
   if (backup_bytes_ > 0) {
     // We have data left over from a previous BackUp(), so just return that.
     *data = buffer_.get() + buffer_used_ - backup_bytes_;
@@ -239,6 +241,15 @@ bool CopyingInputStreamAdaptor::Next(const void** data, int* size) {
     return true;
   }
 
+  if (adaptive_ && buffer_used_ == buffer_size_ &&
+      buffer_size_ < kMaxAdaptiveBlockSize) {
+    // The last read filled the buffer, so there is probably more where that
+    // came from: read twice as much this time.
+    buffer_size_ = min(buffer_size_ * 2, kMaxAdaptiveBlockSize);
+    buffer_.reset();
+  }
+  AllocateBufferIfNeeded();
+
   // Read new data into the buffer.
   buffer_used_ = copying_stream_->Read(buffer_.get(), buffer_size_);
   if (buffer_used_ <= 0) {
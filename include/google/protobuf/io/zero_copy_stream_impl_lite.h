@@ -196,8 +196,10 @@ class LIBPROTOBUF_EXPORT CopyingInputStreamAdaptor : public ZeroCopyInputStream
   // Creates a stream that reads from the given CopyingInputStream.
   // If a block_size is given, it specifies the number of bytes that
   // should be read and returned with each call to Next().  Otherwise,
-  // a reasonable default is used.  The caller retains ownership of
-  // copying_stream unless SetOwnsCopyingStream(true) is called.
+  // reads start small and double, up to 1MB, for as long as each one fills
+  // the buffer, so a long sequential read ends up with few large reads.
+  // The caller retains ownership of copying_stream unless
+  // SetOwnsCopyingStream(true) is called.
   explicit CopyingInputStreamAdaptor(CopyingInputStream* copying_stream,
                                      int block_size = -1);
   ~CopyingInputStreamAdaptor();
@@ -232,7 +234,10 @@ class LIBPROTOBUF_EXPORT CopyingInputStreamAdaptor : public ZeroCopyInputStream
   // Data is read into this buffer.  It may be NULL if no buffer is currently
   // in use.  Otherwise, it points to an array of size buffer_size_.
   scoped_array<uint8> buffer_;
-  const int buffer_size_;
+  int buffer_size_;
+
+  // True if no block_size was given, so buffer_size_ grows.
+  const bool adaptive_;
 
   // Number of valid bytes currently in the buffer (i.e. the size last
   // returned by Next()).  0 <= buffer_used_ <= buffer_size_.
@@ -66,6 +66,12 @@
 #if HAVE_ZLIB
 #include <google/protobuf/io/gzip_stream.h>
 #endif
+#if HAVE_LZ4
+#include <google/protobuf/io/lz4_stream.h>
+#endif
+#if HAVE_ZSTD
+#include <google/protobuf/io/zstd_stream.h>
+#endif
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/testing/googletest.h>
@@ -561,8 +567,340 @@ TEST_F(IoTest, TwoSessionWriteGzip) {
   delete [] temp_buffer;
   delete [] buffer;
 }
+
+#ifndef _WIN32
+TEST_F(IoTest, ParallelGzipIo) {
+  const int kParallelBlockSizes[] = {1, 7, 64, 1000, -1};
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < GOOGLE_ARRAYSIZE(kParallelBlockSizes); j++) {
+      for (int threads = 1; threads <= 4; threads += 3) {
+        ParallelGzipOutputStream::Options options;
+        if (kParallelBlockSizes[j] != -1) {
+          options.block_size = kParallelBlockSizes[j];
+        }
+        options.threads = threads;
+        // Thousands of tiny blocks are slow; the small text is enough.
+        bool large = kParallelBlockSizes[j] >= 1000;
+
+        string compressed;
+        {
+          StringOutputStream output(&compressed);
+          ParallelGzipOutputStream gzout(&output, options);
+          if (large) {
+            WriteStuffLarge(&gzout);
+          } else {
+            WriteStuff(&gzout);
+          }
+          EXPECT_TRUE(gzout.Close());
+          EXPECT_EQ(Z_OK, gzout.ZlibErrorCode());
+        }
+        ArrayInputStream input(compressed.data(), compressed.size(),
+                               kBlockSizes[i]);
+        GzipInputStream gzin(&input, GzipInputStream::GZIP);
+        if (large) {
+          ReadStuffLarge(&gzin);
+        } else {
+          ReadStuff(&gzin);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IoTest, ParallelGzipCompression) {
+  string golden;
+  File::ReadFileToStringOrDie(
+    TestSourceDir() + "/google/protobuf/testdata/golden_message",
+    &golden);
+  string data;
+  for (int i = 0; i < 200; i++) {
+    data += golden;
+  }
+
+  // Without threads the caller compresses each block itself.
+  for (int threads = 0; threads <= 8; threads += 4) {
+    ParallelGzipOutputStream::Options options;
+    options.block_size = 4096;
+    options.threads = threads;
+    string compressed;
+    {
+      StringOutputStream output(&compressed);
+      ParallelGzipOutputStream gzout(&output, options);
+      EXPECT_TRUE(WriteToOutput(&gzout, data.data(), data.size()));
+      EXPECT_EQ(data.size(), gzout.ByteCount());
+    }
+    EXPECT_TRUE(Uncompress(compressed) == data);
+
+    // Each block is primed with the one before it, so the repetition
+    // across blocks is still found.
+    EXPECT_LT(compressed.size(), data.size() / 20);
+  }
+
+  // An empty stream is still a valid gzip member.
+  string empty;
+  {
+    StringOutputStream output(&empty);
+    ParallelGzipOutputStream gzout(&output);
+  }
+  EXPECT_EQ(20, empty.size());
+  EXPECT_TRUE(Uncompress(empty).empty());
+
+  // A full sub-stream fails the stream.
+  uint8 buffer[64];
+  ArrayOutputStream output(buffer, sizeof(buffer));
+  ParallelGzipOutputStream gzout(&output);
+  WriteToOutput(&gzout, data.data(), data.size());
+  EXPECT_FALSE(gzout.Close());
+  EXPECT_EQ(Z_BUF_ERROR, gzout.ZlibErrorCode());
+}
+
+TEST_F(IoTest, ReadaheadIo) {
+  const int kBufferSize = 256;
+  uint8 buffer[kBufferSize];
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      for (int count = 1; count <= 3; count += 2) {
+        int size;
+        {
+          ArrayOutputStream output(buffer, kBufferSize);
+          size = WriteStuff(&output);
+        }
+        ArrayInputStream input(buffer, size, kBlockSizes[i]);
+        ReadaheadInputStream readahead(&input, kBlockSizes[j], count);
+        ReadStuff(&readahead);
+      }
+    }
+  }
+}
+
+TEST_F(IoTest, ReadaheadGzipIo) {
+  string compressed;
+  {
+    StringOutputStream output(&compressed);
+    GzipOutputStream gzout(&output);
+    WriteStuffLarge(&gzout);
+  }
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    ArrayInputStream input(compressed.data(), compressed.size(),
+                           kBlockSizes[i]);
+    GzipInputStream gzin(&input);
+    ReadaheadInputStream readahead(&gzin);
+    ReadStuffLarge(&readahead);
+  }
+
+  // Destroyed before the sub-stream is exhausted.
+  ArrayInputStream input(compressed.data(), compressed.size());
+  GzipInputStream gzin(&input);
+  ReadaheadInputStream readahead(&gzin, 1024, 2);
+  ReadString(&readahead, "Hello world!\n");
+}
+#endif  // !_WIN32
 #endif
 
+#if HAVE_LZ4
+TEST_F(IoTest, Lz4Io) {
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      for (int z = 0; z < kBlockSizeCount; z++) {
+        // Tiny buffers make for a lot of tiny LZ4 blocks; they are only
+        // tried with the small text.
+        bool large = kBlockSizes[z] == -1;
+        string compressed;
+        {
+          StringOutputStream output(&compressed);
+          Lz4OutputStream::Options options;
+          if (!large) {
+            options.buffer_size = kBlockSizes[z];
+          }
+          Lz4OutputStream lz4out(&output, options);
+          if (large) {
+            WriteStuffLarge(&lz4out);
+          } else {
+            WriteStuff(&lz4out);
+          }
+          EXPECT_TRUE(lz4out.Close());
+        }
+        ArrayInputStream input(compressed.data(), compressed.size(),
+                               kBlockSizes[i]);
+        Lz4InputStream lz4in(&input, kBlockSizes[j]);
+        if (large) {
+          ReadStuffLarge(&lz4in);
+        } else {
+          ReadStuff(&lz4in);
+        }
+        EXPECT_TRUE(lz4in.ErrorMessage() == NULL);
+      }
+    }
+  }
+}
+
+TEST_F(IoTest, Lz4Frames) {
+  // Two frames, the first flushed midway, read as one stream.
+  string compressed;
+  {
+    StringOutputStream output(&compressed);
+    Lz4OutputStream lz4out(&output);
+    WriteString(&lz4out, "Hello world!\n");
+    EXPECT_TRUE(lz4out.Flush());
+    WriteString(&lz4out, "Some text.  Blah blah.");
+  }
+  {
+    StringOutputStream output(&compressed);
+    Lz4OutputStream::Options options;
+    options.compression_level = 9;
+    Lz4OutputStream lz4out(&output, options);
+    WriteString(&lz4out, "abcdefg01234567890123456789foobar");
+  }
+  {
+    ArrayInputStream input(compressed.data(), compressed.size());
+    Lz4InputStream lz4in(&input);
+    ReadStuff(&lz4in);
+    EXPECT_TRUE(lz4in.ErrorMessage() == NULL);
+  }
+
+  // A stream cut short is an error, and so is garbage.
+  {
+    ArrayInputStream input(compressed.data(), compressed.size() - 1);
+    Lz4InputStream lz4in(&input);
+    const void* data;
+    int size;
+    while (lz4in.Next(&data, &size)) {}
+    EXPECT_TRUE(lz4in.ErrorMessage() != NULL);
+  }
+  {
+    ArrayInputStream input("not lz4 at all", 14);
+    Lz4InputStream lz4in(&input);
+    const void* data;
+    int size;
+    EXPECT_FALSE(lz4in.Next(&data, &size));
+    EXPECT_TRUE(lz4in.ErrorMessage() != NULL);
+  }
+}
+
+TEST_F(IoTest, Lz4ReferenceFrame) {
+  // Written by the lz4 command-line tool (lz4 -9 -BD -BX -B4), which, unlike
+  // Lz4OutputStream, links each block to the ones before it, with block and
+  // content checksums, and followed by a skippable frame.  It holds 70000
+  // bytes of "abcd...xyzabcd...".
+  static const uint8 kFrame[] = {
+    0x04, 0x22, 0x4d, 0x18, 0x54, 0x40, 0xae, 0x25, 0x01, 0x00, 0x00, 0xff,
+    0x0b, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b,
+    0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7a, 0x1a, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xce, 0x50, 0x6c,
+    0x6d, 0x6e, 0x6f, 0x70, 0x8a, 0xd7, 0x27, 0xda, 0x1b, 0x00, 0x00, 0x00,
+    0x0f, 0x1a, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x69, 0x50, 0x64, 0x65,
+    0x66, 0x67, 0x68, 0xaa, 0xbb, 0x85, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x38,
+    0x4d, 0xcb, 0xae, 0x51, 0x2a, 0x4d, 0x18, 0x03, 0x00, 0x00, 0x00, 0x78,
+    0x79, 0x7a
+  };
+  string expected;
+  for (int i = 0; i < 70000; i++) {
+    expected.push_back('a' + i % 26);
+  }
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    ArrayInputStream input(kFrame, sizeof(kFrame), kBlockSizes[i]);
+    Lz4InputStream lz4in(&input);
+    ReadString(&lz4in, expected);
+    const void* data;
+    int size;
+    EXPECT_FALSE(lz4in.Next(&data, &size));
+    EXPECT_TRUE(lz4in.ErrorMessage() == NULL);
+  }
+}
+#endif  // HAVE_LZ4
+
+#if HAVE_ZSTD
+TEST_F(IoTest, ZstdIo) {
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      for (int z = 0; z < kBlockSizeCount; z++) {
+        string compressed;
+        {
+          StringOutputStream output(&compressed);
+          ZstdOutputStream::Options options;
+          if (kBlockSizes[z] != -1) {
+            options.buffer_size = kBlockSizes[z];
+          }
+          ZstdOutputStream zstdout(&output, options);
+          WriteStuffLarge(&zstdout);
+          EXPECT_TRUE(zstdout.Close());
+        }
+        ArrayInputStream input(compressed.data(), compressed.size(),
+                               kBlockSizes[i]);
+        ZstdInputStream zstdin(&input, kBlockSizes[j]);
+        ReadStuffLarge(&zstdin);
+        EXPECT_TRUE(zstdin.ErrorMessage() == NULL);
+      }
+    }
+  }
+}
+
+TEST_F(IoTest, ZstdFrames) {
+  // Two frames, the first flushed midway, read as one stream.
+  string compressed;
+  {
+    StringOutputStream output(&compressed);
+    ZstdOutputStream zstdout(&output);
+    WriteString(&zstdout, "Hello world!\n");
+    EXPECT_TRUE(zstdout.Flush());
+    WriteString(&zstdout, "Some text.  Blah blah.");
+  }
+  {
+    StringOutputStream output(&compressed);
+    ZstdOutputStream::Options options;
+    options.compression_level = 19;
+    ZstdOutputStream zstdout(&output, options);
+    WriteString(&zstdout, "abcdefg01234567890123456789foobar");
+  }
+  {
+    ArrayInputStream input(compressed.data(), compressed.size(), 3);
+    ZstdInputStream zstdin(&input);
+    ReadStuff(&zstdin);
+    EXPECT_TRUE(zstdin.ErrorMessage() == NULL);
+  }
+
+  // A stream cut short is an error, and so is garbage.
+  {
+    ArrayInputStream input(compressed.data(), compressed.size() - 1);
+    ZstdInputStream zstdin(&input);
+    const void* data;
+    int size;
+    while (zstdin.Next(&data, &size)) {}
+    EXPECT_TRUE(zstdin.ErrorMessage() != NULL);
+  }
+  {
+    ArrayInputStream input("not zstd at all", 15);
+    ZstdInputStream zstdin(&input);
+    const void* data;
+    int size;
+    EXPECT_FALSE(zstdin.Next(&data, &size));
+    EXPECT_TRUE(zstdin.ErrorMessage() != NULL);
+  }
+}
+#endif  // HAVE_ZSTD
+
 // There is no string input, only string output.  Also, it doesn't support
 // explicit block sizes.  So, we'll only run one test and we'll use
 // ArrayInput to read back the results.
@@ -610,6 +948,239 @@ TEST_F(IoTest, FileIo) {
   }
 }
 
+// A CopyingInputStream of zeros which records the size of every read.
+class RecordingInputStream : public CopyingInputStream {
+ public:
+  explicit RecordingInputStream(int size) : remaining_(size) {}
+
+  int Read(void* buffer, int size) {
+    read_sizes_.push_back(size);
+    int result = min(size, remaining_);
+    memset(buffer, 0, result);
+    remaining_ -= result;
+    return result;
+  }
+
+  vector<int> read_sizes_;
+
+ private:
+  int remaining_;
+};
+
+TEST_F(IoTest, CopyingInputStreamAdaptiveBlocks) {
+  // Reads double while they fill the buffer, and stop growing at 1MB.
+  RecordingInputStream source(5 << 20);
+  CopyingInputStreamAdaptor input(&source);
+  const void* data;
+  int size;
+  int64 total = 0;
+  while (input.Next(&data, &size)) {
+    total += size;
+  }
+  EXPECT_EQ(5 << 20, total);
+  ASSERT_GE(source.read_sizes_.size(), 9);
+  EXPECT_EQ(8192, source.read_sizes_[0]);
+  EXPECT_EQ(16384, source.read_sizes_[1]);
+  EXPECT_EQ(1 << 20, source.read_sizes_[7]);
+  EXPECT_EQ(1 << 20, source.read_sizes_.back());
+
+  // A given block size is kept.
+  RecordingInputStream fixed_source(100000);
+  CopyingInputStreamAdaptor fixed_input(&fixed_source, 1000);
+  while (fixed_input.Next(&data, &size)) {}
+  for (int i = 0; i < fixed_source.read_sizes_.size(); i++) {
+    EXPECT_EQ(1000, fixed_source.read_sizes_[i]);
+  }
+
+  // A short read stops the growth.
+  RecordingInputStream short_source(10000);
+  CopyingInputStreamAdaptor short_input(&short_source);
+  while (short_input.Next(&data, &size)) {}
+  ASSERT_EQ(3, short_source.read_sizes_.size());
+  EXPECT_EQ(16384, short_source.read_sizes_[2]);
+}
+
+#ifndef _WIN32
+TEST_F(IoTest, DirectFileIo) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+
+  // Whether O_DIRECT is honored depends on the file system; the data must
+  // come out the same either way.
+  const int kDirectBlockSizes[] = {-1, 1, 4096, 10000};
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kDirectBlockSizes); i++) {
+    int file =
+      open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+    ASSERT_GE(file, 0);
+
+    {
+      FileOutputStream output(file);
+      WriteStuffLarge(&output);
+      EXPECT_EQ(0, output.GetErrno());
+    }
+    ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+    int flags = fcntl(file, F_GETFL);
+
+    {
+      DirectFileInputStream input(file, kDirectBlockSizes[i]);
+      ReadStuffLarge(&input);
+      EXPECT_EQ(0, input.GetErrno());
+      // The last read is short, which ends direct reads.
+      EXPECT_FALSE(input.direct());
+    }
+    // The descriptor's flags are left as they were.
+    EXPECT_EQ(flags, fcntl(file, F_GETFL));
+
+    close(file);
+  }
+}
+
+TEST_F(IoTest, DirectFileReadError) {
+  // -1 = invalid file descriptor.
+  DirectFileInputStream input(-1);
+
+  const void* buffer;
+  int size;
+  EXPECT_FALSE(input.Next(&buffer, &size));
+  EXPECT_EQ(EBADF, input.GetErrno());
+}
+
+TEST_F(IoTest, MmapFileIo) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+
+  // Sizes smaller than a page, and large enough to need several windows.
+  const int kInitialSizes[] = {-1, 1, 4096, 10000};
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kInitialSizes); i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      int file =
+        open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+      ASSERT_GE(file, 0);
+
+      {
+        MmapFileOutputStream output(file, kInitialSizes[i]);
+        WriteStuffLarge(&output);
+        EXPECT_EQ(0, output.GetErrno());
+      }
+
+      // The file is truncated to exactly what was written.
+      struct stat stats;
+      ASSERT_EQ(0, fstat(file, &stats));
+      EXPECT_EQ(200055, stats.st_size);
+      ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+
+      {
+        FileInputStream input(file, kBlockSizes[j]);
+        ReadStuffLarge(&input);
+        EXPECT_EQ(0, input.GetErrno());
+      }
+
+      close(file);
+    }
+  }
+}
+
+TEST_F(IoTest, MmapFileWriteError) {
+  // -1 = invalid file descriptor.
+  MmapFileOutputStream output(-1);
+  void* buffer;
+  int size;
+  EXPECT_FALSE(output.Next(&buffer, &size));
+  EXPECT_EQ(EBADF, output.GetErrno());
+}
+
+TEST_F(IoTest, IovecIo) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      int file =
+        open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+      ASSERT_GE(file, 0);
+
+      {
+        IovecOutputStream output(kBlockSizes[i]);
+        WriteStuff(&output);
+        EXPECT_TRUE(output.WriteTo(file));
+      }
+
+      ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+
+      {
+        FileInputStream input(file, kBlockSizes[j]);
+        ReadStuff(&input);
+        EXPECT_EQ(0, input.GetErrno());
+      }
+
+      close(file);
+    }
+  }
+}
+
+// Large bytes fields go into an IovecOutputStream by reference.
+TEST_F(IoTest, IovecAliasing) {
+  string big(100000, 'x');
+  string expected;
+  IovecOutputStream output(64);
+  {
+    CodedOutputStream coded_output(&output);
+    coded_output.EnableAliasing(true);
+    coded_output.WriteString("abc");
+    coded_output.WriteRawMaybeAliased(big.data(), big.size());
+    coded_output.WriteRawMaybeAliased("de", 2);
+    coded_output.WriteRawMaybeAliased(big.data(), big.size());
+    coded_output.WriteString("fgh");
+    EXPECT_EQ(200008, coded_output.ByteCount());
+    EXPECT_FALSE(coded_output.HadError());
+  }
+  expected = "abc" + big + "de" + big + "fgh";
+  EXPECT_EQ(expected.size(), output.ByteCount());
+
+  string actual;
+  int aliased = 0;
+  for (int i = 0; i < output.iovec_count(); i++) {
+    const struct iovec& iov = output.iovecs()[i];
+    if (iov.iov_base == big.data()) aliased++;
+    actual.append(reinterpret_cast<const char*>(iov.iov_base), iov.iov_len);
+  }
+  EXPECT_EQ(2, aliased);
+  EXPECT_TRUE(actual == expected);
+
+  // Enough iovecs to take several writev() calls.
+  output.Clear();
+  expected.clear();
+  for (int i = 0; i < 3000; i++) {
+    output.WriteAliasedRaw(big.data() + i, 7);
+    expected.append(big.data() + i, 7);
+    WriteString(&output, "y");
+    expected += "y";
+  }
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+  int file =
+    open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+  ASSERT_GE(file, 0);
+  EXPECT_TRUE(output.WriteTo(file));
+  ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+  {
+    FileInputStream input(file);
+    ReadString(&input, expected);
+  }
+  close(file);
+}
+
+// Streams that can't alias make EnableAliasing() a no-op.
+TEST_F(IoTest, AliasingUnsupported) {
+  uint8 buffer[1000];
+  string big(500, 'z');
+  {
+    ArrayOutputStream output(buffer, sizeof(buffer), 10);
+    CodedOutputStream coded_output(&output);
+    coded_output.EnableAliasing(true);
+    coded_output.WriteRawMaybeAliased(big.data(), big.size());
+    EXPECT_EQ(500, coded_output.ByteCount());
+  }
+  EXPECT_EQ(big, string(reinterpret_cast<char*>(buffer), 500));
+}
+#endif  // !_WIN32
+
 #if HAVE_ZLIB
 TEST_F(IoTest, GzipFileIo) {
   string filename = TestTempDir() + "/zero_copy_stream_test_file";
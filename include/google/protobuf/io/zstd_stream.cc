@@ -0,0 +1,311 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the implementation of classes ZstdInputStream and
+// ZstdOutputStream.
+
+#include "config.h"
+
+#if HAVE_ZSTD
+#include <google/protobuf/io/zstd_stream.h>
+
+#include <string.h>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+static const int kDefaultBufferSize = 65536;
+
+static const char kOutOfMemory[] = "Zstandard context allocation failed";
+static const char kTruncatedFrame[] = "Zstandard frame is truncated";
+static const char kSubStreamFailed[] = "writing the sub-stream failed";
+
+ZstdInputStream::ZstdInputStream(
+    ZeroCopyInputStream* sub_stream, int buffer_size)
+    : sub_stream_(sub_stream), context_(ZSTD_createDStream()),
+      error_message_(NULL), frame_pending_(0), output_full_(false),
+      output_size_(0), backup_bytes_(0), byte_count_(0) {
+  input_.src = NULL;
+  input_.size = 0;
+  input_.pos = 0;
+  if (buffer_size == -1) {
+    output_buffer_size_ = ZSTD_DStreamOutSize();
+  } else {
+    output_buffer_size_ = buffer_size;
+  }
+  GOOGLE_CHECK_GT(output_buffer_size_, 0);
+  output_buffer_ = new uint8[output_buffer_size_];
+  if (context_ == NULL) {
+    error_message_ = kOutOfMemory;
+  } else {
+    size_t result = ZSTD_initDStream(context_);
+    if (ZSTD_isError(result)) {
+      error_message_ = ZSTD_getErrorName(result);
+    }
+  }
+}
+
+ZstdInputStream::~ZstdInputStream() {
+  if (context_ != NULL) {
+    ZSTD_freeDStream(context_);
+  }
+  delete [] output_buffer_;
+}
+
+// implements ZeroCopyInputStream ----------------------------------
+bool ZstdInputStream::Next(const void** data, int* size) {
+  if (backup_bytes_ > 0) {
+    *data = output_buffer_ + output_size_ - backup_bytes_;
+    *size = backup_bytes_;
+    byte_count_ += backup_bytes_;
+    backup_bytes_ = 0;
+    return true;
+  }
+  if (error_message_ != NULL) {
+    return false;
+  }
+
+  while (true) {
+    // A full output buffer may have left decompressed data behind, which
+    // has to be collected before more input is given.  Once a frame is
+    // complete nothing is held back, and calling again would start on the
+    // next frame's header.
+    if (input_.pos == input_.size && !output_full_) {
+      const void* in;
+      int in_size;
+      if (!sub_stream_->Next(&in, &in_size)) {
+        if (frame_pending_ != 0) {
+          error_message_ = kTruncatedFrame;
+        }
+        return false;
+      }
+      input_.src = in;
+      input_.size = in_size;
+      input_.pos = 0;
+    }
+
+    ZSTD_outBuffer output = {
+        output_buffer_, static_cast<size_t>(output_buffer_size_), 0 };
+    size_t result = ZSTD_decompressStream(context_, &output, &input_);
+    if (ZSTD_isError(result)) {
+      error_message_ = ZSTD_getErrorName(result);
+      return false;
+    }
+    frame_pending_ = result;
+    output_full_ = output.pos == output.size && result != 0;
+
+    if (output.pos > 0) {
+      output_size_ = output.pos;
+      *data = output_buffer_;
+      *size = output.pos;
+      byte_count_ += output.pos;
+      return true;
+    }
+  }
+}
+
+void ZstdInputStream::BackUp(int count) {
+  GOOGLE_CHECK(backup_bytes_ == 0 && count <= output_size_)
+      << "BackUp() can only be called after Next().";
+  backup_bytes_ = count;
+  byte_count_ -= count;
+}
+
+bool ZstdInputStream::Skip(int count) {
+  const void* data;
+  int size;
+  while (count > 0) {
+    if (!Next(&data, &size)) return false;
+    if (size > count) {
+      BackUp(size - count);
+      return true;
+    }
+    count -= size;
+  }
+  return true;
+}
+
+int64 ZstdInputStream::ByteCount() const {
+  return byte_count_;
+}
+
+// =========================================================================
+
+ZstdOutputStream::Options::Options()
+    : buffer_size(kDefaultBufferSize),
+      compression_level(ZSTD_CLEVEL_DEFAULT) {}
+
+ZstdOutputStream::ZstdOutputStream(ZeroCopyOutputStream* sub_stream) {
+  Init(sub_stream, Options());
+}
+
+ZstdOutputStream::ZstdOutputStream(ZeroCopyOutputStream* sub_stream,
+                                   const Options& options) {
+  Init(sub_stream, options);
+}
+
+void ZstdOutputStream::Init(ZeroCopyOutputStream* sub_stream,
+                            const Options& options) {
+  sub_stream_ = sub_stream;
+  error_message_ = NULL;
+  closed_ = false;
+  output_.dst = NULL;
+  output_.size = 0;
+  output_.pos = 0;
+  input_size_ = 0;
+  byte_count_ = 0;
+
+  GOOGLE_CHECK_GT(options.buffer_size, 0);
+  input_buffer_size_ = options.buffer_size;
+  input_buffer_ = new uint8[input_buffer_size_];
+
+  context_ = ZSTD_createCStream();
+  if (context_ == NULL) {
+    error_message_ = kOutOfMemory;
+    return;
+  }
+  size_t result = ZSTD_initCStream(context_, options.compression_level);
+  if (ZSTD_isError(result)) {
+    error_message_ = ZSTD_getErrorName(result);
+  }
+}
+
+ZstdOutputStream::~ZstdOutputStream() {
+  Close();
+  if (context_ != NULL) {
+    ZSTD_freeCStream(context_);
+  }
+  delete [] input_buffer_;
+}
+
+bool ZstdOutputStream::NextOutput() {
+  if (output_.pos < output_.size) {
+    return true;
+  }
+  void* data;
+  int size;
+  if (!sub_stream_->Next(&data, &size)) {
+    output_.dst = NULL;
+    output_.size = 0;
+    output_.pos = 0;
+    error_message_ = kSubStreamFailed;
+    return false;
+  }
+  output_.dst = data;
+  output_.size = size;
+  output_.pos = 0;
+  return true;
+}
+
+bool ZstdOutputStream::Compress() {
+  ZSTD_inBuffer input = { input_buffer_, static_cast<size_t>(input_size_), 0 };
+  while (input.pos < input.size) {
+    if (!NextOutput()) {
+      return false;
+    }
+    size_t result = ZSTD_compressStream(context_, &output_, &input);
+    if (ZSTD_isError(result)) {
+      error_message_ = ZSTD_getErrorName(result);
+      return false;
+    }
+  }
+  byte_count_ += input_size_;
+  input_size_ = 0;
+  return true;
+}
+
+bool ZstdOutputStream::Finish(bool end) {
+  size_t remaining;
+  do {
+    if (!NextOutput()) {
+      return false;
+    }
+    remaining = end ? ZSTD_endStream(context_, &output_)
+                    : ZSTD_flushStream(context_, &output_);
+    if (ZSTD_isError(remaining)) {
+      error_message_ = ZSTD_getErrorName(remaining);
+      return false;
+    }
+  } while (remaining != 0);
+  // Notify lower layer of data.
+  sub_stream_->BackUp(output_.size - output_.pos);
+  // We don't own the buffer anymore.
+  output_.dst = NULL;
+  output_.size = 0;
+  output_.pos = 0;
+  return true;
+}
+
+// implements ZeroCopyOutputStream ---------------------------------
+bool ZstdOutputStream::Next(void** data, int* size) {
+  if (closed_ || error_message_ != NULL) {
+    return false;
+  }
+  if (input_size_ == input_buffer_size_ && !Compress()) {
+    return false;
+  }
+  *data = input_buffer_ + input_size_;
+  *size = input_buffer_size_ - input_size_;
+  input_size_ = input_buffer_size_;
+  return true;
+}
+
+void ZstdOutputStream::BackUp(int count) {
+  GOOGLE_CHECK_GE(input_size_, count);
+  input_size_ -= count;
+}
+
+int64 ZstdOutputStream::ByteCount() const {
+  return byte_count_ + input_size_;
+}
+
+bool ZstdOutputStream::Flush() {
+  if (closed_ || error_message_ != NULL) {
+    return false;
+  }
+  return Compress() && Finish(false);
+}
+
+bool ZstdOutputStream::Close() {
+  if (closed_ || error_message_ != NULL) {
+    return error_message_ == NULL;
+  }
+  closed_ = true;
+  return Compress() && Finish(true);
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // HAVE_ZSTD
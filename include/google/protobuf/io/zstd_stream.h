@@ -0,0 +1,173 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the definition for classes ZstdInputStream and
+// ZstdOutputStream, which read and write the Zstandard format through
+// libzstd, in the same way GzipInputStream and GzipOutputStream use zlib.
+// Zstandard compresses about as well as gzip at its default level and
+// decompresses several times faster.
+
+#ifndef GOOGLE_PROTOBUF_IO_ZSTD_STREAM_H__
+#define GOOGLE_PROTOBUF_IO_ZSTD_STREAM_H__
+
+#include <zstd.h>
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A ZeroCopyInputStream that reads Zstandard frames.  Concatenated frames
+// are read as one stream.
+class LIBPROTOBUF_EXPORT ZstdInputStream : public ZeroCopyInputStream {
+ public:
+  // buffer_size may be -1 for the default of ZSTD_DStreamOutSize(), which
+  // holds one full block.
+  explicit ZstdInputStream(
+      ZeroCopyInputStream* sub_stream,
+      int buffer_size = -1);
+  virtual ~ZstdInputStream();
+
+  // Return last error message or NULL if no error.  A stream that ends in
+  // the middle of a frame is an error.
+  inline const char* ErrorMessage() const {
+    return error_message_;
+  }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size);
+  void BackUp(int count);
+  bool Skip(int count);
+  int64 ByteCount() const;
+
+ private:
+  ZeroCopyInputStream* sub_stream_;
+  ZSTD_DStream* context_;
+  const char* error_message_;
+
+  // Compressed bytes from sub_stream_; those before pos are consumed.
+  ZSTD_inBuffer input_;
+  // Zero once a frame is complete, otherwise what ZSTD_decompressStream()
+  // hinted it wants next.
+  size_t frame_pending_;
+  // The last call filled the output buffer, so more may be held back.
+  bool output_full_;
+
+  uint8* output_buffer_;
+  int output_buffer_size_;
+  int output_size_;       // Bytes of output_buffer_ filled.
+  int backup_bytes_;      // Bytes at the end given back by BackUp().
+  int64 byte_count_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ZstdInputStream);
+};
+
+
+class LIBPROTOBUF_EXPORT ZstdOutputStream : public ZeroCopyOutputStream {
+ public:
+  struct Options {
+    // What size buffer to use internally.  Defaults to 64kB.
+    int buffer_size;
+
+    // A number between 1 and ZSTD_maxCLevel() (19 or more), where higher
+    // levels compress better and more slowly; decompression speed hardly
+    // depends on it.  Defaults to ZSTD_CLEVEL_DEFAULT (3).
+    int compression_level;
+
+    Options();  // Initializes with default values.
+  };
+
+  // Create a ZstdOutputStream with default options.
+  explicit ZstdOutputStream(ZeroCopyOutputStream* sub_stream);
+
+  // Create a ZstdOutputStream with the given options.
+  ZstdOutputStream(
+      ZeroCopyOutputStream* sub_stream,
+      const Options& options);
+
+  virtual ~ZstdOutputStream();
+
+  // Return last error message or NULL if no error.
+  inline const char* ErrorMessage() const {
+    return error_message_;
+  }
+
+  // Flushes data written so far to compressed data in the underlying
+  // stream.  It is the caller's responsibility to flush the underlying
+  // stream if necessary.
+  // Returns true if no error.
+  bool Flush();
+
+  // Writes out all data and ends the frame.
+  // It is the caller's responsibility to close the underlying stream if
+  // necessary.
+  // Returns true if no error.
+  bool Close();
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+
+ private:
+  ZeroCopyOutputStream* sub_stream_;
+  ZSTD_CStream* context_;
+  const char* error_message_;
+  bool closed_;
+
+  // Result from calling Next() on sub_stream_; compressed data is written
+  // straight into it.
+  ZSTD_outBuffer output_;
+
+  uint8* input_buffer_;
+  int input_buffer_size_;
+  int input_size_;        // Bytes of input_buffer_ handed out.
+  int64 byte_count_;      // Bytes compressed so far.
+
+  // Shared constructor code.
+  void Init(ZeroCopyOutputStream* sub_stream, const Options& options);
+
+  // Gets a new buffer from sub_stream_ if output_ is full.
+  bool NextOutput();
+  // Compresses the buffered input.  Returns false on error.
+  bool Compress();
+  // Calls ZSTD_flushStream() or, if end, ZSTD_endStream() until it is done,
+  // then gives the unused part of output_ back to sub_stream_.
+  bool Finish(bool end);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ZstdOutputStream);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_ZSTD_STREAM_H__
@@ -34,10 +34,44 @@
 #include <iostream>
 
 #include <google/protobuf/test_util_lite.h>
+#include <google/protobuf/unittest_table_driven_lite.pb.h>
 #include <google/protobuf/stubs/common.h>
 
 using namespace std;
 
+namespace {
+
+// Counts the fields of a lite message, and the values set in them, through
+// VisitFields().
+template <typename Message>
+class FieldCounter {
+ public:
+  explicit FieldCounter(const Message& message)
+    : message_(message), singular_(0), repeated_(0), values_(0),
+      last_number_(0), in_order_(true) {}
+
+  template <typename Field>
+  void operator()(Field) {
+    if (Field::kRepeated) {
+      ++repeated_;
+    } else {
+      ++singular_;
+    }
+    values_ += Field::Size(message_);
+    in_order_ = in_order_ && Field::kNumber > last_number_;
+    last_number_ = Field::kNumber;
+  }
+
+  const Message& message_;
+  int singular_;
+  int repeated_;
+  int values_;
+  int last_number_;
+  bool in_order_;
+};
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   string data, packed_data;
 
@@ -107,6 +141,362 @@ int main(int argc, char* argv[]) {
     google::protobuf::TestUtilLite::ExpectPackedExtensionsClear(message);
   }
 
+  {
+    google::protobuf::Arena arena;
+    protobuf_unittest::TestAllTypesLite* message =
+        google::protobuf::Arena::CreateMessage<
+            protobuf_unittest::TestAllTypesLite>(&arena);
+    GOOGLE_CHECK(message->GetArena() == &arena);
+    GOOGLE_CHECK(message->ParseFromString(data));
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(*message);
+    google::protobuf::TestUtilLite::ModifyRepeatedFields(message);
+    google::protobuf::TestUtilLite::ExpectRepeatedFieldsModified(*message);
+
+    // Swapping with a heap message exchanges contents, not storage.
+    protobuf_unittest::TestAllTypesLite heap_message;
+    google::protobuf::TestUtilLite::SetAllFields(&heap_message);
+    heap_message.Swap(message);
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(*message);
+    google::protobuf::TestUtilLite::ExpectRepeatedFieldsModified(heap_message);
+
+    // Released fields are heap copies the caller owns.
+    delete message->release_optional_nested_message();
+    delete message->release_optional_string();
+    delete message->mutable_repeated_string()->ReleaseLast();
+    message->Clear();
+    google::protobuf::TestUtilLite::ExpectClear(*message);
+  }
+
+  {
+    google::protobuf::Arena arena;
+    protobuf_unittest::TestAllExtensionsLite* message =
+        google::protobuf::Arena::CreateMessage<
+            protobuf_unittest::TestAllExtensionsLite>(&arena);
+    GOOGLE_CHECK(message->ParseFromString(data));
+    google::protobuf::TestUtilLite::ExpectAllExtensionsSet(*message);
+  }
+
+  {
+    // Flat and boxed points share a wire format.
+    protobuf_unittest::TestFlatLite flat, flat2;
+    protobuf_unittest::TestFlatBoxedLite boxed;
+    for (int i = 0; i < 100; i++) {
+      protobuf_unittest::TestFlatPointLite::Flat* point = flat.add_point();
+      GOOGLE_CHECK(point->x == 0 && point->y == 0 && point->label == 0);
+      point->x = i * 0.5f;
+      point->y = i * -0.25;
+      point->label = -i;
+    }
+    string flat_data = flat.SerializeAsString();
+    GOOGLE_CHECK_EQ(flat.ByteSize(), static_cast<int>(flat_data.size()));
+    GOOGLE_CHECK(boxed.ParseFromString(flat_data));
+    GOOGLE_CHECK_EQ(boxed.point_size(), 100);
+    GOOGLE_CHECK_EQ(boxed.point(7).x(), 3.5f);
+    GOOGLE_CHECK_EQ(boxed.point(7).y(), -1.75);
+    GOOGLE_CHECK_EQ(boxed.point(7).label(), -7);
+    GOOGLE_CHECK(boxed.SerializeAsString() == flat_data);
+
+    // Fields out of order or repeated take the slow path.
+    protobuf_unittest::TestFlatPointLite* point = boxed.add_point();
+    point->set_label(1);
+    point->set_y(2);
+    point->set_x(3);
+    string shuffled;
+    point->SerializeToString(&shuffled);
+    string boxed_data = boxed.SerializeAsString() + "\x0a" +
+                        static_cast<char>(shuffled.size() * 2) +
+                        shuffled.substr(5) + shuffled.substr(0, 5) +
+                        shuffled;
+    GOOGLE_CHECK(flat2.ParseFromString(boxed_data));
+    GOOGLE_CHECK_EQ(flat2.point_size(), 102);
+    GOOGLE_CHECK_EQ(flat2.point(100).x, 3);
+    GOOGLE_CHECK_EQ(flat2.point(101).label, 1);
+    flat2.mutable_point()->RemoveLast();
+    flat2.mutable_point()->RemoveLast();
+    GOOGLE_CHECK(flat2.SerializeAsString() == flat_data);
+
+    // A point missing fields still parses, like a boxed one does; the
+    // struct has no has-bits, so they read as their defaults, even in a
+    // slot that held another point before.
+    GOOGLE_CHECK(flat2.ParsePartialFromString(
+        string("\x0a\x05\x0d\0\0\0\0\x0a\x05\x0d\0\0\0\0", 14)));
+    GOOGLE_CHECK_EQ(flat2.point_size(), 2);
+    GOOGLE_CHECK_EQ(flat2.point(1).x, 0);
+    GOOGLE_CHECK_EQ(flat2.point(1).y, 0);
+    GOOGLE_CHECK_EQ(flat2.point(1).label, 0);
+  }
+
+  {
+    // A message of required fixed-width fields has a constant size once they
+    // are all set, and is sized field by field until then.
+    protobuf_unittest::TestFlatBoxedLite boxed;
+    protobuf_unittest::TestFlatPointLite* point = boxed.add_point();
+    point->set_x(1);
+    GOOGLE_CHECK_EQ(point->ByteSize(), 5);
+    GOOGLE_CHECK_EQ(point->GetCachedSize(), 5);
+    GOOGLE_CHECK_EQ(boxed.ByteSize(),
+                    static_cast<int>(boxed.SerializePartialAsString().size()));
+    point->set_y(2);
+    point->set_label(3);
+    GOOGLE_CHECK_EQ(point->GetCachedSize(),
+                    protobuf_unittest::TestFlatPointLite::kByteSize);
+    GOOGLE_CHECK_EQ(boxed.ByteSize(),
+                    2 + protobuf_unittest::TestFlatPointLite::kByteSize);
+    GOOGLE_CHECK_EQ(boxed.ByteSize(),
+                    static_cast<int>(boxed.SerializeAsString().size()));
+  }
+
+  {
+    // Runs of scalars in order are read straight from the buffer, but not
+    // past a limit, and not when a field is missing.
+    protobuf_unittest::TestAllTypesLite message, in_order, prefix;
+    google::protobuf::TestUtilLite::SetAllFields(&in_order);
+    prefix.set_optional_int32(101);
+    prefix.set_optional_int64(102);
+    google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const google::protobuf::uint8*>(data.data()),
+        data.size());
+    input.PushLimit(prefix.ByteSize());
+    GOOGLE_CHECK(message.MergePartialFromCodedStream(&input));
+    GOOGLE_CHECK_EQ(message.optional_int64(), 102);
+    GOOGLE_CHECK(!message.has_optional_uint32());
+    GOOGLE_CHECK_EQ(message.optional_uint32(), 0);
+    GOOGLE_CHECK(!message.optional_bool());
+
+    in_order.clear_optional_int64();
+    GOOGLE_CHECK(message.ParseFromString(in_order.SerializeAsString()));
+    GOOGLE_CHECK_EQ(message.optional_int32(), 101);
+    GOOGLE_CHECK(!message.has_optional_int64());
+    GOOGLE_CHECK_EQ(message.optional_uint32(), 103);
+    GOOGLE_CHECK(message.optional_bool());
+  }
+
+  {
+    // Table-driven parsers read what the generated switches read.
+    protobuf_unittest::TestAllTypesTableDrivenLite message;
+    GOOGLE_CHECK(message.ParseFromString(data));
+    GOOGLE_CHECK_EQ(message.optional_int32(), 101);
+    GOOGLE_CHECK(message.optional_string() == "115");
+    GOOGLE_CHECK_EQ(message.optionalgroup().a(), 117);
+    GOOGLE_CHECK_EQ(message.repeated_int32(1), 301);
+    GOOGLE_CHECK(message.SerializeAsString() == data);
+    GOOGLE_CHECK(message.ParseFromString(data + data));
+    GOOGLE_CHECK_EQ(message.repeated_int32_size(), 4);
+    GOOGLE_CHECK_EQ(message.repeated_nested_message_size(), 4);
+
+    // Fields out of order, and tags it doesn't know.
+    protobuf_unittest::TestAllTypesTableDrivenLite last, first;
+    last.set_default_string("last");
+    first.set_optional_int32(1);
+    GOOGLE_CHECK(message.ParseFromString(last.SerializeAsString() +
+                                         packed_data +
+                                         first.SerializeAsString()));
+    GOOGLE_CHECK(message.default_string() == "last");
+    GOOGLE_CHECK_EQ(message.optional_int32(), 1);
+    GOOGLE_CHECK_EQ(message.ByteSize(), last.ByteSize() + first.ByteSize());
+
+    google::protobuf::Arena arena;
+    protobuf_unittest::TestAllTypesTableDrivenLite* arena_message =
+        google::protobuf::Arena::CreateMessage<
+            protobuf_unittest::TestAllTypesTableDrivenLite>(&arena);
+    GOOGLE_CHECK(arena_message->ParseFromString(data));
+    GOOGLE_CHECK(arena_message->SerializeAsString() == data);
+
+    // Packed and unpacked encodings of a field are both accepted.
+    protobuf_unittest::TestPackedTypesTableDrivenLite packed;
+    protobuf_unittest::TestUnpackedTypesTableDrivenLite unpacked;
+    GOOGLE_CHECK(packed.ParseFromString(packed_data));
+    GOOGLE_CHECK(packed.SerializeAsString() == packed_data);
+    GOOGLE_CHECK(unpacked.ParseFromString(packed_data));
+    GOOGLE_CHECK_EQ(unpacked.unpacked_int32_size(), 2);
+    GOOGLE_CHECK_EQ(unpacked.unpacked_enum(1),
+                    protobuf_unittest::FOREIGN_LITE_BAZ);
+    GOOGLE_CHECK(packed.ParseFromString(unpacked.SerializeAsString()));
+    GOOGLE_CHECK(packed.SerializeAsString() == packed_data);
+
+    protobuf_unittest::TestExtensionsTableDrivenLite extensions;
+    GOOGLE_CHECK(extensions.ParseFromString(data));
+    GOOGLE_CHECK_EQ(extensions.optional_int32(), 101);
+    GOOGLE_CHECK_EQ(extensions.GetExtension(
+        protobuf_unittest::optional_int64_table_driven_extension), 102);
+    GOOGLE_CHECK(extensions.GetExtension(
+        protobuf_unittest::repeated_string_table_driven_extension, 1) == "315");
+
+    protobuf_unittest::TestFlatLite flat;
+    protobuf_unittest::TestFlatTableDrivenLite flat2;
+    for (int i = 0; i < 10; i++) {
+      flat.add_point()->label = i;
+    }
+    GOOGLE_CHECK(flat2.ParseFromString(flat.SerializeAsString()));
+    GOOGLE_CHECK_EQ(flat2.point_size(), 10);
+    GOOGLE_CHECK_EQ(flat2.point(9).label, 9);
+    GOOGLE_CHECK(flat2.ParsePartialFromString(
+        string("\x0a\x05\x0d\0\0\0\0", 7)));
+    GOOGLE_CHECK_EQ(flat2.point_size(), 1);
+    GOOGLE_CHECK_EQ(flat2.point(0).label, 0);
+  }
+
+  {
+    // Single-pass serialization produces the same bytes.
+    protobuf_unittest::TestAllTypesLite message;
+    protobuf_unittest::TestAllExtensionsLite extensions;
+    protobuf_unittest::TestPackedTypesLite packed;
+    protobuf_unittest::TestPackedExtensionsLite packed_extensions;
+    protobuf_unittest::TestFlatLite flat;
+    string reverse_data;
+    GOOGLE_CHECK(message.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data.empty());
+    GOOGLE_CHECK(message.ParseFromString(data));
+    GOOGLE_CHECK(message.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data == data);
+    GOOGLE_CHECK(extensions.ParseFromString(data));
+    GOOGLE_CHECK(extensions.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data == data);
+    GOOGLE_CHECK(packed.ParseFromString(packed_data));
+    GOOGLE_CHECK(packed.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data == packed_data);
+    GOOGLE_CHECK(packed_extensions.ParseFromString(packed_data));
+    GOOGLE_CHECK(packed_extensions.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data == packed_data);
+    for (int i = 0; i < 3; i++) {
+      flat.add_point()->label = i;
+    }
+    GOOGLE_CHECK(flat.SerializeToStringSinglePass(&reverse_data));
+    GOOGLE_CHECK(reverse_data == flat.SerializeAsString());
+
+    // A buffer that has to grow many times, and is then reused.
+    google::protobuf::io::ReverseCodedOutputBuffer buffer(1);
+    for (int i = 0; i < 100; i++) {
+      message.SerializeReverse(&buffer);
+    }
+    GOOGLE_CHECK_EQ(buffer.ByteCount(), 100 * static_cast<int>(data.size()));
+    GOOGLE_CHECK(string(reinterpret_cast<const char*>(buffer.data()),
+                        data.size()) == data);
+    buffer.Clear();
+    message.SerializeReverse(&buffer);
+    GOOGLE_CHECK(string(reinterpret_cast<const char*>(buffer.data()),
+                        buffer.ByteCount()) == data);
+  }
+
+  {
+    protobuf_unittest::TestAllTypesLite message;
+    FieldCounter<protobuf_unittest::TestAllTypesLite> empty(message);
+    protobuf_unittest::TestAllTypesLite::VisitFields(&empty);
+    GOOGLE_CHECK_EQ(empty.singular_ + empty.repeated_, 68);
+    GOOGLE_CHECK_EQ(empty.values_, 0);
+    GOOGLE_CHECK(empty.in_order_);
+
+    google::protobuf::TestUtilLite::SetAllFields(&message);
+    FieldCounter<protobuf_unittest::TestAllTypesLite> counter(message);
+    protobuf_unittest::TestAllTypesLite::VisitFields(&counter);
+    // SetAllFields() skips the four singular and two repeated STRING_PIECE
+    // and CORD fields, and adds two values to every other repeated field.
+    GOOGLE_CHECK_EQ(counter.values_,
+                    (counter.singular_ - 4) + 2 * (counter.repeated_ - 2));
+
+    typedef protobuf_unittest::TestAllTypesLite::Fields Fields;
+    GOOGLE_CHECK_EQ(Fields::optional_int32::kNumber, 1);
+    GOOGLE_CHECK_EQ(Fields::optional_int32::kType,
+                    google::protobuf::internal::WireFormatLite::TYPE_INT32);
+    GOOGLE_CHECK_EQ(Fields::optional_int32::Get(message, 0), 101);
+    GOOGLE_CHECK(strcmp(Fields::optionalgroup::Name(), "optionalgroup") == 0);
+    GOOGLE_CHECK_EQ(Fields::optionalgroup::Get(message, 0).a(), 117);
+    GOOGLE_CHECK(Fields::repeated_string::kRepeated);
+    GOOGLE_CHECK_EQ(Fields::repeated_string::Size(message), 2);
+    GOOGLE_CHECK(Fields::repeated_string::Get(message, 1) == "315");
+    GOOGLE_CHECK(Fields::repeated_nested_enum::Get(message, 0) ==
+                 protobuf_unittest::TestAllTypesLite::BAR);
+  }
+
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  {
+    // Moves hand over the fields of heap messages without copying them.
+    protobuf_unittest::TestAllTypesLite message;
+    google::protobuf::TestUtilLite::SetAllFields(&message);
+    const string* string_field = &message.optional_string();
+    protobuf_unittest::TestAllTypesLite moved(std::move(message));
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(moved);
+    GOOGLE_CHECK(&moved.optional_string() == string_field);
+    message = std::move(moved);
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(message);
+    GOOGLE_CHECK(&message.optional_string() == string_field);
+
+    // Between arenas, they copy.
+    google::protobuf::Arena arena;
+    protobuf_unittest::TestAllTypesLite* arena_message =
+        google::protobuf::Arena::CreateMessage<
+            protobuf_unittest::TestAllTypesLite>(&arena);
+    *arena_message = std::move(message);
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(*arena_message);
+    protobuf_unittest::TestAllTypesLite from_arena(std::move(*arena_message));
+    google::protobuf::TestUtilLite::ExpectAllFieldsSet(from_arena);
+    GOOGLE_CHECK(from_arena.SerializeAsString() == data);
+
+    google::protobuf::RepeatedPtrField<string> strings;
+    strings.Add()->assign("a");
+    const string* element = &strings.Get(0);
+    google::protobuf::RepeatedPtrField<string> moved_strings(std::move(strings));
+    GOOGLE_CHECK_EQ(moved_strings.size(), 1);
+    GOOGLE_CHECK(&moved_strings.Get(0) == element);
+    google::protobuf::RepeatedField<int> ints;
+    for (int i = 0; i < 10; i++) ints.Add(i);
+    const int* elements = ints.data();
+    google::protobuf::RepeatedField<int> moved_ints;
+    moved_ints = std::move(ints);
+    GOOGLE_CHECK_EQ(moved_ints.size(), 10);
+    GOOGLE_CHECK(moved_ints.data() == elements);
+
+    // The rvalue setters and set_allocated_foo() keep the caller's buffers.
+    string value(1000, 'x');
+    const char* buffer = value.data();
+    message.Clear();
+    message.set_optional_bytes(std::move(value));
+    GOOGLE_CHECK(message.optional_bytes().data() == buffer);
+    value.assign(1000, 'y');
+    buffer = value.data();
+    message.add_repeated_bytes(std::move(value));
+    GOOGLE_CHECK(message.repeated_bytes(0).data() == buffer);
+    string* allocated = new string("z");
+    message.set_allocated_optional_string(allocated);
+    GOOGLE_CHECK(message.has_optional_string());
+    GOOGLE_CHECK(&message.optional_string() == allocated);
+    message.set_allocated_optional_string(NULL);
+    GOOGLE_CHECK(!message.has_optional_string());
+    protobuf_unittest::TestAllTypesLite::NestedMessage* nested =
+        new protobuf_unittest::TestAllTypesLite::NestedMessage;
+    message.set_allocated_optional_nested_message(nested);
+    GOOGLE_CHECK(&message.optional_nested_message() == nested);
+
+    // On an arena, the arena takes ownership.
+    arena_message->Clear();
+    arena_message->set_allocated_optional_string(new string("z"));
+    arena_message->set_allocated_optional_nested_message(
+        new protobuf_unittest::TestAllTypesLite::NestedMessage);
+    GOOGLE_CHECK(arena_message->has_optional_nested_message());
+
+    // A submessage from the same arena is used as is; one from another
+    // arena, or one from an arena given to a heap message, is copied.
+    nested = google::protobuf::Arena::CreateMessage<
+        protobuf_unittest::TestAllTypesLite::NestedMessage>(&arena);
+    nested->set_bb(1);
+    arena_message->set_allocated_optional_nested_message(nested);
+    GOOGLE_CHECK(&arena_message->optional_nested_message() == nested);
+    google::protobuf::Arena other_arena;
+    nested = google::protobuf::Arena::CreateMessage<
+        protobuf_unittest::TestAllTypesLite::NestedMessage>(&other_arena);
+    nested->set_bb(2);
+    arena_message->set_allocated_optional_nested_message(nested);
+    GOOGLE_CHECK(&arena_message->optional_nested_message() != nested);
+    GOOGLE_CHECK(arena_message->optional_nested_message().GetArena() ==
+                 &arena);
+    GOOGLE_CHECK_EQ(arena_message->optional_nested_message().bb(), 2);
+    message.set_allocated_optional_nested_message(nested);
+    GOOGLE_CHECK(&message.optional_nested_message() != nested);
+    GOOGLE_CHECK(message.optional_nested_message().GetArena() == NULL);
+    GOOGLE_CHECK_EQ(message.optional_nested_message().bb(), 2);
+  }
+#endif
+
   cout << "PASS" << endl;
   return 0;
 }
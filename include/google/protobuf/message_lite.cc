@@ -110,10 +110,10 @@ inline bool InlineParsePartialFromCodedStream(io::CodedInputStream* input,
                                               MessageLite* message)
                                               GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 inline bool InlineParseFromArray(const void* data, int size,
-                                 MessageLite* message)
+                                 MessageLite* message, bool aliasing)
                                  GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 inline bool InlineParsePartialFromArray(const void* data, int size,
-                                        MessageLite* message)
+                                        MessageLite* message, bool aliasing)
                                         GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
 bool InlineMergeFromCodedStream(io::CodedInputStream* input,
@@ -138,15 +138,18 @@ bool InlineParsePartialFromCodedStream(io::CodedInputStream* input,
   return message->MergePartialFromCodedStream(input);
 }
 
-bool InlineParseFromArray(const void* data, int size, MessageLite* message) {
+bool InlineParseFromArray(const void* data, int size, MessageLite* message,
+                          bool aliasing) {
   io::CodedInputStream input(reinterpret_cast<const uint8*>(data), size);
+  input.EnableAliasing(aliasing);
   return InlineParseFromCodedStream(&input, message) &&
          input.ConsumedEntireMessage();
 }
 
 bool InlineParsePartialFromArray(const void* data, int size,
-                                 MessageLite* message) {
+                                 MessageLite* message, bool aliasing) {
   io::CodedInputStream input(reinterpret_cast<const uint8*>(data), size);
+  input.EnableAliasing(aliasing);
   return InlineParsePartialFromCodedStream(&input, message) &&
          input.ConsumedEntireMessage();
 }
@@ -196,19 +199,27 @@ bool MessageLite::ParsePartialFromBoundedZeroCopyStream(
 }
 
 bool MessageLite::ParseFromString(const string& data) {
-  return InlineParseFromArray(data.data(), data.size(), this);
+  return InlineParseFromArray(data.data(), data.size(), this, false);
 }
 
 bool MessageLite::ParsePartialFromString(const string& data) {
-  return InlineParsePartialFromArray(data.data(), data.size(), this);
+  return InlineParsePartialFromArray(data.data(), data.size(), this, false);
 }
 
 bool MessageLite::ParseFromArray(const void* data, int size) {
-  return InlineParseFromArray(data, size, this);
+  return InlineParseFromArray(data, size, this, false);
 }
 
 bool MessageLite::ParsePartialFromArray(const void* data, int size) {
-  return InlineParsePartialFromArray(data, size, this);
+  return InlineParsePartialFromArray(data, size, this, false);
+}
+
+bool MessageLite::ParseFromArrayAliased(const void* data, int size) {
+  return InlineParseFromArray(data, size, this, true);
+}
+
+bool MessageLite::ParsePartialFromArrayAliased(const void* data, int size) {
+  return InlineParsePartialFromArray(data, size, this, true);
 }
 
 
@@ -286,6 +297,36 @@ bool MessageLite::AppendPartialToString(string* output) const {
   return true;
 }
 
+bool MessageLite::AppendToStringSinglePass(string* output) const {
+  GOOGLE_DCHECK(IsInitialized()) << InitializationErrorMessage("serialize", *this);
+
+  // Write into the string's spare capacity, so a reused string makes no
+  // allocations, and then move the output to the front.
+  int old_size = output->size();
+  STLStringResizeUninitialized(output, output->capacity());
+  uint8* start = reinterpret_cast<uint8*>(string_as_array(output) + old_size);
+  int spare = output->size() - old_size;
+  int byte_size;
+  {
+    io::ReverseCodedOutputBuffer buffer(start, spare);
+    SerializeReverse(&buffer);
+    byte_size = buffer.ByteCount();
+    if (byte_size <= spare) {
+      memmove(start, buffer.data(), byte_size);
+    } else {
+      STLStringResizeUninitialized(output, old_size + byte_size);
+      memcpy(string_as_array(output) + old_size, buffer.data(), byte_size);
+    }
+  }
+  output->resize(old_size + byte_size);
+  return true;
+}
+
+bool MessageLite::SerializeToStringSinglePass(string* output) const {
+  output->clear();
+  return AppendToStringSinglePass(output);
+}
+
 bool MessageLite::SerializeToString(string* output) const {
   output->clear();
   return AppendToString(output);
@@ -312,6 +353,16 @@ bool MessageLite::SerializePartialToArray(void* data, int size) const {
   return true;
 }
 
+void MessageLite::SerializeReverse(
+    io::ReverseCodedOutputBuffer* output) const {
+  int byte_size = ByteSize();
+  uint8* start = output->Prepend(byte_size);
+  uint8* end = SerializeWithCachedSizesToArray(start);
+  if (end - start != byte_size) {
+    ByteSizeConsistencyError(byte_size, ByteSize(), end - start);
+  }
+}
+
 string MessageLite::SerializeAsString() const {
   // If the compiler implements the (Named) Return Value Optimization,
   // the local variable 'result' will not actually reside on the stack
@@ -136,6 +136,14 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // Like ParseFromArray(), but accepts messages that are missing
   // required fields.
   bool ParsePartialFromArray(const void* data, int size);
+  // Like ParseFromArray(), but fields declared with [ctype=STRING_PIECE] are
+  // left pointing into "data" instead of being copied (see
+  // io::CodedInputStream::EnableAliasing()).  "data" must stay alive and
+  // unmodified for as long as those fields are read.
+  bool ParseFromArrayAliased(const void* data, int size);
+  // Like ParseFromArrayAliased(), but accepts messages that are missing
+  // required fields.
+  bool ParsePartialFromArrayAliased(const void* data, int size);
 
 
   // Reads a protocol buffer from the stream and merges it into this
@@ -199,6 +207,12 @@ class LIBPROTOBUF_EXPORT MessageLite {
   bool AppendToString(string* output) const;
   // Like AppendToString(), but allows missing required fields.
   bool AppendPartialToString(string* output) const;
+  // Like SerializeToString() and AppendToString(), but serialize in a single
+  // pass over the message with SerializeReverse() rather than computing
+  // ByteSize() first, at the cost of copying the output once at the end.
+  // Usually faster for deep trees of small messages.
+  bool SerializeToStringSinglePass(string* output) const;
+  bool AppendToStringSinglePass(string* output) const;
 
   // Computes the serialized size of the message.  This recursively calls
   // ByteSize() on all embedded messages.  If a subclass does not override
@@ -216,6 +230,13 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // must point at a byte array of at least ByteSize() bytes.
   virtual uint8* SerializeWithCachedSizesToArray(uint8* target) const;
 
+  // Serializes the message back to front, prepending it to whatever "output"
+  // already holds.  Needs no cached sizes: the length of each embedded
+  // message is known once it has been written.  The default implementation
+  // calls ByteSize() and SerializeWithCachedSizesToArray(); generated lite
+  // messages override it.
+  virtual void SerializeReverse(io::ReverseCodedOutputBuffer* output) const;
+
   // Returns the result of the last call to ByteSize().  An embedded message's
   // size is needed both to serialize it (because embedded messages are
   // length-delimited) and to compute the outer message's size.  Caching
@@ -47,6 +47,13 @@ void RepeatedPtrFieldBase::Reserve(int new_size) {
 
   void** old_elements = elements_;
   total_size_ = max(total_size_ * 2, new_size);
+  if (arena_ != NULL) {
+    // The old array, if any, stays in the arena until it is cleared.
+    elements_ = reinterpret_cast<void**>(
+        arena_->AllocateAligned(total_size_ * sizeof(elements_[0])));
+    memcpy(elements_, old_elements, allocated_size_ * sizeof(elements_[0]));
+    return;
+  }
   elements_ = new void*[total_size_];
   memcpy(elements_, old_elements, allocated_size_ * sizeof(elements_[0]));
   if (old_elements != initial_space_) {
@@ -55,6 +62,10 @@ void RepeatedPtrFieldBase::Reserve(int new_size) {
 }
 
 void RepeatedPtrFieldBase::Swap(RepeatedPtrFieldBase* other) {
+  // RepeatedPtrField<T>::Swap() copies across arenas; callers that only have
+  // the base class cannot.
+  GOOGLE_CHECK(arena_ == other->arena_)
+      << "Can't swap repeated fields that live on different arenas.";
   void** swap_elements       = elements_;
   int    swap_current_size   = current_size_;
   int    swap_allocated_size = allocated_size_;
@@ -54,6 +54,7 @@
 #include <string>
 #include <iterator>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message_lite.h>
 
 namespace google {
@@ -77,11 +78,21 @@ template <typename Element>
 class RepeatedField {
  public:
   RepeatedField();
+  // Grows into memory allocated from "arena", which must outlive the field.
+  // A NULL arena means the heap.
+  explicit RepeatedField(Arena* arena);
   RepeatedField(const RepeatedField& other);
   ~RepeatedField();
 
   RepeatedField& operator=(const RepeatedField& other);
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  // Take the array of "other" rather than copying it, unless the two fields
+  // are on different arenas.  "other" is left valid but unspecified.
+  RepeatedField(RepeatedField&& other);
+  RepeatedField& operator=(RepeatedField&& other);
+#endif
+
   int size() const;
 
   const Element& Get(int index) const;
@@ -116,7 +127,8 @@ class RepeatedField {
   Element* mutable_data();
   const Element* data() const;
 
-  // Swap entire contents with "other".
+  // Swap entire contents with "other".  Fields on different arenas are
+  // swapped by copying.
   void Swap(RepeatedField* other);
 
   // Swap two elements.
@@ -136,12 +148,16 @@ class RepeatedField {
   // sizeof(*this)
   int SpaceUsedExcludingSelf() const;
 
+  // The arena the elements are allocated from, or NULL.
+  Arena* GetArena() const { return arena_; }
+
  private:
   static const int kInitialSize = 4;
 
   Element* elements_;
   int      current_size_;
   int      total_size_;
+  Arena*   arena_;
 
   Element  initial_space_[kInitialSize];
 
@@ -170,6 +186,7 @@ namespace internal {
 //    public:
 //     typedef MyType Type;
 //     static Type* New();
+//     static Type* New(Arena* arena);  // New() if "arena" is NULL
 //     static void Delete(Type*);
 //     static void Clear(Type*);
 //     static void Merge(const Type& from, Type* to);
@@ -191,7 +208,12 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   // use of AddFromCleared(), which is not part of the public interface.
   friend class ExtensionSet;
 
+  // The table-driven parser adds elements of message types it only knows
+  // through a factory; see AddFromFactory().
+  friend class TableDrivenParser;
+
   RepeatedPtrFieldBase();
+  explicit RepeatedPtrFieldBase(Arena* arena);
 
   // Must be called from destructor.
   template <typename TypeHandler>
@@ -234,6 +256,8 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   int SpaceUsedExcludingSelf() const;
 
+  Arena* GetArena() const { return arena_; }
+
 
   // Advanced memory management --------------------------------------
 
@@ -241,6 +265,12 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   typename TypeHandler::Type* AddFromCleared();
 
+  // Like Add(), but a new element comes from "create" rather than
+  // TypeHandler::New().
+  template <typename TypeHandler>
+  typename TypeHandler::Type* AddFromFactory(
+      typename TypeHandler::Type* (*create)(Arena* arena));
+
   template <typename TypeHandler>
   void AddAllocated(typename TypeHandler::Type* value);
   template <typename TypeHandler>
@@ -261,6 +291,9 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   int    current_size_;
   int    allocated_size_;
   int    total_size_;
+  // When set, the pointer array and every element are owned by the arena;
+  // elements added with AddAllocated() or AddCleared() are handed to it.
+  Arena* arena_;
 
   void*  initial_space_[kInitialSize];
 
@@ -279,6 +312,9 @@ class GenericTypeHandler {
  public:
   typedef GenericType Type;
   static GenericType* New() { return new GenericType; }
+  static GenericType* New(Arena* arena) {
+    return Arena::CreateMessage<GenericType>(arena);
+  }
   static void Delete(GenericType* value) { delete value; }
   static void Clear(GenericType* value) { value->Clear(); }
   static void Merge(const GenericType& from, GenericType* to) {
@@ -305,6 +341,9 @@ class LIBPROTOBUF_EXPORT StringTypeHandlerBase {
  public:
   typedef string Type;
   static string* New();
+  static string* New(Arena* arena) {
+    return arena == NULL ? New() : Arena::Create<string>(arena);
+  }
   static void Delete(string* value);
   static void Clear(string* value) { value->clear(); }
   static void Merge(const string& from, string* to) { *to = from; }
@@ -326,11 +365,21 @@ template <typename Element>
 class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
  public:
   RepeatedPtrField();
+  // Allocates the pointer array and new elements from "arena", which must
+  // outlive the field.  A NULL arena means the heap.
+  explicit RepeatedPtrField(Arena* arena);
   RepeatedPtrField(const RepeatedPtrField& other);
   ~RepeatedPtrField();
 
   RepeatedPtrField& operator=(const RepeatedPtrField& other);
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  // Take the elements of "other" rather than copying them, unless the two
+  // fields are on different arenas.  "other" is left valid but unspecified.
+  RepeatedPtrField(RepeatedPtrField&& other);
+  RepeatedPtrField& operator=(RepeatedPtrField&& other);
+#endif
+
   int size() const;
 
   const Element& Get(int index) const;
@@ -353,7 +402,8 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   Element** mutable_data();
   const Element* const* data() const;
 
-  // Swap entire contents with "other".
+  // Swap entire contents with "other".  Fields on different arenas are
+  // swapped by copying.
   void Swap(RepeatedPtrField* other);
 
   // Swap two elements.
@@ -379,15 +429,18 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   // excluding sizeof(*this).
   int SpaceUsedExcludingSelf() const;
 
+  // The arena the elements are allocated from, or NULL.
+  Arena* GetArena() const { return RepeatedPtrFieldBase::GetArena(); }
+
   // Advanced memory management --------------------------------------
   // When hardcore memory management becomes necessary -- as it often
   // does here at Google -- the following methods may be useful.
 
   // Add an already-allocated object, passing ownership to the
-  // RepeatedPtrField.
+  // RepeatedPtrField (or to its arena, which will delete it).
   void AddAllocated(Element* value);
   // Remove the last element and return it, passing ownership to the
-  // caller.
+  // caller.  On an arena, this returns a heap-allocated copy instead.
   // Requires:  size() > 0
   Element* ReleaseLast();
 
@@ -427,20 +480,30 @@ template <typename Element>
 inline RepeatedField<Element>::RepeatedField()
   : elements_(initial_space_),
     current_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
+}
+
+template <typename Element>
+inline RepeatedField<Element>::RepeatedField(Arena* arena)
+  : elements_(initial_space_),
+    current_size_(0),
+    total_size_(kInitialSize),
+    arena_(arena) {
 }
 
 template <typename Element>
 inline RepeatedField<Element>::RepeatedField(const RepeatedField& other)
   : elements_(initial_space_),
     current_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
   CopyFrom(other);
 }
 
 template <typename Element>
 RepeatedField<Element>::~RepeatedField() {
-  if (elements_ != initial_space_) {
+  if (elements_ != initial_space_ && arena_ == NULL) {
     delete [] elements_;
   }
 }
@@ -452,6 +515,34 @@ RepeatedField<Element>::operator=(const RepeatedField& other) {
   return *this;
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+template <typename Element>
+inline RepeatedField<Element>::RepeatedField(RepeatedField&& other)
+  : elements_(initial_space_),
+    current_size_(0),
+    total_size_(kInitialSize),
+    arena_(NULL) {
+  if (other.arena_ == NULL) {
+    Swap(&other);
+  } else {
+    CopyFrom(other);
+  }
+}
+
+template <typename Element>
+inline RepeatedField<Element>&
+RepeatedField<Element>::operator=(RepeatedField&& other) {
+  if (this != &other) {
+    if (arena_ == other.arena_) {
+      Swap(&other);
+    } else {
+      CopyFrom(other);
+    }
+  }
+  return *this;
+}
+#endif
+
 template <typename Element>
 inline int RepeatedField<Element>::size() const {
   return current_size_;
@@ -541,6 +632,14 @@ inline const Element* RepeatedField<Element>::data() const {
 
 template <typename Element>
 void RepeatedField<Element>::Swap(RepeatedField* other) {
+  if (arena_ != other->arena_) {
+    // The arrays cannot change owners.
+    RepeatedField temp(*other);
+    other->CopyFrom(*this);
+    CopyFrom(temp);
+    return;
+  }
+
   Element* swap_elements     = elements_;
   int      swap_current_size = current_size_;
   int      swap_total_size   = total_size_;
@@ -606,6 +705,13 @@ void RepeatedField<Element>::Reserve(int new_size) {
 
   Element* old_elements = elements_;
   total_size_ = max(total_size_ * 2, new_size);
+  if (arena_ != NULL) {
+    // The old array, if any, stays in the arena until it is cleared.
+    elements_ = reinterpret_cast<Element*>(
+        arena_->AllocateAligned(total_size_ * sizeof(Element)));
+    MoveArray(elements_, old_elements, current_size_);
+    return;
+  }
   elements_ = new Element[total_size_];
   MoveArray(elements_, old_elements, current_size_);
   if (old_elements != initial_space_) {
@@ -640,11 +746,21 @@ inline RepeatedPtrFieldBase::RepeatedPtrFieldBase()
   : elements_(initial_space_),
     current_size_(0),
     allocated_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
+}
+
+inline RepeatedPtrFieldBase::RepeatedPtrFieldBase(Arena* arena)
+  : elements_(initial_space_),
+    current_size_(0),
+    allocated_size_(0),
+    total_size_(kInitialSize),
+    arena_(arena) {
 }
 
 template <typename TypeHandler>
 void RepeatedPtrFieldBase::Destroy() {
+  if (arena_ != NULL) return;
   for (int i = 0; i < allocated_size_; i++) {
     TypeHandler::Delete(cast<TypeHandler>(elements_[i]));
   }
@@ -679,7 +795,7 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::Add() {
   }
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   ++allocated_size_;
-  typename TypeHandler::Type* result = TypeHandler::New();
+  typename TypeHandler::Type* result = TypeHandler::New(arena_);
   elements_[current_size_++] = result;
   return result;
 }
@@ -762,9 +878,24 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromCleared() {
   }
 }
 
+template <typename TypeHandler>
+inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromFactory(
+    typename TypeHandler::Type* (*create)(Arena* arena)) {
+  if (current_size_ < allocated_size_) {
+    return cast<TypeHandler>(elements_[current_size_++]);
+  }
+  if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
+  ++allocated_size_;
+  typename TypeHandler::Type* result = create(arena_);
+  elements_[current_size_++] = result;
+  return result;
+}
+
 template <typename TypeHandler>
 void RepeatedPtrFieldBase::AddAllocated(
     typename TypeHandler::Type* value) {
+  if (arena_ != NULL) arena_->Own(value);
+
   // Make room for the new pointer.
   if (current_size_ == total_size_) {
     // The array is completely full with no cleared objects, so grow it.
@@ -774,8 +905,10 @@ void RepeatedPtrFieldBase::AddAllocated(
     // There is no more space in the pointer array because it contains some
     // cleared objects awaiting reuse.  We don't want to grow the array in this
     // case because otherwise a loop calling AddAllocated() followed by Clear()
-    // would leak memory.
-    TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    // would leak memory.  (An arena frees the object itself.)
+    if (arena_ == NULL) {
+      TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    }
   } else if (current_size_ < allocated_size_) {
     // We have some cleared objects.  We don't care about their order, so we
     // can just move the first one to the end to make space.
@@ -800,6 +933,12 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseLast() {
     // with the last allocated element.
     elements_[current_size_] = elements_[allocated_size_];
   }
+  if (arena_ != NULL) {
+    // The caller gets ownership, so it cannot have the arena's object.
+    typename TypeHandler::Type* copy = TypeHandler::New(NULL);
+    TypeHandler::Merge(*result, copy);
+    result = copy;
+  }
   return result;
 }
 
@@ -811,6 +950,7 @@ inline int RepeatedPtrFieldBase::ClearedCount() const {
 template <typename TypeHandler>
 inline void RepeatedPtrFieldBase::AddCleared(
     typename TypeHandler::Type* value) {
+  if (arena_ != NULL) arena_->Own(value);
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   elements_[allocated_size_++] = value;
 }
@@ -818,7 +958,11 @@ inline void RepeatedPtrFieldBase::AddCleared(
 template <typename TypeHandler>
 inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseCleared() {
   GOOGLE_DCHECK_GT(allocated_size_, current_size_);
-  return cast<TypeHandler>(elements_[--allocated_size_]);
+  typename TypeHandler::Type* result =
+      cast<TypeHandler>(elements_[--allocated_size_]);
+  // Cleared objects are interchangeable; hand out a fresh one and leave the
+  // arena's to the arena.
+  return arena_ != NULL ? TypeHandler::New(NULL) : result;
 }
 
 }  // namespace internal
@@ -837,6 +981,10 @@ class RepeatedPtrField<string>::TypeHandler
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField() {}
 
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(Arena* arena)
+  : RepeatedPtrFieldBase(arena) {}
+
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField(
     const RepeatedPtrField& other) {
@@ -855,6 +1003,30 @@ inline RepeatedPtrField<Element>& RepeatedPtrField<Element>::operator=(
   return *this;
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(RepeatedPtrField&& other) {
+  if (other.GetArena() == NULL) {
+    RepeatedPtrFieldBase::Swap(&other);
+  } else {
+    CopyFrom(other);
+  }
+}
+
+template <typename Element>
+inline RepeatedPtrField<Element>& RepeatedPtrField<Element>::operator=(
+    RepeatedPtrField&& other) {
+  if (this != &other) {
+    if (GetArena() == other.GetArena()) {
+      RepeatedPtrFieldBase::Swap(&other);
+    } else {
+      CopyFrom(other);
+    }
+  }
+  return *this;
+}
+#endif
+
 template <typename Element>
 inline int RepeatedPtrField<Element>::size() const {
   return RepeatedPtrFieldBase::size();
@@ -909,6 +1081,14 @@ inline const Element* const* RepeatedPtrField<Element>::data() const {
 
 template <typename Element>
 void RepeatedPtrField<Element>::Swap(RepeatedPtrField* other) {
+  if (GetArena() != other->GetArena()) {
+    // The elements cannot change owners.
+    RepeatedPtrField temp;
+    temp.MergeFrom(*other);
+    other->CopyFrom(*this);
+    CopyFrom(temp);
+    return;
+  }
   RepeatedPtrFieldBase::Swap(other);
 }
 
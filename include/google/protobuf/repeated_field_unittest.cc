@@ -314,6 +314,27 @@ TEST(RepeatedField, Truncate) {
 #endif
 }
 
+TEST(RepeatedField, Arena) {
+  Arena arena;
+  RepeatedField<int> field(&arena);
+  EXPECT_TRUE(field.GetArena() == &arena);
+  for (int i = 0; i < 100; i++) {
+    field.Add(i);
+  }
+  EXPECT_EQ(100, field.size());
+  EXPECT_EQ(99, field.Get(99));
+  EXPECT_GE(arena.SpaceUsed(), 100 * sizeof(int));
+
+  // Swapping with a heap field copies.
+  RepeatedField<int> heap_field;
+  heap_field.Add(7);
+  field.Swap(&heap_field);
+  ASSERT_EQ(1, field.size());
+  EXPECT_EQ(7, field.Get(0));
+  ASSERT_EQ(100, heap_field.size());
+  EXPECT_EQ(42, heap_field.Get(42));
+}
+
 
 // ===================================================================
 // RepeatedPtrField tests.  These pretty much just mirror the RepeatedField
@@ -644,6 +665,35 @@ TEST(RepeatedPtrField, MutableDataIsMutable) {
   EXPECT_EQ("2", field.Get(0));
 }
 
+TEST(RepeatedPtrField, Arena) {
+  Arena arena;
+  RepeatedPtrField<string> field(&arena);
+  for (int i = 0; i < 20; i++) {
+    *field.Add() = "a string long enough to need its own heap buffer";
+  }
+  field.AddAllocated(new string("allocated"));
+  EXPECT_EQ(21, field.size());
+
+  // Objects handed to the caller are never the arena's.
+  string* released = field.ReleaseLast();
+  EXPECT_EQ("allocated", *released);
+  delete released;
+  released = field.ReleaseLast();
+  EXPECT_EQ("a string long enough to need its own heap buffer", *released);
+  delete released;
+
+  field.Clear();
+  EXPECT_EQ(19, field.ClearedCount());
+  delete field.ReleaseCleared();
+
+  RepeatedPtrField<string> heap_field;
+  heap_field.Add()->assign("heap");
+  field.Swap(&heap_field);
+  ASSERT_EQ(1, field.size());
+  EXPECT_EQ("heap", field.Get(0));
+  EXPECT_EQ(0, heap_field.size());
+}
+
 // ===================================================================
 
 // Iterator tests stolen from net/proto/proto-array_unittest.
@@ -40,6 +40,7 @@
 #include <cstddef>
 #include <string>
 #include <string.h>
+#include <utility>
 #if defined(__osf__)
 // Tru64 lacks stdint.h, but has inttypes.h which defines a superset of
 // what stdint.h would define.
@@ -235,6 +236,17 @@ static const uint64 kuint64max = GOOGLE_ULONGLONG(0xFFFFFFFFFFFFFFFF);
 #endif
 #endif
 
+#ifndef GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+#if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1600)
+// Move constructors, move assignment and the set_foo(string&&) accessors are
+// only declared when the compiler has C++11 rvalue references.
+#define GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES 1
+#else
+#define GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES 0
+#endif
+#endif
+
 // Delimits a block of code which may write to memory which is simultaneously
 // written by other threads, but which has been determined to be thread-safe
 // (e.g. because it is an idempotent write).
@@ -44,8 +44,8 @@
 #include HASH_SET_H
 #else
 #define MISSING_HASH
-#include <map>
-#include <set>
+#include <functional>
+#include <google/protobuf/stubs/hash_table.h>
 #endif
 
 namespace google {
@@ -53,18 +53,16 @@ namespace protobuf {
 
 #ifdef MISSING_HASH
 
-// This system doesn't have hash_map or hash_set.  Emulate them using map and
-// set.
+// This system doesn't have hash_map or hash_set.  Implement them with our own
+// open-addressing hash table (see hash_table.h).
 
-// Make hash<T> be the same as less<T>.  Note that everywhere where custom
-// hash functions are defined in the protobuf code, they are also defined such
-// that they can be used as "less" functions, which is required by MSVC anyway.
+// Hashes integers and enums to themselves, like the SGI and TR1 versions.
+// The custom hash functions in the protobuf code can also be used as "less"
+// functions, which MSVC requires, and so can these.
 template <typename Key>
 struct hash {
-  // Dummy, just to make derivative hash functions compile.
-  int operator()(const Key& key) {
-    GOOGLE_LOG(FATAL) << "Should never be called.";
-    return 0;
+  inline size_t operator()(const Key& key) const {
+    return static_cast<size_t>(key);
   }
 
   inline bool operator()(const Key& a, const Key& b) const {
@@ -72,13 +70,26 @@ struct hash {
   }
 };
 
-// Make sure char* is compared by value.
+template <typename Key>
+struct hash<const Key*> {
+  inline size_t operator()(const Key* key) const {
+    return reinterpret_cast<size_t>(key);
+  }
+
+  inline bool operator()(const Key* a, const Key* b) const {
+    return a < b;
+  }
+};
+
+// Make sure char* is hashed and compared by value.
 template <>
 struct hash<const char*> {
-  // Dummy, just to make derivative hash functions compile.
-  int operator()(const char* key) {
-    GOOGLE_LOG(FATAL) << "Should never be called.";
-    return 0;
+  inline size_t operator()(const char* str) const {
+    size_t result = 0;
+    for (; *str != '\0'; str++) {
+      result = 5 * result + *str;
+    }
+    return result;
   }
 
   inline bool operator()(const char* a, const char* b) const {
@@ -88,14 +99,24 @@ struct hash<const char*> {
 
 template <typename Key, typename Data,
           typename HashFcn = hash<Key>,
-          typename EqualKey = int >
-class hash_map : public std::map<Key, Data, HashFcn> {
+          typename EqualKey = std::equal_to<Key> >
+class hash_map : public internal::HashTable<
+    std::pair<const Key, Data>, Key,
+    internal::HashTableFirst<std::pair<const Key, Data> >,
+    HashFcn, EqualKey> {
+ public:
+  typedef Data mapped_type;
+
+  Data& operator[](const Key& key) {
+    return this->insert(std::pair<const Key, Data>(key, Data())).first->second;
+  }
 };
 
 template <typename Key,
           typename HashFcn = hash<Key>,
-          typename EqualKey = int >
-class hash_set : public std::set<Key, HashFcn> {
+          typename EqualKey = std::equal_to<Key> >
+class hash_set : public internal::HashTable<
+    Key, Key, internal::HashTableIdentity<Key>, HashFcn, EqualKey> {
 };
 
 #elif defined(_MSC_VER) && !defined(_STLPORT_VERSION)
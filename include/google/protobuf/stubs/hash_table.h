@@ -0,0 +1,307 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// The hash table behind hash_map and hash_set on systems that don't have
+// them (see hash.h).  It implements the parts of the hash_map interface the
+// protobuf code uses.
+//
+// The table is an array of slots, each holding the hash of an element and a
+// pointer to it, and collisions are resolved by probing the following
+// slots (linear probing).  A lookup compares the hashes it finds along the
+// way and only visits an element whose hash matches, so a probe mostly reads
+// one or two adjacent cache lines.  Elements live in their own allocations,
+// so that, like with map and the TR1 unordered_map, pointers and references
+// to them stay valid until they are erased.  Iterators are invalidated by
+// any insertion or erasure.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_HASH_TABLE_H__
+#define GOOGLE_PROTOBUF_STUBS_HASH_TABLE_H__
+
+#include <stddef.h>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Extracts the key from an element of a hash_set, which is the key.
+template <typename Value>
+struct HashTableIdentity {
+  inline const Value& operator()(const Value& value) const { return value; }
+};
+
+// Extracts the key from an element of a hash_map, which is a pair.
+template <typename Value>
+struct HashTableFirst {
+  inline const typename Value::first_type& operator()(
+      const Value& value) const {
+    return value.first;
+  }
+};
+
+template <typename Value, typename Key, typename ExtractKey,
+          typename HashFcn, typename EqualKey>
+class HashTable {
+ private:
+  struct Slot {
+    size_t hash;
+    Value* value;  // NULL if the slot is empty.
+  };
+
+  // Walks the slots from "slot" to "end", stopping at the full ones.
+  // ValueType is Value or const Value.
+  template <typename ValueType>
+  class Iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef ptrdiff_t difference_type;
+    typedef ValueType* pointer;
+    typedef ValueType& reference;
+
+    Iterator() : slot_(NULL), end_(NULL) {}
+    Iterator(const Slot* slot, const Slot* end) : slot_(slot), end_(end) {
+      SkipEmpty();
+    }
+    // Converts an iterator to a const_iterator.
+    template <typename OtherValueType>
+    Iterator(const Iterator<OtherValueType>& other)
+        : slot_(other.slot_), end_(other.end_) {}
+
+    reference operator*() const { return *slot_->value; }
+    pointer operator->() const { return slot_->value; }
+
+    Iterator& operator++() {
+      ++slot_;
+      SkipEmpty();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator result(*this);
+      ++*this;
+      return result;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return slot_ != other.slot_;
+    }
+
+   private:
+    template <typename OtherValueType> friend class Iterator;
+    friend class HashTable;
+
+    void SkipEmpty() {
+      while (slot_ != end_ && slot_->value == NULL) ++slot_;
+    }
+
+    const Slot* slot_;
+    const Slot* end_;
+  };
+
+ public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef size_t size_type;
+  typedef HashFcn hasher;
+  typedef EqualKey key_equal;
+  typedef Iterator<Value> iterator;
+  typedef Iterator<const Value> const_iterator;
+
+  HashTable() : slots_(NULL), mask_(0), size_(0) {}
+  HashTable(const HashTable& other) : slots_(NULL), mask_(0), size_(0) {
+    for (const_iterator it = other.begin(); it != other.end(); ++it) {
+      insert(*it);
+    }
+  }
+  ~HashTable() { clear(); }
+
+  HashTable& operator=(const HashTable& other) {
+    HashTable copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  void swap(HashTable& other) {
+    std::swap(slots_, other.slots_);
+    std::swap(mask_, other.mask_);
+    std::swap(size_, other.size_);
+  }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator begin() { return iterator(slots_, end_slot()); }
+  iterator end() { return iterator(end_slot(), end_slot()); }
+  const_iterator begin() const { return const_iterator(slots_, end_slot()); }
+  const_iterator end() const {
+    return const_iterator(end_slot(), end_slot());
+  }
+
+  iterator find(const key_type& key) {
+    return iterator(FindSlot(key, Hash(key)), end_slot());
+  }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(FindSlot(key, Hash(key)), end_slot());
+  }
+  size_type count(const key_type& key) const {
+    return FindSlot(key, Hash(key)) == end_slot() ? 0 : 1;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    const key_type& key = ExtractKey()(value);
+    // Hashing long names is a good part of the cost; do it once.
+    size_t hash = Hash(key);
+    Slot* slot = FindSlot(key, hash);
+    if (slot != end_slot()) {
+      return std::make_pair(iterator(slot, end_slot()), false);
+    }
+    // Keep at least a quarter of the slots empty, so probes stay short.
+    if ((size_ + 1) * 4 > capacity() * 3) {
+      Rehash(capacity() == 0 ? 8 : capacity() * 2);
+    }
+    slot = Place(hash, new Value(value));
+    ++size_;
+    return std::make_pair(iterator(slot, end_slot()), true);
+  }
+
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  size_type erase(const key_type& key) {
+    Slot* slot = FindSlot(key, Hash(key));
+    if (slot == end_slot()) return 0;
+    EraseSlot(slot);
+    return 1;
+  }
+
+  void erase(iterator position) {
+    EraseSlot(const_cast<Slot*>(position.slot_));
+  }
+
+  void clear() {
+    for (size_t i = 0; i < capacity(); i++) {
+      delete slots_[i].value;
+    }
+    delete [] slots_;
+    slots_ = NULL;
+    mask_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  size_t capacity() const { return slots_ == NULL ? 0 : mask_ + 1; }
+  Slot* end_slot() const { return slots_ + capacity(); }
+
+  // The hash functions in hash.h, like the pointer hash, leave the low bits
+  // poorly distributed, and those are the ones that pick the slot.  Multiply
+  // by the golden ratio and fold the high half of the product down.
+  static size_t Hash(const key_type& key) {
+    size_t hash = HashFcn()(key) *
+                  static_cast<size_t>(GOOGLE_ULONGLONG(0x9e3779b97f4a7c15));
+    return hash ^ (hash >> (sizeof(size_t) * 4));
+  }
+
+  // Returns end_slot() if "key", whose Hash() is "hash", isn't in the table.
+  Slot* FindSlot(const key_type& key, size_t hash) const {
+    if (size_ == 0) return end_slot();
+    for (size_t i = hash & mask_; ; i = (i + 1) & mask_) {
+      Slot* slot = slots_ + i;
+      if (slot->value == NULL) return end_slot();
+      if (slot->hash == hash && EqualKey()(ExtractKey()(*slot->value), key)) {
+        return slot;
+      }
+    }
+  }
+
+  // Puts "value" into the first empty slot from the one "hash" picks.  There
+  // must be one.
+  Slot* Place(size_t hash, Value* value) {
+    size_t i = hash & mask_;
+    while (slots_[i].value != NULL) i = (i + 1) & mask_;
+    slots_[i].hash = hash;
+    slots_[i].value = value;
+    return slots_ + i;
+  }
+
+  void Rehash(size_t new_capacity) {
+    Slot* old_slots = slots_;
+    size_t old_capacity = capacity();
+    slots_ = new Slot[new_capacity];
+    mask_ = new_capacity - 1;
+    for (size_t i = 0; i < new_capacity; i++) {
+      slots_[i].value = NULL;
+    }
+    for (size_t i = 0; i < old_capacity; i++) {
+      if (old_slots[i].value != NULL) {
+        Place(old_slots[i].hash, old_slots[i].value);
+      }
+    }
+    delete [] old_slots;
+  }
+
+  // Empties "slot", then moves back the elements after it which can't be
+  // found anymore across the gap, so that no tombstones are needed.
+  void EraseSlot(Slot* slot) {
+    delete slot->value;
+    slot->value = NULL;
+    --size_;
+    size_t gap = slot - slots_;
+    for (size_t i = (gap + 1) & mask_; slots_[i].value != NULL;
+         i = (i + 1) & mask_) {
+      size_t home = slots_[i].hash & mask_;
+      // Move the element if its home slot is not in the range (gap, i],
+      // counting around the end of the array.
+      if (((i - home) & mask_) >= ((i - gap) & mask_)) {
+        slots_[gap] = slots_[i];
+        slots_[i].value = NULL;
+        gap = i;
+      }
+    }
+  }
+
+  Slot* slots_;
+  size_t mask_;   // The number of slots, minus one, if slots_ isn't NULL.
+  size_t size_;   // The number of full slots.
+};
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // GOOGLE_PROTOBUF_STUBS_HASH_TABLE_H__
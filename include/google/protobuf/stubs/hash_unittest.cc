@@ -0,0 +1,171 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// hash_map and hash_set are our own hash table where the system has none (see
+// hash.h); these tests cover the parts of their interface the library uses.
+
+#include <google/protobuf/stubs/hash.h>
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+TEST(HashMapTest, InsertAndFind) {
+  hash_map<int, string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.find(1) == map.end());
+
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(map.insert(make_pair(i, SimpleItoa(i))).second);
+  }
+  EXPECT_FALSE(map.insert(make_pair(5, string("five"))).second);
+  EXPECT_EQ(1000, map.size());
+
+  for (int i = 0; i < 1000; i++) {
+    hash_map<int, string>::const_iterator it = map.find(i);
+    ASSERT_TRUE(it != map.end());
+    EXPECT_EQ(i, it->first);
+    EXPECT_EQ(SimpleItoa(i), it->second);
+  }
+  EXPECT_TRUE(map.find(1000) == map.end());
+  EXPECT_EQ(0, map.count(-1));
+}
+
+TEST(HashMapTest, Subscript) {
+  hash_map<string, int> map;
+  map["foo"] = 1;
+  map["bar"] += 2;
+  map["foo"] += 3;
+  EXPECT_EQ(2, map.size());
+  EXPECT_EQ(4, map["foo"]);
+  EXPECT_EQ(2, map["bar"]);
+  EXPECT_EQ(0, map["baz"]);
+  EXPECT_EQ(3, map.size());
+}
+
+TEST(HashMapTest, CStringKeys) {
+  // Keys that are equal strings at different addresses are the same key.
+  hash_map<const char*, int, hash<const char*>, streq> map;
+  string foo = "foo";
+  string bar = "bar";
+  map[foo.c_str()] = 1;
+  map[bar.c_str()] = 2;
+  EXPECT_EQ(1, map["foo"]);
+  EXPECT_EQ(2, map["bar"]);
+  EXPECT_EQ(2, map.size());
+}
+
+TEST(HashMapTest, Erase) {
+  // Erasing must leave every other key findable, including those that
+  // collided with the erased one and were placed after it.
+  hash_map<int, int> map;
+  for (int i = 0; i < 1000; i++) map[i] = i;
+  for (int i = 0; i < 1000; i += 3) EXPECT_EQ(1, map.erase(i));
+  EXPECT_EQ(0, map.erase(0));
+  EXPECT_EQ(666, map.size());
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i % 3 == 0 ? 0 : 1, map.count(i)) << i;
+  }
+
+  map.erase(map.find(1));
+  EXPECT_TRUE(map.find(1) == map.end());
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.begin() == map.end());
+  map[7] = 7;
+  EXPECT_EQ(1, map.size());
+}
+
+TEST(HashMapTest, Iteration) {
+  hash_map<int, int> map;
+  for (int i = 0; i < 100; i++) map[i] = i * 2;
+
+  vector<bool> seen(100, false);
+  int count = 0;
+  for (hash_map<int, int>::iterator it = map.begin(); it != map.end(); ++it) {
+    EXPECT_EQ(it->first * 2, it->second);
+    EXPECT_FALSE(seen[it->first]);
+    seen[it->first] = true;
+    ++count;
+  }
+  EXPECT_EQ(100, count);
+}
+
+TEST(HashMapTest, ReferencesStayValid) {
+  // Like with map, the library keeps pointers to values while inserting more.
+  hash_map<int, int> map;
+  int* first = &map[0];
+  for (int i = 1; i < 1000; i++) map[i] = i;
+  EXPECT_EQ(first, &map[0]);
+}
+
+TEST(HashMapTest, CopyAndSwap) {
+  hash_map<int, int> map;
+  for (int i = 0; i < 10; i++) map[i] = i;
+
+  hash_map<int, int> copy(map);
+  copy[10] = 10;
+  EXPECT_EQ(10, map.size());
+  EXPECT_EQ(11, copy.size());
+
+  map.swap(copy);
+  EXPECT_EQ(11, map.size());
+  EXPECT_EQ(10, copy.size());
+
+  copy = map;
+  EXPECT_EQ(11, copy.size());
+  EXPECT_EQ(10, copy[10]);
+}
+
+TEST(HashSetTest, PointerKeys) {
+  // Pointers are aligned, so their low bits must not alone pick the slot.
+  vector<int> values(1000);
+  hash_set<const int*> set;
+  for (int i = 0; i < values.size(); i++) {
+    EXPECT_TRUE(set.insert(&values[i]).second);
+  }
+  EXPECT_FALSE(set.insert(&values[0]).second);
+  EXPECT_EQ(1000, set.size());
+  for (int i = 0; i < values.size(); i++) {
+    EXPECT_EQ(1, set.count(&values[i]));
+  }
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,86 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// A StringPiece is a pointer/length pair referring to bytes owned by
+// someone else.  It is what the accessors of fields declared with
+// [ctype=STRING_PIECE] return: the bytes either live in the message itself
+// or, when the message was parsed with aliasing enabled (see
+// io::CodedInputStream::EnableAliasing()), in the caller's input buffer.
+//
+// This is deliberately minimal -- just enough for generated code and for
+// callers to get at the bytes or copy them out.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+#define GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+
+#include <string.h>
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class StringPiece {
+ public:
+  StringPiece() : ptr_(""), length_(0) {}
+  StringPiece(const char* str) : ptr_(str), length_(strlen(str)) {}
+  StringPiece(const string& str) : ptr_(str.data()), length_(str.size()) {}
+  StringPiece(const char* ptr, int length) : ptr_(ptr), length_(length) {}
+
+  // Not NUL-terminated.
+  const char* data() const { return ptr_; }
+  int size() const { return length_; }
+  int length() const { return length_; }
+  bool empty() const { return length_ == 0; }
+
+  char operator[](int i) const { return ptr_[i]; }
+
+  string as_string() const { return string(ptr_, length_); }
+  void CopyToString(string* target) const { target->assign(ptr_, length_); }
+
+ private:
+  const char* ptr_;
+  int length_;
+};
+
+inline bool operator==(const StringPiece& x, const StringPiece& y) {
+  return x.size() == y.size() &&
+         (x.size() == 0 || memcmp(x.data(), y.data(), x.size()) == 0);
+}
+
+inline bool operator!=(const StringPiece& x, const StringPiece& y) {
+  return !(x == y);
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
@@ -102,6 +102,7 @@ bool WireFormat::SkipField(io::CodedInputStream* input, uint32 tag,
       if (unknown_fields == NULL) {
         if (!input->Skip(length)) return false;
       } else {
+        if (!input->CheckBytesLength(length)) return false;
         if (!input->ReadString(unknown_fields->AddLengthDelimited(number),
                                length)) {
           return false;
@@ -567,6 +568,7 @@ bool WireFormat::ParseAndMergeField(
       // Handle strings separately so that we can optimize the ctype=CORD case.
       case FieldDescriptor::TYPE_STRING: {
         string value;
+        input->BeginBytesField(field->full_name().c_str());
         if (!WireFormatLite::ReadString(input, &value)) return false;
         VerifyUTF8String(value.data(), value.length(), PARSE);
         if (field->is_repeated()) {
@@ -579,6 +581,7 @@ bool WireFormat::ParseAndMergeField(
 
       case FieldDescriptor::TYPE_BYTES: {
         string value;
+        input->BeginBytesField(field->full_name().c_str());
         if (!WireFormatLite::ReadBytes(input, &value)) return false;
         if (field->is_repeated()) {
           message_reflection->AddString(message, field, value);
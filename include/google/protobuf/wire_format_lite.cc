@@ -288,7 +288,14 @@ void WireFormatLite::WriteBytes(int field_number, const string& value,
                                 io::CodedOutputStream* output) {
   WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
   output->WriteVarint32(value.size());
-  output->WriteString(value);
+  output->WriteRawMaybeAliased(value.data(), value.size());
+}
+void WireFormatLite::WriteStringPiece(int field_number,
+                                      const StringPiece& value,
+                                      io::CodedOutputStream* output) {
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+  output->WriteVarint32(value.size());
+  output->WriteRawMaybeAliased(value.data(), value.size());
 }
 
 
@@ -339,11 +346,49 @@ void WireFormatLite::WriteMessageMaybeToArray(int field_number,
   }
 }
 
+void WireFormatLite::WriteString(int field_number, const string& value,
+                                 io::ReverseCodedOutputBuffer* output) {
+  output->WriteRaw(value.data(), value.size());
+  output->WriteVarint32(value.size());
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+void WireFormatLite::WriteBytes(int field_number, const string& value,
+                                io::ReverseCodedOutputBuffer* output) {
+  output->WriteRaw(value.data(), value.size());
+  output->WriteVarint32(value.size());
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+void WireFormatLite::WriteStringPiece(int field_number,
+                                      const StringPiece& value,
+                                      io::ReverseCodedOutputBuffer* output) {
+  output->WriteRaw(value.data(), value.size());
+  output->WriteVarint32(value.size());
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+void WireFormatLite::WriteGroup(int field_number,
+                                const MessageLite& value,
+                                io::ReverseCodedOutputBuffer* output) {
+  WriteTag(field_number, WIRETYPE_END_GROUP, output);
+  value.SerializeReverse(output);
+  WriteTag(field_number, WIRETYPE_START_GROUP, output);
+}
+
+void WireFormatLite::WriteMessage(int field_number,
+                                  const MessageLite& value,
+                                  io::ReverseCodedOutputBuffer* output) {
+  const int end = output->ByteCount();
+  value.SerializeReverse(output);
+  output->WriteVarint32(output->ByteCount() - end);
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
 bool WireFormatLite::ReadString(io::CodedInputStream* input,
                                 string* value) {
   // String is for UTF-8 text only
   uint32 length;
   if (!input->ReadVarint32(&length)) return false;
+  if (!input->CheckBytesLength(length)) return false;
   if (!input->InternalReadStringInline(value, length)) return false;
   return true;
 }
@@ -351,6 +396,7 @@ bool WireFormatLite::ReadBytes(io::CodedInputStream* input,
                                string* value) {
   uint32 length;
   if (!input->ReadVarint32(&length)) return false;
+  if (!input->CheckBytesLength(length)) return false;
   return input->InternalReadStringInline(value, length);
 }
 
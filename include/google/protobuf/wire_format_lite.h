@@ -42,6 +42,7 @@
 
 #include <string>
 #include <google/protobuf/message_lite.h>
+#include <google/protobuf/stubs/stringpiece.h>
 
 namespace google {
 
@@ -50,6 +51,7 @@ namespace protobuf {
   namespace io {
     class CodedInputStream;             // coded_stream.h
     class CodedOutputStream;            // coded_stream.h
+    class ReverseCodedOutputBuffer;     // coded_stream.h
   }
 }
 
@@ -264,8 +266,10 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
   // Reads a primitive value directly from the provided buffer. It returns a
   // pointer past the segment of data that was read.
   //
-  // This is only implemented for the types with fixed wire size, e.g.
-  // float, double, and the (s)fixed* types.
+  // This is implemented for the types with fixed wire size, e.g. float,
+  // double, and the (s)fixed* types, and for the varint types.  For the
+  // latter the buffer must have io::CodedInputStream::kMaxVarintBytes
+  // readable bytes, and NULL is returned if the varint is malformed.
   template <typename CType, enum FieldType DeclaredType>
   static inline const uint8* ReadPrimitiveFromArray(const uint8* buffer,
                                                     CType* value) INL;
@@ -290,6 +294,10 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static bool ReadString(input, string* value);
   static bool ReadBytes (input, string* value);
+  // Reads a string or bytes field as a pointer into the input; see
+  // CodedInputStream::ReadRawAliased().  Used by [ctype=STRING_PIECE] fields.
+  static inline bool ReadStringPieceAliased(input, const void** data,
+                                            int* size);
 
   static inline bool ReadGroup  (field_number, input, MessageLite* value);
   static inline bool ReadMessage(input, MessageLite* value);
@@ -342,6 +350,8 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static void WriteString(field_number, const string& value, output);
   static void WriteBytes (field_number, const string& value, output);
+  static void WriteStringPiece(field_number, const StringPiece& value,
+                               output);
 
   static void WriteGroup(
     field_number, const MessageLite& value, output);
@@ -364,6 +374,64 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
   static inline void WriteMessageNoVirtual(
     field_number, const MessageType& value, output);
 
+#undef output
+#define output io::ReverseCodedOutputBuffer* output
+
+  // Like above, but prepending to a ReverseCodedOutputBuffer: each value is
+  // written before its tag, and messages are written before their length.
+  // See MessageLite::SerializeReverse().
+  static inline void WriteTag(field_number, WireType type, output) INL;
+
+  // Write fields, without tags.
+  static inline void WriteInt32NoTag   (int32 value, output) INL;
+  static inline void WriteInt64NoTag   (int64 value, output) INL;
+  static inline void WriteUInt32NoTag  (uint32 value, output) INL;
+  static inline void WriteUInt64NoTag  (uint64 value, output) INL;
+  static inline void WriteSInt32NoTag  (int32 value, output) INL;
+  static inline void WriteSInt64NoTag  (int64 value, output) INL;
+  static inline void WriteFixed32NoTag (uint32 value, output) INL;
+  static inline void WriteFixed64NoTag (uint64 value, output) INL;
+  static inline void WriteSFixed32NoTag(int32 value, output) INL;
+  static inline void WriteSFixed64NoTag(int64 value, output) INL;
+  static inline void WriteFloatNoTag   (float value, output) INL;
+  static inline void WriteDoubleNoTag  (double value, output) INL;
+  static inline void WriteBoolNoTag    (bool value, output) INL;
+  static inline void WriteEnumNoTag    (int value, output) INL;
+
+  // Write fields, including tags.
+  static inline void WriteInt32   (field_number,  int32 value, output);
+  static inline void WriteInt64   (field_number,  int64 value, output);
+  static inline void WriteUInt32  (field_number, uint32 value, output);
+  static inline void WriteUInt64  (field_number, uint64 value, output);
+  static inline void WriteSInt32  (field_number,  int32 value, output);
+  static inline void WriteSInt64  (field_number,  int64 value, output);
+  static inline void WriteFixed32 (field_number, uint32 value, output);
+  static inline void WriteFixed64 (field_number, uint64 value, output);
+  static inline void WriteSFixed32(field_number,  int32 value, output);
+  static inline void WriteSFixed64(field_number,  int64 value, output);
+  static inline void WriteFloat   (field_number,  float value, output);
+  static inline void WriteDouble  (field_number, double value, output);
+  static inline void WriteBool    (field_number,   bool value, output);
+  static inline void WriteEnum    (field_number,    int value, output);
+
+  static void WriteString(field_number, const string& value, output);
+  static void WriteBytes (field_number, const string& value, output);
+  static void WriteStringPiece(field_number, const StringPiece& value,
+                               output);
+
+  static void WriteGroup(
+    field_number, const MessageLite& value, output);
+  static void WriteMessage(
+    field_number, const MessageLite& value, output);
+
+  // Like above, but de-virtualize the call to SerializeReverse().
+  template<typename MessageType>
+  static inline void WriteGroupNoVirtual(
+    field_number, const MessageType& value, output);
+  template<typename MessageType>
+  static inline void WriteMessageNoVirtual(
+    field_number, const MessageType& value, output);
+
 #undef output
 #define output uint8* target
 
@@ -420,6 +488,8 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
     field_number, const string& value, output) INL;
   static inline uint8* WriteBytesToArray(
     field_number, const string& value, output) INL;
+  static inline uint8* WriteStringPieceToArray(
+    field_number, const StringPiece& value, output) INL;
 
   static inline uint8* WriteGroupToArray(
       field_number, const MessageLite& value, output) INL;
@@ -465,6 +535,7 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static inline int StringSize(const string& value);
   static inline int BytesSize (const string& value);
+  static inline int StringPieceSize(const StringPiece& value);
 
   static inline int GroupSize  (const MessageLite& value);
   static inline int MessageSize(const MessageLite& value);
@@ -488,6 +559,14 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
       google::protobuf::io::CodedInputStream* input,
       RepeatedField<CType>* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // A helper method for the packed primitive reader, for the varint types.
+  // Values are decoded straight out of the stream's buffer whenever a whole
+  // varint is guaranteed to be there.
+  template <typename CType, enum FieldType DeclaredType>
+  static inline bool ReadPackedVarintPrimitive(
+      google::protobuf::io::CodedInputStream* input,
+      RepeatedField<CType>* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
   static const CppType kFieldTypeToCppTypeMap[];
   static const WireFormatLite::WireType kWireTypeForFieldType[];
 
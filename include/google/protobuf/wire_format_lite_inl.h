@@ -226,6 +226,84 @@ inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
   return buffer;
 }
 
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  int32, WireFormatLite::TYPE_INT32>(
+    const uint8* buffer,
+    int32* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = static_cast<int32>(temp);
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  int64, WireFormatLite::TYPE_INT64>(
+    const uint8* buffer,
+    int64* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = static_cast<int64>(temp);
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  uint32, WireFormatLite::TYPE_UINT32>(
+    const uint8* buffer,
+    uint32* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = static_cast<uint32>(temp);
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  uint64, WireFormatLite::TYPE_UINT64>(
+    const uint8* buffer,
+    uint64* value) {
+  return io::CodedInputStream::ReadVarint64FromArray(buffer, value);
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  int32, WireFormatLite::TYPE_SINT32>(
+    const uint8* buffer,
+    int32* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = ZigZagDecode32(static_cast<uint32>(temp));
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  int64, WireFormatLite::TYPE_SINT64>(
+    const uint8* buffer,
+    int64* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = ZigZagDecode64(temp);
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  bool, WireFormatLite::TYPE_BOOL>(
+    const uint8* buffer,
+    bool* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = static_cast<uint32>(temp) != 0;
+  return buffer;
+}
+template <>
+inline const uint8* WireFormatLite::ReadPrimitiveFromArray<
+  int, WireFormatLite::TYPE_ENUM>(
+    const uint8* buffer,
+    int* value) {
+  uint64 temp;
+  buffer = io::CodedInputStream::ReadVarint64FromArray(buffer, &temp);
+  *value = static_cast<int>(temp);
+  return buffer;
+}
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 inline bool WireFormatLite::ReadRepeatedPrimitive(int, // tag_size, unused.
                                                uint32 tag,
@@ -339,6 +417,66 @@ inline bool WireFormatLite::ReadPackedPrimitive(io::CodedInputStream* input,
   return true;
 }
 
+template <typename CType, enum WireFormatLite::FieldType DeclaredType>
+inline bool WireFormatLite::ReadPackedVarintPrimitive(
+    io::CodedInputStream* input,
+    RepeatedField<CType>* values) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  io::CodedInputStream::Limit limit = input->PushLimit(length);
+  while (input->BytesUntilLimit() > 0) {
+    // The direct buffer ends at the limit, so as long as kMaxVarintBytes
+    // remain in it, the next varint can be decoded without bounds checks and
+    // without reading past the field.
+    const void* void_pointer;
+    int size;
+    input->GetDirectBufferPointerInline(&void_pointer, &size);
+    if (size >= io::CodedInputStream::kMaxVarintBytes) {
+      const uint8* start = reinterpret_cast<const uint8*>(void_pointer);
+      const uint8* safe_end =
+          start + size - io::CodedInputStream::kMaxVarintBytes;
+      const uint8* buffer = start;
+      while (buffer <= safe_end) {
+        CType value;
+        buffer = ReadPrimitiveFromArray<CType, DeclaredType>(buffer, &value);
+        if (buffer == NULL) return false;
+        values->Add(value);
+      }
+      input->Skip(buffer - start);
+    } else {
+      // Close to the end of the buffer or the field.
+      CType value;
+      if (!ReadPrimitive<CType, DeclaredType>(input, &value)) return false;
+      values->Add(value);
+    }
+  }
+  input->PopLimit(limit);
+  return true;
+}
+
+// Specializations of ReadPackedPrimitive for the varint types, which use the
+// bulk decoding path.
+#define READ_PACKED_VARINT_PRIMITIVE(CPPTYPE, DECLARED_TYPE)                   \
+template <>                                                                    \
+inline bool WireFormatLite::ReadPackedPrimitive<                               \
+  CPPTYPE, WireFormatLite::DECLARED_TYPE>(                                     \
+    io::CodedInputStream* input,                                               \
+    RepeatedField<CPPTYPE>* values) {                                          \
+  return ReadPackedVarintPrimitive<                                            \
+    CPPTYPE, WireFormatLite::DECLARED_TYPE>(input, values);                    \
+}
+
+READ_PACKED_VARINT_PRIMITIVE(int32, TYPE_INT32);
+READ_PACKED_VARINT_PRIMITIVE(int64, TYPE_INT64);
+READ_PACKED_VARINT_PRIMITIVE(uint32, TYPE_UINT32);
+READ_PACKED_VARINT_PRIMITIVE(uint64, TYPE_UINT64);
+READ_PACKED_VARINT_PRIMITIVE(int32, TYPE_SINT32);
+READ_PACKED_VARINT_PRIMITIVE(int64, TYPE_SINT64);
+READ_PACKED_VARINT_PRIMITIVE(bool, TYPE_BOOL);
+READ_PACKED_VARINT_PRIMITIVE(int, TYPE_ENUM);
+
+#undef READ_PACKED_VARINT_PRIMITIVE
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 bool WireFormatLite::ReadPackedPrimitiveNoInline(io::CodedInputStream* input,
                                                  RepeatedField<CType>* values) {
@@ -358,10 +496,22 @@ inline bool WireFormatLite::ReadGroup(int field_number,
   }
   return true;
 }
+inline bool WireFormatLite::ReadStringPieceAliased(io::CodedInputStream* input,
+                                                   const void** data,
+                                                   int* size) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  if (!input->CheckBytesLength(length)) return false;
+  if (!input->ReadRawAliased(data, length)) return false;
+  *size = length;
+  return true;
+}
+
 inline bool WireFormatLite::ReadMessage(io::CodedInputStream* input,
                                         MessageLite* value) {
   uint32 length;
   if (!input->ReadVarint32(&length)) return false;
+  if (!input->CheckMessageLength(length)) return false;
   if (!input->IncrementRecursionDepth()) return false;
   io::CodedInputStream::Limit limit = input->PushLimit(length);
   if (!value->MergePartialFromCodedStream(input)) return false;
@@ -403,6 +553,7 @@ inline bool WireFormatLite::ReadMessageNoVirtual(
     io::CodedInputStream* input, MessageType_WorkAroundCppLookupDefect* value) {
   uint32 length;
   if (!input->ReadVarint32(&length)) return false;
+  if (!input->CheckMessageLength(length)) return false;
   if (!input->IncrementRecursionDepth()) return false;
   io::CodedInputStream::Limit limit = input->PushLimit(length);
   if (!value->
@@ -502,6 +653,159 @@ inline void WireFormatLite::WriteMessageNoVirtual(
 
 // ===================================================================
 
+inline void WireFormatLite::WriteTag(
+    int field_number, WireType type, io::ReverseCodedOutputBuffer* output) {
+  output->WriteTag(MakeTag(field_number, type));
+}
+
+inline void WireFormatLite::WriteInt32NoTag(
+    int32 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint32SignExtended(value);
+}
+inline void WireFormatLite::WriteInt64NoTag(
+    int64 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint64(static_cast<uint64>(value));
+}
+inline void WireFormatLite::WriteUInt32NoTag(
+    uint32 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint32(value);
+}
+inline void WireFormatLite::WriteUInt64NoTag(
+    uint64 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint64(value);
+}
+inline void WireFormatLite::WriteSInt32NoTag(
+    int32 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint32(ZigZagEncode32(value));
+}
+inline void WireFormatLite::WriteSInt64NoTag(
+    int64 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint64(ZigZagEncode64(value));
+}
+inline void WireFormatLite::WriteFixed32NoTag(
+    uint32 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian32(value);
+}
+inline void WireFormatLite::WriteFixed64NoTag(
+    uint64 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian64(value);
+}
+inline void WireFormatLite::WriteSFixed32NoTag(
+    int32 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian32(static_cast<uint32>(value));
+}
+inline void WireFormatLite::WriteSFixed64NoTag(
+    int64 value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian64(static_cast<uint64>(value));
+}
+inline void WireFormatLite::WriteFloatNoTag(
+    float value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian32(EncodeFloat(value));
+}
+inline void WireFormatLite::WriteDoubleNoTag(
+    double value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteLittleEndian64(EncodeDouble(value));
+}
+inline void WireFormatLite::WriteBoolNoTag(
+    bool value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint32(value ? 1 : 0);
+}
+inline void WireFormatLite::WriteEnumNoTag(
+    int value, io::ReverseCodedOutputBuffer* output) {
+  output->WriteVarint32SignExtended(value);
+}
+
+inline void WireFormatLite::WriteInt32(
+    int field_number, int32 value, io::ReverseCodedOutputBuffer* output) {
+  WriteInt32NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteInt64(
+    int field_number, int64 value, io::ReverseCodedOutputBuffer* output) {
+  WriteInt64NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteUInt32(
+    int field_number, uint32 value, io::ReverseCodedOutputBuffer* output) {
+  WriteUInt32NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteUInt64(
+    int field_number, uint64 value, io::ReverseCodedOutputBuffer* output) {
+  WriteUInt64NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteSInt32(
+    int field_number, int32 value, io::ReverseCodedOutputBuffer* output) {
+  WriteSInt32NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteSInt64(
+    int field_number, int64 value, io::ReverseCodedOutputBuffer* output) {
+  WriteSInt64NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteFixed32(
+    int field_number, uint32 value, io::ReverseCodedOutputBuffer* output) {
+  WriteFixed32NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteFixed64(
+    int field_number, uint64 value, io::ReverseCodedOutputBuffer* output) {
+  WriteFixed64NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteSFixed32(
+    int field_number, int32 value, io::ReverseCodedOutputBuffer* output) {
+  WriteSFixed32NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteSFixed64(
+    int field_number, int64 value, io::ReverseCodedOutputBuffer* output) {
+  WriteSFixed64NoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteFloat(
+    int field_number, float value, io::ReverseCodedOutputBuffer* output) {
+  WriteFloatNoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteDouble(
+    int field_number, double value, io::ReverseCodedOutputBuffer* output) {
+  WriteDoubleNoTag(value, output);
+  WriteTag(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteBool(
+    int field_number, bool value, io::ReverseCodedOutputBuffer* output) {
+  WriteBoolNoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteEnum(
+    int field_number, int value, io::ReverseCodedOutputBuffer* output) {
+  WriteEnumNoTag(value, output);
+  WriteTag(field_number, WIRETYPE_VARINT, output);
+}
+
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::WriteGroupNoVirtual(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::ReverseCodedOutputBuffer* output) {
+  WriteTag(field_number, WIRETYPE_END_GROUP, output);
+  value.MessageType_WorkAroundCppLookupDefect::SerializeReverse(output);
+  WriteTag(field_number, WIRETYPE_START_GROUP, output);
+}
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::WriteMessageNoVirtual(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::ReverseCodedOutputBuffer* output) {
+  int end = output->ByteCount();
+  value.MessageType_WorkAroundCppLookupDefect::SerializeReverse(output);
+  output->WriteVarint32(output->ByteCount() - end);
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+// ===================================================================
+
 inline uint8* WireFormatLite::WriteTagToArray(int field_number,
                                               WireType type,
                                               uint8* target) {
@@ -676,6 +980,14 @@ inline uint8* WireFormatLite::WriteBytesToArray(int field_number,
   target = io::CodedOutputStream::WriteVarint32ToArray(value.size(), target);
   return io::CodedOutputStream::WriteStringToArray(value, target);
 }
+inline uint8* WireFormatLite::WriteStringPieceToArray(int field_number,
+                                                      const StringPiece& value,
+                                                      uint8* target) {
+  target = WriteTagToArray(field_number, WIRETYPE_LENGTH_DELIMITED, target);
+  target = io::CodedOutputStream::WriteVarint32ToArray(value.size(), target);
+  return io::CodedOutputStream::WriteRawToArray(value.data(), value.size(),
+                                                target);
+}
 
 
 inline uint8* WireFormatLite::WriteGroupToArray(int field_number,
@@ -748,6 +1060,10 @@ inline int WireFormatLite::BytesSize(const string& value) {
   return io::CodedOutputStream::VarintSize32(value.size()) +
          value.size();
 }
+inline int WireFormatLite::StringPieceSize(const StringPiece& value) {
+  return io::CodedOutputStream::VarintSize32(value.size()) +
+         value.size();
+}
 
 
 inline int WireFormatLite::GroupSize(const MessageLite& value) {
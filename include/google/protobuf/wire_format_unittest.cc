@@ -503,6 +503,73 @@ TEST(WireFormatTest, RecursionLimit) {
   }
 }
 
+TEST(WireFormatTest, LengthLimits) {
+  unittest::TestAllTypes message;
+  message.set_optional_bytes(string(100, 'x'));
+  message.mutable_optional_nested_message()->set_bb(1);
+  string data;
+  message.SerializeToString(&data);
+  int nested_size = message.optional_nested_message().ByteSize();
+
+  {
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(data.data()), data.size());
+    input.SetBytesLengthLimit(100);
+    input.SetMessageLengthLimit(nested_size);
+    unittest::TestAllTypes message2;
+    EXPECT_TRUE(message2.ParseFromCodedStream(&input));
+  }
+
+  {
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(data.data()), data.size());
+    input.SetBytesLengthLimit(99);
+    unittest::TestAllTypes message2;
+    EXPECT_FALSE(message2.ParseFromCodedStream(&input));
+  }
+
+  {
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(data.data()), data.size());
+    input.SetMessageLengthLimit(nested_size - 1);
+    unittest::TestAllTypes message2;
+    EXPECT_FALSE(message2.ParseFromCodedStream(&input));
+  }
+}
+
+int OptionalBytesLengthLimit(void* context, const char* field_name) {
+  return strcmp(field_name, "protobuf_unittest.TestAllTypes.optional_bytes")
+      == 0 ? *static_cast<int*>(context) : -1;
+}
+
+TEST(WireFormatTest, FieldLengthLimits) {
+  // Generated code names each string and bytes field it reads, so one of
+  // them can be held to a limit below the others'.
+  unittest::TestAllTypes message;
+  message.set_optional_bytes(string(100, 'x'));
+  message.set_optional_string(string(200, 'y'));
+  string data;
+  message.SerializeToString(&data);
+
+  int limit = 100;
+  {
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(data.data()), data.size());
+    input.SetFieldLengthLimitFunc(&OptionalBytesLengthLimit, &limit);
+    unittest::TestAllTypes message2;
+    EXPECT_TRUE(message2.ParseFromCodedStream(&input));
+  }
+
+  limit = 99;
+  {
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(data.data()), data.size());
+    input.SetFieldLengthLimitFunc(&OptionalBytesLengthLimit, &limit);
+    unittest::TestAllTypes message2;
+    EXPECT_FALSE(message2.ParseFromCodedStream(&input));
+  }
+}
+
 TEST(WireFormatTest, UnknownFieldRecursionLimit) {
   unittest::TestEmptyMessage message;
   message.mutable_unknown_fields()
@@ -1,20 +1,32 @@
 #include "template_feature.pb.h"
 #include <unistd.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <climits>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <string.h>
-#include <fstream>
-#include <sstream>
+#include <vector>
+#include "async_file_io.h"
+#include "pipeline_stats.h"
 #include "st_imagehelper.hpp"
+#include "template_blob_writer.h"
+#include "template_codec.h"
+#include "template_dump.h"
+#include <google/protobuf/io/coded_stream.h>
 #include "codec/jpge.h"
 #include "codec/stb_image.h"
+#include "codec/stb_image_write.h"
 
 // #define TO_STRING(x) #x
 
 const char* template_file_path = "./template_file.data";
 const char* parsed_template_dir = "./parsed_templates/template_";
+const char* parsed_template_blob_path = "./parsed_templates/templates.blob";
 
 const char* template_version_1_0_0 = "1.0.0";
 const char* template_version_1_0_1 = "1.0.1";
@@ -29,15 +41,6 @@ typedef struct st_tee_input_t {
 } st_tee_input;
 
 
-template < typename T > 
-std::string to_string(const T& n)
-{
-	std::ostringstream stm ;
-	stm << n ;
-	return stm.str() ;
-}
-
-
 bool IsFileExist(const char* path)
 {
 	if (nullptr == path) return false;
@@ -49,30 +52,250 @@ bool IsFileExist(const char* path)
 }
 
 
-int ReadFile(const char *filePath, char **content, int &nFileLen)
+// the file as a whole may be as large as an int can describe; images,
+// features and nested messages are held to budgets of their own, checked
+// while parsing as each length is read, so a corrupt length is refused
+// before anything is allocated or copied for it
+struct ParseBudget {
+	int max_image_bytes;
+	int max_feature_bytes;
+	int max_message_bytes;
+};
+
+// a person's templates are a handful of images, so no nested message
+// needs more than a few of the largest images
+static const ParseBudget kDefaultParseBudget = { 64 << 20, 1 << 20, 256 << 20 };
+
+// per-field limits for CodedInputStream::SetFieldLengthLimitFunc()
+static int TemplateFieldLengthLimit(void *context, const char *field_name)
 {
-	FILE *pF = NULL;
-    pF = fopen(filePath, "r");
-    if (pF == NULL) {
-        return -1;
-    }
-    fseek(pF, 0, SEEK_END);
-    nFileLen = ftell(pF);
-    rewind(pF);
-    char *szBuffer = new (std::nothrow) char[nFileLen + 1];
-    if (!szBuffer) {
-        fclose(pF);
-        return -1;
-    }
-    nFileLen = fread(szBuffer, sizeof(char), nFileLen, pF);
-    szBuffer[nFileLen] = '\0';
-    fclose(pF);
-    *content = szBuffer;
-    return 0;
+	const ParseBudget *budget = static_cast< const ParseBudget * >(context);
+	if (0 == strcmp(field_name, "pb.Image.data")) return budget->max_image_bytes;
+	if (0 == strcmp(field_name, "pb.SingleTemlate.feature")) return budget->max_feature_bytes;
+	return -1;
+}
+
+int ParseTemplateFile(const char *content, int length, const ParseBudget &budget, pb::TemplateFile *parse_template)
+{
+	google::protobuf::io::CodedInputStream input(reinterpret_cast< const google::protobuf::uint8 * >(content), length);
+	// image payloads stay in content rather than being copied out
+	input.EnableAliasing(true);
+	input.SetTotalBytesLimit(INT_MAX, -1);
+	input.SetMessageLengthLimit(budget.max_message_bytes);
+	// images and features get their own limits, any other string the
+	// larger of the two
+	input.SetBytesLengthLimit(std::max(budget.max_image_bytes, budget.max_feature_bytes));
+	input.SetFieldLengthLimitFunc(TemplateFieldLengthLimit, const_cast< ParseBudget * >(&budget));
+	if (!parse_template->ParseFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
+		return -1;
+	}
+	return 0;
+}
+
+// parses "<name><n>" into *value if arg starts with name; n must be an integer
+// from min_value to INT_MAX, anything else is warned about and ignored
+static bool ParseIntOption(const char *arg, const char *name, int min_value, int *value)
+{
+	size_t name_length = strlen(name);
+	if (0 != strncmp(arg, name, name_length)) return false;
+	const char *digits = arg + name_length;
+	char *end = nullptr;
+	long parsed = strtol(digits, &end, 10);
+	if (end == digits || '\0' != *end || parsed < min_value || parsed > INT_MAX) {
+		printf("Warning ! ignoring %s\n", arg);
+	} else {
+		*value = static_cast< int >(parsed);
+	}
+	return true;
+}
+
+// re-serializes the parsed template 'rounds' times with both serializers,
+// two-pass (ByteSize() then write) and single-pass (written back to front),
+// timing each as its own stage; returns 0, or -1 if the outputs differ
+int BenchSerialize(const pb::TemplateFile &parse_template, int rounds, PipelineStats *stats)
+{
+	std::string two_pass;
+	std::string single_pass;
+	uint64_t two_pass_ns = 0;
+	uint64_t single_pass_ns = 0;
+	for (int round = 0; round < rounds; round++)
+	{
+		uint64_t start_ns = PipelineStats::NowNs();
+		parse_template.SerializeToString(&two_pass);
+		uint64_t middle_ns = PipelineStats::NowNs();
+		parse_template.SerializeToStringSinglePass(&single_pass);
+		uint64_t end_ns = PipelineStats::NowNs();
+		stats->Record(PipelineStats::kStageSerialize, start_ns, middle_ns, two_pass.size());
+		stats->Record(PipelineStats::kStageSerializeSinglePass, middle_ns, end_ns, single_pass.size());
+		two_pass_ns += middle_ns - start_ns;
+		single_pass_ns += end_ns - middle_ns;
+	}
+	if (two_pass != single_pass) {
+		printf("Error ! single pass serialization differs\n");
+		return -1;
+	}
+	printf("serialize %zu bytes x %d : two pass %.1f us, single pass %.1f us\n", two_pass.size(), rounds,
+		two_pass_ns / 1e3 / rounds, single_pass_ns / 1e3 / rounds);
+	return 0;
+}
+
+// parses the template 'rounds' times, each into a fresh arena like main
+// does, for the parse time alone; the rounds are recorded as their own
+// stage, apart from the real parse; returns 0, or -1 if a parse fails
+int BenchParse(const char *content, int length, const ParseBudget &budget, int rounds, PipelineStats *stats)
+{
+	uint64_t parse_ns = 0;
+	for (int round = 0; round < rounds; round++)
+	{
+		google::protobuf::Arena arena;
+		pb::TemplateFile *parse_template = google::protobuf::Arena::CreateMessage< pb::TemplateFile >(&arena);
+		uint64_t start_ns = PipelineStats::NowNs();
+		int ret = ParseTemplateFile(content, length, budget, parse_template);
+		uint64_t end_ns = PipelineStats::NowNs();
+		if (0 != ret) {
+			printf("Error ! parse template failed in round %d\n", round);
+			return -1;
+		}
+		stats->Record(PipelineStats::kStageParseBench, start_ns, end_ns, length);
+		parse_ns += end_ns - start_ns;
+	}
+	printf("parse %d bytes x %d : %.1f us, %.1f MB/s\n", length, rounds, parse_ns / 1e3 / rounds,
+		static_cast< double >(length) * rounds * 1e3 / parse_ns);
+	return 0;
+}
+
+// compresses the raw template once with every codec built in and times
+// 'rounds' decompressions of each, for the ratio and decode throughput;
+// returns 0, or -1 if a codec fails or doesn't round-trip
+int BenchCodecs(const char *content, int length, int rounds)
+{
+	for (int i = kCodecNone + 1; i < kCodecCount; i++)
+	{
+		TemplateCodec codec = static_cast< TemplateCodec >(i);
+		if (!TemplateCodecAvailable(codec)) continue;
+		std::string compressed;
+		uint64_t start_ns = PipelineStats::NowNs();
+		if (0 != CompressTemplate(codec, content, length, &compressed)) {
+			printf("Error ! %s compression failed\n", TemplateCodecName(codec));
+			return -1;
+		}
+		uint64_t compress_ns = PipelineStats::NowNs() - start_ns;
+		uint64_t decompress_ns = 0;
+		for (int round = 0; round < rounds; round++)
+		{
+			std::unique_ptr< char[] > output;
+			int output_length = 0;
+			start_ns = PipelineStats::NowNs();
+			int ret = DecompressTemplate(codec, compressed.data(), compressed.size(), &output, &output_length);
+			decompress_ns += PipelineStats::NowNs() - start_ns;
+			if (0 != ret || output_length != length || 0 != memcmp(output.get(), content, length)) {
+				printf("Error ! %s does not round-trip\n", TemplateCodecName(codec));
+				return -1;
+			}
+		}
+		printf("codec %-4s : %d -> %zu bytes (%.3f), compress %.1f MB/s, decompress %.1f MB/s\n", TemplateCodecName(codec),
+			length, compressed.size(), static_cast< double >(compressed.size()) / length,
+			length * 1e3 / compress_ns, static_cast< double >(length) * rounds * 1e3 / decompress_ns);
+	}
+	return 0;
+}
+
+// writes the raw template compressed with 'codec' next to the original,
+// named with the codec's suffix; returns 0 or -1
+int WriteCompressedTemplate(TemplateCodec codec, const char *content, int length)
+{
+	std::string compressed;
+	if (0 != CompressTemplate(codec, content, length, &compressed)) {
+		return -1;
+	}
+	std::string path = std::string(template_file_path) + TemplateCodecSuffix(codec);
+	FILE *file = fopen(path.c_str(), "wb");
+	if (nullptr == file) {
+		return -1;
+	}
+	bool ok = compressed.size() == fwrite(compressed.data(), 1, compressed.size(), file);
+	if (0 != fclose(file) || !ok) {
+		return -1;
+	}
+	printf("compressed template : %s, %zu bytes\n", path.c_str(), compressed.size());
+	return 0;
 }
 
+// large files are read as several chunks in flight at once
+static const int kReadChunkSize = 1 << 20;
+static const unsigned kAsyncIODepth = 16;
 
-int WriteFile(const char *path, const char *file, int length)
+int ReadFile(AsyncFileIO *io, const char *filePath, char **content, int &nFileLen)
+{
+	int fd = open(filePath, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+	struct stat st;
+	if (0 != fstat(fd, &st)) {
+		close(fd);
+		return -1;
+	}
+	// the length is handed around as an int from here on
+	if (st.st_size > INT_MAX) {
+		printf("Error ! %s is over %d bytes\n", filePath, INT_MAX);
+		close(fd);
+		return -1;
+	}
+	nFileLen = static_cast< int >(st.st_size);
+	char *szBuffer = new (std::nothrow) char[static_cast< size_t >(nFileLen) + 1];
+	if (!szBuffer) {
+		close(fd);
+		return -1;
+	}
+
+	std::vector< AsyncIORequest > requests(nFileLen / kReadChunkSize + (0 != nFileLen % kReadChunkSize));
+	int submit_failed = 0;
+	for (size_t i = 0; i < requests.size() && 0 == submit_failed; i++) {
+		int offset = i * kReadChunkSize;
+		AsyncIORequest &req = requests[i];
+		memset(&req, 0, sizeof(req));
+		req.fd = fd;
+		req.buffer = szBuffer + offset;
+		req.length = std::min(kReadChunkSize, nFileLen - offset);
+		req.offset = offset;
+		submit_failed = io->Submit(&req);
+	}
+	// everything that did get queued must land before the buffer and fd go
+	int failed = io->Drain();
+	close(fd);
+	if (0 != submit_failed || 0 != failed) {
+		delete[] szBuffer;
+		return -1;
+	}
+	szBuffer[nFileLen] = '\0';
+	*content = szBuffer;
+	return 0;
+}
+
+
+struct PendingWrite {
+	AsyncIORequest request;
+	std::unique_ptr< unsigned char[] > data;
+	PipelineStats *stats;
+	uint64_t start_ns;
+};
+
+static void FinishWrite(AsyncIORequest *req)
+{
+	PendingWrite *pending = static_cast< PendingWrite * >(req->user);
+	if (req->result != static_cast< ssize_t >(req->length)) {
+		printf("Error ! template file write failed (%d)\n", (int)req->result);
+	}
+	close(req->fd);
+	// from submit to completion, so queueing behind earlier writes counts
+	pending->stats->Record(PipelineStats::kStageWrite, pending->start_ns, PipelineStats::NowNs(),
+		req->result > 0 ? req->result : 0);
+	delete pending;
+}
+
+// queues the write and returns; 'file' is released once it is on disk
+int WriteFile(AsyncFileIO *io, PipelineStats *stats, const char *path, std::unique_ptr< unsigned char[] > file, int length)
 {
 	if (nullptr == path || nullptr == file || length <= 0) 
 	{
@@ -80,17 +303,51 @@ int WriteFile(const char *path, const char *file, int length)
 		return -1;
 	}
 
-	std::ofstream out(path, std::fstream::out | std::fstream::trunc);
-	if (!out.is_open()) 
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) 
 	{
 		printf("Error ! template file [%s] open failed\n", path);
 		return -1;
 	}
 
-	out.write(file, length);
-	out.close();
+	uint64_t start_ns = PipelineStats::NowNs();
+	PendingWrite *pending = new PendingWrite();
+	memset(&pending->request, 0, sizeof(pending->request));
+	pending->request.fd = fd;
+	pending->request.buffer = reinterpret_cast< char * >(file.get());
+	pending->request.length = length;
+	pending->request.write = true;
+	pending->request.done = FinishWrite;
+	pending->request.user = pending;
+	pending->data = std::move(file);
+	pending->stats = stats;
+	pending->start_ns = start_ns;
+	return io->Submit(&pending->request);
+}
 
-	return 0;
+struct JpegRowTarget {
+	unsigned char *buffer;
+	int row_bytes;
+};
+
+static int AllocJpegRows(void *user, int x, int y, int /*comp*/)
+{
+	JpegRowTarget *target = static_cast< JpegRowTarget * >(user);
+	target->row_bytes = x * STBI_rgb;
+	size_t row_bytes = static_cast< size_t >(target->row_bytes);
+	if (0 != row_bytes && static_cast< size_t >(y) > SIZE_MAX / row_bytes) {
+		return 0;
+	}
+	target->buffer = new (std::nothrow) unsigned char[row_bytes * y];
+	return target->buffer != nullptr;
+}
+
+static int CopyJpegRows(void *user, stbi_uc const *rows, int y0, int count)
+{
+	JpegRowTarget *target = static_cast< JpegRowTarget * >(user);
+	size_t row_bytes = static_cast< size_t >(target->row_bytes);
+	memcpy(target->buffer + row_bytes * y0, rows, row_bytes * count);
+	return 1;
 }
 
 int LoadJpegMemoryToBGR(const unsigned char *srcBuffer, 
@@ -98,32 +355,135 @@ int LoadJpegMemoryToBGR(const unsigned char *srcBuffer,
 					int &width, int &height, int &channels, 
 					std::unique_ptr< unsigned char[] > &outBufferGurad) 
 {
-	int ret(0);
     if (!srcBuffer) {
         return -1;
     }
-    unsigned char *readBuffer = stbi_load_from_memory(( unsigned char * )srcBuffer, srcBufferLen, &width, &height, &channels, STBI_rgb);
-    if (readBuffer == nullptr) {
+    // decode straight into the output buffer a few scanlines at a time
+    // instead of copying out of a full-size stbi buffer
+    JpegRowTarget target = { nullptr, 0 };
+    stbi_jpeg_row_callbacks callbacks = { AllocJpegRows, CopyJpegRows };
+    int ret = stbi_jpeg_stream_from_memory(srcBuffer, srcBufferLen, &width, &height, &channels, STBI_rgb, &callbacks, &target);
+    outBufferGurad.reset(target.buffer);
+    if (!ret || target.buffer == nullptr) {
         printf("image load_from_memory failed\n");
         return -1;
     }
+    channels = STBI_rgb;
     printf("load from memory width:%d height:%d channels:%d\n", width, height, channels);
-    auto stbiImageFree = [](unsigned char *pInv) { stbi_image_free(pInv); };
-    std::unique_ptr< unsigned char, decltype(stbiImageFree) > detectionResultManager(readBuffer, stbiImageFree);
+    return 0;
+}
 
-    auto mallocLen = width * height * channels;
-    unsigned char *dstRGBBuffer = new (std::nothrow) unsigned char[mallocLen];
-    if (dstRGBBuffer == nullptr) {
-        return -1;
-    }
-    outBufferGurad.reset(dstRGBBuffer);
-    memcpy(dstRGBBuffer, readBuffer, mallocLen);
-    return ret;
+struct PngFile {
+	FILE *file;
+	long bytes;
+	bool ok;
+};
+
+static void WritePngData(void *context, void *data, int size)
+{
+	PngFile *png = static_cast< PngFile * >(context);
+	if (png->ok && size != static_cast< int >(fwrite(data, 1, size, png->file))) {
+		png->ok = false;
+	}
+	png->bytes += size;
 }
 
-int main()
+// writes a decoded image as a PNG; the deflated rows go to the file while
+// they are compressed, at stbi_write_png_compression_level; returns the
+// file size, or -1
+long WritePngFile(const char *path, const unsigned char *pixels, int width, int height, int channels)
+{
+	PngFile png = { fopen(path, "wb"), 0, true };
+	if (nullptr == png.file) {
+		return -1;
+	}
+	int ret = stbi_write_png_to_func(WritePngData, &png, width, height, channels, pixels, 0);
+	if (0 != fclose(png.file) || !ret || !png.ok) {
+		return -1;
+	}
+	return png.bytes;
+}
+
+int main(int argc, char *argv[])
 {	
-	std::shared_ptr< pb::TemplateFile > parse_template = std::make_shared<pb::TemplateFile>();
+	// --blob: append every decoded image to one indexed file instead of
+	// writing a file per template
+	// --stats=<path>: write per-stage timings as JSON once done
+	// --max-image-bytes=<n>, --max-feature-bytes=<n>, --max-message-bytes=<n>:
+	// parse budget, see ParseBudget
+	// --bench-parse=<n>: time parsing the template n more times, see
+	// BenchParse
+	// --bench-serialize=<n>: time re-serializing the template n times, see
+	// BenchSerialize
+	// --bench-codecs=<n>: time decompressing the template n times with each
+	// codec built in, see BenchCodecs
+	// --write-compressed=<codec>: also write the template compressed with
+	// gzip, lz4 or zstd; a compressed template file is read the same way as
+	// a raw one
+	// --dump: print every field of the parsed template, see DumpFields
+	// --png[=<level>]: write the decoded images as PNG files, deflated at
+	// level 0 (stored) to 9 (smallest, slowest), 8 by default
+	bool blob_output = false;
+	bool dump_fields = false;
+	const char *stats_path = nullptr;
+	ParseBudget budget = kDefaultParseBudget;
+	int parse_rounds = 0;
+	int serialize_rounds = 0;
+	int codec_rounds = 0;
+	int png_level = -1;
+	TemplateCodec write_codec = kCodecNone;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (0 == strcmp(argv[arg], "--blob")) {
+			blob_output = true;
+		} else if (0 == strcmp(argv[arg], "--dump")) {
+			dump_fields = true;
+		} else if (0 == strcmp(argv[arg], "--png")) {
+			png_level = stbi_write_png_compression_level;
+		} else if (0 == strncmp(argv[arg], "--png=", 6)) {
+			char *end = nullptr;
+			long level = strtol(argv[arg] + 6, &end, 10);
+			if (end == argv[arg] + 6 || '\0' != *end || level < 0 || level > 9) {
+				printf("Warning ! ignoring %s\n", argv[arg]);
+			} else {
+				png_level = static_cast< int >(level);
+			}
+		} else if (0 == strncmp(argv[arg], "--stats=", 8)) {
+			stats_path = argv[arg] + 8;
+		} else if (ParseIntOption(argv[arg], "--max-image-bytes=", 1, &budget.max_image_bytes) ||
+				   ParseIntOption(argv[arg], "--max-feature-bytes=", 1, &budget.max_feature_bytes) ||
+				   ParseIntOption(argv[arg], "--max-message-bytes=", 1, &budget.max_message_bytes) ||
+				   ParseIntOption(argv[arg], "--bench-parse=", 1, &parse_rounds) ||
+				   ParseIntOption(argv[arg], "--bench-serialize=", 1, &serialize_rounds) ||
+				   ParseIntOption(argv[arg], "--bench-codecs=", 1, &codec_rounds)) {
+			// handled
+		} else if (0 == strncmp(argv[arg], "--write-compressed=", 19)) {
+			write_codec = ParseTemplateCodec(argv[arg] + 19);
+			if (kCodecCount == write_codec || !TemplateCodecAvailable(write_codec)) {
+				printf("Warning ! codec %s is not available\n", argv[arg] + 19);
+				write_codec = kCodecNone;
+			}
+		} else {
+			printf("Warning ! unknown option %s\n", argv[arg]);
+		}
+	}
+	if (png_level >= 0) {
+		stbi_write_png_compression_level = png_level;
+	}
+	PipelineStats stats;
+	TemplateBlobWriter blob_writer;
+	// decoded images are written while the next one is being decoded
+	std::unique_ptr< AsyncFileIO > async_io(AsyncFileIO::Create(kAsyncIODepth));
+	printf("async io backend : %s\n", async_io->Name());
+	if (blob_output && 0 != blob_writer.Open(parsed_template_blob_path)) {
+		printf("Error ! open blob file failed!\n");
+		return 0;
+	}
+
+	// the parsed templates (submessages, strings, repeated fields) are
+	// bump-allocated from template_arena and released together when it goes
+	google::protobuf::Arena template_arena;
+	pb::TemplateFile *parse_template = google::protobuf::Arena::CreateMessage< pb::TemplateFile >(&template_arena);
 
 	if (!IsFileExist(template_file_path)){
 		printf("Error ! template file not exist!\n");
@@ -134,19 +494,55 @@ int main()
 	int file_length(0);
 	std::unique_ptr< char[] > templateFileContentManager;
 
-	if (0 != ReadFile(template_file_path, &template_file_content, file_length)) {
-		printf("Error ! read template file failed!\n");
-		return 0;
+	{
+		ScopedStageTimer timer(&stats, PipelineStats::kStageRead);
+		if (0 != ReadFile(async_io.get(), template_file_path, &template_file_content, file_length)) {
+			printf("Error ! read template file failed!\n");
+			return 0;
+		}
+		timer.set_bytes(file_length);
 	}
 	
 	templateFileContentManager.reset(template_file_content);
 
+	TemplateCodec template_codec = DetectTemplateCodec(template_file_content, file_length);
+	if (kCodecNone != template_codec) {
+		if (!TemplateCodecAvailable(template_codec)) {
+			printf("Error ! template file is %s compressed, which this build can't read\n", TemplateCodecName(template_codec));
+			return 0;
+		}
+		std::unique_ptr< char[] > decompressed;
+		int decompressed_length(0);
+		{
+			ScopedStageTimer timer(&stats, PipelineStats::kStageDecompress, file_length);
+			if (0 != DecompressTemplate(template_codec, template_file_content, file_length, &decompressed, &decompressed_length)) {
+				printf("Error ! decompress template file failed!\n");
+				return 0;
+			}
+		}
+		templateFileContentManager = std::move(decompressed);
+		template_file_content = templateFileContentManager.get();
+		file_length = decompressed_length;
+		printf("template file : %s compressed, %d bytes\n", TemplateCodecName(template_codec), file_length);
+	}
+
+	if (kCodecNone != write_codec && 0 != WriteCompressedTemplate(write_codec, template_file_content, file_length)) {
+		printf("Error ! write compressed template failed!\n");
+		return 0;
+	}
+	if (codec_rounds > 0 && 0 != BenchCodecs(template_file_content, file_length, codec_rounds)) {
+		return 0;
+	}
+
 	if (nullptr == template_file_content) {
 		printf("Error ! template file is NULL\n");
 		return 0;
 	} else {
 		bool ret(false);
-		ret = parse_template->ParseFromArray(template_file_content, file_length);
+		{
+			ScopedStageTimer timer(&stats, PipelineStats::kStageParse, file_length);
+			ret = (0 == ParseTemplateFile(template_file_content, file_length, budget, parse_template));
+		}
 		if (!ret) {
 			printf("Error ! parse template from array failed!\n");
 			return 0;
@@ -161,6 +557,16 @@ int main()
 	printf("versionstring : %s\n", parse_template->versionstring().c_str());
 	printf("identifier : %s\n", parse_template->identifier().c_str());
 	printf("singlePersonTemplateIndex : %d\n", parse_template->singlepersontemplateindex());
+	if (dump_fields) {
+		DumpFields(*parse_template, 0);
+	}
+
+	if (parse_rounds > 0 && 0 != BenchParse(template_file_content, file_length, budget, parse_rounds, &stats)) {
+		return 0;
+	}
+	if (serialize_rounds > 0 && 0 != BenchSerialize(*parse_template, serialize_rounds, &stats)) {
+		return 0;
+	}
 
 	std::vector<st_tee_input> parsed_templates;
 
@@ -173,12 +579,12 @@ int main()
 		for (auto j = 0; j < single_template_count; j++)
 		{
 			pb::SingleTemlate &single_template = const_cast<pb::SingleTemlate&>(singlePersonTemplate.singletemlate(j));
-			auto image = single_template.imageinfo();
+			const pb::Image &image = single_template.imageinfo();
 			st_tee_input parsed_image {0};
 			std::unique_ptr<unsigned char[]> outBufferGuard;
 			if (tempalte_version == template_version_1_0_0)
 			{
-				parsed_image.image_data = (unsigned char*)(image.data().c_str());
+				parsed_image.image_data = (unsigned char*)(image.data().data());
 				parsed_image.width = image.width();
 				parsed_image.height = image.height();
 				parsed_image.format = image.format();
@@ -192,24 +598,55 @@ int main()
 				
 				printf("image.data().length() = %d\n", image.data().length());
 
-				if (0 != LoadJpegMemoryToBGR(reinterpret_cast<const unsigned char*>(image.data().c_str()), 
-											image.data().length(), width, height, channels,
-											outBufferGuard))
 				{
-					printf("Error ! LoadJpegMemoryToBGR failed!\ns");
-					return 0;
+					// bytes counted are the compressed input
+					ScopedStageTimer timer(&stats, PipelineStats::kStageDecode, image.data().length());
+					if (0 != LoadJpegMemoryToBGR(reinterpret_cast<const unsigned char*>(image.data().data()), 
+												image.data().length(), width, height, channels,
+												outBufferGuard))
+					{
+						printf("Error ! LoadJpegMemoryToBGR failed!\ns");
+						return 0;
+					}
 				}
 				parsed_image = { outBufferGuard.get(), image.width(), image.height(), channels, 0 };
 				parsed_image.format = image.format();
 				// parsed_templates.push_back(parsed_image);
 
-				std::string parsed_template_path(parsed_template_dir);
-				parsed_template_path = parsed_template_path + ::to_string(i);
-				printf("%s\n", parsed_template_path.c_str());
 				const char* str = reinterpret_cast<const char*>(parsed_image.image_data);
 				int length = width * height * channels;
 				printf("length = %d\n", length);
-				WriteFile(parsed_template_path.c_str(), str, length);
+				if (blob_output)
+				{
+					BlobIndexEntry entry = { 0, 0, i, j, width, height, channels, parsed_image.format };
+					ScopedStageTimer timer(&stats, PipelineStats::kStageWrite, length);
+					if (0 != blob_writer.Append(entry, str, length))
+					{
+						printf("Error ! append to blob file failed!\n");
+						return 0;
+					}
+				}
+				else if (png_level >= 0)
+				{
+					char png_path[256];
+					snprintf(png_path, sizeof(png_path), "%s%d_%d.png", parsed_template_dir, i, j);
+					printf("%s\n", png_path);
+					ScopedStageTimer timer(&stats, PipelineStats::kStageWrite);
+					long png_bytes = WritePngFile(png_path, outBufferGuard.get(), width, height, channels);
+					if (png_bytes < 0)
+					{
+						printf("Error ! write png [%s] failed!\n", png_path);
+						return 0;
+					}
+					timer.set_bytes(png_bytes);
+				}
+				else
+				{
+					char parsed_template_path[256];
+					snprintf(parsed_template_path, sizeof(parsed_template_path), "%s%d_%d", parsed_template_dir, i, j);
+					printf("%s\n", parsed_template_path);
+					WriteFile(async_io.get(), &stats, parsed_template_path, std::move(outBufferGuard), length);
+				}
 
 			}
 			else
@@ -223,7 +660,26 @@ int main()
 		
 	}
 	
+	if (0 != async_io->Drain())
+	{
+		printf("Error ! write parsed templates failed!\n");
+		return 0;
+	}
 
+	if (blob_output)
+	{
+		if (0 != blob_writer.Close())
+		{
+			printf("Error ! close blob file failed!\n");
+			return 0;
+		}
+		printf("blob file %s : %d images\n", parsed_template_blob_path, (int)blob_writer.image_count());
+	}
+
+	if (nullptr != stats_path && 0 == stats.WriteJsonReport(stats_path))
+	{
+		printf("stats report : %s\n", stats_path);
+	}
 
 	return 0;
 }
@@ -0,0 +1,31 @@
+#!/bin/bash
+# -O3 + LTO build of parse_template, optimized with the profile of a run over
+# template/template_file.data on the device
+
+DEVICE_DIR=/data/protobuf
+
+if [ ! -d "./build_pgo" ]; then
+	mkdir ./build_pgo
+fi
+
+cd ./build_pgo
+rm -rf *
+
+# instrumented build, which writes its profile to $DEVICE_DIR/pgo
+cmake -DCMAKE_BUILD_TYPE=Release -DPGO=GENERATE -DPGO_DIR=$DEVICE_DIR/pgo ../
+make
+
+adb shell rm -rf $DEVICE_DIR/pgo $DEVICE_DIR/parsed_templates
+adb shell mkdir -p $DEVICE_DIR/parsed_templates
+adb push ./parse_template $DEVICE_DIR
+adb push ../template/template_file.data $DEVICE_DIR
+adb shell "cd $DEVICE_DIR && ./parse_template"
+adb pull $DEVICE_DIR/pgo ./pgo
+
+# rebuild everything with the profile
+cmake -DPGO=USE -DPGO_DIR=$(pwd)/pgo ../
+make clean
+make
+
+cd ../
+adb push ./build_pgo/parse_template $DEVICE_DIR
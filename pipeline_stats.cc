@@ -0,0 +1,100 @@
+#include "pipeline_stats.h"
+#include <stdio.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <algorithm>
+
+static const char *const kStageNames[PipelineStats::kStageCount] = {
+	"read", "decompress", "parse", "decode", "write", "serialize", "serialize_single_pass",
+	"parse_bench",
+};
+
+
+// nearest-rank percentile of sorted samples
+static uint64_t Percentile(const std::vector< uint64_t > &sorted, double p)
+{
+	if (sorted.empty()) return 0;
+	size_t rank = static_cast< size_t >(p / 100.0 * sorted.size() + 0.999999);
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+	return sorted[rank - 1];
+}
+
+static double ToMs(uint64_t ns)
+{
+	return ns / 1e6;
+}
+
+
+PipelineStats::PipelineStats()
+	: start_ns_(NowNs())
+{
+	for (int i = 0; i < kStageCount; i++) {
+		stages_[i].bytes = 0;
+	}
+}
+
+uint64_t PipelineStats::NowNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast< uint64_t >(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+void PipelineStats::Record(Stage stage, uint64_t start_ns, uint64_t end_ns, uint64_t bytes)
+{
+	std::lock_guard< std::mutex > lock(mutex_);
+	stages_[stage].latency_ns.push_back(end_ns - start_ns);
+	stages_[stage].bytes += bytes;
+}
+
+int PipelineStats::WriteJsonReport(const char *path) const
+{
+	FILE *out = fopen(path, "w");
+	if (nullptr == out) {
+		printf("Error ! stats report [%s] open failed\n", path);
+		return -1;
+	}
+
+	std::lock_guard< std::mutex > lock(mutex_);
+	double wall_s = (NowNs() - start_ns_) / 1e9;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	fprintf(out, "{\n");
+	fprintf(out, "  \"wall_ms\": %.3f,\n", wall_s * 1e3);
+	// ru_maxrss is in kilobytes on Linux/Android
+	fprintf(out, "  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+	fprintf(out, "  \"images\": %zu,\n", stages_[kStageDecode].latency_ns.size());
+	fprintf(out, "  \"images_per_second\": %.3f,\n",
+		wall_s > 0 ? stages_[kStageDecode].latency_ns.size() / wall_s : 0.0);
+	fprintf(out, "  \"stages\": {\n");
+	for (int i = 0; i < kStageCount; i++) {
+		std::vector< uint64_t > sorted(stages_[i].latency_ns);
+		std::sort(sorted.begin(), sorted.end());
+		uint64_t total = 0;
+		for (size_t k = 0; k < sorted.size(); k++) {
+			total += sorted[k];
+		}
+		double total_s = total / 1e9;
+		fprintf(out, "    \"%s\": {\n", kStageNames[i]);
+		fprintf(out, "      \"count\": %zu,\n", sorted.size());
+		fprintf(out, "      \"bytes\": %llu,\n", static_cast< unsigned long long >(stages_[i].bytes));
+		fprintf(out, "      \"total_ms\": %.3f,\n", ToMs(total));
+		fprintf(out, "      \"min_ms\": %.3f,\n", ToMs(sorted.empty() ? 0 : sorted.front()));
+		fprintf(out, "      \"mean_ms\": %.3f,\n", sorted.empty() ? 0.0 : ToMs(total) / sorted.size());
+		fprintf(out, "      \"p50_ms\": %.3f,\n", ToMs(Percentile(sorted, 50)));
+		fprintf(out, "      \"p90_ms\": %.3f,\n", ToMs(Percentile(sorted, 90)));
+		fprintf(out, "      \"p99_ms\": %.3f,\n", ToMs(Percentile(sorted, 99)));
+		fprintf(out, "      \"max_ms\": %.3f,\n", ToMs(sorted.empty() ? 0 : sorted.back()));
+		fprintf(out, "      \"bytes_per_second\": %.1f,\n", total_s > 0 ? stages_[i].bytes / total_s : 0.0);
+		fprintf(out, "      \"items_per_second\": %.3f\n", total_s > 0 ? sorted.size() / total_s : 0.0);
+		fprintf(out, "    }%s\n", i + 1 < kStageCount ? "," : "");
+	}
+	fprintf(out, "  }\n");
+	fprintf(out, "}\n");
+
+	int ret = ferror(out) ? -1 : 0;
+	if (0 != fclose(out)) ret = -1;
+	return ret;
+}
@@ -0,0 +1,65 @@
+#ifndef PIPELINE_STATS_H_
+#define PIPELINE_STATS_H_
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+// Per-stage latency and throughput of the template pipeline. Samples are
+// taken with the monotonic clock; Record() may be called from any thread
+// (async write completions run on I/O threads).
+class PipelineStats {
+public:
+	enum Stage {
+		kStageRead,
+		kStageDecompress,
+		kStageParse,
+		kStageDecode,
+		kStageWrite,
+		kStageSerialize,
+		kStageSerializeSinglePass,
+		kStageParseBench,
+		kStageCount,
+	};
+
+	PipelineStats();
+
+	static uint64_t NowNs();
+
+	void Record(Stage stage, uint64_t start_ns, uint64_t end_ns, uint64_t bytes);
+
+	// stage latencies (count, total, min/mean/p50/p90/p99/max), bytes and
+	// images per second, wall time and peak RSS; returns 0 or -1
+	int WriteJsonReport(const char *path) const;
+
+private:
+	struct StageSamples {
+		std::vector< uint64_t > latency_ns;
+		uint64_t bytes;
+	};
+
+	uint64_t start_ns_;
+	mutable std::mutex mutex_;
+	StageSamples stages_[kStageCount];
+};
+
+// Times the enclosing scope as one sample of 'stage'.
+class ScopedStageTimer {
+public:
+	ScopedStageTimer(PipelineStats *stats, PipelineStats::Stage stage, uint64_t bytes = 0)
+		: stats_(stats), stage_(stage), bytes_(bytes), start_ns_(PipelineStats::NowNs()) {}
+	~ScopedStageTimer() { stats_->Record(stage_, start_ns_, PipelineStats::NowNs(), bytes_); }
+
+	void set_bytes(uint64_t bytes) { bytes_ = bytes; }
+
+private:
+	PipelineStats *stats_;
+	PipelineStats::Stage stage_;
+	uint64_t bytes_;
+	uint64_t start_ns_;
+
+	ScopedStageTimer(const ScopedStageTimer &);
+	ScopedStageTimer &operator=(const ScopedStageTimer &);
+};
+
+#endif  // PIPELINE_STATS_H_
@@ -0,0 +1,10 @@
+// The stb image decoder and writer the tool uses, built from include/codec.
+// The prebuilt lib/libst_imagehelper.a carries older copies of both in
+// stb_impl.c.o, without the streamed JPEG decode; this object defines every
+// symbol the tool needs from there, so that member is never pulled out of
+// the archive and the two don't clash. Configure with WITH_OPENMP to filter
+// the rows of a PNG on all cores.
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "codec/stb_image.h"
+#include "codec/stb_image_write.h"
@@ -0,0 +1,176 @@
+#include "template_blob_writer.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static const size_t kBlobBufferSize = 1 << 20;
+// payloads at least this large are written straight from the caller's memory
+static const size_t kBlobDirectWriteSize = kBlobBufferSize / 4;
+
+
+static int WriteFully(int fd, struct iovec *iov, int iovcnt)
+{
+	while (iovcnt > 0) {
+		ssize_t n = writev(fd, iov, iovcnt);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			return -1;
+		}
+		while (iovcnt > 0 && static_cast< size_t >(n) >= iov->iov_len) {
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = static_cast< char * >(iov->iov_base) + n;
+			iov->iov_len -= n;
+		}
+	}
+	return 0;
+}
+
+
+TemplateBlobWriter::TemplateBlobWriter()
+	: fd_(-1), buffer_(nullptr), buffered_(0), offset_(0)
+{
+}
+
+TemplateBlobWriter::~TemplateBlobWriter()
+{
+	if (fd_ >= 0) {
+		Close();
+	}
+	free(buffer_);
+}
+
+int TemplateBlobWriter::Open(const char *path)
+{
+	if (nullptr == path || fd_ >= 0) {
+		printf("Warning ! %s invalid args\n", __FUNCTION__);
+		return -1;
+	}
+	if (nullptr == buffer_) {
+		void *buffer = nullptr;
+		if (0 != posix_memalign(&buffer, kBlobAlignment, kBlobBufferSize)) {
+			return -1;
+		}
+		buffer_ = static_cast< char * >(buffer);
+	}
+
+	fd_ = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd_ < 0) {
+		printf("Error ! blob file [%s] open failed\n", path);
+		return -1;
+	}
+	buffered_ = 0;
+	offset_ = 0;
+	index_.clear();
+
+	// placeholder, rewritten by Close() once the index location is known
+	BlobFileHeader header;
+	memset(&header, 0, sizeof(header));
+	return Buffer(reinterpret_cast< const char * >(&header), sizeof(header));
+}
+
+int TemplateBlobWriter::Append(const BlobIndexEntry &entry, const char *data, size_t length)
+{
+	if (fd_ < 0 || nullptr == data || 0 == length) {
+		printf("Warning ! %s invalid args\n", __FUNCTION__);
+		return -1;
+	}
+	if (0 != Pad(kBlobAlignment)) {
+		return -1;
+	}
+
+	BlobIndexEntry indexed = entry;
+	indexed.offset = offset_;
+	indexed.length = length;
+	index_.push_back(indexed);
+
+	if (length >= kBlobDirectWriteSize) {
+		return Flush(data, length);
+	}
+	return Buffer(data, length);
+}
+
+int TemplateBlobWriter::Close()
+{
+	if (fd_ < 0) {
+		return -1;
+	}
+	int ret = Pad(sizeof(uint64_t));
+
+	BlobFileHeader header;
+	memcpy(header.magic, kBlobMagic, sizeof(header.magic));
+	header.version = kBlobVersion;
+	header.image_count = static_cast< uint32_t >(index_.size());
+	header.index_offset = offset_;
+
+	if (0 == ret && !index_.empty()) {
+		ret = Buffer(reinterpret_cast< const char * >(&index_[0]), index_.size() * sizeof(BlobIndexEntry));
+	}
+	if (0 == ret) {
+		ret = Flush(nullptr, 0);
+	}
+	if (0 == ret && pwrite(fd_, &header, sizeof(header), 0) != static_cast< ssize_t >(sizeof(header))) {
+		ret = -1;
+	}
+	if (0 != close(fd_)) {
+		ret = -1;
+	}
+	fd_ = -1;
+	if (0 != ret) {
+		printf("Error ! blob file write failed\n");
+	}
+	return ret;
+}
+
+int TemplateBlobWriter::Buffer(const char *data, size_t length)
+{
+	while (length > 0) {
+		if (buffered_ == kBlobBufferSize && 0 != Flush(nullptr, 0)) {
+			return -1;
+		}
+		size_t n = kBlobBufferSize - buffered_;
+		if (n > length) n = length;
+		memcpy(buffer_ + buffered_, data, n);
+		buffered_ += n;
+		offset_ += n;
+		data += n;
+		length -= n;
+	}
+	return 0;
+}
+
+int TemplateBlobWriter::Pad(size_t alignment)
+{
+	static const char zeros[kBlobAlignment] = { 0 };
+	size_t padding = (alignment - offset_ % alignment) % alignment;
+	return Buffer(zeros, padding);
+}
+
+int TemplateBlobWriter::Flush(const char *tail, size_t tail_length)
+{
+	struct iovec iov[2];
+	int iovcnt = 0;
+	if (buffered_ > 0) {
+		iov[iovcnt].iov_base = buffer_;
+		iov[iovcnt].iov_len = buffered_;
+		iovcnt++;
+	}
+	if (tail_length > 0) {
+		iov[iovcnt].iov_base = const_cast< char * >(tail);
+		iov[iovcnt].iov_len = tail_length;
+		iovcnt++;
+	}
+	if (0 != WriteFully(fd_, iov, iovcnt)) {
+		return -1;
+	}
+	buffered_ = 0;
+	offset_ += tail_length;
+	return 0;
+}
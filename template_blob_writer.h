@@ -0,0 +1,66 @@
+#ifndef TEMPLATE_BLOB_WRITER_H_
+#define TEMPLATE_BLOB_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Layout of a blob file (host byte order):
+//   BlobFileHeader
+//   image payloads, each starting on a kBlobAlignment boundary
+//   BlobIndexEntry[image_count] starting at index_offset
+// so a loader can mmap the file and address every image through the index.
+
+static const char kBlobMagic[8] = { 'T', 'P', 'L', 'B', 'L', 'O', 'B', '1' };
+static const uint32_t kBlobVersion = 1;
+static const size_t kBlobAlignment = 4096;
+
+struct BlobFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t image_count;
+	uint64_t index_offset;
+};
+
+struct BlobIndexEntry {
+	uint64_t offset;
+	uint64_t length;
+	int32_t person_index;
+	int32_t template_index;
+	int32_t width;
+	int32_t height;
+	int32_t channels;
+	int32_t format;
+};
+
+// Appends images to a single file through one large aligned buffer; big
+// payloads skip the buffer and go out with writev together with whatever
+// is pending. The header and index are written by Close().
+class TemplateBlobWriter {
+public:
+	TemplateBlobWriter();
+	~TemplateBlobWriter();
+
+	int Open(const char *path);
+	// offset/length of entry are filled in by the writer
+	int Append(const BlobIndexEntry &entry, const char *data, size_t length);
+	int Close();
+
+	size_t image_count() const { return index_.size(); }
+
+private:
+	int Buffer(const char *data, size_t length);
+	int Pad(size_t alignment);
+	int Flush(const char *tail, size_t tail_length);
+
+	int fd_;
+	char *buffer_;
+	size_t buffered_;
+	uint64_t offset_;
+	std::vector< BlobIndexEntry > index_;
+
+	TemplateBlobWriter(const TemplateBlobWriter &);
+	TemplateBlobWriter &operator=(const TemplateBlobWriter &);
+};
+
+#endif  // TEMPLATE_BLOB_WRITER_H_
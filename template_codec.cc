@@ -0,0 +1,223 @@
+#include "template_codec.h"
+#include <stdio.h>
+#include <string.h>
+#include <climits>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#if HAVE_ZLIB
+#include <google/protobuf/io/gzip_stream.h>
+#endif
+#if HAVE_LZ4
+#include <google/protobuf/io/lz4_stream.h>
+#endif
+#if HAVE_ZSTD
+#include <google/protobuf/io/zstd_stream.h>
+#endif
+
+using google::protobuf::io::ArrayInputStream;
+using google::protobuf::io::StringOutputStream;
+using google::protobuf::io::ZeroCopyInputStream;
+using google::protobuf::io::ZeroCopyOutputStream;
+
+struct CodecInfo {
+	const char *name;
+	const char *suffix;
+	const char *magic;
+	int magic_length;
+};
+
+static const CodecInfo kCodecs[kCodecCount] = {
+	{ "none", "", "", 0 },
+	{ "gzip", ".gz", "\x1f\x8b", 2 },
+	{ "lz4", ".lz4", "\x04\x22\x4d\x18", 4 },
+	{ "zstd", ".zst", "\x28\xb5\x2f\xfd", 4 },
+};
+
+// a template is mostly JPEG data, which hardly compresses, so twice the
+// input is a safe first guess at the output; the buffer doubles from there
+static const int kInitialExpansion = 2;
+
+
+const char *TemplateCodecName(TemplateCodec codec)
+{
+	return kCodecs[codec].name;
+}
+
+const char *TemplateCodecSuffix(TemplateCodec codec)
+{
+	return kCodecs[codec].suffix;
+}
+
+TemplateCodec ParseTemplateCodec(const char *name)
+{
+	for (int i = 0; i < kCodecCount; i++) {
+		if (0 == strcmp(name, kCodecs[i].name)) return static_cast< TemplateCodec >(i);
+	}
+	return kCodecCount;
+}
+
+bool TemplateCodecAvailable(TemplateCodec codec)
+{
+	switch (codec) {
+	case kCodecNone:
+		return true;
+#if HAVE_ZLIB
+	case kCodecGzip:
+		return true;
+#endif
+#if HAVE_LZ4
+	case kCodecLz4:
+		return true;
+#endif
+#if HAVE_ZSTD
+	case kCodecZstd:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+TemplateCodec DetectTemplateCodec(const char *content, int length)
+{
+	for (int i = 1; i < kCodecCount; i++) {
+		if (length >= kCodecs[i].magic_length && 0 == memcmp(content, kCodecs[i].magic, kCodecs[i].magic_length)) {
+			return static_cast< TemplateCodec >(i);
+		}
+	}
+	return kCodecNone;
+}
+
+// copies all of input into output, returns 0 or -1
+static int CopyStream(const char *data, int length, ZeroCopyOutputStream *output)
+{
+	while (length > 0) {
+		void *buffer;
+		int size;
+		if (!output->Next(&buffer, &size)) return -1;
+		if (size > length) {
+			memcpy(buffer, data, length);
+			output->BackUp(size - length);
+			return 0;
+		}
+		memcpy(buffer, data, size);
+		data += size;
+		length -= size;
+	}
+	return 0;
+}
+
+int CompressTemplate(TemplateCodec codec, const char *content, int length, std::string *compressed)
+{
+	compressed->clear();
+	StringOutputStream output(compressed);
+	switch (codec) {
+	case kCodecNone:
+		return CopyStream(content, length, &output);
+#if HAVE_ZLIB
+	case kCodecGzip: {
+		// the blocks of a large template are compressed on every core
+		google::protobuf::io::ParallelGzipOutputStream gzip(&output);
+		if (0 != CopyStream(content, length, &gzip) || !gzip.Close()) return -1;
+		return 0;
+	}
+#endif
+#if HAVE_LZ4
+	case kCodecLz4: {
+		google::protobuf::io::Lz4OutputStream lz4(&output);
+		if (0 != CopyStream(content, length, &lz4) || !lz4.Close()) return -1;
+		return 0;
+	}
+#endif
+#if HAVE_ZSTD
+	case kCodecZstd: {
+		google::protobuf::io::ZstdOutputStream zstd(&output);
+		if (0 != CopyStream(content, length, &zstd) || !zstd.Close()) return -1;
+		return 0;
+	}
+#endif
+	default:
+		return -1;
+	}
+}
+
+// reads input to its end into a buffer that grows as needed; returns 0 or
+// -1 if the output would exceed INT_MAX bytes
+static int ReadStream(ZeroCopyInputStream *input, int size_hint, std::unique_ptr< char[] > *output, int *output_length)
+{
+	int capacity = size_hint > 0 ? size_hint : 4096;
+	std::unique_ptr< char[] > buffer(new char[capacity + 1]);
+	int used = 0;
+	const void *data;
+	int size;
+	while (input->Next(&data, &size)) {
+		if (size > capacity - used) {
+			if (size > INT_MAX - 1 - used) return -1;
+			int new_capacity = capacity > (INT_MAX - 1) / 2 ? INT_MAX - 1 : capacity * 2;
+			if (new_capacity < used + size) new_capacity = used + size;
+			std::unique_ptr< char[] > grown(new char[new_capacity + 1]);
+			memcpy(grown.get(), buffer.get(), used);
+			buffer.swap(grown);
+			capacity = new_capacity;
+		}
+		memcpy(buffer.get() + used, data, size);
+		used += size;
+	}
+	buffer[used] = '\0';
+	output->swap(buffer);
+	*output_length = used;
+	return 0;
+}
+
+int DecompressTemplate(TemplateCodec codec, const char *content, int length,
+					   std::unique_ptr< char[] > *output, int *output_length)
+{
+	ArrayInputStream input(content, length);
+	int size_hint = length > INT_MAX / kInitialExpansion ? INT_MAX - 1 : length * kInitialExpansion;
+	switch (codec) {
+	case kCodecNone:
+		return ReadStream(&input, length, output, output_length);
+#if HAVE_ZLIB
+	case kCodecGzip: {
+		// the gzip trailer ends with the length mod 2^32; it is not checked
+		// until the end of the stream, so it may only shrink the first guess,
+		// never make us allocate more than kInitialExpansion times the input
+		if (length >= 4) {
+			const unsigned char *trailer = reinterpret_cast< const unsigned char * >(content + length - 4);
+			unsigned int isize = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast< unsigned int >(trailer[3]) << 24);
+			if (isize > 0 && isize < static_cast< unsigned int >(size_hint)) size_hint = isize;
+		}
+		google::protobuf::io::GzipInputStream gzip(&input, google::protobuf::io::GzipInputStream::GZIP);
+		if (0 != ReadStream(&gzip, size_hint, output, output_length)) return -1;
+		if (gzip.ZlibErrorCode() < 0) {
+			printf("Error ! gzip : %s\n", gzip.ZlibErrorMessage() ? gzip.ZlibErrorMessage() : "corrupt data");
+			return -1;
+		}
+		return 0;
+	}
+#endif
+#if HAVE_LZ4
+	case kCodecLz4: {
+		google::protobuf::io::Lz4InputStream lz4(&input);
+		if (0 != ReadStream(&lz4, size_hint, output, output_length)) return -1;
+		if (nullptr != lz4.ErrorMessage()) {
+			printf("Error ! lz4 : %s\n", lz4.ErrorMessage());
+			return -1;
+		}
+		return 0;
+	}
+#endif
+#if HAVE_ZSTD
+	case kCodecZstd: {
+		google::protobuf::io::ZstdInputStream zstd(&input);
+		if (0 != ReadStream(&zstd, size_hint, output, output_length)) return -1;
+		if (nullptr != zstd.ErrorMessage()) {
+			printf("Error ! zstd : %s\n", zstd.ErrorMessage());
+			return -1;
+		}
+		return 0;
+	}
+#endif
+	default:
+		return -1;
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef TEMPLATE_CODEC_H_
+#define TEMPLATE_CODEC_H_
+
+#include <memory>
+#include <string>
+
+// Template files may be stored compressed. Which codecs are usable depends
+// on the build (HAVE_ZLIB, HAVE_LZ4, HAVE_ZSTD); a compressed file is
+// recognised by the magic number its format starts with.
+enum TemplateCodec {
+	kCodecNone,
+	kCodecGzip,
+	kCodecLz4,
+	kCodecZstd,
+	kCodecCount,
+};
+
+// "none", "gzip", "lz4" or "zstd"
+const char *TemplateCodecName(TemplateCodec codec);
+// file name suffix for the codec, including the dot ("" for none)
+const char *TemplateCodecSuffix(TemplateCodec codec);
+// kCodecCount if the name is unknown
+TemplateCodec ParseTemplateCodec(const char *name);
+bool TemplateCodecAvailable(TemplateCodec codec);
+
+// kCodecNone unless content starts with a known magic number
+TemplateCodec DetectTemplateCodec(const char *content, int length);
+
+// returns 0, or -1 if the codec isn't built in or fails
+int CompressTemplate(TemplateCodec codec, const char *content, int length, std::string *compressed);
+
+// decompresses all of content into a new buffer, which like ReadFile()'s
+// has a '\0' after the last byte; returns 0 or -1
+int DecompressTemplate(TemplateCodec codec, const char *content, int length,
+					   std::unique_ptr< char[] > *output, int *output_length);
+
+#endif  // TEMPLATE_CODEC_H_
@@ -0,0 +1,62 @@
+#ifndef TEMPLATE_DUMP_H_
+#define TEMPLATE_DUMP_H_
+
+#include <stdio.h>
+#include <string>
+#include "template_feature.pb.h"
+
+// Prints every field of a template message, one per line and indented by
+// nesting. The lite runtime has no reflection, so this goes through the
+// Fields types and VisitFields() the generator emits for each message.
+// Strings and bytes are printed as their length only, since they hold
+// images and features.
+template <typename Message>
+void DumpFields(const Message &message, int depth);
+
+inline void DumpValue(float value, int) { printf("%g\n", value); }
+inline void DumpValue(int32_t value, int) { printf("%d\n", value); }
+inline void DumpValue(uint32_t value, int) { printf("%u\n", value); }
+inline void DumpValue(pb::FaceDirection value, int) { printf("%d\n", (int)value); }
+inline void DumpValue(const std::string &value, int) { printf("<%zu bytes>\n", value.size()); }
+inline void DumpValue(google::protobuf::StringPiece value, int) { printf("<%d bytes>\n", value.size()); }
+inline void DumpValue(const pb::KeyPoint_Flat &value, int) { printf("(%g, %g)\n", value.x, value.y); }
+
+template <typename Message>
+void DumpValue(const Message &message, int depth)
+{
+	printf("{\n");
+	DumpFields(message, depth + 1);
+	printf("%*s}\n", depth * 2, "");
+}
+
+template <typename Message>
+class FieldDumper {
+public:
+	FieldDumper(const Message &message, int depth) : message_(message), depth_(depth) {}
+
+	template <typename Field>
+	void operator()(Field)
+	{
+		for (int i = 0; i < Field::Size(message_); i++) {
+			if (Field::kRepeated) {
+				printf("%*s%s[%d] : ", depth_ * 2, "", Field::Name(), i);
+			} else {
+				printf("%*s%s : ", depth_ * 2, "", Field::Name());
+			}
+			DumpValue(Field::Get(message_, i), depth_);
+		}
+	}
+
+private:
+	const Message &message_;
+	int depth_;
+};
+
+template <typename Message>
+void DumpFields(const Message &message, int depth)
+{
+	FieldDumper< Message > dumper(message, depth);
+	Message::VisitFields(&dumper);
+}
+
+#endif  // TEMPLATE_DUMP_H_
@@ -65,10 +65,27 @@ bool FaceDirection_IsValid(int value) {
 #ifndef _MSC_VER
 const int KeyPoint::kXFieldNumber;
 const int KeyPoint::kYFieldNumber;
+const int KeyPoint::kByteSize;
+const int KeyPoint::kFlatByteSize;
+const int KeyPoint::Fields::x::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    KeyPoint::Fields::x::kType;
+const bool KeyPoint::Fields::x::kRepeated;
+const int KeyPoint::Fields::y::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    KeyPoint::Fields::y::kType;
+const bool KeyPoint::Fields::y::kRepeated;
 #endif  // !_MSC_VER
 
 KeyPoint::KeyPoint()
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+}
+
+KeyPoint::KeyPoint(::google::protobuf::Arena* arena)
+  : ::google::protobuf::MessageLite(),
+    arena_(arena) {
   SharedCtor();
 }
 
@@ -76,11 +93,25 @@ void KeyPoint::InitAsDefaultInstance() {
 }
 
 KeyPoint::KeyPoint(const KeyPoint& from)
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+KeyPoint::KeyPoint(KeyPoint&& from)
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+  if (from.arena_ == NULL) {
+    Swap(&from);
+  } else {
+    MergeFrom(from);
+  }
+}
+#endif
+
 void KeyPoint::SharedCtor() {
   _cached_size_ = 0;
   x_ = 0;
@@ -130,6 +161,36 @@ bool KeyPoint::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_FIXED32) {
+          {
+            // Fast path: x to y in order.
+            const void* data;
+            int size;
+            int readable;
+            input->GetDirectBufferPointerInline(&data, &size, &readable);
+            const ::google::protobuf::uint8* start =
+                static_cast<const ::google::protobuf::uint8*>(data);
+            const ::google::protobuf::uint8* ptr = start;
+            float x_value;
+            float y_value;
+            if (readable >= 9 &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(
+                   ptr, &x_value)) != NULL &&
+                (ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+                   ptr, 21)) != NULL &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(
+                   ptr, &y_value)) != NULL &&
+                ptr - start <= size) {
+              x_ = x_value;
+              set_has_x();
+              y_ = y_value;
+              set_has_y();
+              DO_(input->Skip(ptr - start));
+              if (input->ExpectAtEnd()) return true;
+              break;
+            }
+          }
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
                    float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(
                  input, &x_)));
@@ -186,7 +247,24 @@ void KeyPoint::SerializeWithCachedSizes(
   
 }
 
+void KeyPoint::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {
+  // required float y = 2;
+  if (has_y()) {
+    ::google::protobuf::internal::WireFormatLite::WriteFloat(2, this->y(), output);
+  }
+  
+  // required float x = 1;
+  if (has_x()) {
+    ::google::protobuf::internal::WireFormatLite::WriteFloat(1, this->x(), output);
+  }
+  
+}
+
 int KeyPoint::ByteSize() const {
+  if ((_has_bits_[0] & 0x00000003u) == 0x00000003u) {
+    return kByteSize;
+  }
   int total_size = 0;
   
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -236,8 +314,114 @@ bool KeyPoint::IsInitialized() const {
   return true;
 }
 
+bool KeyPoint::ReadFlat(
+    ::google::protobuf::io::CodedInputStream* input, Flat* value) {
+#define DO_(EXPRESSION) if (!(EXPRESSION)) return false
+  ::google::protobuf::uint32 length;
+  DO_(input->ReadVarint32(&length));
+
+  // Fast path: every field once, in order, entirely in the buffer.
+  const void* data;
+  int size;
+  input->GetDirectBufferPointerInline(&data, &size);
+  if (length == kFlatByteSize && size >= kFlatByteSize) {
+    const ::google::protobuf::uint8* ptr =
+        static_cast<const ::google::protobuf::uint8*>(data);
+    if ((ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+             ptr, 13)) != NULL) {
+      ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+          float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(ptr, &value->x);
+      if ((ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+               ptr, 21)) != NULL) {
+        ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+            float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(ptr, &value->y);
+        return input->Skip(kFlatByteSize);
+      }
+    }
+  }
+
+  // Anything else: any order, repeated, missing or unknown fields, or
+  // split across buffers.  A struct has no has-bits, so missing fields
+  // read as their defaults.
+  value->x = 0;
+  value->y = 0;
+  ::google::protobuf::io::CodedInputStream::Limit limit =
+      input->PushLimit(length);
+  ::google::protobuf::uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    switch (tag) {
+      case 13:
+        DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(
+              input, &value->x)));
+        break;
+      case 21:
+        DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                float, ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT>(
+              input, &value->y)));
+        break;
+      default:
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
+          return false;
+        }
+        DO_(::google::protobuf::internal::WireFormatLite::SkipField(input, tag));
+        break;
+    }
+  }
+  DO_(input->ConsumedEntireMessage());
+  input->PopLimit(limit);
+  return true;
+#undef DO_
+}
+
+void KeyPoint::WriteFlat(
+    int field_number, const Flat& value,
+    ::google::protobuf::io::CodedOutputStream* output) {
+  ::google::protobuf::internal::WireFormatLite::WriteTag(field_number,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      output);
+  output->WriteVarint32(kFlatByteSize);
+  ::google::protobuf::uint8* target =
+      output->GetDirectBufferForNBytesAndAdvance(kFlatByteSize);
+  if (target != NULL) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteFloatToArray(1, value.x, target);
+    target = ::google::protobuf::internal::WireFormatLite::
+      WriteFloatToArray(2, value.y, target);
+    return;
+  }
+  ::google::protobuf::internal::WireFormatLite::WriteFloat(
+    1, value.x, output);
+  ::google::protobuf::internal::WireFormatLite::WriteFloat(
+    2, value.y, output);
+}
+
+::google::protobuf::uint8* KeyPoint::WriteFlatToArray(
+    int field_number, const Flat& value,
+    ::google::protobuf::uint8* target) {
+  target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+      field_number,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      target);
+  target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+      kFlatByteSize, target);
+  target = ::google::protobuf::internal::WireFormatLite::
+    WriteFloatToArray(1, value.x, target);
+  target = ::google::protobuf::internal::WireFormatLite::
+    WriteFloatToArray(2, value.y, target);
+  return target;
+}
+
 void KeyPoint::Swap(KeyPoint* other) {
   if (other != this) {
+    if (arena_ != other->arena_) {
+      KeyPoint temp;
+      temp.MergeFrom(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(x_, other->x_);
     std::swap(y_, other->y_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -258,10 +442,37 @@ const int Image::kFormatFieldNumber;
 const int Image::kWidthFieldNumber;
 const int Image::kHeightFieldNumber;
 const int Image::kStrideFieldNumber;
+const int Image::Fields::data::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    Image::Fields::data::kType;
+const bool Image::Fields::data::kRepeated;
+const int Image::Fields::format::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    Image::Fields::format::kType;
+const bool Image::Fields::format::kRepeated;
+const int Image::Fields::width::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    Image::Fields::width::kType;
+const bool Image::Fields::width::kRepeated;
+const int Image::Fields::height::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    Image::Fields::height::kType;
+const bool Image::Fields::height::kRepeated;
+const int Image::Fields::stride::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    Image::Fields::stride::kType;
+const bool Image::Fields::stride::kRepeated;
 #endif  // !_MSC_VER
 
 Image::Image()
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+}
+
+Image::Image(::google::protobuf::Arena* arena)
+  : ::google::protobuf::MessageLite(),
+    arena_(arena) {
   SharedCtor();
 }
 
@@ -269,14 +480,30 @@ void Image::InitAsDefaultInstance() {
 }
 
 Image::Image(const Image& from)
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+Image::Image(Image&& from)
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+  if (from.arena_ == NULL) {
+    Swap(&from);
+  } else {
+    MergeFrom(from);
+  }
+}
+#endif
+
 void Image::SharedCtor() {
   _cached_size_ = 0;
   data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  data_alias_ = NULL;
+  data_alias_size_ = 0;
   format_ = 0u;
   width_ = 0;
   height_ = 0;
@@ -314,6 +541,7 @@ Image* Image::New() const {
 void Image::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_data()) {
+      data_alias_ = NULL;
       if (data_ != &::google::protobuf::internal::kEmptyString) {
         data_->clear();
       }
@@ -332,12 +560,21 @@ bool Image::MergePartialFromCodedStream(
   ::google::protobuf::uint32 tag;
   while ((tag = input->ReadTag()) != 0) {
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // required bytes data = 1;
+      // required bytes data = 1 [ctype = STRING_PIECE];
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
-                input, this->mutable_data()));
+          input->BeginBytesField("pb.Image.data");
+          if (input->AliasingEnabled()) {
+            const void* alias;
+            int alias_size;
+            DO_(::google::protobuf::internal::WireFormatLite::ReadStringPieceAliased(
+                  input, &alias, &alias_size));
+            set_aliased_data(static_cast<const char*>(alias), alias_size);
+          } else {
+            DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                  input, this->mutable_data()));
+          }
         } else {
           goto handle_uninterpreted;
         }
@@ -350,6 +587,52 @@ bool Image::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
          parse_format:
+          {
+            // Fast path: format to stride in order.
+            const void* data;
+            int size;
+            int readable;
+            input->GetDirectBufferPointerInline(&data, &size, &readable);
+            const ::google::protobuf::uint8* start =
+                static_cast<const ::google::protobuf::uint8*>(data);
+            const ::google::protobuf::uint8* ptr = start;
+            ::google::protobuf::uint32 format_value;
+            ::google::protobuf::int32 width_value;
+            ::google::protobuf::int32 height_value;
+            ::google::protobuf::int32 stride_value;
+            if (readable >= 43 &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                   ptr, &format_value)) != NULL &&
+                (ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+                   ptr, 24)) != NULL &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                   ptr, &width_value)) != NULL &&
+                (ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+                   ptr, 32)) != NULL &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                   ptr, &height_value)) != NULL &&
+                (ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+                   ptr, 40)) != NULL &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                   ptr, &stride_value)) != NULL &&
+                ptr - start <= size) {
+              format_ = format_value;
+              set_has_format();
+              width_ = width_value;
+              set_has_width();
+              height_ = height_value;
+              set_has_height();
+              stride_ = stride_value;
+              set_has_stride();
+              DO_(input->Skip(ptr - start));
+              if (input->ExpectAtEnd()) return true;
+              break;
+            }
+          }
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
                    ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
                  input, &format_)));
@@ -426,9 +709,9 @@ bool Image::MergePartialFromCodedStream(
 
 void Image::SerializeWithCachedSizes(
     ::google::protobuf::io::CodedOutputStream* output) const {
-  // required bytes data = 1;
+  // required bytes data = 1 [ctype = STRING_PIECE];
   if (has_data()) {
-    ::google::protobuf::internal::WireFormatLite::WriteBytes(
+    ::google::protobuf::internal::WireFormatLite::WriteStringPiece(
       1, this->data(), output);
   }
   
@@ -454,14 +737,44 @@ void Image::SerializeWithCachedSizes(
   
 }
 
+void Image::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {
+  // required int32 stride = 5;
+  if (has_stride()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(5, this->stride(), output);
+  }
+  
+  // required int32 height = 4;
+  if (has_height()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(4, this->height(), output);
+  }
+  
+  // required int32 width = 3;
+  if (has_width()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(3, this->width(), output);
+  }
+  
+  // required uint32 format = 2;
+  if (has_format()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(2, this->format(), output);
+  }
+  
+  // required bytes data = 1 [ctype = STRING_PIECE];
+  if (has_data()) {
+    ::google::protobuf::internal::WireFormatLite::WriteStringPiece(
+      1, this->data(), output);
+  }
+  
+}
+
 int Image::ByteSize() const {
   int total_size = 0;
   
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    // required bytes data = 1;
+    // required bytes data = 1 [ctype = STRING_PIECE];
     if (has_data()) {
       total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::BytesSize(
+        ::google::protobuf::internal::WireFormatLite::StringPieceSize(
           this->data());
     }
     
@@ -509,7 +822,7 @@ void Image::MergeFrom(const Image& from) {
   GOOGLE_CHECK_NE(&from, this);
   if (from._has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (from.has_data()) {
-      set_data(from.data());
+      set_data(from.data().data(), from.data().size());
     }
     if (from.has_format()) {
       set_format(from.format());
@@ -540,7 +853,16 @@ bool Image::IsInitialized() const {
 
 void Image::Swap(Image* other) {
   if (other != this) {
+    if (arena_ != other->arena_) {
+      Image temp;
+      temp.MergeFrom(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(data_, other->data_);
+    std::swap(data_alias_, other->data_alias_);
+    std::swap(data_alias_size_, other->data_alias_size_);
     std::swap(format_, other->format_);
     std::swap(width_, other->width_);
     std::swap(height_, other->height_);
@@ -562,10 +884,34 @@ const int SingleTemlate::kImageInfoFieldNumber;
 const int SingleTemlate::kFeatureFieldNumber;
 const int SingleTemlate::kPointsFieldNumber;
 const int SingleTemlate::kDirectionFieldNumber;
+const int SingleTemlate::Fields::imageinfo::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SingleTemlate::Fields::imageinfo::kType;
+const bool SingleTemlate::Fields::imageinfo::kRepeated;
+const int SingleTemlate::Fields::feature::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SingleTemlate::Fields::feature::kType;
+const bool SingleTemlate::Fields::feature::kRepeated;
+const int SingleTemlate::Fields::points::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SingleTemlate::Fields::points::kType;
+const bool SingleTemlate::Fields::points::kRepeated;
+const int SingleTemlate::Fields::direction::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SingleTemlate::Fields::direction::kType;
+const bool SingleTemlate::Fields::direction::kRepeated;
 #endif  // !_MSC_VER
 
 SingleTemlate::SingleTemlate()
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+}
+
+SingleTemlate::SingleTemlate(::google::protobuf::Arena* arena)
+  : ::google::protobuf::MessageLite(),
+    arena_(arena),
+    points_(arena) {
   SharedCtor();
 }
 
@@ -574,11 +920,25 @@ void SingleTemlate::InitAsDefaultInstance() {
 }
 
 SingleTemlate::SingleTemlate(const SingleTemlate& from)
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+SingleTemlate::SingleTemlate(SingleTemlate&& from)
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+  if (from.arena_ == NULL) {
+    Swap(&from);
+  } else {
+    MergeFrom(from);
+  }
+}
+#endif
+
 void SingleTemlate::SharedCtor() {
   _cached_size_ = 0;
   imageinfo_ = NULL;
@@ -655,6 +1015,7 @@ bool SingleTemlate::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_feature:
+          input->BeginBytesField("pb.SingleTemlate.feature");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_feature()));
         } else {
@@ -664,13 +1025,12 @@ bool SingleTemlate::MergePartialFromCodedStream(
         break;
       }
       
-      // repeated .pb.KeyPoint points = 3;
+      // repeated .pb.KeyPoint points = 3 [flat = true];
       case 3: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_points:
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-                input, add_points()));
+          DO_(::pb::KeyPoint::ReadFlat(input, points_.Add()));
         } else {
           goto handle_uninterpreted;
         }
@@ -727,10 +1087,9 @@ void SingleTemlate::SerializeWithCachedSizes(
       2, this->feature(), output);
   }
   
-  // repeated .pb.KeyPoint points = 3;
+  // repeated .pb.KeyPoint points = 3 [flat = true];
   for (int i = 0; i < this->points_size(); i++) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessage(
-      3, this->points(i), output);
+    ::pb::KeyPoint::WriteFlat(3, this->points(i), output);
   }
   
   // optional .pb.FaceDirection direction = 4;
@@ -741,6 +1100,41 @@ void SingleTemlate::SerializeWithCachedSizes(
   
 }
 
+void SingleTemlate::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {
+  // optional .pb.FaceDirection direction = 4;
+  if (has_direction()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnum(
+      4, this->direction(), output);
+  }
+  
+  // repeated .pb.KeyPoint points = 3 [flat = true];
+  if (this->points_size() > 0) {
+    const int element_size = 1 +
+      ::google::protobuf::io::CodedOutputStream::VarintSize32(
+        ::pb::KeyPoint::kFlatByteSize) +
+      ::pb::KeyPoint::kFlatByteSize;
+    ::google::protobuf::uint8* target =
+      output->Prepend(element_size * this->points_size());
+    for (int i = 0; i < this->points_size(); i++) {
+      target = ::pb::KeyPoint::WriteFlatToArray(3, this->points(i), target);
+    }
+  }
+  
+  // required string feature = 2;
+  if (has_feature()) {
+    ::google::protobuf::internal::WireFormatLite::WriteString(
+      2, this->feature(), output);
+  }
+  
+  // required .pb.Image imageInfo = 1;
+  if (has_imageinfo()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageNoVirtual(
+      1, this->imageinfo(), output);
+  }
+  
+}
+
 int SingleTemlate::ByteSize() const {
   int total_size = 0;
   
@@ -766,13 +1160,11 @@ int SingleTemlate::ByteSize() const {
     }
     
   }
-  // repeated .pb.KeyPoint points = 3;
-  total_size += 1 * this->points_size();
-  for (int i = 0; i < this->points_size(); i++) {
-    total_size +=
-      ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-        this->points(i));
-  }
+  // repeated .pb.KeyPoint points = 3 [flat = true];
+  total_size += (1 +
+    ::google::protobuf::io::CodedOutputStream::VarintSize32(
+      ::pb::KeyPoint::kFlatByteSize) +
+    ::pb::KeyPoint::kFlatByteSize) * this->points_size();
   
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = total_size;
@@ -813,14 +1205,18 @@ bool SingleTemlate::IsInitialized() const {
   if (has_imageinfo()) {
     if (!this->imageinfo().IsInitialized()) return false;
   }
-  for (int i = 0; i < points_size(); i++) {
-    if (!this->points(i).IsInitialized()) return false;
-  }
   return true;
 }
 
 void SingleTemlate::Swap(SingleTemlate* other) {
   if (other != this) {
+    if (arena_ != other->arena_) {
+      SingleTemlate temp;
+      temp.MergeFrom(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(imageinfo_, other->imageinfo_);
     std::swap(feature_, other->feature_);
     points_.Swap(&other->points_);
@@ -840,10 +1236,26 @@ void SingleTemlate::Swap(SingleTemlate* other) {
 #ifndef _MSC_VER
 const int SinglePersonTemplate::kIndexFieldNumber;
 const int SinglePersonTemplate::kSingleTemlateFieldNumber;
+const int SinglePersonTemplate::Fields::index::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SinglePersonTemplate::Fields::index::kType;
+const bool SinglePersonTemplate::Fields::index::kRepeated;
+const int SinglePersonTemplate::Fields::singletemlate::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    SinglePersonTemplate::Fields::singletemlate::kType;
+const bool SinglePersonTemplate::Fields::singletemlate::kRepeated;
 #endif  // !_MSC_VER
 
 SinglePersonTemplate::SinglePersonTemplate()
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+}
+
+SinglePersonTemplate::SinglePersonTemplate(::google::protobuf::Arena* arena)
+  : ::google::protobuf::MessageLite(),
+    arena_(arena),
+    singletemlate_(arena) {
   SharedCtor();
 }
 
@@ -851,11 +1263,25 @@ void SinglePersonTemplate::InitAsDefaultInstance() {
 }
 
 SinglePersonTemplate::SinglePersonTemplate(const SinglePersonTemplate& from)
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+SinglePersonTemplate::SinglePersonTemplate(SinglePersonTemplate&& from)
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+  if (from.arena_ == NULL) {
+    Swap(&from);
+  } else {
+    MergeFrom(from);
+  }
+}
+#endif
+
 void SinglePersonTemplate::SharedCtor() {
   _cached_size_ = 0;
   index_ = 0;
@@ -960,6 +1386,21 @@ void SinglePersonTemplate::SerializeWithCachedSizes(
   
 }
 
+void SinglePersonTemplate::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {
+  // repeated .pb.SingleTemlate singleTemlate = 2;
+  for (int i = this->singletemlate_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtual(2, this->singletemlate(i), output);
+  }
+  
+  // required int32 index = 1;
+  if (has_index()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(1, this->index(), output);
+  }
+  
+}
+
 int SinglePersonTemplate::ByteSize() const {
   int total_size = 0;
   
@@ -1018,6 +1459,13 @@ bool SinglePersonTemplate::IsInitialized() const {
 
 void SinglePersonTemplate::Swap(SinglePersonTemplate* other) {
   if (other != this) {
+    if (arena_ != other->arena_) {
+      SinglePersonTemplate temp;
+      temp.MergeFrom(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(index_, other->index_);
     singletemlate_.Swap(&other->singletemlate_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -1039,10 +1487,38 @@ const int TemplateFile::kSinglePersonTemplateIndexFieldNumber;
 const int TemplateFile::kModelVersionFieldNumber;
 const int TemplateFile::kIdentifierFieldNumber;
 const int TemplateFile::kSinglePersonTemplateFieldNumber;
+const int TemplateFile::Fields::versionstring::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    TemplateFile::Fields::versionstring::kType;
+const bool TemplateFile::Fields::versionstring::kRepeated;
+const int TemplateFile::Fields::singlepersontemplateindex::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    TemplateFile::Fields::singlepersontemplateindex::kType;
+const bool TemplateFile::Fields::singlepersontemplateindex::kRepeated;
+const int TemplateFile::Fields::modelversion::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    TemplateFile::Fields::modelversion::kType;
+const bool TemplateFile::Fields::modelversion::kRepeated;
+const int TemplateFile::Fields::identifier::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    TemplateFile::Fields::identifier::kType;
+const bool TemplateFile::Fields::identifier::kRepeated;
+const int TemplateFile::Fields::singlepersontemplate::kNumber;
+const ::google::protobuf::internal::WireFormatLite::FieldType
+    TemplateFile::Fields::singlepersontemplate::kType;
+const bool TemplateFile::Fields::singlepersontemplate::kRepeated;
 #endif  // !_MSC_VER
 
 TemplateFile::TemplateFile()
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+}
+
+TemplateFile::TemplateFile(::google::protobuf::Arena* arena)
+  : ::google::protobuf::MessageLite(),
+    arena_(arena),
+    singlepersontemplate_(arena) {
   SharedCtor();
 }
 
@@ -1050,11 +1526,25 @@ void TemplateFile::InitAsDefaultInstance() {
 }
 
 TemplateFile::TemplateFile(const TemplateFile& from)
-  : ::google::protobuf::MessageLite() {
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+TemplateFile::TemplateFile(TemplateFile&& from)
+  : ::google::protobuf::MessageLite(),
+    arena_(NULL) {
+  SharedCtor();
+  if (from.arena_ == NULL) {
+    Swap(&from);
+  } else {
+    MergeFrom(from);
+  }
+}
+#endif
+
 void TemplateFile::SharedCtor() {
   _cached_size_ = 0;
   versionstring_ = const_cast< ::std::string*>(&_default_versionstring_);
@@ -1123,6 +1613,7 @@ bool TemplateFile::MergePartialFromCodedStream(
       case 1: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          input->BeginBytesField("pb.TemplateFile.versionString");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_versionstring()));
         } else {
@@ -1137,6 +1628,36 @@ bool TemplateFile::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
          parse_singlePersonTemplateIndex:
+          {
+            // Fast path: singlePersonTemplateIndex to modelVersion in order.
+            const void* data;
+            int size;
+            int readable;
+            input->GetDirectBufferPointerInline(&data, &size, &readable);
+            const ::google::protobuf::uint8* start =
+                static_cast<const ::google::protobuf::uint8*>(data);
+            const ::google::protobuf::uint8* ptr = start;
+            ::google::protobuf::int32 singlepersontemplateindex_value;
+            ::google::protobuf::int32 modelversion_value;
+            if (readable >= 21 &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                   ptr, &singlepersontemplateindex_value)) != NULL &&
+                (ptr = ::google::protobuf::io::CodedInputStream::ExpectTagFromArray(
+                   ptr, 24)) != NULL &&
+                (ptr = ::google::protobuf::internal::WireFormatLite::ReadPrimitiveFromArray<
+                     ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                   ptr, &modelversion_value)) != NULL &&
+                ptr - start <= size) {
+              singlepersontemplateindex_ = singlepersontemplateindex_value;
+              set_has_singlepersontemplateindex();
+              modelversion_ = modelversion_value;
+              set_has_modelversion();
+              DO_(input->Skip(ptr - start));
+              if (input->ExpectTag(34)) goto parse_identifier;
+              break;
+            }
+          }
           DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
                    ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
                  input, &singlepersontemplateindex_)));
@@ -1169,6 +1690,7 @@ bool TemplateFile::MergePartialFromCodedStream(
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
             ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
          parse_identifier:
+          input->BeginBytesField("pb.TemplateFile.identifier");
           DO_(::google::protobuf::internal::WireFormatLite::ReadString(
                 input, this->mutable_identifier()));
         } else {
@@ -1240,6 +1762,38 @@ void TemplateFile::SerializeWithCachedSizes(
   
 }
 
+void TemplateFile::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputBuffer* output) const {
+  // repeated .pb.SinglePersonTemplate singlePersonTemplate = 5;
+  for (int i = this->singlepersontemplate_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtual(5, this->singlepersontemplate(i), output);
+  }
+  
+  // required string identifier = 4;
+  if (has_identifier()) {
+    ::google::protobuf::internal::WireFormatLite::WriteString(
+      4, this->identifier(), output);
+  }
+  
+  // required int32 modelVersion = 3;
+  if (has_modelversion()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(3, this->modelversion(), output);
+  }
+  
+  // required int32 singlePersonTemplateIndex = 2;
+  if (has_singlepersontemplateindex()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(2, this->singlepersontemplateindex(), output);
+  }
+  
+  // required string versionString = 1 [default = "1.0.0"];
+  if (has_versionstring()) {
+    ::google::protobuf::internal::WireFormatLite::WriteString(
+      1, this->versionstring(), output);
+  }
+  
+}
+
 int TemplateFile::ByteSize() const {
   int total_size = 0;
   
@@ -1328,6 +1882,13 @@ bool TemplateFile::IsInitialized() const {
 
 void TemplateFile::Swap(TemplateFile* other) {
   if (other != this) {
+    if (arena_ != other->arena_) {
+      TemplateFile temp;
+      temp.MergeFrom(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(versionstring_, other->versionstring_);
     std::swap(singlepersontemplateindex_, other->singlepersontemplateindex_);
     std::swap(modelversion_, other->modelversion_);
@@ -22,6 +22,7 @@
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
 // @@protoc_insertion_point(includes)
 
 namespace pb {
@@ -49,6 +50,12 @@ const FaceDirection FaceDirection_MIN = MIDDLE;
 const FaceDirection FaceDirection_MAX = RIGHT;
 const int FaceDirection_ARRAYSIZE = FaceDirection_MAX + 1;
 
+// pb.KeyPoint as a plain struct, for [flat = true] fields.
+struct KeyPoint_Flat {
+  float x;
+  float y;
+};
+
 // ===================================================================
 
 class KeyPoint : public ::google::protobuf::MessageLite {
@@ -63,6 +70,22 @@ class KeyPoint : public ::google::protobuf::MessageLite {
     return *this;
   }
   
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  KeyPoint(KeyPoint&& from);
+  
+  inline KeyPoint& operator=(KeyPoint&& from) {
+    if (arena_ == from.arena_) {
+      Swap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+#endif
+  
+  inline ::google::protobuf::Arena* GetArena() const { return arena_; }
+  typedef void InternalArenaConstructable_;
+  
   static const KeyPoint& default_instance();
   
   void Swap(KeyPoint* other);
@@ -81,8 +104,19 @@ class KeyPoint : public ::google::protobuf::MessageLite {
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
-  int GetCachedSize() const { return _cached_size_; }
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;
+  // Every field is required and fixed-width, so once they are all set
+  // the message takes kByteSize bytes, and ByteSize() has nothing to
+  // cache.
+  static const int kByteSize = 10;
+  int GetCachedSize() const {
+    return (_has_bits_[0] & 0x00000003u) == 0x00000003u ?
+        kByteSize : _cached_size_;
+  }
   private:
+  explicit KeyPoint(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -92,6 +126,21 @@ class KeyPoint : public ::google::protobuf::MessageLite {
   
   // nested types ----------------------------------------------------
   
+  // flat layout -----------------------------------------------------
+  
+  // [flat = true] fields store this message as a Flat struct.  These
+  // read and write one element, tag and length included.
+  typedef KeyPoint_Flat Flat;
+  static const int kFlatByteSize = 10;
+  static bool ReadFlat(
+      ::google::protobuf::io::CodedInputStream* input, Flat* value);
+  static void WriteFlat(
+      int field_number, const Flat& value,
+      ::google::protobuf::io::CodedOutputStream* output);
+  static ::google::protobuf::uint8* WriteFlatToArray(
+      int field_number, const Flat& value,
+      ::google::protobuf::uint8* target);
+  
   // accessors -------------------------------------------------------
   
   // required float x = 1;
@@ -108,6 +157,51 @@ class KeyPoint : public ::google::protobuf::MessageLite {
   inline float y() const;
   inline void set_y(float value);
   
+  // fields ----------------------------------------------------------
+  
+  // One type per field, for templates that work on any message without
+  // reflection.  Size() is the number of values set, 0 or 1 for singular
+  // fields, and Get() returns the index-th one.
+  struct Fields {
+    struct x {
+      typedef KeyPoint Message;
+      typedef float Type;
+      static const int kNumber = 1;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT;
+      static const bool kRepeated = false;
+      static const char* Name() { return "x"; }
+      static int Size(const KeyPoint& message) {
+        return message.has_x() ? 1 : 0;
+      }
+      static Type Get(const KeyPoint& message, int) {
+        return message.x();
+      }
+    };
+    struct y {
+      typedef KeyPoint Message;
+      typedef float Type;
+      static const int kNumber = 2;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_FLOAT;
+      static const bool kRepeated = false;
+      static const char* Name() { return "y"; }
+      static int Size(const KeyPoint& message) {
+        return message.has_y() ? 1 : 0;
+      }
+      static Type Get(const KeyPoint& message, int) {
+        return message.y();
+      }
+    };
+  };
+  
+  // Calls (*visitor)(Fields::foo()) for each field foo, in order of number.
+  template <typename Visitor>
+  static void VisitFields(Visitor* visitor) {
+    (*visitor)(Fields::x());
+    (*visitor)(Fields::y());
+  }
+  
   // @@protoc_insertion_point(class_scope:pb.KeyPoint)
  private:
   inline void set_has_x();
@@ -115,6 +209,8 @@ class KeyPoint : public ::google::protobuf::MessageLite {
   inline void set_has_y();
   inline void clear_has_y();
   
+  ::google::protobuf::Arena* arena_;
+  
   float x_;
   float y_;
   
@@ -142,6 +238,22 @@ class Image : public ::google::protobuf::MessageLite {
     return *this;
   }
   
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  Image(Image&& from);
+  
+  inline Image& operator=(Image&& from) {
+    if (arena_ == from.arena_) {
+      Swap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+#endif
+  
+  inline ::google::protobuf::Arena* GetArena() const { return arena_; }
+  typedef void InternalArenaConstructable_;
+  
   static const Image& default_instance();
   
   void Swap(Image* other);
@@ -160,8 +272,12 @@ class Image : public ::google::protobuf::MessageLite {
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit Image(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -173,16 +289,24 @@ class Image : public ::google::protobuf::MessageLite {
   
   // accessors -------------------------------------------------------
   
-  // required bytes data = 1;
+  // required bytes data = 1 [ctype = STRING_PIECE];
   inline bool has_data() const;
   inline void clear_data();
   static const int kDataFieldNumber = 1;
-  inline const ::std::string& data() const;
+  inline ::google::protobuf::StringPiece data() const;
   inline void set_data(const ::std::string& value);
   inline void set_data(const char* value);
   inline void set_data(const void* value, size_t size);
+  inline void set_aliased_data(const void* value, size_t size);
+  inline bool data_is_aliased() const;
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_data(::std::string&& value);
+#endif
   inline ::std::string* mutable_data();
   inline ::std::string* release_data();
+  // "value" must have been allocated with new.  It is deleted with
+  // this message, or with its arena.
+  inline void set_allocated_data(::std::string* value);
   
   // required uint32 format = 2;
   inline bool has_format() const;
@@ -212,6 +336,99 @@ class Image : public ::google::protobuf::MessageLite {
   inline ::google::protobuf::int32 stride() const;
   inline void set_stride(::google::protobuf::int32 value);
   
+  // fields ----------------------------------------------------------
+  
+  // One type per field, for templates that work on any message without
+  // reflection.  Size() is the number of values set, 0 or 1 for singular
+  // fields, and Get() returns the index-th one.
+  struct Fields {
+    struct data {
+      typedef Image Message;
+      typedef ::google::protobuf::StringPiece Type;
+      static const int kNumber = 1;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_BYTES;
+      static const bool kRepeated = false;
+      static const char* Name() { return "data"; }
+      static int Size(const Image& message) {
+        return message.has_data() ? 1 : 0;
+      }
+      static Type Get(const Image& message, int) {
+        return message.data();
+      }
+    };
+    struct format {
+      typedef Image Message;
+      typedef ::google::protobuf::uint32 Type;
+      static const int kNumber = 2;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_UINT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "format"; }
+      static int Size(const Image& message) {
+        return message.has_format() ? 1 : 0;
+      }
+      static Type Get(const Image& message, int) {
+        return message.format();
+      }
+    };
+    struct width {
+      typedef Image Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 3;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "width"; }
+      static int Size(const Image& message) {
+        return message.has_width() ? 1 : 0;
+      }
+      static Type Get(const Image& message, int) {
+        return message.width();
+      }
+    };
+    struct height {
+      typedef Image Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 4;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "height"; }
+      static int Size(const Image& message) {
+        return message.has_height() ? 1 : 0;
+      }
+      static Type Get(const Image& message, int) {
+        return message.height();
+      }
+    };
+    struct stride {
+      typedef Image Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 5;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "stride"; }
+      static int Size(const Image& message) {
+        return message.has_stride() ? 1 : 0;
+      }
+      static Type Get(const Image& message, int) {
+        return message.stride();
+      }
+    };
+  };
+  
+  // Calls (*visitor)(Fields::foo()) for each field foo, in order of number.
+  template <typename Visitor>
+  static void VisitFields(Visitor* visitor) {
+    (*visitor)(Fields::data());
+    (*visitor)(Fields::format());
+    (*visitor)(Fields::width());
+    (*visitor)(Fields::height());
+    (*visitor)(Fields::stride());
+  }
+  
   // @@protoc_insertion_point(class_scope:pb.Image)
  private:
   inline void set_has_data();
@@ -225,7 +442,11 @@ class Image : public ::google::protobuf::MessageLite {
   inline void set_has_stride();
   inline void clear_has_stride();
   
+  ::google::protobuf::Arena* arena_;
+  
   ::std::string* data_;
+  const char* data_alias_;
+  int data_alias_size_;
   ::google::protobuf::uint32 format_;
   ::google::protobuf::int32 width_;
   ::google::protobuf::int32 height_;
@@ -255,6 +476,22 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
     return *this;
   }
   
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  SingleTemlate(SingleTemlate&& from);
+  
+  inline SingleTemlate& operator=(SingleTemlate&& from) {
+    if (arena_ == from.arena_) {
+      Swap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+#endif
+  
+  inline ::google::protobuf::Arena* GetArena() const { return arena_; }
+  typedef void InternalArenaConstructable_;
+  
   static const SingleTemlate& default_instance();
   
   void Swap(SingleTemlate* other);
@@ -273,8 +510,12 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit SingleTemlate(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -293,6 +534,9 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
   inline const ::pb::Image& imageinfo() const;
   inline ::pb::Image* mutable_imageinfo();
   inline ::pb::Image* release_imageinfo();
+  // Takes over "imageinfo" if it is on the heap or in this message's
+  // arena; one in another arena is copied and left to that arena.
+  inline void set_allocated_imageinfo(::pb::Image* imageinfo);
   
   // required string feature = 2;
   inline bool has_feature() const;
@@ -302,19 +546,26 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
   inline void set_feature(const ::std::string& value);
   inline void set_feature(const char* value);
   inline void set_feature(const char* value, size_t size);
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_feature(::std::string&& value);
+#endif
   inline ::std::string* mutable_feature();
   inline ::std::string* release_feature();
+  // "value" must have been allocated with new.  It is deleted with
+  // this message, or with its arena.
+  inline void set_allocated_feature(::std::string* value);
   
-  // repeated .pb.KeyPoint points = 3;
+  // repeated .pb.KeyPoint points = 3 [flat = true];
   inline int points_size() const;
   inline void clear_points();
   static const int kPointsFieldNumber = 3;
-  inline const ::pb::KeyPoint& points(int index) const;
-  inline ::pb::KeyPoint* mutable_points(int index);
-  inline ::pb::KeyPoint* add_points();
-  inline const ::google::protobuf::RepeatedPtrField< ::pb::KeyPoint >&
+  inline const ::pb::KeyPoint_Flat& points(int index) const;
+  inline ::pb::KeyPoint_Flat* mutable_points(int index);
+  inline ::pb::KeyPoint_Flat* add_points();
+  inline void add_points(const ::pb::KeyPoint_Flat& value);
+  inline const ::google::protobuf::RepeatedField< ::pb::KeyPoint_Flat >&
       points() const;
-  inline ::google::protobuf::RepeatedPtrField< ::pb::KeyPoint >*
+  inline ::google::protobuf::RepeatedField< ::pb::KeyPoint_Flat >*
       mutable_points();
   
   // optional .pb.FaceDirection direction = 4;
@@ -324,6 +575,83 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
   inline pb::FaceDirection direction() const;
   inline void set_direction(pb::FaceDirection value);
   
+  // fields ----------------------------------------------------------
+  
+  // One type per field, for templates that work on any message without
+  // reflection.  Size() is the number of values set, 0 or 1 for singular
+  // fields, and Get() returns the index-th one.
+  struct Fields {
+    struct imageinfo {
+      typedef SingleTemlate Message;
+      typedef ::pb::Image Type;
+      static const int kNumber = 1;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_MESSAGE;
+      static const bool kRepeated = false;
+      static const char* Name() { return "imageInfo"; }
+      static int Size(const SingleTemlate& message) {
+        return message.has_imageinfo() ? 1 : 0;
+      }
+      static const Type& Get(const SingleTemlate& message, int) {
+        return message.imageinfo();
+      }
+    };
+    struct feature {
+      typedef SingleTemlate Message;
+      typedef ::std::string Type;
+      static const int kNumber = 2;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_STRING;
+      static const bool kRepeated = false;
+      static const char* Name() { return "feature"; }
+      static int Size(const SingleTemlate& message) {
+        return message.has_feature() ? 1 : 0;
+      }
+      static const Type& Get(const SingleTemlate& message, int) {
+        return message.feature();
+      }
+    };
+    struct points {
+      typedef SingleTemlate Message;
+      typedef ::pb::KeyPoint_Flat Type;
+      static const int kNumber = 3;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_MESSAGE;
+      static const bool kRepeated = true;
+      static const char* Name() { return "points"; }
+      static int Size(const SingleTemlate& message) {
+        return message.points_size();
+      }
+      static const Type& Get(const SingleTemlate& message, int index) {
+        return message.points(index);
+      }
+    };
+    struct direction {
+      typedef SingleTemlate Message;
+      typedef pb::FaceDirection Type;
+      static const int kNumber = 4;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_ENUM;
+      static const bool kRepeated = false;
+      static const char* Name() { return "direction"; }
+      static int Size(const SingleTemlate& message) {
+        return message.has_direction() ? 1 : 0;
+      }
+      static Type Get(const SingleTemlate& message, int) {
+        return message.direction();
+      }
+    };
+  };
+  
+  // Calls (*visitor)(Fields::foo()) for each field foo, in order of number.
+  template <typename Visitor>
+  static void VisitFields(Visitor* visitor) {
+    (*visitor)(Fields::imageinfo());
+    (*visitor)(Fields::feature());
+    (*visitor)(Fields::points());
+    (*visitor)(Fields::direction());
+  }
+  
   // @@protoc_insertion_point(class_scope:pb.SingleTemlate)
  private:
   inline void set_has_imageinfo();
@@ -333,9 +661,11 @@ class SingleTemlate : public ::google::protobuf::MessageLite {
   inline void set_has_direction();
   inline void clear_has_direction();
   
+  ::google::protobuf::Arena* arena_;
+  
   ::pb::Image* imageinfo_;
   ::std::string* feature_;
-  ::google::protobuf::RepeatedPtrField< ::pb::KeyPoint > points_;
+  ::google::protobuf::RepeatedField< ::pb::KeyPoint_Flat > points_;
   int direction_;
   
   mutable int _cached_size_;
@@ -362,6 +692,22 @@ class SinglePersonTemplate : public ::google::protobuf::MessageLite {
     return *this;
   }
   
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  SinglePersonTemplate(SinglePersonTemplate&& from);
+  
+  inline SinglePersonTemplate& operator=(SinglePersonTemplate&& from) {
+    if (arena_ == from.arena_) {
+      Swap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+#endif
+  
+  inline ::google::protobuf::Arena* GetArena() const { return arena_; }
+  typedef void InternalArenaConstructable_;
+  
   static const SinglePersonTemplate& default_instance();
   
   void Swap(SinglePersonTemplate* other);
@@ -380,8 +726,12 @@ class SinglePersonTemplate : public ::google::protobuf::MessageLite {
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit SinglePersonTemplate(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -412,11 +762,58 @@ class SinglePersonTemplate : public ::google::protobuf::MessageLite {
   inline ::google::protobuf::RepeatedPtrField< ::pb::SingleTemlate >*
       mutable_singletemlate();
   
+  // fields ----------------------------------------------------------
+  
+  // One type per field, for templates that work on any message without
+  // reflection.  Size() is the number of values set, 0 or 1 for singular
+  // fields, and Get() returns the index-th one.
+  struct Fields {
+    struct index {
+      typedef SinglePersonTemplate Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 1;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "index"; }
+      static int Size(const SinglePersonTemplate& message) {
+        return message.has_index() ? 1 : 0;
+      }
+      static Type Get(const SinglePersonTemplate& message, int) {
+        return message.index();
+      }
+    };
+    struct singletemlate {
+      typedef SinglePersonTemplate Message;
+      typedef ::pb::SingleTemlate Type;
+      static const int kNumber = 2;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_MESSAGE;
+      static const bool kRepeated = true;
+      static const char* Name() { return "singleTemlate"; }
+      static int Size(const SinglePersonTemplate& message) {
+        return message.singletemlate_size();
+      }
+      static const Type& Get(const SinglePersonTemplate& message, int index) {
+        return message.singletemlate(index);
+      }
+    };
+  };
+  
+  // Calls (*visitor)(Fields::foo()) for each field foo, in order of number.
+  template <typename Visitor>
+  static void VisitFields(Visitor* visitor) {
+    (*visitor)(Fields::index());
+    (*visitor)(Fields::singletemlate());
+  }
+  
   // @@protoc_insertion_point(class_scope:pb.SinglePersonTemplate)
  private:
   inline void set_has_index();
   inline void clear_has_index();
   
+  ::google::protobuf::Arena* arena_;
+  
   ::google::protobuf::RepeatedPtrField< ::pb::SingleTemlate > singletemlate_;
   ::google::protobuf::int32 index_;
   
@@ -444,6 +841,22 @@ class TemplateFile : public ::google::protobuf::MessageLite {
     return *this;
   }
   
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  TemplateFile(TemplateFile&& from);
+  
+  inline TemplateFile& operator=(TemplateFile&& from) {
+    if (arena_ == from.arena_) {
+      Swap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+#endif
+  
+  inline ::google::protobuf::Arena* GetArena() const { return arena_; }
+  typedef void InternalArenaConstructable_;
+  
   static const TemplateFile& default_instance();
   
   void Swap(TemplateFile* other);
@@ -462,8 +875,12 @@ class TemplateFile : public ::google::protobuf::MessageLite {
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputBuffer* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit TemplateFile(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -483,8 +900,14 @@ class TemplateFile : public ::google::protobuf::MessageLite {
   inline void set_versionstring(const ::std::string& value);
   inline void set_versionstring(const char* value);
   inline void set_versionstring(const char* value, size_t size);
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_versionstring(::std::string&& value);
+#endif
   inline ::std::string* mutable_versionstring();
   inline ::std::string* release_versionstring();
+  // "value" must have been allocated with new.  It is deleted with
+  // this message, or with its arena.
+  inline void set_allocated_versionstring(::std::string* value);
   
   // required int32 singlePersonTemplateIndex = 2;
   inline bool has_singlepersontemplateindex() const;
@@ -508,8 +931,14 @@ class TemplateFile : public ::google::protobuf::MessageLite {
   inline void set_identifier(const ::std::string& value);
   inline void set_identifier(const char* value);
   inline void set_identifier(const char* value, size_t size);
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+  inline void set_identifier(::std::string&& value);
+#endif
   inline ::std::string* mutable_identifier();
   inline ::std::string* release_identifier();
+  // "value" must have been allocated with new.  It is deleted with
+  // this message, or with its arena.
+  inline void set_allocated_identifier(::std::string* value);
   
   // repeated .pb.SinglePersonTemplate singlePersonTemplate = 5;
   inline int singlepersontemplate_size() const;
@@ -523,6 +952,99 @@ class TemplateFile : public ::google::protobuf::MessageLite {
   inline ::google::protobuf::RepeatedPtrField< ::pb::SinglePersonTemplate >*
       mutable_singlepersontemplate();
   
+  // fields ----------------------------------------------------------
+  
+  // One type per field, for templates that work on any message without
+  // reflection.  Size() is the number of values set, 0 or 1 for singular
+  // fields, and Get() returns the index-th one.
+  struct Fields {
+    struct versionstring {
+      typedef TemplateFile Message;
+      typedef ::std::string Type;
+      static const int kNumber = 1;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_STRING;
+      static const bool kRepeated = false;
+      static const char* Name() { return "versionString"; }
+      static int Size(const TemplateFile& message) {
+        return message.has_versionstring() ? 1 : 0;
+      }
+      static const Type& Get(const TemplateFile& message, int) {
+        return message.versionstring();
+      }
+    };
+    struct singlepersontemplateindex {
+      typedef TemplateFile Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 2;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "singlePersonTemplateIndex"; }
+      static int Size(const TemplateFile& message) {
+        return message.has_singlepersontemplateindex() ? 1 : 0;
+      }
+      static Type Get(const TemplateFile& message, int) {
+        return message.singlepersontemplateindex();
+      }
+    };
+    struct modelversion {
+      typedef TemplateFile Message;
+      typedef ::google::protobuf::int32 Type;
+      static const int kNumber = 3;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_INT32;
+      static const bool kRepeated = false;
+      static const char* Name() { return "modelVersion"; }
+      static int Size(const TemplateFile& message) {
+        return message.has_modelversion() ? 1 : 0;
+      }
+      static Type Get(const TemplateFile& message, int) {
+        return message.modelversion();
+      }
+    };
+    struct identifier {
+      typedef TemplateFile Message;
+      typedef ::std::string Type;
+      static const int kNumber = 4;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_STRING;
+      static const bool kRepeated = false;
+      static const char* Name() { return "identifier"; }
+      static int Size(const TemplateFile& message) {
+        return message.has_identifier() ? 1 : 0;
+      }
+      static const Type& Get(const TemplateFile& message, int) {
+        return message.identifier();
+      }
+    };
+    struct singlepersontemplate {
+      typedef TemplateFile Message;
+      typedef ::pb::SinglePersonTemplate Type;
+      static const int kNumber = 5;
+      static const ::google::protobuf::internal::WireFormatLite::FieldType kType =
+          ::google::protobuf::internal::WireFormatLite::TYPE_MESSAGE;
+      static const bool kRepeated = true;
+      static const char* Name() { return "singlePersonTemplate"; }
+      static int Size(const TemplateFile& message) {
+        return message.singlepersontemplate_size();
+      }
+      static const Type& Get(const TemplateFile& message, int index) {
+        return message.singlepersontemplate(index);
+      }
+    };
+  };
+  
+  // Calls (*visitor)(Fields::foo()) for each field foo, in order of number.
+  template <typename Visitor>
+  static void VisitFields(Visitor* visitor) {
+    (*visitor)(Fields::versionstring());
+    (*visitor)(Fields::singlepersontemplateindex());
+    (*visitor)(Fields::modelversion());
+    (*visitor)(Fields::identifier());
+    (*visitor)(Fields::singlepersontemplate());
+  }
+  
   // @@protoc_insertion_point(class_scope:pb.TemplateFile)
  private:
   inline void set_has_versionstring();
@@ -534,6 +1056,8 @@ class TemplateFile : public ::google::protobuf::MessageLite {
   inline void set_has_identifier();
   inline void clear_has_identifier();
   
+  ::google::protobuf::Arena* arena_;
+  
   ::std::string* versionstring_;
   static const ::std::string _default_versionstring_;
   ::google::protobuf::int32 singlepersontemplateindex_;
@@ -606,7 +1130,7 @@ inline void KeyPoint::set_y(float value) {
 
 // Image
 
-// required bytes data = 1;
+// required bytes data = 1 [ctype = STRING_PIECE];
 inline bool Image::has_data() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
 }
@@ -617,52 +1141,100 @@ inline void Image::clear_has_data() {
   _has_bits_[0] &= ~0x00000001u;
 }
 inline void Image::clear_data() {
+  data_alias_ = NULL;
   if (data_ != &::google::protobuf::internal::kEmptyString) {
     data_->clear();
   }
   clear_has_data();
 }
-inline const ::std::string& Image::data() const {
-  return *data_;
+inline ::google::protobuf::StringPiece Image::data() const {
+  if (data_alias_ != NULL) {
+    return ::google::protobuf::StringPiece(data_alias_, data_alias_size_);
+  }
+  return ::google::protobuf::StringPiece(*data_);
 }
 inline void Image::set_data(const ::std::string& value) {
   set_has_data();
+  data_alias_ = NULL;
   if (data_ == &::google::protobuf::internal::kEmptyString) {
-    data_ = new ::std::string;
+    data_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   data_->assign(value);
 }
 inline void Image::set_data(const char* value) {
   set_has_data();
+  data_alias_ = NULL;
   if (data_ == &::google::protobuf::internal::kEmptyString) {
-    data_ = new ::std::string;
+    data_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   data_->assign(value);
 }
 inline void Image::set_data(const void* value, size_t size) {
   set_has_data();
+  data_alias_ = NULL;
   if (data_ == &::google::protobuf::internal::kEmptyString) {
-    data_ = new ::std::string;
+    data_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   data_->assign(reinterpret_cast<const char*>(value), size);
 }
+inline void Image::set_aliased_data(
+    const void* value, size_t size) {
+  set_has_data();
+  data_alias_ = size == 0 ? "" : reinterpret_cast<const char*>(value);
+  data_alias_size_ = size;
+}
+inline bool Image::data_is_aliased() const {
+  return data_alias_ != NULL;
+}
 inline ::std::string* Image::mutable_data() {
   set_has_data();
   if (data_ == &::google::protobuf::internal::kEmptyString) {
-    data_ = new ::std::string;
+    data_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
+  }
+  if (data_alias_ != NULL) {
+    data_->assign(data_alias_, data_alias_size_);
+    data_alias_ = NULL;
   }
   return data_;
 }
 inline ::std::string* Image::release_data() {
+  if (data_alias_ != NULL) {
+    mutable_data();
+  }
   clear_has_data();
   if (data_ == &::google::protobuf::internal::kEmptyString) {
     return NULL;
   } else {
     ::std::string* temp = data_;
     data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (arena_ != NULL) temp = new ::std::string(*temp);
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void Image::set_data(::std::string&& value) {
+  set_has_data();
+  data_alias_ = NULL;
+  if (data_ == &::google::protobuf::internal::kEmptyString) {
+    data_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
+  }
+  *data_ = ::std::move(value);
+}
+#endif
+inline void Image::set_allocated_data(::std::string* value) {
+  data_alias_ = NULL;
+  if (data_ != &::google::protobuf::internal::kEmptyString && arena_ == NULL) {
+    delete data_;
+  }
+  if (value != NULL) {
+    if (arena_ != NULL) arena_->Own(value);
+    set_has_data();
+    data_ = value;
+  } else {
+    clear_has_data();
+    data_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // required uint32 format = 2;
 inline bool Image::has_format() const {
@@ -775,15 +1347,36 @@ inline const ::pb::Image& SingleTemlate::imageinfo() const {
 }
 inline ::pb::Image* SingleTemlate::mutable_imageinfo() {
   set_has_imageinfo();
-  if (imageinfo_ == NULL) imageinfo_ = new ::pb::Image;
+  if (imageinfo_ == NULL) imageinfo_ = ::google::protobuf::Arena::CreateMessage< ::pb::Image >(arena_);
   return imageinfo_;
 }
 inline ::pb::Image* SingleTemlate::release_imageinfo() {
   clear_has_imageinfo();
   ::pb::Image* temp = imageinfo_;
+  if (arena_ != NULL && temp != NULL) temp = new ::pb::Image(*temp);
   imageinfo_ = NULL;
   return temp;
 }
+inline void SingleTemlate::set_allocated_imageinfo(::pb::Image* imageinfo) {
+  if (arena_ == NULL) {
+    delete imageinfo_;
+  }
+  if (imageinfo != NULL && imageinfo->GetArena() != arena_) {
+    if (imageinfo->GetArena() == NULL) {
+      arena_->Own(imageinfo);
+    } else {
+      ::pb::Image* temp = ::google::protobuf::Arena::CreateMessage< ::pb::Image >(arena_);
+      temp->CopyFrom(*imageinfo);
+      imageinfo = temp;
+    }
+  }
+  imageinfo_ = imageinfo;
+  if (imageinfo != NULL) {
+    set_has_imageinfo();
+  } else {
+    clear_has_imageinfo();
+  }
+}
 
 // required string feature = 2;
 inline bool SingleTemlate::has_feature() const {
@@ -807,28 +1400,28 @@ inline const ::std::string& SingleTemlate::feature() const {
 inline void SingleTemlate::set_feature(const ::std::string& value) {
   set_has_feature();
   if (feature_ == &::google::protobuf::internal::kEmptyString) {
-    feature_ = new ::std::string;
+    feature_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   feature_->assign(value);
 }
 inline void SingleTemlate::set_feature(const char* value) {
   set_has_feature();
   if (feature_ == &::google::protobuf::internal::kEmptyString) {
-    feature_ = new ::std::string;
+    feature_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   feature_->assign(value);
 }
 inline void SingleTemlate::set_feature(const char* value, size_t size) {
   set_has_feature();
   if (feature_ == &::google::protobuf::internal::kEmptyString) {
-    feature_ = new ::std::string;
+    feature_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   feature_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* SingleTemlate::mutable_feature() {
   set_has_feature();
   if (feature_ == &::google::protobuf::internal::kEmptyString) {
-    feature_ = new ::std::string;
+    feature_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   return feature_;
 }
@@ -839,31 +1432,60 @@ inline ::std::string* SingleTemlate::release_feature() {
   } else {
     ::std::string* temp = feature_;
     feature_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (arena_ != NULL) temp = new ::std::string(*temp);
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void SingleTemlate::set_feature(::std::string&& value) {
+  set_has_feature();
+  if (feature_ == &::google::protobuf::internal::kEmptyString) {
+    feature_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
+  }
+  *feature_ = ::std::move(value);
+}
+#endif
+inline void SingleTemlate::set_allocated_feature(::std::string* value) {
+  if (feature_ != &::google::protobuf::internal::kEmptyString && arena_ == NULL) {
+    delete feature_;
+  }
+  if (value != NULL) {
+    if (arena_ != NULL) arena_->Own(value);
+    set_has_feature();
+    feature_ = value;
+  } else {
+    clear_has_feature();
+    feature_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
-// repeated .pb.KeyPoint points = 3;
+// repeated .pb.KeyPoint points = 3 [flat = true];
 inline int SingleTemlate::points_size() const {
   return points_.size();
 }
 inline void SingleTemlate::clear_points() {
   points_.Clear();
 }
-inline const ::pb::KeyPoint& SingleTemlate::points(int index) const {
+inline const ::pb::KeyPoint_Flat& SingleTemlate::points(int index) const {
   return points_.Get(index);
 }
-inline ::pb::KeyPoint* SingleTemlate::mutable_points(int index) {
+inline ::pb::KeyPoint_Flat* SingleTemlate::mutable_points(int index) {
   return points_.Mutable(index);
 }
-inline ::pb::KeyPoint* SingleTemlate::add_points() {
-  return points_.Add();
+inline ::pb::KeyPoint_Flat* SingleTemlate::add_points() {
+  ::pb::KeyPoint_Flat* value = points_.Add();
+  value->x = 0;
+  value->y = 0;
+  return value;
+}
+inline void SingleTemlate::add_points(const ::pb::KeyPoint_Flat& value) {
+  points_.Add(value);
 }
-inline const ::google::protobuf::RepeatedPtrField< ::pb::KeyPoint >&
+inline const ::google::protobuf::RepeatedField< ::pb::KeyPoint_Flat >&
 SingleTemlate::points() const {
   return points_;
 }
-inline ::google::protobuf::RepeatedPtrField< ::pb::KeyPoint >*
+inline ::google::protobuf::RepeatedField< ::pb::KeyPoint_Flat >*
 SingleTemlate::mutable_points() {
   return &points_;
 }
@@ -968,28 +1590,28 @@ inline const ::std::string& TemplateFile::versionstring() const {
 inline void TemplateFile::set_versionstring(const ::std::string& value) {
   set_has_versionstring();
   if (versionstring_ == &_default_versionstring_) {
-    versionstring_ = new ::std::string;
+    versionstring_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   versionstring_->assign(value);
 }
 inline void TemplateFile::set_versionstring(const char* value) {
   set_has_versionstring();
   if (versionstring_ == &_default_versionstring_) {
-    versionstring_ = new ::std::string;
+    versionstring_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   versionstring_->assign(value);
 }
 inline void TemplateFile::set_versionstring(const char* value, size_t size) {
   set_has_versionstring();
   if (versionstring_ == &_default_versionstring_) {
-    versionstring_ = new ::std::string;
+    versionstring_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   versionstring_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* TemplateFile::mutable_versionstring() {
   set_has_versionstring();
   if (versionstring_ == &_default_versionstring_) {
-    versionstring_ = new ::std::string(_default_versionstring_);
+    versionstring_ = ::google::protobuf::Arena::Create< ::std::string>(arena_, _default_versionstring_);
   }
   return versionstring_;
 }
@@ -1000,9 +1622,32 @@ inline ::std::string* TemplateFile::release_versionstring() {
   } else {
     ::std::string* temp = versionstring_;
     versionstring_ = const_cast< ::std::string*>(&_default_versionstring_);
+    if (arena_ != NULL) temp = new ::std::string(*temp);
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void TemplateFile::set_versionstring(::std::string&& value) {
+  set_has_versionstring();
+  if (versionstring_ == &_default_versionstring_) {
+    versionstring_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
+  }
+  *versionstring_ = ::std::move(value);
+}
+#endif
+inline void TemplateFile::set_allocated_versionstring(::std::string* value) {
+  if (versionstring_ != &_default_versionstring_ && arena_ == NULL) {
+    delete versionstring_;
+  }
+  if (value != NULL) {
+    if (arena_ != NULL) arena_->Own(value);
+    set_has_versionstring();
+    versionstring_ = value;
+  } else {
+    clear_has_versionstring();
+    versionstring_ = const_cast< ::std::string*>(&_default_versionstring_);
+  }
+}
 
 // required int32 singlePersonTemplateIndex = 2;
 inline bool TemplateFile::has_singlepersontemplateindex() const {
@@ -1070,28 +1715,28 @@ inline const ::std::string& TemplateFile::identifier() const {
 inline void TemplateFile::set_identifier(const ::std::string& value) {
   set_has_identifier();
   if (identifier_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_ = new ::std::string;
+    identifier_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   identifier_->assign(value);
 }
 inline void TemplateFile::set_identifier(const char* value) {
   set_has_identifier();
   if (identifier_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_ = new ::std::string;
+    identifier_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   identifier_->assign(value);
 }
 inline void TemplateFile::set_identifier(const char* value, size_t size) {
   set_has_identifier();
   if (identifier_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_ = new ::std::string;
+    identifier_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   identifier_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* TemplateFile::mutable_identifier() {
   set_has_identifier();
   if (identifier_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_ = new ::std::string;
+    identifier_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
   }
   return identifier_;
 }
@@ -1102,9 +1747,32 @@ inline ::std::string* TemplateFile::release_identifier() {
   } else {
     ::std::string* temp = identifier_;
     identifier_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (arena_ != NULL) temp = new ::std::string(*temp);
     return temp;
   }
 }
+#if GOOGLE_PROTOBUF_HAS_RVALUE_REFERENCES
+inline void TemplateFile::set_identifier(::std::string&& value) {
+  set_has_identifier();
+  if (identifier_ == &::google::protobuf::internal::kEmptyString) {
+    identifier_ = ::google::protobuf::Arena::Create< ::std::string>(arena_);
+  }
+  *identifier_ = ::std::move(value);
+}
+#endif
+inline void TemplateFile::set_allocated_identifier(::std::string* value) {
+  if (identifier_ != &::google::protobuf::internal::kEmptyString && arena_ == NULL) {
+    delete identifier_;
+  }
+  if (value != NULL) {
+    if (arena_ != NULL) arena_->Own(value);
+    set_has_identifier();
+    identifier_ = value;
+  } else {
+    clear_has_identifier();
+    identifier_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // repeated .pb.SinglePersonTemplate singlePersonTemplate = 5;
 inline int TemplateFile::singlepersontemplate_size() const {